@@ -0,0 +1,80 @@
+﻿#include "AiWorker.h"
+
+AiWorker::AiWorker()
+    : m_thread(&AiWorker::run, this)
+{
+}
+
+AiWorker::~AiWorker() {
+    cancel();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+/**
+ * @brief 提交任务实现：取消旧任务后放入待执行槽位并唤醒工作线程
+ */
+void AiWorker::submit(Task task, StopFn stop) {
+    cancel();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = std::move(task);
+        m_pendingStop = std::move(stop);
+    }
+    m_wake.notify_one();
+}
+
+/**
+ * @brief 取消任务实现
+ * 实现逻辑：
+ * Step1：清空待执行槽位（工作线程尚未取走的任务直接丢弃）；
+ * Step2：若有任务正在执行，在锁外调用其停止函数，再等待最多1毫秒；
+ *        任务可能在停止请求之后才进入搜索入口（复位了停止标志），因此循环直到任务确认返回。
+ */
+void AiWorker::cancel() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_pending = nullptr;
+    m_pendingStop = nullptr;
+    while (m_running) {
+        const StopFn stop = m_activeStop;
+        lock.unlock();
+        if (stop) {
+            stop();
+        }
+        lock.lock();
+        m_idle.wait_for(lock, std::chrono::milliseconds(1), [this]() { return !m_running; });
+    }
+}
+
+bool AiWorker::isBusy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running || m_pending;
+}
+
+/**
+ * @brief 工作线程主循环：等待任务 → 在锁外执行 → 标记空闲并通知 cancel()
+ */
+void AiWorker::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_quit || m_pending; });
+        if (m_quit) {
+            return;
+        }
+        Task task = std::move(m_pending);
+        m_pending = nullptr;
+        m_activeStop = std::move(m_pendingStop);
+        m_pendingStop = nullptr;
+        m_running = true;
+        lock.unlock();
+        task();
+        lock.lock();
+        m_running = false;
+        m_activeStop = nullptr;
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,96 @@
+﻿#pragma once
+#ifndef AIWORKER_H
+#define AIWORKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief AI 工作线程：在一个常驻后台线程上执行 AI 搜索任务，使界面线程在 AI 思考期间保持响应
+ * 核心职责：
+ * 1. submit() 提交一个任务（通常是一次 SearchEngine/MctsEngine 搜索）与对应的停止函数，立即返回；
+ *    任务在工作线程上执行，结果由任务自己投递回界面线程（GameController 用排队调用）；
+ * 2. cancel() 取消当前任务：丢弃尚未开始的任务，并反复调用停止函数直到正在执行的任务返回；
+ *    搜索入口会复位停止标志，单次请求可能被覆盖，因此与 Ponderer::stop() 一样循环请求；
+ * 3. 同一时刻至多一个任务，新任务提交前自动取消旧任务。
+ * 设计特点：纯逻辑类（不依赖Qt），线程在构造时启动、析构时取消当前任务并退出，
+ * 任务之间复用同一线程，不为每步棋创建/销毁线程。
+ */
+class AiWorker {
+public:
+    using Task = std::function<void()>;
+    using StopFn = std::function<void()>;
+
+    AiWorker();
+    ~AiWorker();
+
+    AiWorker(const AiWorker&) = delete;
+    AiWorker& operator=(const AiWorker&) = delete;
+
+    /**
+     * @brief 提交任务（先取消当前任务），立即返回
+     * @param task 在工作线程上执行的任务
+     * @param stop 请求任务尽快结束的函数（可在其他线程调用，可能被调用多次）
+     */
+    void submit(Task task, StopFn stop);
+
+    /**
+     * @brief 取消当前任务并等待其返回（没有任务时立即返回）
+     * 返回后可以安全地修改任务引用的对象（棋盘、会话）。
+     */
+    void cancel();
+
+    /**
+     * @brief 是否有任务正在执行或等待执行
+     */
+    bool isBusy() const;
+
+private:
+    void run();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;      // 有新任务或需要退出
+    std::condition_variable m_idle;      // 当前任务已返回
+    Task m_pending;
+    StopFn m_pendingStop;
+    StopFn m_activeStop;
+    bool m_running = false;
+    bool m_quit = false;
+    std::thread m_thread;                // 最后声明：构造时其余成员已初始化完毕，线程才开始运行
+};
+
+/**
+ * @brief 进度节流器：两次放行之间至少间隔 intervalMs 毫秒（首次总是放行）
+ * 搜索进度（每轮迭代、每批模拟）可能在毫秒内连续到达，逐条转发会让界面频繁重绘而卡顿；
+ * 由任务在工作线程上持有，只在单一线程上使用，不加锁。
+ */
+class ProgressThrottle {
+public:
+    explicit ProgressThrottle(int intervalMs)
+        : m_interval(intervalMs)
+    {
+    }
+
+    /**
+     * @brief 距上次放行已满间隔时返回 true 并记录本次时间，否则返回 false（调用方丢弃这条进度）
+     */
+    bool tryAcquire() {
+        const auto now = std::chrono::steady_clock::now();
+        if (m_started && now - m_last < m_interval) {
+            return false;
+        }
+        m_started = true;
+        m_last = now;
+        return true;
+    }
+
+private:
+    std::chrono::milliseconds m_interval;
+    std::chrono::steady_clock::time_point m_last;
+    bool m_started = false;
+};
+
+#endif // AIWORKER_H
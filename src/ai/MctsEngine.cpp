@@ -0,0 +1,442 @@
+﻿#include "MctsEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief PUCT探索常数
+ */
+constexpr double PUCT_C = 1.5;
+
+/**
+ * @brief 快速走子最多步数（超过后按静态估值的符号判定胜负）
+ */
+constexpr int MAX_ROLLOUT_MOVES = 60;
+
+/**
+ * @brief 快速走子每步随机抽样的候选点数量（取攻防分最高者）
+ */
+constexpr int ROLLOUT_SAMPLES = 4;
+
+constexpr uint32_t ALLOC_FAILED = UINT32_MAX;
+
+/**
+ * @brief 着法的攻防分：双方在该点四个方向的棋型分之和
+ */
+template <int N, Rule R>
+inline int moveWeight(const BasicBoard<N, R>& board, int cell, Config::PieceType side, Config::PieceType opp) {
+    const int row = cell / N;
+    const int col = cell % N;
+    int weight = 0;
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        weight += PATTERN_SCORE[static_cast<int>(board.pattern(row, col, dir, side))];
+        weight += PATTERN_SCORE[static_cast<int>(board.pattern(row, col, dir, opp))];
+    }
+    return weight;
+}
+
+/**
+ * @brief 判断color方在cell落子能否成五
+ */
+template <int N, Rule R>
+inline bool makesFive(const BasicBoard<N, R>& board, int cell, Config::PieceType color) {
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        if (board.pattern(cell / N, cell % N, dir, color) == PatternType::Five) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现：只记录节点池容量，内存在首次搜索时分配（避免未使用MCTS时占用内存）
+ */
+template <int N, Rule R>
+BasicMctsEngine<N, R>::BasicMctsEngine(size_t memoryMB)
+    : m_capacity(std::max<size_t>(memoryMB * 1024 * 1024 / sizeof(Node), 1024))
+{
+}
+
+template <int N, Rule R>
+BasicMctsEngine<N, R>::~BasicMctsEngine() = default;
+
+/**
+ * @brief 节点分配实现：一次原子加法取得count个连续节点，并复位各字段
+ * @return uint32_t 第一个节点的下标；节点池耗尽返回ALLOC_FAILED
+ */
+template <int N, Rule R>
+uint32_t BasicMctsEngine<N, R>::allocate(int count) {
+    const size_t first = m_used.fetch_add(static_cast<size_t>(count), std::memory_order_relaxed);
+    if (first + static_cast<size_t>(count) > m_capacity) {
+        return ALLOC_FAILED;
+    }
+    for (int i = 0; i < count; ++i) {
+        Node& n = m_nodes[first + i];
+        n.visits.store(0, std::memory_order_relaxed);
+        n.virtualLoss.store(0, std::memory_order_relaxed);
+        n.score.store(0, std::memory_order_relaxed);
+        n.firstChild.store(0, std::memory_order_relaxed);
+        n.childCount.store(0, std::memory_order_relaxed);
+        n.state.store(UNEXPANDED, std::memory_order_relaxed);
+        n.move = -1;
+        n.prior = 0.0f;
+    }
+    return static_cast<uint32_t>(first);
+}
+
+/**
+ * @brief 节点扩展实现
+ * 实现逻辑：
+ * Step1：候选着法不含己方禁手点；己方可成五 → 只生成成五点，并直接标记为终局（走到该子节点的一方获胜）；
+ * Step2：对方可成五 → 只生成封堵点；
+ * Step3：否则（或封堵点都是己方禁手）取全部候选着法，按攻防分保留前MAX_CHILDREN个，先验 = 攻防分 / 总和；
+ * Step4：分配连续子节点、填写着法与先验，最后以release语义发布子节点并置为已扩展。
+ * @return bool 是否扩展成功（节点池耗尽时恢复为未扩展并返回false）
+ */
+template <int N, Rule R>
+bool BasicMctsEngine<N, R>::expand(Node& node, const BasicBoard<N, R>& board, Config::PieceType side) {
+    if (m_used.load(std::memory_order_relaxed) >= m_capacity) {
+        node.state.store(UNEXPANDED, std::memory_order_release);
+        return false;
+    }
+    const Config::PieceType opp = Config::opponent(side);
+    int candidates[N * N];
+    const int candidateCount = board.candidateMoves(candidates, side);
+
+    struct Weighted { int cell; int weight; };
+    Weighted moves[N * N];
+    int count = 0;
+    bool winning = false;
+    if (board.threatCount(side, PatternType::Five) > 0) {
+        for (int i = 0; i < candidateCount && count == 0; ++i) {
+            if (makesFive(board, candidates[i], side)) {
+                moves[count++] = { candidates[i], 1 };
+            }
+        }
+        winning = true;
+    } else if (board.threatCount(opp, PatternType::Five) > 0) {
+        for (int i = 0; i < candidateCount; ++i) {
+            if (makesFive(board, candidates[i], opp)) {
+                moves[count++] = { candidates[i], 1 };
+            }
+        }
+    }
+    if (count == 0) {
+        // 无需封堵，或封堵点全是己方禁手（已必败，仍按普通着法扩展）
+        for (int i = 0; i < candidateCount; ++i) {
+            moves[count++] = { candidates[i], 1 + moveWeight(board, candidates[i], side, opp) };
+        }
+        if (count > MAX_CHILDREN) {
+            std::partial_sort(moves, moves + MAX_CHILDREN, moves + count,
+                              [](const Weighted& a, const Weighted& b) { return a.weight > b.weight; });
+            count = MAX_CHILDREN;
+        }
+    }
+
+    if (count == 0) {
+        node.state.store(TERMINAL, std::memory_order_release);   // 满盘：和棋
+        return true;
+    }
+    const uint32_t first = allocate(count);
+    if (first == ALLOC_FAILED) {
+        node.state.store(UNEXPANDED, std::memory_order_release);
+        return false;
+    }
+
+    double total = 0.0;
+    for (int i = 0; i < count; ++i) {
+        total += moves[i].weight;
+    }
+    for (int i = 0; i < count; ++i) {
+        Node& child = m_nodes[first + i];
+        child.move = static_cast<int16_t>(moves[i].cell);
+        child.prior = static_cast<float>(moves[i].weight / total);
+        if (winning) {
+            child.state.store(TERMINAL, std::memory_order_relaxed);
+        }
+    }
+    node.firstChild.store(first, std::memory_order_relaxed);
+    node.childCount.store(static_cast<uint16_t>(count), std::memory_order_relaxed);
+    node.state.store(EXPANDED, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief PUCT选择实现
+ * 实现逻辑：有效访问数 = 访问数 + 虚拟损失（虚拟损失按负计入，不加分）；
+ * 未访问的子节点Q取0.5（中性），U = C × P × sqrt(父节点有效访问数) / (1 + 子节点有效访问数)。
+ * @return int 选中子节点在节点池中的下标
+ */
+template <int N, Rule R>
+int BasicMctsEngine<N, R>::select(const Node& node) const {
+    const uint32_t first = node.firstChild.load(std::memory_order_relaxed);
+    const int count = node.childCount.load(std::memory_order_relaxed);
+    const double parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed);
+    const double sqrtParent = std::sqrt(std::max(1.0, parentVisits));
+
+    int best = static_cast<int>(first);
+    double bestValue = -1e300;
+    for (int i = 0; i < count; ++i) {
+        const Node& child = m_nodes[first + i];
+        const double n = child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+        const double q = n > 0 ? child.score.load(std::memory_order_relaxed) / (2.0 * n) : 0.5;
+        const double value = q + PUCT_C * child.prior * sqrtParent / (1.0 + n);
+        if (value > bestValue) {
+            bestValue = value;
+            best = static_cast<int>(first) + i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 快速走子实现
+ * 实现逻辑：轮流落子直到分出胜负或达到步数上限——
+ * 行棋方可成五或有活四（对方无五，且行棋方无禁手）判胜；对方可成五则堵（堵不住下一步即负，封堵点是禁手直接判负）；
+ * 否则随机抽取ROLLOUT_SAMPLES个候选点，取攻防分最高者。
+ * @return int 对side的结果：1胜，0和，-1负
+ */
+template <int N, Rule R>
+int BasicMctsEngine<N, R>::rollout(BasicBoard<N, R>& board, Config::PieceType side, std::mt19937& rng) const {
+    const Config::PieceType rootSide = side;
+    int candidates[N * N];
+    for (int step = 0; step < MAX_ROLLOUT_MOVES; ++step) {
+        const Config::PieceType opp = Config::opponent(side);
+        const int sign = side == rootSide ? 1 : -1;
+        if (board.threatCount(side, PatternType::Five) > 0) {
+            return sign;
+        }
+        const int count = board.candidateMoves(candidates, side);
+        if (count == 0 || board.isFull()) {
+            return 0;
+        }
+
+        int move = -1;
+        if (board.threatCount(opp, PatternType::Five) > 0) {
+            for (int i = 0; i < count && move < 0; ++i) {
+                if (makesFive(board, candidates[i], opp)) {
+                    move = candidates[i];
+                }
+            }
+            if (move < 0) {
+                return -sign;   // 封堵点是己方禁手
+            }
+        } else if (!hasForbiddenMoves(R, side) && board.threatCount(side, PatternType::OpenFour) > 0) {
+            return sign;
+        } else {
+            int bestWeight = -1;
+            for (int k = 0; k < ROLLOUT_SAMPLES; ++k) {
+                const int cell = candidates[rng() % static_cast<unsigned>(count)];
+                const int weight = moveWeight(board, cell, side, opp);
+                if (weight > bestWeight) {
+                    bestWeight = weight;
+                    move = cell;
+                }
+            }
+        }
+        board.makeMove(move / N, move % N, side);
+        side = opp;
+    }
+    const int eval = board.evaluate(rootSide);
+    return eval > 0 ? 1 : (eval < 0 ? -1 : 0);
+}
+
+/**
+ * @brief 一次模拟实现（选择 → 扩展 → 快速走子 → 回传）
+ * 实现逻辑：
+ * Step1：从根出发按PUCT下行，沿途给子节点加虚拟损失并在棋盘副本上落子，
+ *        遇到终局节点、未扩展节点或正由其他线程扩展的节点时停止；
+ * Step2：未扩展节点尝试抢占扩展权（CAS 0→1），由抢到的线程扩展；
+ * Step3：从当前局面快速走子得到结果；终局节点直接以“走到该节点的一方获胜/和棋”为结果；
+ * Step4：沿路径自底向上交替视角累加得分与访问次数，并撤销虚拟损失。
+ */
+template <int N, Rule R>
+void BasicMctsEngine<N, R>::playout(BasicBoard<N, R>& board, std::mt19937& rng) {
+    Node* path[MAX_TREE_DEPTH];
+    int length = 0;
+    Node* node = &m_nodes[0];
+    Config::PieceType side = m_rootSide;
+    path[length++] = node;
+
+    int result;   // 对“当前行棋方side”的结果
+    while (true) {
+        uint8_t state = node->state.load(std::memory_order_acquire);
+        if (state == TERMINAL) {
+            // 成五终局：走到该节点的一方（side的对方）已获胜；否则为无子可下的满盘和棋
+            result = node->move >= 0 && board.checkWin(node->move / N, node->move % N, Config::opponent(side)) ? -1 : 0;
+            break;
+        }
+        if (state == UNEXPANDED) {
+            uint8_t expected = UNEXPANDED;
+            if (node->state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acq_rel)) {
+                expand(*node, board, side);
+            }
+            result = rollout(board, side, rng);
+            break;
+        }
+        if (state == EXPANDING || length >= MAX_TREE_DEPTH) {
+            result = rollout(board, side, rng);
+            break;
+        }
+        Node* child = &m_nodes[select(*node)];
+        child->virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        board.makeMove(child->move / N, child->move % N, side);
+        side = Config::opponent(side);
+        node = child;
+        path[length++] = node;
+    }
+
+    // 叶节点的得分视角是“走到叶节点的一方”，即当前行棋方的对方
+    int value = -result;
+    for (int i = length - 1; i >= 0; --i) {
+        Node* n = path[i];
+        n->score.fetch_add(value + 1, std::memory_order_relaxed);
+        n->visits.fetch_add(1, std::memory_order_relaxed);
+        if (i > 0) {
+            n->virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+        }
+        value = -value;
+    }
+    m_playouts.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief 预算检查：停止标志、模拟次数、时间任一到达即返回true
+ */
+template <int N, Rule R>
+bool BasicMctsEngine<N, R>::budgetExhausted() {
+    if (m_stop.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (m_limits.maxPlayouts && m_playouts.load(std::memory_order_relaxed) >= m_limits.maxPlayouts) {
+        return true;
+    }
+    if (m_limits.timeMs > 0) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_startTime).count();
+        if (elapsed >= m_limits.timeMs) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 搜索线程主循环：每个线程只复制一次根局面，每次模拟后用unmakeMove退回根局面
+ * reportProgress为true（调用search()的线程）时，每 PROGRESS_PLAYOUTS 次模拟调用一次limits.onProgress。
+ */
+template <int N, Rule R>
+void BasicMctsEngine<N, R>::worker(unsigned seed, bool reportProgress) {
+    std::mt19937 rng(seed);
+    BasicBoard<N, R> board = m_rootBoard;
+    const int rootMoves = board.moveCount();
+    uint64_t sinceReport = 0;
+    while (!budgetExhausted()) {
+        playout(board, rng);
+        while (board.moveCount() > rootMoves) {
+            board.unmakeMove();
+        }
+        if (reportProgress && m_limits.onProgress && ++sinceReport == PROGRESS_PLAYOUTS) {
+            sinceReport = 0;
+            MctsResult progress;
+            fillBest(progress);
+            progress.playouts = m_playouts.load(std::memory_order_relaxed);
+            progress.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - m_startTime).count();
+            m_limits.onProgress(progress);
+        }
+    }
+}
+
+/**
+ * @brief 最佳着法提取实现：根节点（节点池第0个）中访问次数最多的子节点及其胜率（搜索中途调用时为近似快照）
+ */
+template <int N, Rule R>
+void BasicMctsEngine<N, R>::fillBest(MctsResult& result) const {
+    const Node& root = m_nodes[0];
+    const uint32_t first = root.firstChild.load(std::memory_order_relaxed);
+    const int rootChildren = root.childCount.load(std::memory_order_relaxed);
+    int bestVisits = -1;
+    for (int i = 0; i < rootChildren; ++i) {
+        const Node& child = m_nodes[first + i];
+        const int visits = child.visits.load(std::memory_order_relaxed);
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            result.row = child.move / N;
+            result.col = child.move % N;
+            result.winRate = visits > 0 ? child.score.load(std::memory_order_relaxed) / (2.0 * visits) : 0.5;
+        }
+    }
+}
+
+/**
+ * @brief 搜索入口实现
+ * 实现逻辑：
+ * Step1：首次搜索时分配节点池（不构造节点，只申请内存）；复位节点池（m_used归零）、计数器与停止标志，分配并扩展根节点；
+ *        空棋盘直接走天元，根节点只有一个子节点（必成五/唯一封堵点）时直接返回；
+ * Step2：启动limits.threads-1个辅助线程，与当前线程一起运行worker()（只有当前线程报告进度），全部结束后汇合；
+ * Step3：取访问次数最多的根子节点为最佳着法，统计模拟次数、每秒模拟数与峰值树内存。
+ */
+template <int N, Rule R>
+MctsResult BasicMctsEngine<N, R>::search(const BasicBoard<N, R>& board, Config::PieceType side, const MctsLimits& limits) {
+    if (!m_nodes) {
+        m_nodes.reset(new Node[m_capacity]);
+    }
+    m_rootBoard = board;
+    m_rootSide = side;
+    m_limits = limits;
+    m_startTime = std::chrono::steady_clock::now();
+    m_stop.store(false, std::memory_order_relaxed);
+    m_playouts.store(0, std::memory_order_relaxed);
+    m_used.store(0, std::memory_order_relaxed);
+
+    MctsResult result;
+    if (board.stoneCount() == 0) {
+        result.row = N / 2;
+        result.col = N / 2;
+        return result;
+    }
+
+    Node& root = m_nodes[allocate(1)];
+    root.state.store(EXPANDING, std::memory_order_relaxed);
+    expand(root, board, side);
+    const int rootChildren = root.childCount.load(std::memory_order_relaxed);
+
+    if (rootChildren > 1) {
+        const int threads = limits.threads > 0 ? limits.threads
+                                               : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> helpers;
+        for (int i = 1; i < threads; ++i) {
+            helpers.emplace_back(&BasicMctsEngine<N, R>::worker, this, 0x9E3779B9u * static_cast<unsigned>(i + 1), false);
+        }
+        worker(0x9E3779B9u, true);
+        for (auto& t : helpers) {
+            t.join();
+        }
+    }
+
+    fillBest(result);
+
+    result.playouts = m_playouts.load(std::memory_order_relaxed);
+    result.nodes = std::min(m_used.load(std::memory_order_relaxed), m_capacity);
+    result.peakMemoryBytes = result.nodes * sizeof(Node);
+    const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_startTime).count();
+    result.timeMs = micros / 1000;
+    result.playoutsPerSec = micros > 0 ? result.playouts * 1000000ull / static_cast<uint64_t>(micros) : 0;
+    return result;
+}
+
+template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Freestyle>;
+template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Standard>;
+template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Renju>;
+template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Caro>;
+template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Caro>;
@@ -0,0 +1,152 @@
+﻿#pragma once
+#ifndef MCTSENGINE_H
+#define MCTSENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include "../game/Board.h"
+
+struct MctsResult;
+
+/**
+ * @brief MCTS 搜索限制条件（时间、模拟次数任一到达即停止）
+ */
+struct MctsLimits {
+    int timeMs = 1000;          // 时间预算（毫秒），<=0 表示不限时
+    uint64_t maxPlayouts = 0;   // 模拟次数预算，0 表示不限
+    int threads = 1;            // 搜索线程数（树并行），<=0 表示使用全部硬件线程
+    /**
+     * @brief 进度回调：调用search()的线程每完成 PROGRESS_PLAYOUTS 次模拟调用一次（在搜索线程上执行），为空时不回调
+     * 参数为当前访问次数最多的根子节点、其胜率与到此为止的模拟次数/耗时。
+     */
+    std::function<void(const MctsResult&)> onProgress;
+};
+
+/**
+ * @brief MCTS 搜索结果
+ */
+struct MctsResult {
+    int row = -1;                   // 最佳着法行坐标（访问次数最多的根子节点）
+    int col = -1;                   // 最佳着法列坐标
+    double winRate = 0.5;           // 最佳着法的胜率估计（落子方视角，平局计0.5）
+    uint64_t playouts = 0;          // 完成的模拟次数
+    uint64_t nodes = 0;             // 本次搜索分配的树节点数
+    int64_t timeMs = 0;             // 实际耗时（毫秒）
+    uint64_t playoutsPerSec = 0;    // 每秒模拟次数
+    size_t peakMemoryBytes = 0;     // 本次搜索的峰值树内存（已分配节点 × 节点大小）
+};
+
+/**
+ * @brief 蒙特卡洛树搜索引擎（Player::Type::AI_MCTS，作为Alpha-Beta之外的另一种AI）
+ * 核心算法：
+ * 1. 选择：PUCT —— Q + C × P × sqrt(N父) / (1 + N子)，先验P来自Board棋型表的攻防分；
+ * 2. 扩展：首次到达的节点一次性生成全部子节点（按先验截取前MAX_CHILDREN个），
+ *    对方可成五时只生成封堵点，己方可成五时只生成成五点；
+ * 3. 模拟：快速走子——己方可成五/有活四判胜，对方可成五必堵，否则随机抽取若干候选点取攻防分最高者；
+ * 4. 回传：沿路径累加访问次数与得分（胜2、和1、负0，半分制整数，便于原子累加）。
+ * 并行方式：树并行——多个线程共享同一棵树，访问计数与得分为原子变量；
+ * 下行时给子节点加虚拟损失（virtual loss），让其他线程暂时避开同一路径，回传时撤销。
+ * 内存管理：节点来自预分配的节点池（m_nodes，首次搜索时一次性分配），分配只是一次原子加法，
+ * 同一节点的全部子节点连续存放；每次搜索开始时整体复位，不存在逐节点new/delete。
+ * @tparam N 棋盘边长（与BasicBoard<N>一致）
+ * @tparam R 规则变体（与BasicBoard<N, R>一致；Renju下黑方的扩展与快速走子都跳过禁手点）
+ */
+template <int N, Rule R = Rule::Freestyle>
+class BasicMctsEngine {
+public:
+    /**
+     * @brief 构造函数
+     * @param memoryMB 节点池大小（MB），首次搜索时一次性分配；节点池耗尽后不再扩展新节点，只继续模拟
+     */
+    explicit BasicMctsEngine(size_t memoryMB = 64);
+    ~BasicMctsEngine();
+
+    BasicMctsEngine(const BasicMctsEngine&) = delete;
+    BasicMctsEngine& operator=(const BasicMctsEngine&) = delete;
+
+    /**
+     * @brief 执行一次完整搜索（阻塞直到达到限制条件）
+     * @param board 当前局面（内部复制，不修改传入棋盘）
+     * @param side 落子方
+     * @param limits 时间/模拟次数/线程数限制
+     */
+    MctsResult search(const BasicBoard<N, R>& board, Config::PieceType side, const MctsLimits& limits);
+
+    /**
+     * @brief 请求停止当前搜索（可在其他线程调用）
+     */
+    void stop() { m_stop.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 节点池容量（节点数）
+     */
+    size_t nodeCapacity() const { return m_capacity; }
+
+private:
+    /**
+     * @brief 树节点（按缓存友好的紧凑布局，全部字段可被多线程并发访问）
+     * 得分以“走到该节点的一方”为视角。
+     * 各字段不带默认初始值：节点池分配时不逐个构造，由 allocate() 在取出节点时复位全部字段，
+     * 否则首次搜索要先花数十毫秒构造整个节点池，期间无法响应停止请求。
+     */
+    struct Node {
+        std::atomic<int32_t> visits;            // 访问次数
+        std::atomic<int32_t> virtualLoss;       // 正在经过该节点的线程数
+        std::atomic<int64_t> score;             // 累计得分（半分制：胜2、和1、负0）
+        std::atomic<uint32_t> firstChild;       // 第一个子节点在节点池中的下标
+        std::atomic<uint16_t> childCount;       // 子节点数量
+        std::atomic<uint8_t> state;             // 0=未扩展，1=扩展中，2=已扩展，3=终局
+        int16_t move;                           // 走到该节点的着法（格子下标）
+        float prior;                            // 先验概率
+    };
+    static_assert(std::is_trivially_default_constructible<Node>::value,
+                  "the node pool must be allocatable without touching every node");
+
+    static constexpr int MAX_CHILDREN = 40;
+    static constexpr uint64_t PROGRESS_PLAYOUTS = 2048;   // 进度回调间隔（调用线程的模拟次数）
+    static constexpr uint8_t UNEXPANDED = 0;
+    static constexpr uint8_t EXPANDING = 1;
+    static constexpr uint8_t EXPANDED = 2;
+    static constexpr uint8_t TERMINAL = 3;
+
+    void worker(unsigned seed, bool reportProgress);
+    void fillBest(MctsResult& result) const;
+    void playout(BasicBoard<N, R>& board, std::mt19937& rng);
+    int select(const Node& node) const;
+    bool expand(Node& node, const BasicBoard<N, R>& board, Config::PieceType side);
+    int rollout(BasicBoard<N, R>& board, Config::PieceType side, std::mt19937& rng) const;
+    uint32_t allocate(int count);
+    bool budgetExhausted();
+
+    static constexpr int MAX_TREE_DEPTH = N * N + 1;
+
+    std::unique_ptr<Node[]> m_nodes;               // 节点池（首次搜索时分配，跨搜索复用）
+    size_t m_capacity = 0;
+    std::atomic<size_t> m_used{0};
+
+    BasicBoard<N, R> m_rootBoard;
+    Config::PieceType m_rootSide = Config::PieceType::Black;
+    MctsLimits m_limits;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_playouts{0};
+};
+
+using MctsEngine = BasicMctsEngine<Config::BOARD_SIZE>;
+
+extern template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Standard>;
+extern template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Renju>;
+extern template class BasicMctsEngine<Config::BOARD_SIZE, Rule::Caro>;
+extern template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+extern template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+extern template class BasicMctsEngine<Config::LARGE_BOARD_SIZE, Rule::Caro>;
+
+#endif // MCTSENGINE_H
@@ -0,0 +1,92 @@
+﻿#include "MoveOrdering.h"
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * @brief 构造函数实现：清空全部启发数据
+ */
+MoveOrdering::MoveOrdering() {
+    clear();
+}
+
+void MoveOrdering::clear() {
+    std::fill(&m_killers[0][0], &m_killers[0][0] + (MAX_PLY + 1) * 2, -1);
+    std::fill(&m_history[0][0], &m_history[0][0] + 2 * CELL_COUNT, 0);
+    std::fill(&m_counterMoves[0][0], &m_counterMoves[0][0] + 2 * CELL_COUNT, -1);
+    m_stats = MoveOrderingStats();
+}
+
+void MoveOrdering::newSearch() {
+    std::fill(&m_killers[0][0], &m_killers[0][0] + (MAX_PLY + 1) * 2, -1);
+    for (int* h = &m_history[0][0]; h != &m_history[0][0] + 2 * CELL_COUNT; ++h) {
+        *h /= 2;
+    }
+    m_stats = MoveOrderingStats();
+}
+
+/**
+ * @brief 历史分更新（重力公式）
+ * 实现逻辑：h += delta - h*|delta|/HISTORY_MAX，奖励/惩罚越接近上限增量越小，分值始终在±HISTORY_MAX内。
+ */
+void MoveOrdering::updateHistory(int colorIdx, int cell, int delta) {
+    int& h = m_history[colorIdx][cell];
+    h += delta - h * std::abs(delta) / HISTORY_MAX;
+}
+
+/**
+ * @brief 普通着法截断更新实现
+ * 实现逻辑：
+ * Step1：杀手着法——与第一杀手不同时，原第一杀手降为第二杀手；
+ * Step2：反击着法——记录“对方走prevMove后，己方用cell截断”；
+ * Step3：历史表——截断着法奖励depth²，之前搜索过的普通着法各惩罚depth²。
+ */
+void MoveOrdering::updateQuietCutoff(Config::PieceType side, int ply, int depth, int cell, int prevMove,
+                                     const int* failedQuiets, int failedCount) {
+    if (ply <= MAX_PLY && m_killers[ply][0] != cell) {
+        m_killers[ply][1] = m_killers[ply][0];
+        m_killers[ply][0] = cell;
+    }
+    const int c = colorIndex(side);
+    if (prevMove >= 0) {
+        m_counterMoves[c][prevMove] = cell;
+    }
+    const int delta = std::min(depth * depth, HISTORY_MAX / 4);
+    updateHistory(c, cell, delta);
+    for (int i = 0; i < failedCount; ++i) {
+        updateHistory(c, failedQuiets[i], -delta);
+    }
+}
+
+/**
+ * @brief 截断来源统计实现：按MoveSource注释中的优先级判定来源
+ */
+void MoveOrdering::recordCutoff(Config::PieceType side, int ply, int cell, int prevMove, int ttMove,
+                                bool isThreat, int moveIndex) {
+    ++m_stats.cutoffs;
+    if (moveIndex == 0) {
+        ++m_stats.firstMoveCutoffs;
+    }
+
+    const int c = colorIndex(side);
+    MoveSource source = MoveSource::Other;
+    if (cell == ttMove) {
+        source = MoveSource::TTMove;
+    } else if (isThreat) {
+        source = MoveSource::Threat;
+    } else if (cell == m_killers[ply][0] || cell == m_killers[ply][1]) {
+        source = MoveSource::Killer;
+    } else if (prevMove >= 0 && cell == m_counterMoves[c][prevMove]) {
+        source = MoveSource::CounterMove;
+    } else if (m_history[c][cell] > 0) {
+        source = MoveSource::History;
+    }
+
+    switch (source) {
+    case MoveSource::TTMove:      ++m_stats.ttMoveCutoffs; break;
+    case MoveSource::Threat:      ++m_stats.threatCutoffs; break;
+    case MoveSource::Killer:      ++m_stats.killerCutoffs; break;
+    case MoveSource::CounterMove: ++m_stats.counterMoveCutoffs; break;
+    case MoveSource::History:     ++m_stats.historyCutoffs; break;
+    case MoveSource::Other:       ++m_stats.otherCutoffs; break;
+    }
+}
@@ -0,0 +1,123 @@
+﻿#pragma once
+#ifndef MOVEORDERING_H
+#define MOVEORDERING_H
+
+#include <cstdint>
+#include "../story/Constants.h"
+
+/**
+ * @brief 着法来源（用于统计哪种排序启发产生了beta截断）
+ * 按优先级判定：置换表着法 > 威胁着法（冲四/必胜棋型）> 杀手着法 > 反击着法 > 历史分为正 > 其他。
+ */
+enum class MoveSource : uint8_t { TTMove, Threat, Killer, CounterMove, History, Other };
+
+/**
+ * @brief 着法排序统计（每次搜索开始时清零）
+ */
+struct MoveOrderingStats {
+    uint64_t cutoffs = 0;               // beta截断总次数
+    uint64_t firstMoveCutoffs = 0;      // 第一个着法即截断的次数（衡量整体排序质量）
+    uint64_t ttMoveCutoffs = 0;         // 置换表着法截断
+    uint64_t threatCutoffs = 0;         // 威胁着法截断
+    uint64_t killerCutoffs = 0;         // 杀手着法截断
+    uint64_t counterMoveCutoffs = 0;    // 反击着法截断
+    uint64_t historyCutoffs = 0;        // 历史分为正的普通着法截断
+    uint64_t otherCutoffs = 0;          // 仅靠棋型分排序的普通着法截断
+};
+
+/**
+ * @brief AI搜索的着法排序启发
+ * 核心职责：在棋型打分之外，为普通（非威胁）着法提供与搜索历史相关的排序加分，
+ * 让最可能产生beta截断的着法先被搜索。
+ * 1. 杀手着法（Killer）：每层保留2个最近产生截断的普通着法；
+ * 2. 历史表（History，butterfly表）：按[颜色][格子]累计截断奖励（深度²），
+ *    截断前已搜索但失败的普通着法同步惩罚，采用“重力”公式使分值收敛在±HISTORY_MAX内；
+ * 3. 反击着法（Counter-move）：按[颜色][对方上一手]记录最近一次截断的应手；
+ * 4. 置换表着法最优先由SearchEngine负责加分（TT_MOVE_BONUS），这里只参与截断来源统计。
+ * 加分量级：威胁着法 > 杀手 > 反击 > 历史/棋型分，保证冲四、堵活三等必应着法不会被启发挤到后面。
+ */
+class MoveOrdering {
+public:
+    static constexpr int MAX_PLY = 64;
+    static constexpr int KILLER_BONUS = 1 << 19;
+    static constexpr int SECOND_KILLER_BONUS = 1 << 18;
+    static constexpr int COUNTER_MOVE_BONUS = 1 << 17;
+    static constexpr int HISTORY_MAX = 1 << 14;
+
+    MoveOrdering();
+
+    /**
+     * @brief 清空全部启发数据与统计（新对局开始时调用）
+     */
+    void clear();
+
+    /**
+     * @brief 新一次搜索开始：清空杀手着法与统计，历史分减半（旧局面的信息逐步淡出）
+     */
+    void newSearch();
+
+    /**
+     * @brief 普通着法的排序加分
+     * @param side 落子方
+     * @param ply 当前层数
+     * @param cell 着法格子下标
+     * @param prevMove 对方上一手（-1表示无）
+     */
+    int bonus(Config::PieceType side, int ply, int cell, int prevMove) const {
+        int score = m_history[colorIndex(side)][cell];
+        if (cell == m_killers[ply][0]) {
+            score += KILLER_BONUS;
+        } else if (cell == m_killers[ply][1]) {
+            score += SECOND_KILLER_BONUS;
+        }
+        if (prevMove >= 0 && cell == m_counterMoves[colorIndex(side)][prevMove]) {
+            score += COUNTER_MOVE_BONUS;
+        }
+        return score;
+    }
+
+    /**
+     * @brief 普通着法产生beta截断：更新杀手、反击着法与历史表
+     * @param side 落子方
+     * @param ply 当前层数
+     * @param depth 剩余深度（奖励为depth²）
+     * @param cell 产生截断的着法
+     * @param prevMove 对方上一手（-1表示无）
+     * @param failedQuiets 截断前已搜索、未产生截断的普通着法（受历史惩罚）
+     * @param failedCount failedQuiets 数量
+     */
+    void updateQuietCutoff(Config::PieceType side, int ply, int depth, int cell, int prevMove,
+                           const int* failedQuiets, int failedCount);
+
+    /**
+     * @brief 判定截断着法的来源并计入统计
+     * @param isThreat 该着法是否为威胁着法（冲四/必胜棋型）
+     * @param moveIndex 该着法在本节点着法列表中的序号（0表示第一个）
+     */
+    void recordCutoff(Config::PieceType side, int ply, int cell, int prevMove, int ttMove,
+                      bool isThreat, int moveIndex);
+
+    /**
+     * @brief 获取本次搜索的截断统计
+     */
+    const MoveOrderingStats& stats() const { return m_stats; }
+
+private:
+    static int colorIndex(Config::PieceType side) {
+        return side == Config::PieceType::Black ? 0 : 1;
+    }
+
+    void updateHistory(int colorIdx, int cell, int delta);
+
+    /**
+     * @brief 按最大棋盘分配（格子下标row*N+col对任何支持的尺寸都小于该值），各尺寸的引擎共用同一实现
+     */
+    static constexpr int CELL_COUNT = Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE;
+
+    int m_killers[MAX_PLY + 1][2];
+    int m_history[2][CELL_COUNT];
+    int m_counterMoves[2][CELL_COUNT];
+    MoveOrderingStats m_stats;
+};
+
+#endif // MOVEORDERING_H
@@ -0,0 +1,314 @@
+﻿#include "Nnue.h"
+#include <cstring>
+#include <random>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NNUE_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang 需要按函数开启目标指令集（与 BoardEval 相同：整个工程按基线指令集编译，运行时再决定是否调用）
+#if defined(NNUE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NNUE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NNUE_TARGET_AVX2
+#endif
+
+namespace {
+
+using namespace Nnue;
+
+constexpr char MAGIC[4] = { 'L', 'Q', 'N', 'N' };
+
+/**
+ * @brief 估值上限：远小于搜索的胜负分（SearchEngine::WIN_SCORE），输出缩放异常的权重文件也不会被误当成杀棋
+ */
+constexpr int EVAL_LIMIT = 500000;
+
+static_assert(sizeof(NnueNetwork::Header) == 64, "network header must be 64 bytes");
+static_assert(ACCUMULATOR_SIZE % 32 == 0 && HIDDEN_SIZE % 16 == 0, "SIMD kernels assume full 256-bit chunks");
+
+/**
+ * @brief 各段在文件中的字节数（除最后的输出层外都是64的倍数，各段起点保持64字节对齐）
+ */
+constexpr int64_t featureBytes(int boardSize) {
+    return static_cast<int64_t>(INPUT_PLANES) * boardSize * boardSize * ACCUMULATOR_SIZE * sizeof(int16_t);
+}
+constexpr int64_t FEATURE_BIAS_BYTES = ACCUMULATOR_SIZE * sizeof(int16_t);
+constexpr int64_t HIDDEN_WEIGHT_BYTES = static_cast<int64_t>(HIDDEN_SIZE) * HIDDEN_INPUTS * sizeof(int8_t);
+constexpr int64_t HIDDEN_BIAS_BYTES = HIDDEN_SIZE * sizeof(int32_t);
+constexpr int64_t OUTPUT_WEIGHT_BYTES = HIDDEN_SIZE * sizeof(int8_t);
+static_assert(FEATURE_BIAS_BYTES % 64 == 0 && HIDDEN_WEIGHT_BYTES % 64 == 0 && HIDDEN_BIAS_BYTES % 64 == 0,
+              "sections must keep 64-byte alignment");
+
+inline int clampActivation(int value) {
+    return std::min(std::max(value, 0), ACTIVATION_MAX);
+}
+
+/**
+ * @brief 标量实现（参考实现）：截断ReLU → 隐藏层点积 → 截断ReLU → 输出层点积
+ * @return int32_t 输出层累加值（含输出偏置）
+ */
+int32_t forwardScalar(const int16_t* own, const int16_t* other, const int8_t* hiddenWeights, const int32_t* hiddenBias,
+                      const int8_t* outputWeights, int32_t outputBias) {
+    uint8_t input[HIDDEN_INPUTS];
+    for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+        input[i] = static_cast<uint8_t>(clampActivation(own[i]));
+        input[ACCUMULATOR_SIZE + i] = static_cast<uint8_t>(clampActivation(other[i]));
+    }
+    int32_t output = outputBias;
+    for (int j = 0; j < HIDDEN_SIZE; ++j) {
+        const int8_t* weights = hiddenWeights + j * HIDDEN_INPUTS;
+        int32_t sum = hiddenBias[j];
+        for (int k = 0; k < HIDDEN_INPUTS; ++k) {
+            sum += input[k] * weights[k];
+        }
+        output += clampActivation(sum >> WEIGHT_SHIFT) * outputWeights[j];
+    }
+    return output;
+}
+
+#if defined(NNUE_X86)
+/**
+ * @brief 4个向量各自的8个int32求和，结果依次放在返回值的4个通道
+ */
+NNUE_TARGET_AVX2 inline __m128i hadd4(__m256i a, __m256i b, __m256i c, __m256i d) {
+    a = _mm256_hadd_epi32(a, b);
+    c = _mm256_hadd_epi32(c, d);
+    a = _mm256_hadd_epi32(a, c);
+    return _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+}
+
+/**
+ * @brief 16个int32截断到[0, ACTIVATION_MAX]并压缩为16个uint8（packs饱和后再取min，与标量截断结果相同）
+ */
+NNUE_TARGET_AVX2 inline __m128i packActivations(__m128i a, __m128i b, __m128i c, __m128i d) {
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    return _mm_min_epu8(packed, _mm_set1_epi8(ACTIVATION_MAX));
+}
+
+/**
+ * @brief AVX2实现
+ * 实现逻辑：
+ * Step1：两个视角的累加器各64个int16，截断到[0,127]后用packus压成uint8（packus按128位通道交错，
+ *        再用permute4x64恢复顺序），得到4个32字节的隐藏层输入向量；
+ * Step2：每个隐藏单元用maddubs（uint8×int8相邻两项相加为int16，127×128×2不会饱和）与madd（int16两两相加为int32）
+ *        累加4个向量，4个单元一组用hadd横向求和，加偏置、算术右移 WEIGHT_SHIFT 位；
+ * Step3：32个隐藏单元截断压成uint8，与输出层int8权重同样用maddubs/madd做点积。
+ */
+NNUE_TARGET_AVX2 int32_t forwardAvx2(const int16_t* own, const int16_t* other, const int8_t* hiddenWeights,
+                                     const int32_t* hiddenBias, const int8_t* outputWeights, int32_t outputBias) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxActivation = _mm256_set1_epi16(ACTIVATION_MAX);
+    constexpr int INPUT_CHUNKS = HIDDEN_INPUTS / 32;
+    __m256i input[INPUT_CHUNKS];
+    for (int chunk = 0; chunk < INPUT_CHUNKS; ++chunk) {
+        const int16_t* source = (chunk < INPUT_CHUNKS / 2 ? own : other) + (chunk % (INPUT_CHUNKS / 2)) * 32;
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 16));
+        lo = _mm256_min_epi16(_mm256_max_epi16(lo, zero), maxActivation);
+        hi = _mm256_min_epi16(_mm256_max_epi16(hi, zero), maxActivation);
+        input[chunk] = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+    }
+
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m128i hidden[HIDDEN_SIZE / 4];
+    for (int group = 0; group < HIDDEN_SIZE / 4; ++group) {
+        __m256i sums[4];
+        for (int t = 0; t < 4; ++t) {
+            const int8_t* weights = hiddenWeights + (group * 4 + t) * HIDDEN_INPUTS;
+            __m256i sum = zero;
+            for (int chunk = 0; chunk < INPUT_CHUNKS; ++chunk) {
+                const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + chunk * 32));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(input[chunk], w), ones));
+            }
+            sums[t] = sum;
+        }
+        const __m128i bias = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hiddenBias + group * 4));
+        hidden[group] = _mm_srai_epi32(_mm_add_epi32(hadd4(sums[0], sums[1], sums[2], sums[3]), bias), WEIGHT_SHIFT);
+    }
+
+    const __m128i ones128 = _mm_set1_epi16(1);
+    __m128i total = _mm_setzero_si128();
+    for (int block = 0; block < HIDDEN_SIZE / 16; ++block) {
+        const __m128i activations = packActivations(hidden[block * 4], hidden[block * 4 + 1],
+                                                    hidden[block * 4 + 2], hidden[block * 4 + 3]);
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(outputWeights + block * 16));
+        total = _mm_add_epi32(total, _mm_madd_epi16(_mm_maddubs_epi16(activations, w), ones128));
+    }
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, _MM_SHUFFLE(1, 0, 3, 2)));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, _MM_SHUFFLE(2, 3, 0, 1)));
+    return outputBias + _mm_cvtsi128_si32(total);
+}
+#endif
+
+} // namespace
+
+void NnueAccumulator::addStone(const NnueNetwork& network, int cell, Config::PieceType color) {
+    const int16_t* black = network.featureRow(cell, color, Config::PieceType::Black);
+    const int16_t* white = network.featureRow(cell, color, Config::PieceType::White);
+    for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+        values[0][i] = static_cast<int16_t>(values[0][i] + black[i]);
+        values[1][i] = static_cast<int16_t>(values[1][i] + white[i]);
+    }
+}
+
+void NnueAccumulator::removeStone(const NnueNetwork& network, int cell, Config::PieceType color) {
+    const int16_t* black = network.featureRow(cell, color, Config::PieceType::Black);
+    const int16_t* white = network.featureRow(cell, color, Config::PieceType::White);
+    for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+        values[0][i] = static_cast<int16_t>(values[0][i] - black[i]);
+        values[1][i] = static_cast<int16_t>(values[1][i] - white[i]);
+    }
+}
+
+NnueNetwork::NnueNetwork() = default;
+
+NnueNetwork::~NnueNetwork() {
+    unload();
+}
+
+int64_t NnueNetwork::fileSize(int boardSize) {
+    return static_cast<int64_t>(sizeof(Header)) + featureBytes(boardSize) + FEATURE_BIAS_BYTES + HIDDEN_WEIGHT_BYTES
+         + HIDDEN_BIAS_BYTES + OUTPUT_WEIGHT_BYTES;
+}
+
+/**
+ * @brief 加载权重实现
+ * 实现逻辑：
+ * Step1：以只读方式打开文件，整体映射到内存（QFile::map，一次映射）；
+ * Step2：校验文件头（魔数、版本、结构尺寸、支持的棋盘大小）与文件大小；
+ * Step3：各层指针直接指向映射区内的对应段，选定当前CPU最快的估值内核；任一步失败都解除映射并返回false。
+ */
+bool NnueNetwork::load(const QString& path) {
+    unload();
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const int64_t size = file->size();
+    if (size < static_cast<int64_t>(sizeof(Header))) {
+        return false;
+    }
+    const uchar* data = file->map(0, size);
+    if (!data) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    const int boardSize = static_cast<int>(header.boardSize);
+    const bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+        && header.version == FORMAT_VERSION
+        && header.accumulatorSize == static_cast<uint32_t>(ACCUMULATOR_SIZE)
+        && header.hiddenSize == static_cast<uint32_t>(HIDDEN_SIZE)
+        && (boardSize == Config::BOARD_SIZE || boardSize == Config::LARGE_BOARD_SIZE)
+        && header.outputScale > 0
+        && size == fileSize(boardSize);
+    if (!valid) {
+        return false;   // file析构时自动解除映射
+    }
+
+    const uchar* section = data + sizeof(Header);
+    m_featureWeights = reinterpret_cast<const int16_t*>(section);
+    section += featureBytes(boardSize);
+    m_featureBias = reinterpret_cast<const int16_t*>(section);
+    section += FEATURE_BIAS_BYTES;
+    m_hiddenWeights = reinterpret_cast<const int8_t*>(section);
+    section += HIDDEN_WEIGHT_BYTES;
+    m_hiddenBias = reinterpret_cast<const int32_t*>(section);
+    section += HIDDEN_BIAS_BYTES;
+    m_outputWeights = reinterpret_cast<const int8_t*>(section);
+
+    m_file = std::move(file);
+    m_boardSize = boardSize;
+    m_outputScale = header.outputScale;
+    m_outputBias = header.outputBias;
+    m_isa = BoardEval::bestIsa();
+    return true;
+}
+
+void NnueNetwork::unload() {
+    m_featureWeights = nullptr;
+    m_featureBias = nullptr;
+    m_hiddenWeights = nullptr;
+    m_hiddenBias = nullptr;
+    m_outputWeights = nullptr;
+    m_boardSize = 0;
+    m_file.reset();
+}
+
+/**
+ * @brief 估值实现：按行棋方取“己方视角、对方视角”两个累加器做前向计算，输出层累加值按输出缩放换算为估值
+ */
+int NnueNetwork::evaluate(const NnueAccumulator& accumulator, Config::PieceType side, BoardEval::Isa isa) const {
+    const int own = side == Config::PieceType::Black ? 0 : 1;
+    int32_t output;
+#if defined(NNUE_X86)
+    if (isa == BoardEval::Isa::AVX2 && (isa == m_isa || BoardEval::isSupported(isa))) {
+        output = forwardAvx2(accumulator.values[own], accumulator.values[1 - own], m_hiddenWeights, m_hiddenBias,
+                             m_outputWeights, m_outputBias);
+    } else
+#endif
+    {
+        (void)isa;
+        output = forwardScalar(accumulator.values[own], accumulator.values[1 - own], m_hiddenWeights, m_hiddenBias,
+                               m_outputWeights, m_outputBias);
+    }
+    const int64_t eval = static_cast<int64_t>(output) * m_outputScale / OUTPUT_DIVISOR;
+    return static_cast<int>(std::min<int64_t>(std::max<int64_t>(eval, -EVAL_LIMIT), EVAL_LIMIT));
+}
+
+NnueWeights::NnueWeights(int size)
+    : boardSize(size)
+    , featureWeights(static_cast<size_t>(INPUT_PLANES) * size * size * ACCUMULATOR_SIZE, 0)
+    , featureBias(ACCUMULATOR_SIZE, 0)
+    , hiddenWeights(static_cast<size_t>(HIDDEN_SIZE) * HIDDEN_INPUTS, 0)
+    , hiddenBias(HIDDEN_SIZE, 0)
+    , outputWeights(HIDDEN_SIZE, 0)
+{
+}
+
+NnueWeights NnueWeights::random(int boardSize, uint32_t seed) {
+    NnueWeights weights(boardSize);
+    std::mt19937 rng(seed);
+    auto fill = [&rng](auto& values, int low, int high) {
+        std::uniform_int_distribution<int> dist(low, high);
+        for (auto& value : values) {
+            value = static_cast<std::remove_reference_t<decltype(value)>>(dist(rng));
+        }
+    };
+    fill(weights.featureWeights, -12, 12);
+    fill(weights.featureBias, 0, 80);
+    fill(weights.hiddenWeights, -20, 20);
+    fill(weights.hiddenBias, -2000, 2000);
+    fill(weights.outputWeights, -30, 30);
+    weights.outputScale = 1000;
+    return weights;
+}
+
+bool NnueWeights::write(const QString& path) const {
+    NnueNetwork::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = NnueNetwork::FORMAT_VERSION;
+    header.boardSize = static_cast<uint32_t>(boardSize);
+    header.accumulatorSize = ACCUMULATOR_SIZE;
+    header.hiddenSize = HIDDEN_SIZE;
+    header.outputScale = outputScale;
+    header.outputBias = outputBias;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    auto writeSection = [&file](const void* data, int64_t bytes) {
+        return file.write(reinterpret_cast<const char*>(data), bytes) == bytes;
+    };
+    return writeSection(&header, sizeof(header))
+        && writeSection(featureWeights.data(), featureBytes(boardSize))
+        && writeSection(featureBias.data(), FEATURE_BIAS_BYTES)
+        && writeSection(hiddenWeights.data(), HIDDEN_WEIGHT_BYTES)
+        && writeSection(hiddenBias.data(), HIDDEN_BIAS_BYTES)
+        && writeSection(outputWeights.data(), OUTPUT_WEIGHT_BYTES);
+}
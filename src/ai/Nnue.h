@@ -0,0 +1,192 @@
+﻿#pragma once
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <QFile>
+#include <QString>
+#include "../game/BoardEval.h"
+#include "../utils/BitUtils.h"
+
+/**
+ * @brief 神经网络估值（NNUE 式）的结构常量
+ * 网络结构：输入 → 特征变换层（每个视角 ACCUMULATOR_SIZE 个，int16）→ 截断ReLU → 隐藏层（HIDDEN_SIZE 个，int8权重）
+ *           → 截断ReLU → 输出（1个，int8权重）。
+ * 输入特征：以某一方为视角，“己方棋子在某格”与“对方棋子在某格”各 N*N 个，共 INPUT_PLANES*N*N 个二值特征；
+ * 每个局面维护黑、白两个视角的特征变换层输出（累加器），估值时按行棋方把“己方视角、对方视角”拼成隐藏层输入。
+ * 量化（与训练约定一致，见 NnueTrainer）：激活值 1.0 对应 ACTIVATION_MAX（127），
+ * 特征变换层权重按 ACTIVATION_MAX 倍取整存为 int16，隐藏层与输出层权重按 2^WEIGHT_SHIFT 倍取整存为 int8。
+ */
+namespace Nnue {
+constexpr int ACCUMULATOR_SIZE = 64;
+constexpr int HIDDEN_SIZE = 32;
+constexpr int INPUT_PLANES = 2;                                 // 0=己方棋子，1=对方棋子
+constexpr int HIDDEN_INPUTS = 2 * ACCUMULATOR_SIZE;             // 行棋方视角 + 对方视角
+constexpr int ACTIVATION_MAX = 127;
+constexpr int WEIGHT_SHIFT = 6;
+constexpr int OUTPUT_DIVISOR = ACTIVATION_MAX << WEIGHT_SHIFT;  // 输出层累加值 / OUTPUT_DIVISOR = 网络输出（胜率的logit）
+} // namespace Nnue
+
+class NnueNetwork;
+
+/**
+ * @brief 特征变换层累加器：黑、白两个视角的特征变换层输出（未激活）
+ * 增量更新：落子/提子只需加上/减去该棋子在两个视角下对应的两行权重（各 ACCUMULATOR_SIZE 个int16），
+ * 与棋盘上已有多少棋子无关；refresh() 从零按全部棋子重算，用于搜索开始时与测试校验。
+ */
+struct NnueAccumulator {
+    alignas(32) int16_t values[2][Nnue::ACCUMULATOR_SIZE];     // [视角（0黑1白）][...]
+
+    /**
+     * @brief 按棋盘上的全部棋子重算
+     */
+    template <int N, Rule R>
+    void refresh(const NnueNetwork& network, const BasicBoard<N, R>& board);
+
+    /**
+     * @brief 落子：加上color方棋子在cell处的特征权重
+     */
+    void addStone(const NnueNetwork& network, int cell, Config::PieceType color);
+
+    /**
+     * @brief 提子/撤销：减去color方棋子在cell处的特征权重
+     */
+    void removeStone(const NnueNetwork& network, int cell, Config::PieceType color);
+};
+
+/**
+ * @brief 内存映射的神经网络权重（只读，多个搜索线程共享）
+ * 文件格式（小端序，各段起点均为64字节对齐，可直接按SIMD宽度读取）：
+ * 1. 64字节文件头 { "LQNN", 版本, 棋盘大小, 累加器宽度, 隐藏层宽度, 输出缩放, 输出偏置, 保留 }；
+ * 2. 特征变换层权重 int16[INPUT_PLANES*N*N][ACCUMULATOR_SIZE]（按特征存放，增量更新时连续读取一行）；
+ * 3. 特征变换层偏置 int16[ACCUMULATOR_SIZE]；
+ * 4. 隐藏层权重 int8[HIDDEN_SIZE][HIDDEN_INPUTS]，隐藏层偏置 int32[HIDDEN_SIZE]；
+ * 5. 输出层权重 int8[HIDDEN_SIZE]。
+ * 加载方式：与开局库相同，QFile::map() 整体映射一次，只校验文件头与大小，各层直接指向映射内存，无解析与拷贝。
+ * 估值单位：网络输出为行棋方胜率的 logit，乘以文件头中的输出缩放后与棋型估值同一量级（训练时按棋型估值拟合的 K 取 1/K），
+ * 搜索中与估值相关的常数（期望窗口等）无需随估值方式调整。
+ */
+class NnueNetwork {
+public:
+    /**
+     * @brief 文件头（64字节）
+     */
+    struct Header {
+        char magic[4];              // "LQNN"
+        uint32_t version;           // 文件格式版本（FORMAT_VERSION）
+        uint32_t boardSize;         // 棋盘边长（网络只适用于该尺寸）
+        uint32_t accumulatorSize;   // 必须等于 Nnue::ACCUMULATOR_SIZE
+        uint32_t hiddenSize;        // 必须等于 Nnue::HIDDEN_SIZE
+        int32_t outputScale;        // 估值 = 输出层累加值 × outputScale / Nnue::OUTPUT_DIVISOR
+        int32_t outputBias;         // 输出层偏置（与输出层累加值同一量化单位）
+        uint32_t reserved[9];
+    };
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    NnueNetwork();
+    ~NnueNetwork();
+
+    NnueNetwork(const NnueNetwork&) = delete;
+    NnueNetwork& operator=(const NnueNetwork&) = delete;
+
+    /**
+     * @brief 映射权重文件（已加载时先卸载）
+     * @return bool 是否加载成功（文件不存在、文件头不匹配或大小不符时返回false）
+     */
+    bool load(const QString& path);
+
+    /**
+     * @brief 解除映射并关闭文件
+     */
+    void unload();
+
+    bool isLoaded() const { return m_featureWeights != nullptr; }
+    int boardSize() const { return m_boardSize; }
+
+    /**
+     * @brief 权重文件的总字节数（由棋盘大小决定）
+     */
+    static int64_t fileSize(int boardSize);
+
+    /**
+     * @brief 某一视角下某方棋子在cell处对应的特征权重行（ACCUMULATOR_SIZE个）
+     */
+    const int16_t* featureRow(int cell, Config::PieceType stone, Config::PieceType perspective) const {
+        const int plane = stone == perspective ? 0 : 1;
+        return m_featureWeights + (static_cast<size_t>(plane) * m_boardSize * m_boardSize + cell) * Nnue::ACCUMULATOR_SIZE;
+    }
+    const int16_t* featureBias() const { return m_featureBias; }
+
+    /**
+     * @brief 估值（side 为行棋方，返回 side 视角的分数，与 Board::evaluate(side) 同一量级）
+     * @param isa 指令集（AVX2 使用 maddubs 整数点积；SSE2 与标量共用标量实现；CPU不支持时退回标量）
+     */
+    int evaluate(const NnueAccumulator& accumulator, Config::PieceType side, BoardEval::Isa isa) const;
+    int evaluate(const NnueAccumulator& accumulator, Config::PieceType side) const {
+        return evaluate(accumulator, side, m_isa);
+    }
+
+private:
+    std::unique_ptr<QFile> m_file;       // 映射期间保持打开（映射随文件对象销毁而解除）
+    int m_boardSize = 0;
+    int32_t m_outputScale = 0;
+    int32_t m_outputBias = 0;
+    BoardEval::Isa m_isa = BoardEval::Isa::Scalar;
+    const int16_t* m_featureWeights = nullptr;
+    const int16_t* m_featureBias = nullptr;
+    const int8_t* m_hiddenWeights = nullptr;
+    const int32_t* m_hiddenBias = nullptr;
+    const int8_t* m_outputWeights = nullptr;
+};
+
+/**
+ * @brief 神经网络权重（可写的内存形式，供训练工具写出权重文件与测试构造网络）
+ */
+struct NnueWeights {
+    int boardSize = 0;
+    int32_t outputScale = 1;
+    int32_t outputBias = 0;
+    std::vector<int16_t> featureWeights;    // [INPUT_PLANES*N*N][ACCUMULATOR_SIZE]
+    std::vector<int16_t> featureBias;       // [ACCUMULATOR_SIZE]
+    std::vector<int8_t> hiddenWeights;      // [HIDDEN_SIZE][HIDDEN_INPUTS]
+    std::vector<int32_t> hiddenBias;        // [HIDDEN_SIZE]
+    std::vector<int8_t> outputWeights;      // [HIDDEN_SIZE]
+
+    /**
+     * @brief 按棋盘大小分配全零权重
+     */
+    explicit NnueWeights(int boardSize = Config::BOARD_SIZE);
+
+    /**
+     * @brief 以固定种子填充随机权重（测试与基准用：激活值分布在截断区间内，输出非平凡）
+     */
+    static NnueWeights random(int boardSize, uint32_t seed);
+
+    /**
+     * @brief 按文件格式写出
+     * @return bool 是否写入成功
+     */
+    bool write(const QString& path) const;
+};
+
+template <int N, Rule R>
+void NnueAccumulator::refresh(const NnueNetwork& network, const BasicBoard<N, R>& board) {
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        std::copy(network.featureBias(), network.featureBias() + Nnue::ACCUMULATOR_SIZE, values[perspective]);
+    }
+    for (const Config::PieceType color : { Config::PieceType::Black, Config::PieceType::White }) {
+        for (int row = 0; row < N; ++row) {
+            uint32_t mask = board.rowMask(color, row);
+            while (mask) {
+                addStone(network, row * N + BitUtils::countTrailingZeros(mask), color);
+                mask &= mask - 1;
+            }
+        }
+    }
+}
+
+#endif // NNUE_H
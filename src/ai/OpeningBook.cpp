@@ -0,0 +1,285 @@
+﻿#include "OpeningBook.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "../game/Zobrist.h"
+#include "../utils/BitUtils.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+constexpr char MAGIC[4] = { 'L', 'Q', 'O', 'B' };
+
+static_assert(sizeof(OpeningBook::Header) == 16, "book header must be 16 bytes");
+static_assert(sizeof(OpeningBook::Entry) == 16, "book entry must be 16 bytes");
+
+/**
+ * @brief 局面中的一枚棋子（格子下标 + 颜色下标）
+ */
+struct Stone {
+    int cell;
+    int color;
+};
+
+/**
+ * @brief 按行掩码收集棋盘上的全部棋子
+ * @return int 棋子数量
+ */
+int collectStones(const Board& board, Stone* out) {
+    int count = 0;
+    for (int color = 0; color < 2; ++color) {
+        const Config::PieceType type = color == 0 ? Config::PieceType::Black : Config::PieceType::White;
+        for (int row = 0; row < N; ++row) {
+            uint32_t mask = board.rowMask(type, row);
+            while (mask) {
+                out[count++] = { row * N + BitUtils::countTrailingZeros(mask), color };
+                mask &= mask - 1;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 着法的平滑得分率（拉普拉斯平滑，对局数少的着法得分率向0.5收缩）
+ */
+double smoothedScore(const BookMove& move) {
+    return (move.score * move.games + 0.5) / (move.games + 1.0);
+}
+
+} // namespace
+
+OpeningBook::OpeningBook() = default;
+
+OpeningBook::~OpeningBook() {
+    unload();
+}
+
+/**
+ * @brief 加载开局库实现
+ * 实现逻辑：
+ * Step1：以只读方式打开文件，整体映射到内存（QFile::map）；
+ * Step2：校验文件头（魔数、版本、棋盘大小）与文件大小（文件头 + 条目数 × 16字节）；
+ * Step3：校验通过后直接把映射区的条目数组作为查询表，任一步失败都解除映射并返回false。
+ */
+bool OpeningBook::load(const QString& path) {
+    unload();
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const int64_t size = file->size();
+    if (size < static_cast<int64_t>(sizeof(Header))) {
+        return false;
+    }
+    const uchar* data = file->map(0, size);
+    if (!data) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    const bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+        && header.version == FORMAT_VERSION
+        && header.boardSize == static_cast<uint32_t>(N)
+        && size == static_cast<int64_t>(sizeof(Header) + header.entryCount * sizeof(Entry));
+    if (!valid) {
+        return false;   // file析构时自动解除映射
+    }
+
+    m_file = std::move(file);
+    m_entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    m_count = header.entryCount;
+    return true;
+}
+
+void OpeningBook::unload() {
+    m_entries = nullptr;
+    m_count = 0;
+    m_file.reset();
+}
+
+/**
+ * @brief 查询实现
+ * 实现逻辑：计算规范化局面键 → 在条目数组上二分查找该键的第一个条目 → 顺序读取同键的全部条目，
+ * 把规范着法换算回实际坐标（被占据的点视为哈希碰撞，跳过）。
+ */
+int OpeningBook::probe(const Board& board, BookMove* out, int maxMoves) const {
+    if (!m_entries) {
+        return 0;
+    }
+    uint8_t symmetryMask = 0;
+    const uint64_t key = canonicalKey(board, &symmetryMask);
+    const Entry* end = m_entries + m_count;
+    const Entry* it = std::lower_bound(m_entries, end, key,
+                                       [](const Entry& e, uint64_t k) { return e.key < k; });
+    int count = 0;
+    for (; it != end && it->key == key && count < maxMoves; ++it) {
+        const int cell = actualMove(it->move, symmetryMask);
+        if (cell < 0 || cell >= N * N || board.getPiece(cell / N, cell % N) != Config::PieceType::None) {
+            continue;
+        }
+        BookMove& move = out[count++];
+        move.row = cell / N;
+        move.col = cell % N;
+        move.games = it->games;
+        move.score = it->games > 0 ? it->points / (2.0 * it->games) : 0.5;
+    }
+    return count;
+}
+
+bool OpeningBook::bestMove(const Board& board, BookMove& out, uint32_t minGames) const {
+    BookMove moves[N * N];
+    const int count = probe(board, moves, N * N);
+    bool found = false;
+    for (int i = 0; i < count; ++i) {
+        if (moves[i].games < minGames) {
+            continue;
+        }
+        if (!found || smoothedScore(moves[i]) > smoothedScore(out)
+            || (smoothedScore(moves[i]) == smoothedScore(out) && moves[i].games > out.games)) {
+            out = moves[i];
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief 规范化局面键实现
+ * 实现逻辑：先收集全部棋子，再对8种对称变换分别累计变换后坐标的Zobrist键，取最小值；
+ * 所有取得最小值的变换都记入symmetryMask（局面自身对称时不止一个）。
+ */
+uint64_t OpeningBook::canonicalKey(const Board& board, uint8_t* symmetryMask) {
+    Stone stones[N * N];
+    const int count = collectStones(board, stones);
+
+    uint64_t best = 0;
+    uint8_t mask = 0;
+    for (int s = 0; s < SYMMETRY_COUNT; ++s) {
+        uint64_t hash = 0;
+        for (int i = 0; i < count; ++i) {
+            const int cell = transformCell(stones[i].cell, s);
+            hash ^= Zobrist::key(stones[i].color, cell / N, cell % N);
+        }
+        if (s == 0 || hash < best) {
+            best = hash;
+            mask = static_cast<uint8_t>(1u << s);
+        } else if (hash == best) {
+            mask = static_cast<uint8_t>(mask | (1u << s));
+        }
+    }
+    if (symmetryMask) {
+        *symmetryMask = mask;
+    }
+    return best;
+}
+
+int OpeningBook::canonicalMove(int cell, uint8_t symmetryMask) {
+    int best = N * N;
+    for (int s = 0; s < SYMMETRY_COUNT; ++s) {
+        if (symmetryMask & (1u << s)) {
+            best = std::min(best, transformCell(cell, s));
+        }
+    }
+    return best;
+}
+
+int OpeningBook::actualMove(int canonicalCell, uint8_t symmetryMask) {
+    for (int s = 0; s < SYMMETRY_COUNT; ++s) {
+        if (symmetryMask & (1u << s)) {
+            return inverseTransformCell(canonicalCell, s);
+        }
+    }
+    return canonicalCell;
+}
+
+int OpeningBook::transformCell(int cell, int symmetry) {
+    int row = cell / N;
+    int col = cell % N;
+    if (symmetry & 1) row = N - 1 - row;
+    if (symmetry & 2) col = N - 1 - col;
+    if (symmetry & 4) std::swap(row, col);
+    return row * N + col;
+}
+
+int OpeningBook::inverseTransformCell(int cell, int symmetry) {
+    int row = cell / N;
+    int col = cell % N;
+    if (symmetry & 4) std::swap(row, col);
+    if (symmetry & 2) col = N - 1 - col;
+    if (symmetry & 1) row = N - 1 - row;
+    return row * N + col;
+}
+
+OpeningBookBuilder::OpeningBookBuilder(int maxPly)
+    : m_maxPly(maxPly)
+{
+}
+
+/**
+ * @brief 收录对局实现
+ * 实现逻辑：在空棋盘上逐手重放前maxPly手，每手落子前计算规范化局面键与规范着法，
+ * 按落子方视角累加对局数与得分（胜2、和1、负0）；成五后对局结束，不再收录。
+ */
+bool OpeningBookBuilder::addGame(const int* cells, int count, int result) {
+    Board board;
+    Config::PieceType side = Config::PieceType::Black;
+    const int plies = std::min(count, m_maxPly);
+    for (int ply = 0; ply < plies; ++ply) {
+        const int cell = cells[ply];
+        if (cell < 0 || cell >= N * N || board.getPiece(cell / N, cell % N) != Config::PieceType::None) {
+            return false;
+        }
+        uint8_t symmetryMask = 0;
+        const uint64_t key = OpeningBook::canonicalKey(board, &symmetryMask);
+        Stats& stats = m_stats[{ key, OpeningBook::canonicalMove(cell, symmetryMask) }];
+        const int moverResult = side == Config::PieceType::Black ? result : -result;
+        stats.games += 1;
+        stats.points += static_cast<uint64_t>(moverResult + 1);
+
+        board.placePiece(cell / N, cell % N, side);
+        if (board.checkWin(cell / N, cell % N, side)) {
+            break;
+        }
+        side = Config::opponent(side);
+    }
+    return true;
+}
+
+/**
+ * @brief 写出开局库实现
+ * 实现逻辑：m_stats按（键, 着法）有序，过滤对局数不足的条目后顺序写出；
+ * 对局数超过16位上限时与得分等比例缩放，保持得分率不变。
+ */
+bool OpeningBookBuilder::write(const QString& path, uint32_t minGames) const {
+    std::vector<OpeningBook::Entry> entries;
+    entries.reserve(m_stats.size());
+    for (const auto& [keyMove, stats] : m_stats) {
+        if (stats.games < minGames) {
+            continue;
+        }
+        uint64_t games = stats.games;
+        uint64_t points = stats.points;
+        if (games > UINT16_MAX) {
+            points = points * UINT16_MAX / games;
+            games = UINT16_MAX;
+        }
+        entries.push_back({ keyMove.first, static_cast<uint32_t>(points),
+                            static_cast<uint16_t>(games), static_cast<uint16_t>(keyMove.second) });
+    }
+
+    OpeningBook::Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = OpeningBook::FORMAT_VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.boardSize = static_cast<uint32_t>(N);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const int64_t entryBytes = static_cast<int64_t>(entries.size() * sizeof(OpeningBook::Entry));
+    return file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<int64_t>(sizeof(header))
+        && file.write(reinterpret_cast<const char*>(entries.data()), entryBytes) == entryBytes;
+}
@@ -0,0 +1,172 @@
+﻿#pragma once
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <QFile>
+#include <QString>
+#include "../game/Board.h"
+
+/**
+ * @brief 开局库中的一个候选着法（已换算回实际棋盘坐标）
+ */
+struct BookMove {
+    int row = -1;
+    int col = -1;
+    uint32_t games = 0;     // 该着法在建库对局中出现的次数
+    double score = 0.5;     // 落子方得分率（胜1、和0.5、负0）
+};
+
+/**
+ * @brief 内存映射开局库（只读）
+ * 核心职责：开局前若干手直接查表落子，省去对熟知局面的重复搜索。
+ * 文件格式（小端序）：
+ * 1. 16字节文件头 { "LQOB", 版本, 条目数, 棋盘大小 }；
+ * 2. 紧随其后的条目数组，每条16字节 { 规范化局面键, 得分(半分制), 对局数, 规范化着法 }，
+ *    按（键, 着法）升序排列，同一局面的全部着法相邻存放。
+ * 对称折叠：棋盘的8种对称变换（4种旋转 × 是否镜像）下等价的局面共用一个条目——
+ * 规范化局面键 = 8种变换后Zobrist哈希的最小值，着法也按同一变换换算到规范坐标；
+ * 局面自身对称时，等价着法取规范坐标最小者，统计数据合并到同一条目。
+ * 加载方式：QFile::map()整体映射，加载时只校验文件头，查询直接在映射内存上二分查找，无任何解析开销。
+ */
+class OpeningBook {
+public:
+    /**
+     * @brief 文件头（16字节）
+     */
+    struct Header {
+        char magic[4];          // "LQOB"
+        uint32_t version;       // 文件格式版本（FORMAT_VERSION）
+        uint32_t entryCount;    // 条目数量
+        uint32_t boardSize;     // 棋盘大小（必须等于Config::BOARD_SIZE）
+    };
+
+    /**
+     * @brief 条目（16字节，落子方视角）
+     */
+    struct Entry {
+        uint64_t key;           // 规范化局面键
+        uint32_t points;        // 累计得分（半分制：胜2、和1、负0）
+        uint16_t games;         // 对局数（超过65535时与得分等比例缩放）
+        uint16_t move;          // 规范化着法（格子下标）
+    };
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr int SYMMETRY_COUNT = 8;
+
+    OpeningBook();
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    /**
+     * @brief 映射开局库文件（已加载时先卸载）
+     * @param path 文件路径
+     * @return bool 是否加载成功（文件不存在、文件头不匹配或大小不符时返回false）
+     */
+    bool load(const QString& path);
+
+    /**
+     * @brief 解除映射并关闭文件
+     */
+    void unload();
+
+    bool isLoaded() const { return m_entries != nullptr; }
+    size_t entryCount() const { return m_count; }
+
+    /**
+     * @brief 查询当前局面的全部库内着法
+     * @param board 当前局面
+     * @param out 输出数组（实际棋盘坐标，已跳过被占据的点）
+     * @param maxMoves 输出数组容量
+     * @return int 写入的着法数量（局面不在库中返回0）
+     */
+    int probe(const Board& board, BookMove* out, int maxMoves) const;
+
+    /**
+     * @brief 选出当前局面的库内最佳着法
+     * 选择标准：对局数不少于minGames的着法中，平滑得分率 (得分+1)/(2×对局数+2) 最高者，相同时取对局数多者。
+     * @return bool 是否找到
+     */
+    bool bestMove(const Board& board, BookMove& out, uint32_t minGames = 1) const;
+
+    /**
+     * @brief 计算规范化局面键
+     * @param board 局面
+     * @param symmetryMask 输出：取得最小哈希的全部对称变换（位掩码，第s位对应变换s），可为nullptr
+     * @return uint64_t 8种对称变换下Zobrist哈希的最小值
+     */
+    static uint64_t canonicalKey(const Board& board, uint8_t* symmetryMask = nullptr);
+
+    /**
+     * @brief 把实际着法换算为规范着法（symmetryMask中各变换结果的最小值）
+     */
+    static int canonicalMove(int cell, uint8_t symmetryMask);
+
+    /**
+     * @brief 把规范着法换算回实际着法（使用symmetryMask中编号最小的变换的逆变换）
+     */
+    static int actualMove(int canonicalCell, uint8_t symmetryMask);
+
+    /**
+     * @brief 对称变换：s的第0位上下翻转、第1位左右翻转、第2位转置（依次施加）
+     */
+    static int transformCell(int cell, int symmetry);
+    static int inverseTransformCell(int cell, int symmetry);
+
+private:
+    std::unique_ptr<QFile> m_file;       // 映射期间保持打开（映射随文件对象销毁而解除）
+    const Entry* m_entries = nullptr;
+    size_t m_count = 0;
+};
+
+/**
+ * @brief 开局库构建器（供建库工具与测试使用）
+ * 使用方式：逐局addGame()累加每个局面下各着法的对局数与得分，最后write()按文件格式排序写出。
+ */
+class OpeningBookBuilder {
+public:
+    /**
+     * @brief 构造函数
+     * @param maxPly 每局只收录前maxPly手（开局库深度）
+     */
+    explicit OpeningBookBuilder(int maxPly = 12);
+
+    /**
+     * @brief 收录一局棋
+     * @param cells 着法序列（格子下标，黑先交替）
+     * @param count 着法数量
+     * @param result 对局结果：1=黑胜，-1=白胜，0=和棋
+     * @return bool 着法序列是否合法（遇到非法着法时只收录此前的部分并返回false）
+     */
+    bool addGame(const int* cells, int count, int result);
+
+    /**
+     * @brief 已收录的（局面, 着法）条目数
+     */
+    size_t entryCount() const { return m_stats.size(); }
+
+    /**
+     * @brief 写出开局库文件
+     * @param path 输出路径
+     * @param minGames 对局数少于minGames的条目不写出（过滤偶然出现的着法）
+     * @return bool 是否写出成功
+     */
+    bool write(const QString& path, uint32_t minGames = 1) const;
+
+private:
+    struct Stats {
+        uint64_t games = 0;
+        uint64_t points = 0;
+    };
+
+    int m_maxPly;
+    std::map<std::pair<uint64_t, int>, Stats> m_stats;   // (规范化局面键, 规范化着法) → 统计，天然有序
+};
+
+#endif // OPENINGBOOK_H
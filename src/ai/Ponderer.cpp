@@ -0,0 +1,63 @@
+﻿#include "Ponderer.h"
+#include <chrono>
+
+template <int N, Rule R>
+BasicPonderer<N, R>::BasicPonderer(BasicSearchEngine<N, R>& engine)
+    : m_engine(engine)
+{
+}
+
+template <int N, Rule R>
+BasicPonderer<N, R>::~BasicPonderer() {
+    stop();
+}
+
+/**
+ * @brief 开始后台思考实现
+ * 实现逻辑：先停止上一次后台搜索，再以棋盘副本启动后台线程；线程结束时置m_finished。
+ */
+template <int N, Rule R>
+void BasicPonderer<N, R>::start(const BasicBoard<N, R>& board, Config::PieceType side, int maxTimeMs) {
+    SearchLimits limits;
+    limits.timeMs = maxTimeMs;
+    start(board, side, limits);
+}
+
+template <int N, Rule R>
+void BasicPonderer<N, R>::start(const BasicBoard<N, R>& board, Config::PieceType side, const SearchLimits& limits) {
+    stop();
+    m_finished.store(false, std::memory_order_release);
+    m_thread = std::thread([this, board, side, limits]() {
+        m_result = m_engine.search(board, side, limits);
+        m_finished.store(true, std::memory_order_release);
+    });
+}
+
+/**
+ * @brief 停止后台思考实现
+ * 实现逻辑：search()开始时会复位停止标志，若stop()恰好发生在后台线程进入search()之前，
+ * 单次请求会被覆盖；因此循环请求停止，直到后台线程确认结束，再join并返回结果。
+ */
+template <int N, Rule R>
+SearchResult BasicPonderer<N, R>::stop() {
+    if (!m_thread.joinable()) {
+        return SearchResult();
+    }
+    while (!m_finished.load(std::memory_order_acquire)) {
+        m_engine.stop();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    m_thread.join();
+    SearchResult result = m_result;
+    m_result = SearchResult();
+    return result;
+}
+
+template class BasicPonderer<Config::BOARD_SIZE, Rule::Freestyle>;
+template class BasicPonderer<Config::BOARD_SIZE, Rule::Standard>;
+template class BasicPonderer<Config::BOARD_SIZE, Rule::Renju>;
+template class BasicPonderer<Config::BOARD_SIZE, Rule::Caro>;
+template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Caro>;
@@ -0,0 +1,77 @@
+﻿#pragma once
+#ifndef PONDERER_H
+#define PONDERER_H
+
+#include <atomic>
+#include <thread>
+#include "SearchEngine.h"
+
+/**
+ * @brief 后台思考（Pondering）控制器
+ * 核心职责：AI 落子后、人类思考期间，在后台线程上用同一个 SearchEngine 搜索“人类行棋方”的当前局面，
+ * 把人类各种应手之下的子树结果写入共享置换表；人类真正落子后，AI 的正式搜索直接命中这些条目，
+ * 相当于把人类的思考时间也用于 AI 搜索。
+ * 设计要点：
+ * 1. 同一时刻最多一个后台搜索，与正式搜索共用引擎，因此正式搜索前必须先 stop()；
+ * 2. stop() 立即返回控制权：反复请求引擎停止直到后台线程确认结束（覆盖“线程尚未进入search()”的竞态），
+ *    通常在一次节点检查间隔（约1024个节点）内完成；
+ * 3. 后台搜索结果的第一手即“预测的人类应手”，可用于统计预测命中率。
+ * @tparam N 棋盘边长（与BasicSearchEngine<N>一致）
+ * @tparam R 规则变体
+ */
+template <int N, Rule R = Rule::Freestyle>
+class BasicPonderer {
+public:
+    /**
+     * @brief 构造函数
+     * @param engine 共享的搜索引擎（生命周期须长于 Ponderer）
+     */
+    explicit BasicPonderer(BasicSearchEngine<N, R>& engine);
+    ~BasicPonderer();
+
+    BasicPonderer(const BasicPonderer&) = delete;
+    BasicPonderer& operator=(const BasicPonderer&) = delete;
+
+    /**
+     * @brief 开始后台思考（若已有后台搜索则先停止）
+     * @param board 当前局面（内部复制）
+     * @param side 当前行棋方（即人类一方）
+     * @param maxTimeMs 后台搜索时间上限（毫秒），防止人类长时间不落子时空耗CPU
+     */
+    void start(const BasicBoard<N, R>& board, Config::PieceType side, int maxTimeMs);
+
+    /**
+     * @brief 以完整的搜索限制开始后台思考（深度上限、逐轮进度回调等；回调在后台线程上调用）
+     */
+    void start(const BasicBoard<N, R>& board, Config::PieceType side, const SearchLimits& limits);
+
+    /**
+     * @brief 立即停止后台思考并等待后台线程结束
+     * @return SearchResult 后台搜索到此为止的结果（未在思考时返回空结果，row=-1）
+     */
+    SearchResult stop();
+
+    /**
+     * @brief 是否正在后台思考
+     */
+    bool isRunning() const { return m_thread.joinable() && !m_finished.load(std::memory_order_acquire); }
+
+private:
+    BasicSearchEngine<N, R>& m_engine;
+    std::thread m_thread;
+    std::atomic<bool> m_finished{true};
+    SearchResult m_result;
+};
+
+using Ponderer = BasicPonderer<Config::BOARD_SIZE>;
+
+extern template class BasicPonderer<Config::BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicPonderer<Config::BOARD_SIZE, Rule::Standard>;
+extern template class BasicPonderer<Config::BOARD_SIZE, Rule::Renju>;
+extern template class BasicPonderer<Config::BOARD_SIZE, Rule::Caro>;
+extern template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+extern template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+extern template class BasicPonderer<Config::LARGE_BOARD_SIZE, Rule::Caro>;
+
+#endif // PONDERER_H
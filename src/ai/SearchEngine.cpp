@@ -0,0 +1,805 @@
+﻿#include "SearchEngine.h"
+#include <algorithm>
+#include <thread>
+#include "../utils/BitUtils.h"
+
+namespace {
+
+/**
+ * @brief 白方行棋时附加到局面哈希上的键（区分相同棋子分布下不同的行棋方）
+ */
+constexpr uint64_t SIDE_KEY = 0x9D39247E33776D41ull;
+
+/**
+ * @brief 非威胁局面下内部节点最多展开的着法数（按棋型打分排序后截取）：第1层BRANCH_WIDTH_MAX个，
+ * 每深一层少2个，不少于BRANCH_WIDTH_MIN个；根节点展开全部候选，不截取
+ */
+constexpr int BRANCH_WIDTH_MAX = 20;
+constexpr int BRANCH_WIDTH_MIN = 8;
+
+inline int branchWidth(int ply) {
+    return std::max(BRANCH_WIDTH_MIN, BRANCH_WIDTH_MAX - 2 * (ply - 1));
+}
+
+/**
+ * @brief 后期着法削减（LMR）：剩余深度≥LMR_MIN_DEPTH时，排序在前LMR_FULL_MOVES个之后的非威胁着法
+ * 先少搜1层（排在2×LMR_FULL_MOVES个之后少搜2层）做零窗口试探，超过alpha再按原深度重搜
+ */
+constexpr int LMR_MIN_DEPTH = 3;
+constexpr int LMR_FULL_MOVES = 4;
+
+inline int lateMoveReduction(int depth, int index, bool threat) {
+    if (threat || depth < LMR_MIN_DEPTH || index < LMR_FULL_MOVES) {
+        return 0;
+    }
+    return index >= 2 * LMR_FULL_MOVES && depth > LMR_MIN_DEPTH ? 2 : 1;
+}
+
+/**
+ * @brief 着法排序加分：置换表着法最优先，其次是必胜/必防的威胁着法
+ */
+constexpr int TT_MOVE_BONUS = 1 << 28;
+constexpr int WINNING_THREAT_BONUS = 1 << 24;
+constexpr int FORCING_BONUS = 1 << 20;
+
+/**
+ * @brief 根节点威胁求解的节点上限（VCF、VCT各自计数，约数毫秒；有节点预算时不超过预算的1/4）
+ */
+constexpr uint64_t ROOT_THREAT_NODES = 50000;
+
+/**
+ * @brief Lazy SMP 深度错开表：第i个辅助线程按SKIP_SIZE[i]个深度为一组，组序号为奇数时跳过，
+ * SKIP_PHASE[i]错开各线程的分组起点，使同一时刻各线程分散在相邻的若干深度上
+ */
+constexpr int SKIP_TABLE_SIZE = 20;
+constexpr int SKIP_SIZE[SKIP_TABLE_SIZE] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+constexpr int SKIP_PHASE[SKIP_TABLE_SIZE] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+template <int N, Rule R>
+inline uint64_t positionKey(const BasicBoard<N, R>& board, Config::PieceType side) {
+    return board.hash() ^ (side == Config::PieceType::White ? SIDE_KEY : 0);
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现：分配置换表，清空主要变例
+ */
+template <int N, Rule R>
+BasicSearchEngine<N, R>::BasicSearchEngine(size_t ttSizeMB, bool useHugePages)
+    : m_ownTT(new TranspositionTable(ttSizeMB, useHugePages))
+    , m_tt(*m_ownTT)
+{
+    std::fill(&m_pvLength[0], &m_pvLength[0] + MAX_PLY + 1, 0);
+    std::fill(&m_playedMove[0], &m_playedMove[0] + MAX_PLY + 1, -1);
+    m_threatSolver.setStopFlag(&m_stop);
+}
+
+/**
+ * @brief 辅助线程构造函数实现：引用共享置换表，威胁求解器只保留最小缓存（辅助线程不做根节点求解），
+ * 全部成员初始化后启动常驻线程
+ */
+template <int N, Rule R>
+BasicSearchEngine<N, R>::BasicSearchEngine(TranspositionTable& sharedTT, int helperIndex)
+    : m_tt(sharedTT)
+    , m_helperIndex(helperIndex)
+    , m_threatSolver(4)
+{
+    std::fill(&m_pvLength[0], &m_pvLength[0] + MAX_PLY + 1, 0);
+    std::fill(&m_playedMove[0], &m_playedMove[0] + MAX_PLY + 1, -1);
+    m_thread = std::thread(&BasicSearchEngine::helperLoop, this);
+}
+
+/**
+ * @brief 析构实现：辅助实例通知常驻线程退出并等待（主实例的辅助实例随m_helpers一起析构）
+ */
+template <int N, Rule R>
+BasicSearchEngine<N, R>::~BasicSearchEngine() {
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_threadMutex);
+            m_quit = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+}
+
+/**
+ * @brief 常驻辅助线程主循环：等待搜索请求，以无限预算运行iterate()（由主线程stop()结束），完成后通知主线程
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::helperLoop() {
+    std::unique_lock<std::mutex> lock(m_threadMutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_searchPending || m_quit; });
+        if (m_quit) {
+            return;
+        }
+        m_searchPending = false;
+        lock.unlock();
+        iterate(m_searchSide, m_helperResult);
+        lock.lock();
+        m_searching = false;
+        m_idle.notify_one();
+    }
+}
+
+/**
+ * @brief 唤醒辅助线程开始搜索（棋盘、限制与根着法须已由主线程写好；互斥锁保证线程看到这些写入）
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::startHelper(Config::PieceType side) {
+    {
+        std::lock_guard<std::mutex> lock(m_threadMutex);
+        m_searchSide = side;
+        m_searchPending = true;
+        m_searching = true;
+    }
+    m_wake.notify_one();
+}
+
+/**
+ * @brief 等待辅助线程本次搜索返回（返回后可以安全读取其结果与节点数）
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::waitHelper() {
+    std::unique_lock<std::mutex> lock(m_threadMutex);
+    m_idle.wait(lock, [this]() { return !m_searching; });
+}
+
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::clear() {
+    m_tt.clear();
+    m_threatSolver.clear();
+    m_ordering.clear();
+    for (auto& helper : m_helpers) {
+        helper->m_ordering.clear();
+    }
+}
+
+/**
+ * @brief 设置线程数实现：按需创建/销毁辅助线程的搜索实例（各带一个常驻线程，随实例创建与退出）
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::setThreadCount(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    const size_t helperCount = static_cast<size_t>(threads - 1);
+    while (m_helpers.size() > helperCount) {
+        m_helpers.pop_back();
+    }
+    while (m_helpers.size() < helperCount) {
+        m_helpers.emplace_back(new BasicSearchEngine(m_tt, static_cast<int>(m_helpers.size()) + 1));
+        m_helpers.back()->m_network = m_network;
+    }
+}
+
+/**
+ * @brief 设置神经网络实现：校验棋盘大小，估值方式变化时清空置换表，并同步给全部辅助线程
+ */
+template <int N, Rule R>
+bool BasicSearchEngine<N, R>::setNetwork(const NnueNetwork* network) {
+    if (network && (!network->isLoaded() || network->boardSize() != N)) {
+        return false;
+    }
+    if (network != m_network) {
+        m_tt.clear();
+    }
+    m_network = network;
+    for (auto& helper : m_helpers) {
+        helper->m_network = network;
+    }
+    return true;
+}
+
+/**
+ * @brief 判断辅助线程是否跳过某一迭代深度（主线程从不跳过）
+ */
+template <int N, Rule R>
+bool BasicSearchEngine<N, R>::skipDepth(int depth, int helperIndex) {
+    if (helperIndex == 0) {
+        return false;
+    }
+    const int i = (helperIndex - 1) % SKIP_TABLE_SIZE;
+    return ((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2 != 0;
+}
+
+/**
+ * @brief 杀棋分写入置换表前换算为“相对当前节点”的步数，读出时再换算回来
+ */
+template <int N, Rule R>
+int BasicSearchEngine<N, R>::scoreToTT(int score, int ply) {
+    if (score > WIN_SCORE - MAX_PLY) return score + ply;
+    if (score < -WIN_SCORE + MAX_PLY) return score - ply;
+    return score;
+}
+
+template <int N, Rule R>
+int BasicSearchEngine<N, R>::scoreFromTT(int score, int ply) {
+    if (score > WIN_SCORE - MAX_PLY) return score - ply;
+    if (score < -WIN_SCORE + MAX_PLY) return score + ply;
+    return score;
+}
+
+/**
+ * @brief 时间/节点预算检查：超限则置停止标志
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::checkLimits() {
+    if (m_limits.maxNodes && m_nodes >= m_limits.maxNodes) {
+        m_stop.store(true, std::memory_order_relaxed);
+        return;
+    }
+    if (m_limits.timeMs > 0) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_startTime).count();
+        if (elapsed >= m_limits.timeMs) {
+            m_stop.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief 更新主要变例：当前着法 + 子节点的主要变例
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::updatePv(int ply, int cell) {
+    m_pv[ply][ply] = cell;
+    for (int i = ply + 1; i < m_pvLength[ply + 1]; ++i) {
+        m_pv[ply][i] = m_pv[ply + 1][i];
+    }
+    m_pvLength[ply] = std::max(m_pvLength[ply + 1], ply + 1);
+}
+
+/**
+ * @brief 搜索内落子/撤销：启用神经网络估值时同步增量更新累加器（只加减该棋子的两行特征权重）
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::makeMove(int cell, Config::PieceType side) {
+    m_board.makeMove(cell / N, cell % N, side);
+    if (m_network) {
+        m_accumulator.addStone(*m_network, cell, side);
+    }
+}
+
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::unmakeMove(int cell, Config::PieceType side) {
+    m_board.unmakeMove();
+    if (m_network) {
+        m_accumulator.removeStone(*m_network, cell, side);
+    }
+}
+
+/**
+ * @brief 静态估值：有神经网络时用网络估值，否则用棋盘增量维护的棋型估值
+ */
+template <int N, Rule R>
+int BasicSearchEngine<N, R>::staticEval(Config::PieceType side) const {
+    return m_network ? m_network->evaluate(m_accumulator, side) : m_board.evaluate(side);
+}
+
+/**
+ * @brief 着法生成实现
+ * 实现逻辑：
+ * Step1：候选区域——直接取Board增量维护的候选着法掩码（距离已有棋子2格以内的空点，Renju下黑方已去掉禁手点）；
+ * Step2：逐点查询双方四个方向的棋型，排序分 = 己方棋型分之和 + 对方棋型分之和（进攻 + 防守），
+ *        活四/双冲四/冲四活三等必胜威胁额外加分；非威胁着法再加上MoveOrdering的杀手/反击/历史分；
+ * Step3：威胁剪枝——
+ *        - 己方可成五：只返回该点（hasWin=true）；
+ *        - 对方可成五：只返回封堵点（两处及以上无法同时封堵，mustLose=true）；
+ *        - 对方有活三（可成活四）且己方没有冲四：只返回能阻止对方成四的点与己方冲四点；
+ *        - 其余情况在内部节点按排序分截取前branchWidth(ply)个，根节点保留全部候选（由LMR控制开销）。
+ * @return int 着法数量（已按排序分从高到低排列）
+ */
+template <int N, Rule R>
+int BasicSearchEngine<N, R>::generateMoves(Config::PieceType side, int ply, ScoredMove* moves, int ttMove,
+                                        bool& hasWin, bool& mustLose) const {
+    hasWin = false;
+    mustLose = false;
+    if (m_board.stoneCount() == 0) {
+        moves[0] = { (N / 2) * N + N / 2, 0, false };
+        return 1;
+    }
+
+    const Config::PieceType opp = Config::opponent(side);
+    const bool oppHasOpenThree = m_board.threatCount(opp, PatternType::OpenFour) > 0;
+    const bool oppHasFive = m_board.threatCount(opp, PatternType::Five) > 0;
+    const int prevMove = ply > 0 ? m_playedMove[ply - 1] : -1;
+
+    int count = 0;
+    int blockCount = 0;
+    bool ownFourAvailable = false;
+    ScoredMove blocks[MAX_MOVES];
+
+    for (int r = 0; r < N; ++r) {
+        uint32_t near = m_board.playableRow(side, r);
+        while (near) {
+            const int c = BitUtils::countTrailingZeros(near);
+            near &= near - 1;
+
+            int attack = 0, defend = 0;
+            int ownFours = 0, ownOpenThrees = 0, oppFours = 0;
+            bool ownFive = false, ownOpenFour = false, oppFive = false;
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                const PatternType own = m_board.pattern(r, c, dir, side);
+                const PatternType other = m_board.pattern(r, c, dir, opp);
+                attack += PATTERN_SCORE[static_cast<int>(own)];
+                defend += PATTERN_SCORE[static_cast<int>(other)];
+                ownFive |= own == PatternType::Five;
+                ownOpenFour |= own == PatternType::OpenFour;
+                ownFours += own == PatternType::Four || own == PatternType::OpenFour;
+                ownOpenThrees += own == PatternType::OpenThree;
+                oppFive |= other == PatternType::Five;
+                oppFours += other >= PatternType::Four;
+            }
+
+            const int cell = r * N + c;
+            if (ownFive) {
+                moves[0] = { cell, INF, true };
+                hasWin = true;
+                return 1;
+            }
+
+            int score = attack + defend;
+            const bool threat = ownFours > 0 || oppFive;
+            if (ownOpenFour || ownFours >= 2 || (ownFours && ownOpenThrees)) {
+                score += WINNING_THREAT_BONUS;
+            } else if (ownFours) {
+                score += FORCING_BONUS;
+            }
+            if (!threat) {
+                score += m_ordering.bonus(side, ply, cell, prevMove);
+            }
+            if (cell == ttMove) {
+                score += TT_MOVE_BONUS;
+            }
+            ownFourAvailable |= ownFours > 0;
+
+            if (oppFive) {
+                blocks[blockCount++] = { cell, score, threat };
+            }
+            if (!oppHasFive && oppHasOpenThree && oppFours == 0 && ownFours == 0) {
+                continue;  // 对方有活三时，既不防守也不冲四的着法直接剪掉
+            }
+            moves[count++] = { cell, score, threat };
+        }
+    }
+
+    if (oppHasFive) {
+        // 封堵点≥2无法同时封堵；封堵点全是己方禁手（blockCount为0）同样必败，此时保留普通着法供根节点返回
+        mustLose = blockCount != 1;
+        if (blockCount > 0) {
+            std::copy(blocks, blocks + blockCount, moves);
+            count = blockCount;
+        }
+    }
+
+    std::sort(moves, moves + count, [](const ScoredMove& a, const ScoredMove& b) { return a.score > b.score; });
+    if (ply > 0 && !oppHasFive && !(oppHasOpenThree && !ownFourAvailable) && count > branchWidth(ply)) {
+        count = branchWidth(ply);
+    }
+    return count;
+}
+
+/**
+ * @brief Negamax + Alpha-Beta + PVS 递归搜索实现
+ * 实现逻辑：
+ * Step1：每1024个节点检查一次预算；杀棋步数剪枝（已不可能比alpha/beta更好则直接返回）；
+ * Step2：威胁快速判定（依赖Board增量威胁计数，O(1)）——己方可成五即胜；对方无五时己方有活四即胜；
+ * Step3：查置换表，非PV节点深度足够时直接截断；
+ * Step4：深度耗尽返回静态估值；
+ * Step5：生成着法，首个着法全窗口搜索，其余先零窗口试探（对方没有威胁时，靠后的非威胁着法按LMR少搜1~2层，
+ *        超过alpha先按原深度重搜），超过alpha再全窗口重搜；
+ *        beta截断时记录截断来源统计，普通着法截断还要更新杀手/反击着法/历史表；
+ * Step6：按结果类型写入置换表。
+ */
+template <int N, Rule R>
+int BasicSearchEngine<N, R>::negamax(int depth, int ply, int alpha, int beta, Config::PieceType side) {
+    if ((++m_nodes & 1023u) == 0) {
+        checkLimits();
+    }
+    if (m_stop.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    m_pvLength[ply] = ply;
+    if constexpr (SearchStats::ENABLED) {
+        m_stats.selDepth = std::max(m_stats.selDepth, ply);
+    }
+
+    const Config::PieceType opp = Config::opponent(side);
+    if (m_board.threatCount(side, PatternType::Five) > 0) {
+        return WIN_SCORE - ply - 1;
+    }
+    // 活四即胜的捷径不适用于有禁手的一方（活四点可能同时构成四四/长连禁手），交给着法生成逐点判断
+    if (!hasForbiddenMoves(R, side) && m_board.threatCount(opp, PatternType::Five) == 0
+        && m_board.threatCount(side, PatternType::OpenFour) > 0) {
+        return WIN_SCORE - ply - 3;
+    }
+    if (ply >= MAX_PLY || m_board.isFull()) {
+        return staticEval(side);
+    }
+
+    alpha = std::max(alpha, -WIN_SCORE + ply);
+    beta = std::min(beta, WIN_SCORE - ply - 1);
+    if (alpha >= beta) {
+        return alpha;
+    }
+
+    const bool pvNode = beta - alpha > 1;
+    const uint64_t key = positionKey(m_board, side);
+    TTEntry tte;
+    int ttMove = -1;
+    const bool ttHit = m_tt.probe(key, tte);
+    if constexpr (SearchStats::ENABLED) {
+        ++m_stats.ttProbes;
+        m_stats.ttHits += ttHit ? 1 : 0;
+    }
+    if (ttHit) {
+        ttMove = tte.move;
+        if (!pvNode && tte.depth >= depth) {
+            const int s = scoreFromTT(tte.score, ply);
+            if (tte.bound == TTBound::Exact
+                || (tte.bound == TTBound::Lower && s >= beta)
+                || (tte.bound == TTBound::Upper && s <= alpha)) {
+                return s;
+            }
+        }
+    }
+
+    if (depth <= 0) {
+        return staticEval(side);
+    }
+
+    ScoredMove* moves = m_moveStack[ply];
+    bool hasWin = false, mustLose = false;
+    const int count = generateMoves(side, ply, moves, ttMove, hasWin, mustLose);
+    if (count == 0) {
+        return 0;
+    }
+    if (mustLose) {
+        return -WIN_SCORE + ply + 2;
+    }
+
+    const int origAlpha = alpha;
+    const bool reducible = m_board.threatCount(opp, PatternType::OpenFour) == 0;
+    int best = -INF;
+    int bestMove = -1;
+    int failedQuiets[MAX_MOVES];
+    int failedQuietCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const int cell = moves[i].cell;
+        makeMove(cell, side);
+        m_tt.prefetch(positionKey(m_board, opp));
+        m_playedMove[ply] = cell;
+
+        int score;
+        if (i == 0) {
+            score = -negamax(depth - 1, ply + 1, -beta, -alpha, opp);
+        } else {
+            const int reduction = reducible ? lateMoveReduction(depth, i, moves[i].threat) : 0;
+            score = -negamax(depth - 1 - reduction, ply + 1, -alpha - 1, -alpha, opp);
+            if (reduction > 0 && score > alpha) {
+                score = -negamax(depth - 1, ply + 1, -alpha - 1, -alpha, opp);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(depth - 1, ply + 1, -beta, -alpha, opp);
+            }
+        }
+        unmakeMove(cell, side);
+
+        if (m_stop.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (score > best) {
+            best = score;
+            bestMove = cell;
+            if (score > alpha) {
+                alpha = score;
+                updatePv(ply, cell);
+                if (alpha >= beta) {
+                    const int prevMove = m_playedMove[ply - 1];
+                    m_ordering.recordCutoff(side, ply, cell, prevMove, ttMove, moves[i].threat, i);
+                    if (!moves[i].threat) {
+                        m_ordering.updateQuietCutoff(side, ply, depth, cell, prevMove, failedQuiets, failedQuietCount);
+                    }
+                    break;
+                }
+            }
+        }
+        if (!moves[i].threat) {
+            failedQuiets[failedQuietCount++] = cell;
+        }
+    }
+
+    const TTBound bound = best >= beta ? TTBound::Lower : (best > origAlpha ? TTBound::Exact : TTBound::Upper);
+    const bool collision = m_tt.store(key, scoreToTT(best, ply), depth, bound, bestMove);
+    if constexpr (SearchStats::ENABLED) {
+        m_stats.ttCollisions += collision ? 1 : 0;
+    }
+    return best;
+}
+
+/**
+ * @brief 根节点搜索实现
+ * 实现逻辑：与negamax相同的PVS流程（含LMR），但遍历预先生成的全部根着法，
+ * 每当找到更好的着法就记录到m_rootBest，并把它移到列表最前（下一轮迭代最先搜索）。
+ */
+template <int N, Rule R>
+int BasicSearchEngine<N, R>::searchRoot(int depth, int alpha, int beta, Config::PieceType side) {
+    const Config::PieceType opp = Config::opponent(side);
+    ScoredMove* moves = m_moveStack[0];
+    const int count = m_rootMoveCount;
+    const bool reducible = m_board.threatCount(opp, PatternType::OpenFour) == 0;
+    m_pvLength[0] = 0;
+
+    int best = -INF;
+    for (int i = 0; i < count; ++i) {
+        const int cell = moves[i].cell;
+        makeMove(cell, side);
+        m_playedMove[0] = cell;
+        ++m_nodes;
+
+        int score;
+        if (i == 0) {
+            score = -negamax(depth - 1, 1, -beta, -alpha, opp);
+        } else {
+            const int reduction = reducible ? lateMoveReduction(depth, i, moves[i].threat) : 0;
+            score = -negamax(depth - 1 - reduction, 1, -alpha - 1, -alpha, opp);
+            if (reduction > 0 && score > alpha) {
+                score = -negamax(depth - 1, 1, -alpha - 1, -alpha, opp);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(depth - 1, 1, -beta, -alpha, opp);
+            }
+        }
+        unmakeMove(cell, side);
+
+        if (m_stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                m_rootBest = cell;
+                updatePv(0, cell);
+                std::rotate(moves, moves + i, moves + i + 1);
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 迭代加深实现（主线程与辅助线程共用）
+ * 实现逻辑：深度1、2、3……逐层加深，辅助线程按skipDepth()跳过部分深度；
+ * 深度≥4且上一轮不是杀棋分时使用期望窗口（±40起，失败后×4放宽，过大则改用全窗口）；
+ * 每完成一轮迭代把最佳着法、得分与主要变例写入result（主线程同时调用limits.onIteration报告进度，
+ * 启用统计时还记录该轮的节点数、耗时与选择性深度）；
+ * 搜到杀棋、被停止，或（仅主线程）已用掉一半时间时停止加深。
+ */
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::iterate(Config::PieceType side, SearchResult& result) {
+    int prevScore = 0;
+    const int maxDepth = std::min(m_limits.maxDepth, MAX_PLY - 1);
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        if (skipDepth(depth, m_helperIndex) && depth < maxDepth) {
+            continue;
+        }
+        [[maybe_unused]] const uint64_t iterationNodes = m_nodes;
+        [[maybe_unused]] const auto iterationStart = std::chrono::steady_clock::now();
+        int delta = 40;
+        int alpha = -INF;
+        int beta = INF;
+        if (depth >= 4 && !isWinScore(prevScore)) {
+            alpha = prevScore - delta;
+            beta = prevScore + delta;
+        }
+
+        int score = 0;
+        while (true) {
+            score = searchRoot(depth, alpha, beta, side);
+            if (m_stop.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if (score <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(-INF, score - delta);
+            } else if (score >= beta) {
+                beta = std::min(INF, score + delta);
+            } else {
+                break;
+            }
+            delta *= 4;
+            if (delta > 20000) {
+                alpha = -INF;
+                beta = INF;
+            }
+        }
+        if (m_stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        prevScore = score;
+        result.depth = depth;
+        result.score = score;
+        if (m_rootBest >= 0) {
+            result.row = m_rootBest / N;
+            result.col = m_rootBest % N;
+        }
+        result.pv.assign(&m_pv[0][0], &m_pv[0][0] + m_pvLength[0]);
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_startTime).count();
+        if constexpr (SearchStats::ENABLED) {
+            if (m_helperIndex == 0) {
+                IterationStats iteration;
+                iteration.depth = depth;
+                iteration.score = score;
+                iteration.selDepth = m_stats.selDepth;
+                iteration.nodes = m_nodes - iterationNodes;
+                iteration.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - iterationStart).count();
+                m_stats.iterations.push_back(iteration);
+            }
+        }
+        if (m_helperIndex == 0 && m_limits.onIteration) {
+            result.nodes = m_nodes;
+            result.timeMs = elapsed;
+            if constexpr (SearchStats::ENABLED) {
+                result.stats = m_stats;
+                result.stats.cutoffs = m_ordering.stats().cutoffs;
+                result.stats.firstMoveCutoffs = m_ordering.stats().firstMoveCutoffs;
+                result.stats.ttFillRate = m_tt.fillRate();
+            }
+            m_limits.onIteration(result);
+        }
+
+        if (isWinScore(score)) {
+            break;
+        }
+        if (m_helperIndex == 0 && m_limits.timeMs > 0 && elapsed * 2 >= m_limits.timeMs) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 搜索入口实现
+ * 实现逻辑：
+ * Step1：清空结果（保留主要变例与迭代统计的缓冲区），复制棋盘（启用神经网络估值时按棋盘重算累加器）、
+ *        重置计数器与停止标志，置换表进入新世代；
+ * Step2：生成根着法：无着法直接返回；可直接成五或只有唯一应手时立即返回；
+ *        再调用ThreatSolver求VCF/VCT，有强制获胜序列直接返回；
+ * Step3：Lazy SMP——每个辅助实例复制棋盘、累加器与根着法列表，唤醒其常驻线程以无限预算运行iterate()；
+ *        主线程在自己的预算内运行iterate()，结束后停止并等待全部辅助线程回到等待状态；
+ * Step4：取完成深度最大的线程结果（同深度以主线程为准），汇总全部线程的节点数，统计耗时与NPS；
+ *        启用统计时附上主线程的搜索统计（置换表命中、截断、选择性深度、各轮迭代）。
+ */
+template <int N, Rule R>
+SearchResult BasicSearchEngine<N, R>::search(const BasicBoard<N, R>& board, Config::PieceType side, const SearchLimits& limits) {
+    SearchResult result;
+    search(board, side, limits, result);
+    return result;
+}
+
+template <int N, Rule R>
+void BasicSearchEngine<N, R>::search(const BasicBoard<N, R>& board, Config::PieceType side, const SearchLimits& limits,
+                                     SearchResult& result) {
+    // 清空结果但保留缓冲区：主要变例留在result中，迭代统计缓冲区在搜索期间交给m_stats，结束时再移回
+    std::vector<int> pv = std::move(result.pv);
+    std::vector<IterationStats> iterations = std::move(result.stats.iterations);
+    pv.clear();
+    iterations.clear();
+    result = SearchResult();
+    result.pv = std::move(pv);
+
+    m_board = board;
+    m_limits = limits;
+    m_startTime = std::chrono::steady_clock::now();
+    m_stop.store(false, std::memory_order_relaxed);
+    m_nodes = 0;
+    m_rootBest = -1;
+    m_tt.newSearch();
+    m_ordering.newSearch();
+    if (m_network) {
+        m_accumulator.refresh(*m_network, m_board);
+    }
+    if constexpr (SearchStats::ENABLED) {
+        m_stats = SearchStats();
+        m_stats.iterations = std::move(iterations);
+        m_stats.iterations.reserve(MAX_PLY);
+    }
+
+    result.pv.reserve(MAX_PLY); // 每轮迭代覆盖写入主要变例，一次预留避免逐轮扩容
+    ScoredMove* rootMoves = m_moveStack[0];
+    bool hasWin = false, mustLose = false;
+    const int rootCount = generateMoves(side, 0, rootMoves, -1, hasWin, mustLose);
+    m_rootMoveCount = rootCount;
+
+    if (rootCount > 0) {
+        result.row = rootMoves[0].cell / N;
+        result.col = rootMoves[0].cell % N;
+        result.pv = { rootMoves[0].cell };
+    }
+
+    bool forcedWin = false;
+    if (rootCount > 1 && !hasWin && !mustLose) {
+        m_threatSolver.setNodeLimit(limits.maxNodes > 0 ? std::min(ROOT_THREAT_NODES, limits.maxNodes / 4 + 1) : ROOT_THREAT_NODES);
+        const ThreatResult threat = m_threatSolver.findForcedWin(m_board, side);
+        if (threat.found) {
+            forcedWin = true;
+            result.row = threat.row;
+            result.col = threat.col;
+            result.score = WIN_SCORE - std::min(static_cast<int>(threat.line.size()), MAX_PLY - 1);
+            result.depth = static_cast<int>(threat.line.size());
+            result.pv = threat.line;
+        }
+        m_nodes += threat.nodes;
+    }
+
+    uint64_t helperNodes = 0;
+    if (rootCount > 1 && !hasWin && !forcedWin) {
+        for (auto& helperPtr : m_helpers) {
+            BasicSearchEngine& helper = *helperPtr;
+            helper.m_board = board;
+            helper.m_accumulator = m_accumulator;
+            helper.m_limits = SearchLimits();
+            helper.m_limits.maxDepth = limits.maxDepth;
+            helper.m_limits.timeMs = 0;
+            helper.m_startTime = m_startTime;
+            helper.m_stop.store(false, std::memory_order_relaxed);
+            helper.m_nodes = 0;
+            helper.m_rootBest = -1;
+            helper.m_ordering.newSearch();
+            helper.m_rootMoveCount = rootCount;
+            std::copy(rootMoves, rootMoves + rootCount, helper.m_moveStack[0]);
+            helper.m_helperResult = result;
+            helper.m_helperResult.pv.reserve(MAX_PLY);
+            helper.startHelper(side);
+        }
+
+        iterate(side, result);
+
+        for (auto& helper : m_helpers) {
+            helper->stop();
+        }
+        for (auto& helper : m_helpers) {
+            helper->waitHelper();
+            helperNodes += helper->m_nodes;
+            if (helper->m_helperResult.depth > result.depth) {
+                result = helper->m_helperResult;
+            }
+        }
+    } else if (hasWin) {
+        result.score = WIN_SCORE - 1;
+    } else if (mustLose) {
+        result.score = -WIN_SCORE + 2;
+    }
+
+    result.nodes = m_nodes + helperNodes;
+    result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_startTime).count();
+    const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_startTime).count();
+    result.nps = micros > 0 ? result.nodes * 1000000ull / static_cast<uint64_t>(micros) : 0;
+    if constexpr (SearchStats::ENABLED) {
+        // 最后写入：辅助线程结果可能整体替换了result，统计始终取主线程的
+        result.stats = std::move(m_stats);
+        result.stats.cutoffs = m_ordering.stats().cutoffs;
+        result.stats.firstMoveCutoffs = m_ordering.stats().firstMoveCutoffs;
+        result.stats.ttFillRate = m_tt.fillRate();
+    }
+}
+
+template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Freestyle>;
+template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Standard>;
+template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Renju>;
+template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Caro>;
+template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Caro>;
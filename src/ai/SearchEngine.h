@@ -0,0 +1,283 @@
+﻿#pragma once
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../game/Board.h"
+#include "MoveOrdering.h"
+#include "Nnue.h"
+#include "ThreatSolver.h"
+#include "TranspositionTable.h"
+
+struct SearchResult;
+
+/**
+ * @brief 搜索限制条件（时间、节点数、深度任一到达即停止）
+ */
+struct SearchLimits {
+    int maxDepth = 64;          // 最大迭代深度
+    int timeMs = 1000;          // 时间预算（毫秒），<=0 表示不限时
+    uint64_t maxNodes = 0;      // 节点预算，0 表示不限节点
+    /**
+     * @brief 进度回调：主线程每完成一轮迭代调用一次（在搜索线程上执行，需自行保证线程安全），为空时不回调
+     * 参数为截至该轮的结果（depth/score/pv 有效，nodes/timeMs 为主线程到此为止的统计）。
+     */
+    std::function<void(const SearchResult&)> onIteration;
+};
+
+/**
+ * @brief 搜索统计的编译期开关（CMake 选项 LQHJ_SEARCH_STATS，默认开启）
+ * 为0时统计代码全部在编译期去掉（if constexpr），搜索热路径上没有任何计数开销，SearchResult::stats 保持为空。
+ */
+#ifndef LQHJ_SEARCH_STATS
+#define LQHJ_SEARCH_STATS 1
+#endif
+
+/**
+ * @brief 一轮迭代的统计
+ */
+struct IterationStats {
+    int depth = 0;              // 迭代深度
+    int score = 0;              // 该轮得分
+    int selDepth = 0;           // 到该轮为止到达的最大层数（选择性深度）
+    uint64_t nodes = 0;         // 该轮的节点数（含期望窗口重搜）
+    int64_t timeMs = 0;         // 该轮耗时（毫秒）
+};
+
+/**
+ * @brief 一次搜索的统计（只统计主线程；用于调试面板与日志，定位“AI慢/弱”的原因）
+ */
+struct SearchStats {
+    static constexpr bool ENABLED = LQHJ_SEARCH_STATS != 0;
+
+    int selDepth = 0;               // 选择性深度：搜索到达的最大层数（迭代深度之外还包括杀棋/威胁延伸）
+    uint64_t ttProbes = 0;          // 置换表查询次数
+    uint64_t ttHits = 0;            // 置换表命中次数
+    uint64_t ttCollisions = 0;      // 置换表写入时挤掉其他局面有效条目的次数
+    double ttFillRate = 0.0;        // 置换表填充率（抽样估计，0~1；每轮迭代结束与搜索结束时更新）
+    uint64_t cutoffs = 0;           // beta截断次数
+    uint64_t firstMoveCutoffs = 0;  // 第一个着法即截断的次数
+    std::vector<IterationStats> iterations;
+
+    double ttHitRate() const { return ttProbes > 0 ? static_cast<double>(ttHits) / ttProbes : 0.0; }
+    double firstMoveCutoffRate() const { return cutoffs > 0 ? static_cast<double>(firstMoveCutoffs) / cutoffs : 0.0; }
+    /**
+     * @brief 有效分支因子：最后两轮迭代的节点数之比（不足两轮时为0）
+     */
+    double branchingFactor() const {
+        const size_t n = iterations.size();
+        return n >= 2 && iterations[n - 2].nodes > 0
+            ? static_cast<double>(iterations[n - 1].nodes) / iterations[n - 2].nodes : 0.0;
+    }
+};
+
+/**
+ * @brief 搜索结果
+ */
+struct SearchResult {
+    int row = -1;               // 最佳着法行坐标（-1表示无合法着法）
+    int col = -1;               // 最佳着法列坐标
+    int score = 0;              // 最佳着法得分（落子方视角）
+    int depth = 0;              // 已完成的最大迭代深度
+    uint64_t nodes = 0;         // 搜索节点数
+    int64_t timeMs = 0;         // 实际耗时（毫秒）
+    uint64_t nps = 0;           // 每秒节点数（nodes per second），用于跨版本性能对比
+    std::vector<int> pv;        // 主要变例（格子下标 row*N+col）
+    SearchStats stats;          // 搜索统计（LQHJ_SEARCH_STATS 为0时为空）
+};
+
+/**
+ * @brief 困难AI（Player::Type::AI_Hard）的搜索引擎
+ * 核心算法：
+ * 1. Negamax + Alpha-Beta 剪枝，主要变例搜索（PVS：首个着法全窗口，其余零窗口试探、失败再重搜）；
+ * 2. 迭代加深：深度1、2、3……逐层加深，上一层的最佳着法与置换表结果用于下一层排序；
+ * 3. 期望窗口（Aspiration Window）：以上一层得分为中心开小窗口，失败高/低时逐步放宽；
+ * 4. 置换表：以Board::hash()为键缓存搜索结果；
+ * 5. 着法生成：只考虑距离已有棋子2格以内的空点，按棋型打分排序，并做威胁剪枝
+ *    （能成五直接走、对方成五必堵、对方有活三时只考虑防守点与己方冲四）；
+ * 6. 根节点先调用ThreatSolver求VCF/VCT，找到强制获胜序列则直接返回，不再进入主搜索；
+ * 7. 着法排序：置换表着法 > 必胜/冲四威胁 > 杀手着法 > 反击着法 > 历史分+棋型分（见MoveOrdering）；
+ * 8. 多线程（Lazy SMP）：setThreadCount(N)后，主线程之外再启动N-1个辅助线程，各自独立做迭代加深，
+ *    只通过共享置换表交换信息；辅助线程按线程序号错开（跳过）部分深度，避免所有线程重复搜索同一深度。
+ *    主线程负责时间控制，结束时停止全部辅助线程，取完成深度最大的线程结果。
+ *    辅助线程常驻（与 AiWorker 相同）：创建后在条件变量上等待，每次search()只唤醒与等待，不创建/销毁线程。
+ * 时间控制：每1024个节点检查一次时间/节点预算，超限立即停止并返回最后一次完整迭代的结果，
+ * 保证在预算内总能返回一步棋。
+ * @tparam N 棋盘边长（与BasicBoard<N>一致；SearchEngine为默认15×15、无禁手实例）
+ * @tparam R 规则变体（与BasicBoard<N, R>一致；Renju下黑方不生成禁手点）
+ */
+template <int N, Rule R = Rule::Freestyle>
+class BasicSearchEngine {
+public:
+    /**
+     * @brief 胜负分：成五为 WIN_SCORE - 步数（越快获胜分越高）
+     */
+    static constexpr int WIN_SCORE = 1000000;
+    static constexpr int MAX_PLY = 64;
+    static constexpr int INF = WIN_SCORE + 1;
+
+    /**
+     * @brief 构造函数
+     * @param ttSizeMB 置换表大小（MB）
+     * @param useHugePages 置换表是否请求大页内存（仅Linux生效，见 TranspositionTable）
+     */
+    explicit BasicSearchEngine(size_t ttSizeMB = 32, bool useHugePages = false);
+    ~BasicSearchEngine();
+
+    /**
+     * @brief 执行一次完整搜索（阻塞直到达到限制条件）
+     * @param board 当前局面（内部复制一份，不修改传入棋盘）
+     * @param side 落子方
+     * @param limits 时间/节点/深度限制
+     * @return SearchResult 最佳着法与统计信息
+     */
+    SearchResult search(const BasicBoard<N, R>& board, Config::PieceType side, const SearchLimits& limits);
+
+    /**
+     * @brief 执行一次完整搜索，结果写入调用方提供的对象
+     * 复用 result 中主要变例与迭代统计的缓冲区容量：同一个结果对象反复使用时，预热后单线程搜索全程没有堆分配。
+     * @param result 输出（原内容被覆盖）
+     */
+    void search(const BasicBoard<N, R>& board, Config::PieceType side, const SearchLimits& limits, SearchResult& result);
+
+    /**
+     * @brief 请求停止当前搜索（可在其他线程调用），搜索会尽快返回已有的最佳结果
+     */
+    void stop() { m_stop.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 清空置换表、威胁求解缓存与着法排序启发（新对局开始时调用）
+     */
+    void clear();
+
+    /**
+     * @brief 设置搜索线程数（Lazy SMP），不可与搜索并发调用
+     * @param threads 线程总数（含主线程）；1为单线程，<=0表示使用全部硬件线程
+     */
+    void setThreadCount(int threads);
+
+    /**
+     * @brief 设置静态估值使用的神经网络（nullptr 恢复棋型估值，默认）
+     * 网络由调用方持有，须在引擎使用期间保持加载；所有搜索线程共享同一份只读权重，各自维护增量累加器。
+     * 估值方式变化时清空置换表（缓存的分数来自另一种估值，不再可比）。
+     * @return bool 网络未加载或棋盘大小与 N 不符时返回 false，估值方式保持不变
+     */
+    bool setNetwork(const NnueNetwork* network);
+
+    /**
+     * @brief 当前使用的神经网络（nullptr 表示棋型估值）
+     */
+    const NnueNetwork* network() const { return m_network; }
+
+    /**
+     * @brief 获取搜索线程数（含主线程）
+     */
+    int threadCount() const { return static_cast<int>(m_helpers.size()) + 1; }
+
+    /**
+     * @brief 访问置换表（用于统计或调整大小）
+     */
+    TranspositionTable& transpositionTable() { return m_tt; }
+
+    /**
+     * @brief 获取最近一次搜索的着法排序截断统计（各启发产生的beta截断次数）
+     */
+    const MoveOrderingStats& orderingStats() const { return m_ordering.stats(); }
+
+    /**
+     * @brief 判断分数是否为杀棋分（已搜到必胜/必败）
+     */
+    static bool isWinScore(int score) { return score > WIN_SCORE - MAX_PLY || score < -WIN_SCORE + MAX_PLY; }
+
+private:
+    /**
+     * @brief 带排序分的着法
+     */
+    struct ScoredMove {
+        int cell;
+        int score;
+        bool threat;            // 威胁着法（己方冲四/必胜棋型、堵对方成五），不参与杀手/历史更新
+    };
+
+    static constexpr int MAX_MOVES = N * N;
+    static_assert(MoveOrdering::MAX_PLY >= MAX_PLY, "killer table must cover every search ply");
+
+    /**
+     * @brief 辅助线程构造函数：共享主线程的置换表，不分配自己的表
+     */
+    BasicSearchEngine(TranspositionTable& sharedTT, int helperIndex);
+
+    void iterate(Config::PieceType side, SearchResult& result);
+    void helperLoop();
+    void startHelper(Config::PieceType side);
+    void waitHelper();
+    static bool skipDepth(int depth, int helperIndex);
+    int negamax(int depth, int ply, int alpha, int beta, Config::PieceType side);
+    int searchRoot(int depth, int alpha, int beta, Config::PieceType side);
+    int generateMoves(Config::PieceType side, int ply, ScoredMove* moves, int ttMove, bool& hasWin, bool& mustLose) const;
+    void checkLimits();
+    void updatePv(int ply, int cell);
+    void makeMove(int cell, Config::PieceType side);
+    void unmakeMove(int cell, Config::PieceType side);
+    int staticEval(Config::PieceType side) const;
+
+    static int scoreToTT(int score, int ply);
+    static int scoreFromTT(int score, int ply);
+
+    BasicBoard<N, R> m_board;
+    std::unique_ptr<TranspositionTable> m_ownTT;   // 主线程持有的置换表（辅助线程为空）
+    TranspositionTable& m_tt;                      // 实际使用的置换表（辅助线程指向主线程的表）
+    std::vector<std::unique_ptr<BasicSearchEngine>> m_helpers;
+    int m_helperIndex = 0;                         // 0为主线程，1..N-1为辅助线程
+    BasicThreatSolver<N, R> m_threatSolver;
+    MoveOrdering m_ordering;
+    SearchLimits m_limits;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::atomic<bool> m_stop{false};
+    uint64_t m_nodes = 0;
+    SearchStats m_stats;                           // 本次搜索的统计（仅在 SearchStats::ENABLED 时累计）
+    const NnueNetwork* m_network = nullptr;        // 神经网络估值（为空时使用棋型估值）
+    NnueAccumulator m_accumulator;                 // 与 m_board 同步增量更新的特征累加器（仅 m_network 非空时维护）
+
+    ScoredMove m_moveStack[MAX_PLY + 1][MAX_MOVES];
+    int m_pv[MAX_PLY + 1][MAX_PLY + 1];
+    int m_pvLength[MAX_PLY + 1];
+    int m_playedMove[MAX_PLY + 1];   // 每层实际走出的着法（下一层的“对方上一手”，用于反击着法）
+    int m_rootMoveCount = 0;
+    int m_rootBest = -1;
+
+    /**
+     * @brief 常驻辅助线程的状态（仅辅助实例使用）：主线程准备好棋盘等状态后置m_searchPending并唤醒，
+     * 线程运行iterate()把结果写入m_helperResult（缓冲区跨搜索复用），结束后清除m_searching并通知m_idle
+     */
+    std::mutex m_threadMutex;
+    std::condition_variable m_wake;      // 有新搜索或需要退出
+    std::condition_variable m_idle;      // 本次搜索已返回
+    bool m_searchPending = false;
+    bool m_searching = false;
+    bool m_quit = false;
+    Config::PieceType m_searchSide = Config::PieceType::Black;
+    SearchResult m_helperResult;
+    std::thread m_thread;                // 最后声明：辅助实例构造完毕后才启动
+};
+
+using SearchEngine = BasicSearchEngine<Config::BOARD_SIZE>;
+
+extern template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Standard>;
+extern template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Renju>;
+extern template class BasicSearchEngine<Config::BOARD_SIZE, Rule::Caro>;
+extern template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+extern template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+extern template class BasicSearchEngine<Config::LARGE_BOARD_SIZE, Rule::Caro>;
+
+#endif // SEARCHENGINE_H
@@ -0,0 +1,462 @@
+﻿#include "ThreatSolver.h"
+#include <algorithm>
+#include "../utils/BitUtils.h"
+
+namespace {
+
+/**
+ * @brief 缓存键扰动：区分攻方颜色与求解类型（VCF/VCT）
+ */
+constexpr uint64_t WHITE_ATTACKER_KEY = 0x2D358DCCAA6C78A5ull;
+constexpr uint64_t VCT_KEY = 0x8BB84B93962EACC9ull;
+
+/**
+ * @brief VCT 每个威胁节点内嵌 VCF 检查的深度（攻方连续冲四手数）
+ */
+constexpr int VCF_DEPTH_IN_VCT = 12;
+
+/**
+ * @brief 把提示着法移到着法列表最前面
+ */
+void moveToFront(int* moves, int count, int cell) {
+    for (int i = 0; i < count; ++i) {
+        if (moves[i] == cell) {
+            std::rotate(moves, moves + i, moves + i + 1);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现：按cacheBits分配缓存
+ */
+template <int N, Rule R>
+BasicThreatSolver<N, R>::BasicThreatSolver(int cacheBits)
+    : m_cache(size_t(1) << cacheBits)
+    , m_cacheMask((uint64_t(1) << cacheBits) - 1)
+{
+}
+
+template <int N, Rule R>
+void BasicThreatSolver<N, R>::clear() {
+    std::fill(m_cache.begin(), m_cache.end(), CacheEntry());
+}
+
+/**
+ * @brief 缓存查询
+ * 实现逻辑：已证无解的结果对更小的剩余深度同样成立，直接剪枝；
+ * 已证胜的结果只作为着法提示（winMove排在最前重新验证），以便沿提示快速重建完整变例。
+ * @return bool 是否已证无解
+ */
+template <int N, Rule R>
+bool BasicThreatSolver<N, R>::probeCache(uint64_t key, int depth, int& winMove) const {
+    const CacheEntry& e = m_cache[key & m_cacheMask];
+    winMove = -1;
+    if (e.key != key) {
+        return false;
+    }
+    if (e.win && e.depth <= depth) {
+        winMove = e.move;
+        return false;
+    }
+    return !e.win && e.depth >= depth;
+}
+
+template <int N, Rule R>
+void BasicThreatSolver<N, R>::storeCache(uint64_t key, int depth, bool win, int move) {
+    CacheEntry& e = m_cache[key & m_cacheMask];
+    e.key = key;
+    e.depth = static_cast<int16_t>(depth);
+    e.move = static_cast<int16_t>(move);
+    e.win = win;
+}
+
+template <int N, Rule R>
+void BasicThreatSolver<N, R>::push(int cell, Config::PieceType color) {
+    m_board.makeMove(cell / N, cell % N, color);
+    m_path[m_pathLength++] = cell;
+}
+
+template <int N, Rule R>
+void BasicThreatSolver<N, R>::pop() {
+    --m_pathLength;
+    m_board.unmakeMove();
+}
+
+/**
+ * @brief 记录获胜变例：当前路径 + 守方堵一端（活四/双四时，block>=0）+ 攻方成五点
+ * 后记录的覆盖先记录的：证明树按“或节点找到即返回、与节点最后一个守法也必须成立”展开，
+ * 因此最后一次记录的叶子一定位于最终成立的那棵证明子树上。
+ */
+template <int N, Rule R>
+void BasicThreatSolver<N, R>::recordWin(int block, int fivePoint) {
+    std::copy(m_path, m_path + m_pathLength, m_winLine);
+    m_winLineLength = m_pathLength;
+    if (block >= 0) {
+        m_winLine[m_winLineLength++] = block;
+    }
+    m_winLine[m_winLineLength++] = fivePoint;
+}
+
+/**
+ * @brief 判断在cell落子后，任一方向能否形成不低于minPattern的棋型
+ */
+template <int N, Rule R>
+bool BasicThreatSolver<N, R>::makesPattern(int cell, Config::PieceType color, PatternType minPattern) const {
+    const int r = cell / N;
+    const int c = cell % N;
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        if (m_board.pattern(r, c, dir, color) >= minPattern) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 收集color方能形成不低于minPattern棋型的空点
+ * 实现逻辑：冲四点/活三点一定在己方棋子2格以内，因此只扫描己方棋子位掩码膨胀2格后的空点（不含color方的禁手点）；
+ * 结果按棋型从高到低排序（成五 > 活四 > 冲四 > 活三），同级按格子下标升序。
+ * @return int 空点数量
+ */
+template <int N, Rule R>
+int BasicThreatSolver<N, R>::collectMoves(Config::PieceType color, PatternType minPattern, int* out) const {
+    struct Ranked { int cell; int rank; };
+    Ranked ranked[N * N];
+    int count = 0;
+
+    uint32_t own[N];
+    for (int r = 0; r < N; ++r) {
+        own[r] = m_board.rowMask(color, r);
+    }
+    for (int r = 0; r < N; ++r) {
+        uint32_t near = 0;
+        for (int rr = std::max(0, r - 2); rr <= std::min(N - 1, r + 2); ++rr) {
+            near |= own[rr];
+        }
+        near = (near | (near << 1) | (near << 2) | (near >> 1) | (near >> 2)) & m_board.playableRow(color, r);
+        while (near) {
+            const int c = BitUtils::countTrailingZeros(near);
+            near &= near - 1;
+            PatternType best = PatternType::None;
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                best = std::max(best, m_board.pattern(r, c, dir, color));
+            }
+            if (best >= minPattern) {
+                ranked[count++] = { r * N + c, static_cast<int>(best) };
+            }
+        }
+    }
+    // 同级按格子下标排序：与按扫描顺序的稳定排序结果相同，且不像 std::stable_sort 那样申请临时缓冲区
+    std::sort(ranked, ranked + count, [](const Ranked& a, const Ranked& b) {
+        return a.rank != b.rank ? a.rank > b.rank : a.cell < b.cell;
+    });
+    for (int i = 0; i < count; ++i) {
+        out[i] = ranked[i].cell;
+    }
+    return count;
+}
+
+/**
+ * @brief 查找color方的成五点
+ * 实现逻辑：around>=0时只检查经过around的四条线上±4范围（新形成的成五点必然在刚落子的线上），
+ * around<0时全盘扫描（仅根节点使用）。
+ * @return int 成五点数量（≥2即为活四/双四，对方无法同时封堵）
+ */
+template <int N, Rule R>
+int BasicThreatSolver<N, R>::findFivePoints(Config::PieceType color, int around, int* out) const {
+    if (around < 0) {
+        return collectMoves(color, PatternType::Five, out);
+    }
+    int count = 0;
+    const int row = around / N;
+    const int col = around % N;
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS; ++k) {
+            const int r = row + k * DIR_DR[dir];
+            const int c = col + k * DIR_DC[dir];
+            if (k == 0 || r < 0 || r >= N || c < 0 || c >= N) {
+                continue;
+            }
+            if (m_board.getPiece(r, c) == Config::PieceType::None && m_board.pattern(r, c, dir, color) == PatternType::Five) {
+                out[count++] = r * N + c;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief VCF递归实现（攻方行棋）
+ * 实现逻辑：
+ * Step1：攻方已有成五点 → 胜；
+ * Step2：守方上一手堵点恰好形成冲四 → 攻方只能堵它，且该堵点本身必须也是攻方冲四点，否则VCF中断；
+ * Step3：查缓存；依次尝试每个冲四点：冲四后若成五点≥2（活四/双四）即胜，
+ *        否则守方堵唯一成五点（该点是守方禁手则无法封堵，即胜），递归求解剩余深度。
+ */
+template <int N, Rule R>
+bool BasicThreatSolver<N, R>::vcf(Config::PieceType attacker, int depth, int lastDefense) {
+    ++m_nodes;
+    const Config::PieceType defender = Config::opponent(attacker);
+    int points[N * N];
+
+    if (m_board.threatCount(attacker, PatternType::Five) > 0) {
+        if (findFivePoints(attacker, -1, points) > 0) {
+            recordWin(-1, points[0]);
+        }
+        return true;
+    }
+
+    int forced = -1;
+    if (m_board.threatCount(defender, PatternType::Five) > 0) {
+        const int n = findFivePoints(defender, lastDefense, points);
+        if (n != 1 || isForbidden(points[0], attacker) || !makesPattern(points[0], attacker, PatternType::Four)) {
+            return false;
+        }
+        forced = points[0];
+    }
+    if (depth <= 0 || outOfBudget() || m_pathLength + 3 >= MAX_LINE) {
+        return false;
+    }
+
+    const uint64_t key = m_board.hash() ^ (attacker == Config::PieceType::White ? WHITE_ATTACKER_KEY : 0);
+    int hint = -1;
+    if (probeCache(key, depth, hint)) {
+        return false;
+    }
+
+    int moves[N * N];
+    int count = 0;
+    if (forced >= 0) {
+        moves[count++] = forced;
+    } else {
+        count = collectMoves(attacker, PatternType::Four, moves);
+        moveToFront(moves, count, hint);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        push(moves[i], attacker);
+        const int n = findFivePoints(attacker, moves[i], points);
+        bool win = false;
+        if (n >= 2) {
+            recordWin(points[1], points[0]);
+            win = true;
+        } else if (n == 1 && isForbidden(points[0], defender)) {
+            recordWin(-1, points[0]);  // 守方唯一的封堵点是禁手，无法封堵
+            win = true;
+        } else if (n == 1) {
+            push(points[0], defender);
+            win = vcf(attacker, depth - 1, points[0]);
+            pop();
+        }
+        pop();
+        if (win) {
+            storeCache(key, depth, true, moves[i]);
+            return true;
+        }
+    }
+    if (!outOfBudget()) {
+        storeCache(key, depth, false, -1);
+    }
+    return false;
+}
+
+/**
+ * @brief VCT攻方节点实现
+ * 实现逻辑：
+ * Step1：攻方已有成五点 → 胜；守方已有成五点 → 放弃（保守处理）；
+ * Step2：先求VCF，成立即胜；
+ * Step3：查缓存；依次尝试每个冲四/活三点，交给守方节点验证所有守法。
+ */
+template <int N, Rule R>
+bool BasicThreatSolver<N, R>::vctAttack(Config::PieceType attacker, int depth) {
+    ++m_nodes;
+    const Config::PieceType defender = Config::opponent(attacker);
+    if (m_board.threatCount(defender, PatternType::Five) > 0 && m_board.threatCount(attacker, PatternType::Five) == 0) {
+        return false;
+    }
+    if (vcf(attacker, VCF_DEPTH_IN_VCT, -1)) {
+        return true;
+    }
+    if (depth <= 0 || outOfBudget() || m_pathLength + 4 >= MAX_LINE) {
+        return false;
+    }
+
+    const uint64_t key = m_board.hash() ^ VCT_KEY ^ (attacker == Config::PieceType::White ? WHITE_ATTACKER_KEY : 0);
+    int hint = -1;
+    if (probeCache(key, depth, hint)) {
+        return false;
+    }
+
+    int moves[N * N];
+    const int count = collectMoves(attacker, PatternType::OpenThree, moves);
+    moveToFront(moves, count, hint);
+    for (int i = 0; i < count; ++i) {
+        push(moves[i], attacker);
+        const bool win = vctDefend(attacker, depth - 1, moves[i]);
+        pop();
+        if (win) {
+            storeCache(key, depth, true, moves[i]);
+            return true;
+        }
+    }
+    if (!outOfBudget()) {
+        storeCache(key, depth, false, -1);
+    }
+    return false;
+}
+
+/**
+ * @brief VCT守方节点实现（攻方刚走出威胁着法lastAttack）
+ * 实现逻辑：
+ * Step1：守方能直接成五 → 攻击失败；
+ * Step2：攻方成五点≥2 → 胜；恰有1个 → 守方只能堵（堵点是守方禁手则胜），然后回到攻方节点；
+ * Step3：攻方没有形成活三（不存在活四点）→ 不构成威胁，失败；守方有VCF反杀 → 失败；
+ * Step4：枚举全部守法——攻方的冲四/活四点（封堵，去掉守方禁手点）与守方的冲四点（反击）；
+ *        守方反冲四时攻方必须先堵，再回到守方节点；任一守法成立即攻击失败。
+ */
+template <int N, Rule R>
+bool BasicThreatSolver<N, R>::vctDefend(Config::PieceType attacker, int depth, int lastAttack) {
+    ++m_nodes;
+    const Config::PieceType defender = Config::opponent(attacker);
+    if (m_board.threatCount(defender, PatternType::Five) > 0) {
+        return false;
+    }
+
+    int points[N * N];
+    const int n = findFivePoints(attacker, lastAttack, points);
+    if (n >= 2) {
+        recordWin(points[1], points[0]);
+        return true;
+    }
+    if (n == 1 && isForbidden(points[0], defender)) {
+        recordWin(-1, points[0]);
+        return true;
+    }
+    if (n == 1) {
+        push(points[0], defender);
+        const bool win = vctAttack(attacker, depth);
+        pop();
+        return win;
+    }
+
+    if (m_board.threatCount(attacker, PatternType::OpenFour) == 0 || outOfBudget()) {
+        return false;
+    }
+    const int savedLength = m_pathLength;
+    int savedLine[MAX_LINE + 2];
+    const int savedLineLength = m_winLineLength;
+    std::copy(m_winLine, m_winLine + savedLineLength, savedLine);
+    const bool defenderVcf = vcf(defender, VCF_DEPTH_IN_VCT, -1);
+    std::copy(savedLine, savedLine + savedLineLength, m_winLine);
+    m_winLineLength = savedLineLength;
+    m_pathLength = savedLength;
+    if (defenderVcf) {
+        return false;
+    }
+
+    int replies[2 * N * N];
+    int count = collectMoves(attacker, PatternType::Four, replies);
+    if constexpr (R == Rule::Renju) {
+        count = static_cast<int>(std::remove_if(replies, replies + count,
+                                                [this, defender](int cell) { return isForbidden(cell, defender); }) - replies);
+    }
+    int counters[N * N];
+    const int counterCount = collectMoves(defender, PatternType::Four, counters);
+    for (int i = 0; i < counterCount; ++i) {
+        if (std::find(replies, replies + count, counters[i]) == replies + count) {
+            replies[count++] = counters[i];
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        push(replies[i], defender);
+        bool win;
+        const int dn = findFivePoints(defender, replies[i], points);
+        if (dn >= 2) {
+            win = false;
+        } else if (dn == 1 && isForbidden(points[0], attacker)) {
+            win = false;
+        } else if (dn == 1) {
+            push(points[0], attacker);
+            win = vctDefend(attacker, depth, points[0]);
+            pop();
+        } else {
+            win = vctAttack(attacker, depth);
+        }
+        pop();
+        if (!win) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief VCF查询入口：复制棋盘、清空变例，成功时返回第一手与完整变例
+ */
+template <int N, Rule R>
+ThreatResult BasicThreatSolver<N, R>::solveVCF(const BasicBoard<N, R>& board, Config::PieceType attacker, int maxDepth) {
+    m_board = board;
+    m_nodes = 0;
+    m_pathLength = 0;
+    m_winLineLength = 0;
+
+    ThreatResult result;
+    result.found = vcf(attacker, maxDepth, -1);
+    result.nodes = m_nodes;
+    if (result.found && m_winLineLength > 0) {
+        result.line.assign(m_winLine, m_winLine + m_winLineLength);
+        result.row = m_winLine[0] / N;
+        result.col = m_winLine[0] % N;
+    } else {
+        result.found = false;
+    }
+    return result;
+}
+
+/**
+ * @brief VCT查询入口：同solveVCF，变例为证明树中的一条分支
+ */
+template <int N, Rule R>
+ThreatResult BasicThreatSolver<N, R>::solveVCT(const BasicBoard<N, R>& board, Config::PieceType attacker, int maxDepth) {
+    m_board = board;
+    m_nodes = 0;
+    m_pathLength = 0;
+    m_winLineLength = 0;
+
+    ThreatResult result;
+    result.found = vctAttack(attacker, maxDepth);
+    result.nodes = m_nodes;
+    if (result.found && m_winLineLength > 0) {
+        result.line.assign(m_winLine, m_winLine + m_winLineLength);
+        result.row = m_winLine[0] / N;
+        result.col = m_winLine[0] % N;
+    } else {
+        result.found = false;
+    }
+    return result;
+}
+
+template <int N, Rule R>
+ThreatResult BasicThreatSolver<N, R>::findForcedWin(const BasicBoard<N, R>& board, Config::PieceType attacker) {
+    ThreatResult result = solveVCF(board, attacker);
+    if (result.found) {
+        return result;
+    }
+    const uint64_t vcfNodes = result.nodes;
+    result = solveVCT(board, attacker);
+    result.nodes += vcfNodes;
+    return result;
+}
+
+template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Freestyle>;
+template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Standard>;
+template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Renju>;
+template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Caro>;
+template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Caro>;
@@ -0,0 +1,135 @@
+﻿#pragma once
+#ifndef THREATSOLVER_H
+#define THREATSOLVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "../game/Board.h"
+
+/**
+ * @brief 威胁空间搜索结果
+ */
+struct ThreatResult {
+    bool found = false;         // 是否找到必胜序列
+    int row = -1;               // 必胜序列的第一手（攻方着法）行坐标
+    int col = -1;               // 第一手列坐标
+    std::vector<int> line;      // 一条必胜变例（攻守交替的格子下标 row*N+col）
+    uint64_t nodes = 0;         // 搜索节点数
+};
+
+/**
+ * @brief VCF/VCT 威胁空间求解器
+ * 核心职责：回答“攻方是否存在强制获胜序列”，供AI在主搜索前调用，也可单独作为必胜查询使用。
+ * 1. VCF（Victory by Continuous Fours，连续冲四胜）：攻方每一手都冲四，守方只能堵唯一成五点，
+ *    直到攻方形成活四/双四或直接成五；
+ * 2. VCT（Victory by Continuous Threats，连续威胁胜）：攻方每一手冲四或做活三，
+ *    守方可以封堵（攻方再下一手能成四的点）或反冲四；活三阶段先检查守方是否有VCF反杀，
+ *    所有守法都被攻破才算必胜。
+ * 实现要点：
+ * - 只在攻方棋子2格范围内枚举冲四/活三点，依赖Board增量棋型表，一次判断只查表；
+ * - 自带小型哈希缓存（按局面哈希+攻方+求解类型索引），记录“在剩余深度d内已证无解”（直接剪枝）
+ *   与“已证胜”（保存获胜着法，作为排序提示重新验证，保证返回完整变例）；
+ * - 节点上限保证单次查询耗时可控（默认20万节点，通常在数毫秒内完成）。
+ * @tparam N 棋盘边长（与BasicBoard<N>一致）
+ * @tparam R 规则变体（Renju下黑方的进攻点与防守点都排除禁手；守方唯一的防守点是禁手时攻方直接获胜）
+ */
+template <int N, Rule R = Rule::Freestyle>
+class BasicThreatSolver {
+public:
+    /**
+     * @brief 构造函数
+     * @param cacheBits 缓存条目数的以2为底的对数（默认2^16个条目，约1MB）
+     */
+    explicit BasicThreatSolver(int cacheBits = 16);
+
+    /**
+     * @brief 求解VCF
+     * @param board 当前局面（内部复制，不修改传入棋盘）
+     * @param attacker 攻方（即当前落子方）
+     * @param maxDepth 攻方最多连续冲四的手数
+     */
+    ThreatResult solveVCF(const BasicBoard<N, R>& board, Config::PieceType attacker, int maxDepth = 30);
+
+    /**
+     * @brief 求解VCT（内部包含VCF）
+     * @param board 当前局面
+     * @param attacker 攻方（即当前落子方）
+     * @param maxDepth 攻方最多连续威胁的手数
+     */
+    ThreatResult solveVCT(const BasicBoard<N, R>& board, Config::PieceType attacker, int maxDepth = 8);
+
+    /**
+     * @brief 必胜查询：先求VCF，失败再求VCT
+     */
+    ThreatResult findForcedWin(const BasicBoard<N, R>& board, Config::PieceType attacker);
+
+    /**
+     * @brief 设置单次查询的节点上限（0表示不限）
+     */
+    void setNodeLimit(uint64_t nodes) { m_nodeLimit = nodes; }
+
+    /**
+     * @brief 设置外部停止标志（如SearchEngine的停止标志），置位后查询尽快返回“未找到”
+     */
+    void setStopFlag(const std::atomic<bool>* stop) { m_stopFlag = stop; }
+
+    /**
+     * @brief 清空缓存（新对局开始时调用）
+     */
+    void clear();
+
+private:
+    static constexpr int MAX_LINE = 128;
+
+    struct CacheEntry {
+        uint64_t key = 0;
+        int16_t depth = 0;
+        int16_t move = -1;      // 已证胜时的获胜着法
+        bool win = false;
+    };
+
+    bool vcf(Config::PieceType attacker, int depth, int lastDefense);
+    bool vctAttack(Config::PieceType attacker, int depth);
+    bool vctDefend(Config::PieceType attacker, int depth, int lastAttack);
+
+    int collectMoves(Config::PieceType color, PatternType minPattern, int* out) const;
+    int findFivePoints(Config::PieceType color, int around, int* out) const;
+    bool makesPattern(int cell, Config::PieceType color, PatternType minPattern) const;
+    bool isForbidden(int cell, Config::PieceType color) const { return m_board.isForbidden(cell / N, cell % N, color); }
+
+    bool probeCache(uint64_t key, int depth, int& winMove) const;
+    void storeCache(uint64_t key, int depth, bool win, int move);
+
+    void push(int cell, Config::PieceType color);
+    void pop();
+    void recordWin(int block, int fivePoint);
+    bool outOfBudget() const {
+        return (m_nodeLimit && m_nodes >= m_nodeLimit) || (m_stopFlag && m_stopFlag->load(std::memory_order_relaxed));
+    }
+
+    BasicBoard<N, R> m_board;
+    std::vector<CacheEntry> m_cache;
+    uint64_t m_cacheMask = 0;
+    uint64_t m_nodes = 0;
+    uint64_t m_nodeLimit = 200000;
+    const std::atomic<bool>* m_stopFlag = nullptr;
+
+    int m_path[MAX_LINE];
+    int m_pathLength = 0;
+    int m_winLine[MAX_LINE + 2];    // 最近记录的获胜变例（路径 + 堵点 + 成五点），定长避免搜索中分配
+    int m_winLineLength = 0;
+};
+
+using ThreatSolver = BasicThreatSolver<Config::BOARD_SIZE>;
+
+extern template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Standard>;
+extern template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Renju>;
+extern template class BasicThreatSolver<Config::BOARD_SIZE, Rule::Caro>;
+extern template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+extern template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+extern template class BasicThreatSolver<Config::LARGE_BOARD_SIZE, Rule::Caro>;
+
+#endif // THREATSOLVER_H
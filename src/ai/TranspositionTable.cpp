@@ -0,0 +1,223 @@
+﻿#include "TranspositionTable.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief 64位乘法取高64位：把哈希均匀映射到[0, n)，桶数无需是2的幂
+ */
+inline uint64_t mulHigh(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER)
+    return __umulh(a, b);
+#else
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#endif
+}
+
+constexpr size_t HUGE_PAGE_SIZE = 2u * 1024u * 1024u;
+
+inline int unpackScore(uint64_t d) { return static_cast<int32_t>(static_cast<uint32_t>(d)); }
+inline int unpackMove(uint64_t d) { return static_cast<int>((d >> 32) & 0xFFFFu) - 1; }
+inline int unpackDepth(uint64_t d) { return static_cast<int>((d >> 48) & 0xFFu); }
+inline TTBound unpackBound(uint64_t d) { return static_cast<TTBound>((d >> 56) & 0x3u); }
+inline uint8_t unpackAge(uint64_t d) { return static_cast<uint8_t>((d >> 58) & 0x3Fu); }
+
+} // namespace
+
+/**
+ * @brief 构造函数实现：按给定大小分配表空间
+ */
+TranspositionTable::TranspositionTable(size_t sizeMB, bool useHugePages) {
+    resize(sizeMB, useHugePages);
+}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+/**
+ * @brief 释放表空间：大页分配走free()，普通分配走对齐版operator delete
+ */
+void TranspositionTable::release() {
+    if (!m_buckets) {
+        return;
+    }
+    if (m_hugePages) {
+        std::free(m_buckets);
+    } else {
+        ::operator delete(m_buckets, std::align_val_t(alignof(Bucket)));
+    }
+    m_buckets = nullptr;
+    m_bucketCount = 0;
+    m_hugePages = false;
+}
+
+/**
+ * @brief 重新分配表空间实现
+ * 实现逻辑：
+ * Step1：释放旧空间，按sizeMB计算桶数（至少1个桶）；
+ * Step2：Linux且请求大页时，按2MB对齐分配并madvise(MADV_HUGEPAGE)；分配失败或内核拒绝（未启用透明大页时返回EINVAL）
+ *        则释放并回退到普通分配，usingHugePages()只在madvise成功时为true；
+ * Step3：其余情况按缓存行（64字节）对齐分配；
+ * Step4：清空全部条目。
+ */
+void TranspositionTable::resize(size_t sizeMB, bool useHugePages) {
+    release();
+    m_bucketCount = sizeMB * 1024u * 1024u / sizeof(Bucket);
+    if (m_bucketCount == 0) {
+        m_bucketCount = 1;
+    }
+    const size_t bytes = m_bucketCount * sizeof(Bucket);
+
+#if defined(__linux__)
+    if (useHugePages) {
+        const size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void* mem = nullptr;
+        if (posix_memalign(&mem, HUGE_PAGE_SIZE, rounded) == 0) {
+            if (madvise(mem, rounded, MADV_HUGEPAGE) == 0) {
+                m_buckets = static_cast<Bucket*>(mem);
+                m_hugePages = true;
+            } else {
+                std::free(mem);
+            }
+        }
+    }
+#else
+    (void)useHugePages;
+    (void)HUGE_PAGE_SIZE;
+#endif
+
+    if (!m_buckets) {
+        m_buckets = static_cast<Bucket*>(::operator new(bytes, std::align_val_t(alignof(Bucket))));
+    }
+    clear();
+}
+
+/**
+ * @brief 清空实现：整块内存置零（data为0即空条目），世代号归零
+ */
+void TranspositionTable::clear() {
+    std::memset(static_cast<void*>(m_buckets), 0, m_bucketCount * sizeof(Bucket));
+    m_age = 0;
+}
+
+void TranspositionTable::newSearch() {
+    m_age = static_cast<uint8_t>((m_age + 1) & 0x3F);
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const {
+    return m_buckets[mulHigh(key, m_bucketCount)];
+}
+
+/**
+ * @brief 打包条目数据
+ * 位布局：[0,32) 得分 | [32,48) 着法+1 | [48,56) 深度 | [56,58) 边界 | [58,64) 世代
+ * 边界不为None，因此有效条目的data必不为0。
+ */
+uint64_t TranspositionTable::pack(int score, int depth, TTBound bound, int move, uint8_t age) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(score))
+         | (static_cast<uint64_t>(static_cast<uint16_t>(move + 1)) << 32)
+         | (static_cast<uint64_t>(depth < 0 ? 0 : (depth > 255 ? 255 : depth)) << 48)
+         | (static_cast<uint64_t>(bound) << 56)
+         | (static_cast<uint64_t>(age & 0x3F) << 58);
+}
+
+/**
+ * @brief 查询实现
+ * 实现逻辑：遍历桶内4个条目，读出(key^data)与data，二者异或等于key才算命中，
+ * 因此并发写造成的半新半旧条目不会被误用。
+ */
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) const {
+    const Bucket& bucket = bucketFor(key);
+    for (const Slot& slot : bucket.entries) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            out.score = unpackScore(data);
+            out.move = unpackMove(data);
+            out.depth = unpackDepth(data);
+            out.bound = unpackBound(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 写入实现
+ * 实现逻辑：
+ * Step1：桶内已有同一局面——旧条目为本世代且明显更深（深度差>2）、新结果又不是精确值时保留旧条目，
+ *        但新结果带着法而旧条目没有时补上着法；否则覆盖；
+ * Step2：否则选择替换目标：空条目优先，其次是“深度 - 8×世代差”最小的条目；
+ * Step3：写入目标条目，返回是否挤掉了其他局面的有效条目。
+ */
+bool TranspositionTable::store(uint64_t key, int score, int depth, TTBound bound, int move) {
+    Bucket& bucket = bucketFor(key);
+    Slot* target = nullptr;
+    int worstPriority = 1 << 30;
+
+    for (Slot& slot : bucket.entries) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            if (bound != TTBound::Exact && unpackAge(data) == m_age && unpackDepth(data) > depth + 2) {
+                if (move >= 0 && unpackMove(data) < 0) {
+                    const uint64_t patched = pack(unpackScore(data), unpackDepth(data), unpackBound(data), move, m_age);
+                    slot.data.store(patched, std::memory_order_relaxed);
+                    slot.keyXorData.store(key ^ patched, std::memory_order_relaxed);
+                }
+                return false;
+            }
+            if (move < 0) {
+                move = unpackMove(data);
+            }
+            target = &slot;
+            break;
+        }
+        const int ageDiff = (m_age - unpackAge(data)) & 0x3F;
+        const int priority = data == 0 ? -(1 << 29) : unpackDepth(data) - 8 * ageDiff;
+        if (priority < worstPriority) {
+            worstPriority = priority;
+            target = &slot;
+        }
+    }
+
+    const uint64_t old = target->data.load(std::memory_order_relaxed);
+    const bool collision = old != 0 && (target->keyXorData.load(std::memory_order_relaxed) ^ old) != key;
+    const uint64_t data = pack(score, depth, bound, move, m_age);
+    target->data.store(data, std::memory_order_relaxed);
+    target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    return collision;
+}
+
+void TranspositionTable::prefetch(uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&bucketFor(key));
+#else
+    (void)key;
+#endif
+}
+
+/**
+ * @brief 填充率实现：抽样前1000个桶，统计非空条目占比
+ */
+double TranspositionTable::fillRate() const {
+    const size_t sample = m_bucketCount < 1000 ? m_bucketCount : 1000;
+    size_t used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (const Slot& slot : m_buckets[i].entries) {
+            used += slot.data.load(std::memory_order_relaxed) != 0;
+        }
+    }
+    return sample ? static_cast<double>(used) / static_cast<double>(sample * BUCKET_SIZE) : 0.0;
+}
@@ -0,0 +1,135 @@
+﻿#pragma once
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 置换表条目的边界类型
+ * - None：空条目；
+ * - Exact：精确值（PV节点）；
+ * - Lower：下界（发生beta截断，真实值 ≥ score）；
+ * - Upper：上界（所有走法都未超过alpha，真实值 ≤ score）。
+ */
+enum class TTBound : uint8_t { None, Exact, Lower, Upper };
+
+/**
+ * @brief 置换表查询结果（由probe()解包得到）
+ */
+struct TTEntry {
+    int score = 0;              // 搜索得分（由搜索层负责杀棋分的层数换算）
+    int move = -1;              // 最佳着法的格子下标（row*BOARD_SIZE+col），-1表示无
+    int depth = 0;              // 搜索深度
+    TTBound bound = TTBound::None;
+};
+
+/**
+ * @brief 固定大小、无锁的置换表（以Board::hash()为键）
+ * 核心职责：缓存搜索过的局面结果（得分、边界、深度、最佳着法），供AI搜索复用转置局面。
+ * 内存布局：
+ * 1. 每个条目16字节：{ key^data, data }，data把得分/着法/深度/边界/世代打包进一个64位整数；
+ * 2. 每4个条目组成一个64字节的桶（Bucket），恰好占一条缓存行，一次查询只访问一条缓存行。
+ * 并发模型（无锁、XOR校验）：
+ * - 读写均为relaxed原子操作，不加锁；写入时先写data再写key^data；
+ * - 读取时只有 (key^data) ^ data == key 才视为命中，多线程交错写导致的“撕裂”条目会被自动丢弃。
+ * 替换策略：同一局面直接覆盖（除非旧条目更深且同一世代）；否则替换桶内“深度 - 8×世代差”最小的条目。
+ * 大页内存：Linux下可选按2MB对齐分配并madvise(MADV_HUGEPAGE)，降低TLB缺失。
+ * 表本身不计数：查询/命中/冲突次数由调用方按返回值累计在各自线程的普通计数器里（见 SearchStats），
+ * 热路径上没有共享的原子计数。
+ */
+class TranspositionTable {
+public:
+    /**
+     * @brief 构造函数
+     * @param sizeMB 表大小（MB），向下取整到桶大小的整数倍
+     * @param useHugePages 是否请求大页内存（仅Linux生效）
+     */
+    explicit TranspositionTable(size_t sizeMB = 64, bool useHugePages = false);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief 重新分配表空间（会清空所有条目），不可与搜索并发调用
+     * @param sizeMB 表大小（MB）
+     * @param useHugePages 是否请求大页内存（仅Linux生效）
+     */
+    void resize(size_t sizeMB, bool useHugePages = false);
+
+    /**
+     * @brief 清空所有条目
+     */
+    void clear();
+
+    /**
+     * @brief 新一轮搜索开始时调用：世代号+1，使旧条目优先被替换
+     */
+    void newSearch();
+
+    /**
+     * @brief 查询局面
+     * @param key 局面哈希
+     * @param out 命中时写入解包后的条目
+     * @return bool 是否命中
+     */
+    bool probe(uint64_t key, TTEntry& out) const;
+
+    /**
+     * @brief 写入局面
+     * @param key 局面哈希
+     * @param score 得分
+     * @param depth 搜索深度（0~255）
+     * @param bound 边界类型
+     * @param move 最佳着法格子下标（-1表示无）
+     * @return bool 是否挤掉了其他局面的有效条目（下标冲突）
+     */
+    bool store(uint64_t key, int score, int depth, TTBound bound, int move);
+
+    /**
+     * @brief 预取目标桶所在缓存行（落子后、递归前调用，隐藏内存延迟）
+     */
+    void prefetch(uint64_t key) const;
+
+    /**
+     * @brief 填充率：按前1000个桶抽样估算非空条目占比
+     */
+    double fillRate() const;
+
+    /**
+     * @brief 表大小（字节）
+     */
+    size_t sizeBytes() const { return m_bucketCount * sizeof(Bucket); }
+
+    /**
+     * @brief 是否成功启用了大页内存（请求了大页且内核接受了madvise(MADV_HUGEPAGE)）
+     */
+    bool usingHugePages() const { return m_hugePages; }
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+
+    struct Slot {
+        std::atomic<uint64_t> keyXorData{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    struct alignas(64) Bucket {
+        Slot entries[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    Bucket& bucketFor(uint64_t key) const;
+    void release();
+
+    static uint64_t pack(int score, int depth, TTBound bound, int move, uint8_t age);
+
+    Bucket* m_buckets = nullptr;
+    size_t m_bucketCount = 0;
+    bool m_hugePages = false;
+    uint8_t m_age = 0;
+};
+
+#endif // TRANSPOSITIONTABLE_H
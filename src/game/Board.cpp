@@ -1,90 +1,1028 @@
 ﻿#include "Board.h"
+#include <algorithm>
+#include <cstring>
+#include "../utils/BitUtils.h"
+
+namespace {
+
+/**
+ * @brief 在一条线的位掩码中判断是否存在经过第pos位的五连
+ * 实现逻辑：five = m & (m>>1) & (m>>2) & (m>>3) & (m>>4) 的第i位表示从第i位起连续5子，
+ * 只要起点落在[pos-4, pos]区间内，该五连就经过pos。
+ * @param mask 一条线上某种颜色的位掩码
+ * @param pos 落子点在该线上的位序号
+ * @return bool 是否存在经过pos的五连（长连同样计为获胜）
+ */
+inline bool hasFiveThrough(unsigned mask, int pos) {
+    const unsigned five = mask & (mask >> 1) & (mask >> 2) & (mask >> 3) & (mask >> 4);
+    const int low = pos >= 4 ? pos - 4 : 0;
+    const unsigned window = ((1u << (pos - low + 1)) - 1u) << low;
+    return (five & window) != 0;
+}
+
+/**
+ * @brief 一条线的位掩码中经过第pos位的连续棋子数（pos位必须有子）
+ */
+inline int runThrough(unsigned mask, int pos) {
+    int len = 1;
+    for (int i = pos - 1; i >= 0 && ((mask >> i) & 1u); --i) ++len;
+    for (int i = pos + 1; (mask >> i) & 1u; ++i) ++len;
+    return len;
+}
+
+/**
+ * @brief Caro成五判断：经过第pos位的连子不少于5，且两端不同时为对方棋子（端点在线外时视为未堵）
+ * @param own 一条线上落子方的位掩码（pos位必须有子）
+ * @param opp 同一条线上对方的位掩码
+ */
+inline bool hasUnblockedFiveThrough(unsigned own, unsigned opp, int pos) {
+    int low = pos;
+    while (low > 0 && ((own >> (low - 1)) & 1u)) --low;
+    int high = pos;
+    while ((own >> (high + 1)) & 1u) ++high;
+    if (high - low + 1 < 5) {
+        return false;
+    }
+    return !(low > 0 && ((opp >> (low - 1)) & 1u) && ((opp >> (high + 1)) & 1u));
+}
+
+/**
+ * @brief 11格线段（偏移-5~+5，第i位对应偏移i-5，中心为黑子）是否为经过中心的活四
+ * 活四即恰好两个成五点且相距5格；成五点是落下后经过中心的连续黑子恰好为5的空点（偏移-4~+4）。
+ * 连续段碰到第±5格时至少6连，因此11格足以判断恰好五连。
+ * @param black 黑子位
+ * @param empty 空点位（棋盘外既不是黑子也不是空点）
+ */
+inline bool isStraightFourLine(unsigned black, unsigned empty) {
+    constexpr int CENTER = PatternCode::WINDOW_RADIUS + 1;
+    int first = -1;
+    int count = 0;
+    for (int i = 1; i < 2 * CENTER; ++i) {
+        if (!((empty >> i) & 1u)) {
+            continue;
+        }
+        const unsigned line = black | (1u << i);
+        int low = CENTER;
+        int high = CENTER;
+        while (low > 0 && ((line >> (low - 1)) & 1u)) --low;
+        while (high < 2 * CENTER && ((line >> (high + 1)) & 1u)) ++high;
+        if (high - low + 1 == 5 && low <= i && i <= high) {
+            first = count == 0 ? i : first;
+            if (++count > 2 || (count == 2 && i - first != 5)) {
+                return false;
+            }
+        }
+    }
+    return count == 2;
+}
+
+/**
+ * @brief 一行的全部格子位
+ */
+template <int N>
+constexpr unsigned ROW_FULL = (1u << N) - 1u;
+
+/**
+ * @brief 连珠禁手的完整判定（黑方）
+ * 直接在两色的行位掩码副本上逐线计数，并递归检查假活三：
+ * 一个方向算作活三，当且仅当该方向上存在一个空点，落下后形成活四，且该空点本身不是禁手。
+ * 棋型表只作必要条件过滤：窗口看不到第±5格，表中的四、活三、活四只会多于实际，
+ * 因此表判为“没有”的方向与成活四点可以直接跳过，逐线计数只在表判为“有”时进行。
+ * 增量禁手位只对少数待定点调用它（见 resolvePendingForbidden()），裁决落子时也直接调用；
+ * 判定过程中的读取依赖记录在 deps() 中：不在依赖线段上的落子/提子不会改变这次判定的结论。
+ * @tparam N 棋盘边长
+ */
+template <int N>
+class RenjuArbiter {
+public:
+    /**
+     * @param black 黑方行位掩码（N行，会被复制）
+     * @param white 白方行位掩码（N行，会被复制）
+     */
+    template <typename LineMask>
+    RenjuArbiter(const LineMask (&black)[N], const LineMask (&white)[N]) {
+        for (int r = 0; r < N; ++r) {
+            m_black[r] = black[r];
+            m_white[r] = white[r];
+        }
+    }
+
+    /**
+     * @brief 自上次 resetDeps() 以来的读取依赖
+     */
+    const ForbiddenDeps& deps() const { return m_deps; }
+
+    /**
+     * @brief 清空读取依赖，开始记录下一次判定
+     */
+    void resetDeps() {
+        m_deps.count = 0;
+        m_current = -1;
+    }
+
+    /**
+     * @brief 黑方在空点(row, col)落子是否为禁手
+     * 实现逻辑：
+     * Step1：试落黑子；任一方向恰好五连 → 不是禁手（成五优先）；否则任一方向六连及以上 → 长连禁手；
+     * Step2：按方向统计四：该方向上能成恰好五连（且经过落子点）的空点数，活四的两个成五点只算一个四；≥2为四四禁手；
+     * Step3：没有四的方向逐一检查是否为真活三（递归排除成活四点本身是禁手的假活三），≥2为三三禁手。
+     * 各步只逐线计数棋型表判为可能的方向：Step1为成五或长连，Step2为四及以上，Step3为活三及以上。
+     */
+    bool isForbidden(int row, int col) {
+        const int parent = m_current;
+        beginCell(row, col);
+        uint16_t codes[DIRECTION_COUNT];
+        PatternType types[DIRECTION_COUNT];
+        bool maybeFive = false;
+        for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+            codes[dir] = windowCode(row, col, dir);
+            const uint32_t entry = table().entries[codes[dir]];
+            types[dir] = PatternTable::typeOf(entry, Config::PieceType::Black);
+            maybeFive |= types[dir] == PatternType::Five || (entry & PatternTable::OVERLINE_FLAG);
+        }
+        set(row, col, Config::PieceType::Black);
+        bool forbidden = false;
+        bool five = false;
+        for (int dir = 0; dir < DIRECTION_COUNT && maybeFive; ++dir) {
+            const int len = runLength(row, col, dir);
+            five |= len == 5;
+            forbidden |= len > 5;
+        }
+        if (five) {
+            forbidden = false;
+        } else if (!forbidden) {
+            int fours = 0;
+            int threes = 0;
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                if (types[dir] < PatternType::OpenThree) {
+                    continue;
+                }
+                const int dirFours = types[dir] >= PatternType::Four ? fourCount(row, col, dir, codes[dir]) : 0;
+                fours += dirFours;
+                threes += dirFours == 0 && isRealThree(row, col, dir, codes[dir]);
+            }
+            forbidden = fours >= 2 || threes >= 2;
+        }
+        set(row, col, Config::PieceType::None);
+        m_current = parent;
+        return forbidden;
+    }
+
+private:
+    static bool inRange(int row, int col) { return row >= 0 && row < N && col >= 0 && col < N; }
+
+    static const PatternTable& table() { return PatternTable::get(Rule::Renju); }
+
+    /**
+     * @brief 记录一个被检查点：之后的读取都在它的四条线上，初始距离为窗口半径（windowCode() 读满±4）
+     */
+    void beginCell(int row, int col) { m_current = m_deps.add(row, col, PatternCode::WINDOW_RADIUS); }
+
+    /**
+     * @brief 记录当前被检查点的线上读到的(row, col)
+     */
+    void touch(int row, int col) {
+        if (m_current < 0) {
+            return;
+        }
+        const int dist = std::max(std::abs(row - m_deps.rows[m_current]), std::abs(col - m_deps.cols[m_current]));
+        m_deps.radius[m_current] = static_cast<uint8_t>(std::max<int>(m_deps.radius[m_current], dist));
+    }
+
+    /**
+     * @brief 读取格子（不记录依赖：调用方只读当前被检查点±4以内的线段，已由 beginCell() 记录）
+     */
+    Config::PieceType at(int row, int col) const {
+        if (!inRange(row, col)) {
+            return Config::PieceType::White;    // 棋盘外按对方棋子处理：不能成五也不能延伸
+        }
+        return (m_black[row] >> col) & 1u ? Config::PieceType::Black
+             : (m_white[row] >> col) & 1u ? Config::PieceType::White
+             : Config::PieceType::None;
+    }
+
+    /**
+     * @brief 试落/撤回黑子（只改黑方掩码，白子不会被试落）
+     */
+    void set(int row, int col, Config::PieceType type) {
+        if (type == Config::PieceType::Black) {
+            m_black[row] |= 1u << col;
+        } else {
+            m_black[row] &= ~(1u << col);
+        }
+    }
+
+    /**
+     * @brief (row, col)沿dir方向的窗口编码（与Board的增量编码格式相同，越界记为EDGE）
+     */
+    uint16_t windowCode(int row, int col, int dir) {
+        uint16_t code = 0;
+        for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS; ++k) {
+            if (k == 0) {
+                continue;
+            }
+            const int r = row + k * DIR_DR[dir];
+            const int c = col + k * DIR_DC[dir];
+            const uint16_t value = !inRange(r, c) ? PatternCode::EDGE
+                                 : (m_black[r] >> c) & 1u ? PatternCode::BLACK
+                                 : (m_white[r] >> c) & 1u ? PatternCode::WHITE
+                                 : PatternCode::EMPTY;
+            code |= static_cast<uint16_t>(value << (PatternCode::slotOf(k) * 2));
+        }
+        return code;
+    }
+
+    /**
+     * @brief 经过(row, col)沿dir方向的连续黑子数（(row, col)必须是黑子）
+     */
+    int runLength(int row, int col, int dir) {
+        int len = 1;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int r = row + sign * DIR_DR[dir];
+            int c = col + sign * DIR_DC[dir];
+            while (at(r, c) == Config::PieceType::Black) {
+                ++len;
+                r += sign * DIR_DR[dir];
+                c += sign * DIR_DC[dir];
+            }
+            touch(r, c);    // 连续段可能延伸到窗口外，记录读到的最远一格
+        }
+        return len;
+    }
+
+    /**
+     * @brief 窗口编码code在偏移k处补一颗黑子后，中心落黑子形成的棋型（表的判定，只会比实际多）
+     */
+    static PatternType typeWith(uint16_t code, int k) {
+        const uint16_t placed = static_cast<uint16_t>(code | (PatternCode::BLACK << (PatternCode::slotOf(k) * 2)));
+        return PatternTable::typeOf(table().entries[placed], Config::PieceType::Black);
+    }
+
+    /**
+     * @brief 列出dir方向上落下后形成恰好五连、且五连经过(row, col)的空点（以相对(row, col)的偏移表示）
+     * @param code (row, col)沿dir方向的窗口编码；表中不成五的空点直接跳过
+     * @return int 成五点个数
+     */
+    int fivePoints(int row, int col, int dir, uint16_t code, int (&offsets)[2 * PatternCode::WINDOW_RADIUS]) {
+        int count = 0;
+        for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS; ++k) {
+            const int r = row + k * DIR_DR[dir];
+            const int c = col + k * DIR_DC[dir];
+            if (k == 0 || at(r, c) != Config::PieceType::None || typeWith(code, k) != PatternType::Five) {
+                continue;
+            }
+            // 五连经过(row, col)：二者之间全是黑子（连续段才能同时包含两点）
+            bool connected = true;
+            for (int j = k < 0 ? k + 1 : 1; j < (k < 0 ? 0 : k) && connected; ++j) {
+                connected = at(row + j * DIR_DR[dir], col + j * DIR_DC[dir]) == Config::PieceType::Black;
+            }
+            if (!connected) {
+                continue;
+            }
+            set(r, c, Config::PieceType::Black);
+            if (runLength(r, c, dir) == 5) {
+                offsets[count++] = k;
+            }
+            set(r, c, Config::PieceType::None);
+        }
+        return count;
+    }
+
+    /**
+     * @brief 两个成五点相距5格（中间恰为连续4子）即活四
+     */
+    static bool isStraightFour(const int (&offsets)[2 * PatternCode::WINDOW_RADIUS], int count) {
+        return count == 2 && offsets[1] - offsets[0] == 5;
+    }
+
+    /**
+     * @brief dir方向上经过(row, col)的四的个数（活四算一个，同线四四算两个）
+     */
+    int fourCount(int row, int col, int dir, uint16_t code) {
+        int offsets[2 * PatternCode::WINDOW_RADIUS];
+        const int count = fivePoints(row, col, dir, code, offsets);
+        return isStraightFour(offsets, count) ? 1 : count;
+    }
+
+    /**
+     * @brief dir方向是否为真活三：存在落下后形成经过(row, col)的活四、且本身不是禁手的空点
+     * @param code (row, col)沿dir方向的窗口编码；落下后表中不成活四的空点不可能成活四，直接跳过
+     */
+    bool isRealThree(int row, int col, int dir, uint16_t code) {
+        for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS; ++k) {
+            const int r = row + k * DIR_DR[dir];
+            const int c = col + k * DIR_DC[dir];
+            if (k == 0 || at(r, c) != Config::PieceType::None || typeWith(code, k) != PatternType::OpenFour) {
+                continue;
+            }
+            const uint16_t placed = static_cast<uint16_t>(code | (PatternCode::BLACK << (PatternCode::slotOf(k) * 2)));
+            set(r, c, Config::PieceType::Black);
+            int offsets[2 * PatternCode::WINDOW_RADIUS];
+            const bool straight = isStraightFour(offsets, fivePoints(row, col, dir, placed, offsets));
+            set(r, c, Config::PieceType::None);
+            if (straight && !isForbidden(r, c)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t m_black[N];
+    uint32_t m_white[N];
+    ForbiddenDeps m_deps = {};
+    int m_current = -1;    // 当前被检查点在m_deps中的下标，-1表示依赖已记为ALL
+};
+
+} // namespace
 
 /**
  * @brief 构造函数实现：初始化棋盘为空
- * 详细实现逻辑（组员需补充）：
- * 遍历15×15的m_grid数组，将所有元素初始化为Config::PieceType::None。
+ * 实现逻辑：委托reset()清空全部位掩码与棋子计数（棋型表由模板参数R在编译期确定）。
  */
-Board::Board() {
-    // 空实现：组员需补充初始化逻辑
+template <int N, Rule R>
+BasicBoard<N, R>::BasicBoard() {
+    reset();
 }
 
 /**
  * @brief 重置棋盘实现
- * 详细实现逻辑（组员需补充）：
- * 遍历m_grid数组，将所有位置重置为Config::PieceType::None，恢复初始状态。
+ * 实现逻辑：将所有行、列、斜线位掩码、候选着法与禁手点清零，棋子计数、撤销栈与哈希归零，并重建棋型编码与估值，恢复初始状态。
  */
-void Board::reset() {
-    // 空实现：组员需补充重置逻辑
+template <int N, Rule R>
+void BasicBoard<N, R>::reset() {
+    std::memset(m_rows, 0, sizeof(m_rows));
+    std::memset(m_cols, 0, sizeof(m_cols));
+    std::memset(m_diags, 0, sizeof(m_diags));
+    std::memset(m_antiDiags, 0, sizeof(m_antiDiags));
+    std::memset(m_candidateRows, 0, sizeof(m_candidateRows));
+    std::memset(m_forbiddenRows, 0, sizeof(m_forbiddenRows));
+    std::memset(m_pendingForbiddenRows, 0, sizeof(m_pendingForbiddenRows));
+    m_pendingForbiddenCount = 0;
+    m_stoneCount = 0;
+    m_undoSize = 0;
+    m_hash = 0;
+    rebuildPatterns();
 }
 
 /**
  * @brief 落子操作实现
- * 详细实现逻辑（组员需补充）：
+ * 实现逻辑：
  * Step1：合法性校验
- * - 检查row和col是否在0~Config::BOARD_SIZE-1范围内（越界则返回false）；
- * - 检查目标位置当前是否为PieceType::None（已有棋子则返回false）。
+ * - type为None时按悔棋语义转交removePiece()；
+ * - row/col越界或目标位置已有棋子（两种颜色的行掩码任一置位）则返回false。
  * Step2：执行落子
- * - 将m_grid[row][col]设置为传入的type。
- * Step3：返回结果
- * - 落子成功返回true，失败返回false。
+ * - 在对应颜色的行、列、主对角线、副对角线掩码中置位，棋子计数+1，哈希异或该子的Zobrist键；
+ * - 增量更新±4窗口内的棋型编码与估值，以及±2行的候选着法。
  * @param row 目标行坐标
  * @param col 目标列坐标
  * @param type 棋子类型
  * @return bool 落子结果
  */
-bool Board::placePiece(int row, int col, Config::PieceType type) {
-    // 空实现：返回false，组员需补充逻辑
-    return false;
+template <int N, Rule R>
+bool BasicBoard<N, R>::placePiece(int row, int col, Config::PieceType type) {
+    if (type == Config::PieceType::None) {
+        return removePiece(row, col);
+    }
+    if (!inRange(row, col) || ((m_rows[0][row] | m_rows[1][row]) >> col) & 1u) {
+        return false;
+    }
+    addStone(row, col, colorIndex(type));
+    updateCandidates(row);
+    return true;
+}
+
+/**
+ * @brief 提子操作实现
+ * 实现逻辑：先由行掩码确定该位置的颜色，再清除四组掩码中的对应位，棋子计数-1、哈希异或回退，
+ * 最后增量恢复±4窗口内的棋型编码与估值，以及±2行的候选着法。
+ * @param row 目标行坐标
+ * @param col 目标列坐标
+ * @return bool 提子结果
+ */
+template <int N, Rule R>
+bool BasicBoard<N, R>::removePiece(int row, int col) {
+    if (!inRange(row, col)) {
+        return false;
+    }
+    const LineMask bit = static_cast<LineMask>(1u << col);
+    int c;
+    if (m_rows[0][row] & bit) {
+        c = 0;
+    } else if (m_rows[1][row] & bit) {
+        c = 1;
+    } else {
+        return false;
+    }
+    clearStone(row, col, c);
+    updateCandidates(row);
+    return true;
+}
+
+/**
+ * @brief 可撤销落子实现
+ * 实现逻辑：
+ * Step1：与placePiece相同的合法性校验（type为None、越界或已有棋子均失败，且不入栈）；
+ * Step2：把格子下标与row±2行的候选掩码写入预分配的撤销栈（栈容量N×N，棋子数不会超过它）；
+ * Step3：执行落子并增量更新棋型、估值、哈希与候选着法。
+ * @param row 目标行坐标
+ * @param col 目标列坐标
+ * @param type 棋子类型（黑棋/白棋）
+ * @return bool 落子结果
+ */
+template <int N, Rule R>
+bool BasicBoard<N, R>::makeMove(int row, int col, Config::PieceType type) {
+    if (type == Config::PieceType::None || !inRange(row, col) || ((m_rows[0][row] | m_rows[1][row]) >> col) & 1u) {
+        return false;
+    }
+    UndoEntry& entry = m_undo[m_undoSize++];
+    entry.cell = static_cast<int16_t>(row * N + col);
+    const int first = std::max(0, row - 2);
+    const int last = std::min(N - 1, row + 2);
+    std::memcpy(entry.candidateRows, &m_candidateRows[first], (last - first + 1) * sizeof(LineMask));
+    addStone(row, col, colorIndex(type));
+    updateCandidates(row);
+    return true;
+}
+
+/**
+ * @brief 撤销落子实现
+ * 实现逻辑：弹出栈顶记录，由行掩码确定棋子颜色后清除四组掩码、回退计数与哈希，
+ * 增量恢复±4窗口内的棋型编码、估值与威胁计数，最后把row±2行的候选掩码从栈中原样拷回（无需重算）。
+ * @return int 被撤销的格子下标（row*N+col）；栈为空时返回-1
+ */
+template <int N, Rule R>
+int BasicBoard<N, R>::unmakeMove() {
+    if (m_undoSize == 0) {
+        return -1;
+    }
+    const UndoEntry& entry = m_undo[--m_undoSize];
+    const int row = entry.cell / N;
+    const int col = entry.cell % N;
+    clearStone(row, col, (m_rows[0][row] >> col) & 1u ? 0 : 1);
+    const int first = std::max(0, row - 2);
+    const int last = std::min(N - 1, row + 2);
+    std::memcpy(&m_candidateRows[first], entry.candidateRows, (last - first + 1) * sizeof(LineMask));
+    return entry.cell;
+}
+
+/**
+ * @brief 置子实现：四组掩码置位、棋子计数+1、哈希异或该子的Zobrist键，并增量更新棋型与估值
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::addStone(int row, int col, int c) {
+    m_rows[c][row] |= static_cast<LineMask>(1u << col);
+    m_cols[c][col] |= static_cast<LineMask>(1u << row);
+    m_diags[c][row - col + N - 1] |= static_cast<LineMask>(1u << col);
+    m_antiDiags[c][row + col] |= static_cast<LineMask>(1u << col);
+    ++m_stoneCount;
+    m_hash ^= Zobrist::key<N>(c, row, col);
+    updatePatterns(row, col, c == 0 ? PatternCode::BLACK : PatternCode::WHITE);
+}
+
+/**
+ * @brief 清子实现：addStone的逆操作
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::clearStone(int row, int col, int c) {
+    const LineMask bit = static_cast<LineMask>(1u << col);
+    m_rows[c][row] &= static_cast<LineMask>(~bit);
+    m_cols[c][col] &= static_cast<LineMask>(~(1u << row));
+    m_diags[c][row - col + N - 1] &= static_cast<LineMask>(~bit);
+    m_antiDiags[c][row + col] &= static_cast<LineMask>(~bit);
+    --m_stoneCount;
+    m_hash ^= Zobrist::key<N>(c, row, col);
+    updatePatterns(row, col, PatternCode::EMPTY);
 }
 
 /**
  * @brief 获取棋子类型实现
- * 详细实现逻辑（组员需补充）：
- * Step1：合法性校验
- * - 若row/col越界，返回PieceType::None；
- * Step2：返回结果
- * - 返回m_grid[row][col]的棋子类型。
+ * 实现逻辑：越界返回None；否则依次检查黑、白两色的行掩码对应位。
  * @param row 行坐标
  * @param col 列坐标
  * @return Config::PieceType 棋子类型
  */
-Config::PieceType Board::getPiece(int row, int col) const {
-    // 空实现：返回None，组员需补充逻辑
+template <int N, Rule R>
+Config::PieceType BasicBoard<N, R>::getPiece(int row, int col) const {
+    if (!inRange(row, col)) {
+        return Config::PieceType::None;
+    }
+    if ((m_rows[0][row] >> col) & 1u) {
+        return Config::PieceType::Black;
+    }
+    if ((m_rows[1][row] >> col) & 1u) {
+        return Config::PieceType::White;
+    }
     return Config::PieceType::None;
 }
 
 /**
  * @brief 胜负判断实现
- * 详细实现逻辑（组员需补充）：
- * 核心思路：检查落子点的4个方向（横、竖、斜），统计连续同色棋子数量，任意方向≥5则获胜。
- * Step1：定义4个方向的偏移量（dx, dy）：
- * - 水平方向：(0, 1)、(0, -1)
- * - 垂直方向：(1, 0)、(-1, 0)
- * - 左上→右下：(1, 1)、(-1, -1)
- * - 右上→左下：(1, -1)、(-1, 1)
- * Step2：对每个方向，向两侧扩展统计连续同色棋子数量
- * - 例如水平方向：从落子点向右数连续同色棋子数 + 向左数连续同色棋子数 + 1（当前落子）≥5 → 获胜。
- * Step3：若任意方向满足条件，返回true；否则返回false。
+ * 实现逻辑：取出落子点所在的行、列、两条斜线的同色位掩码，
+ * 分别做一次“移位相与”判断是否存在经过落子点的连续5子，任意方向满足即获胜。
+ * 行掩码与两条斜线均以col为位序号，列掩码以row为位序号。
+ * 规则分支全部为if constexpr：要求恰好五连的一方改为数出连子长度；Caro另取对方同一条线的掩码检查两端。
  * @param row 落子行坐标
  * @param col 落子列坐标
  * @param type 棋子类型
  * @return bool 胜负结果
  */
-bool Board::checkWin(int row, int col, Config::PieceType type) {
-    // 空实现：返回false，组员需补充判断逻辑
-    return false;
+template <int N, Rule R>
+bool BasicBoard<N, R>::checkWin(int row, int col, Config::PieceType type) {
+    if (type == Config::PieceType::None || !inRange(row, col)) {
+        return false;
+    }
+    const int c = colorIndex(type);
+    if constexpr (requiresUnblockedFive(R)) {
+        const int o = 1 - c;
+        return hasUnblockedFiveThrough(m_rows[c][row], m_rows[o][row], col)
+            || hasUnblockedFiveThrough(m_cols[c][col], m_cols[o][col], row)
+            || hasUnblockedFiveThrough(m_diags[c][row - col + N - 1], m_diags[o][row - col + N - 1], col)
+            || hasUnblockedFiveThrough(m_antiDiags[c][row + col], m_antiDiags[o][row + col], col);
+    }
+    if (requiresExactFive(R, type)) {
+        return runThrough(m_rows[c][row], col) == 5
+            || runThrough(m_cols[c][col], row) == 5
+            || runThrough(m_diags[c][row - col + N - 1], col) == 5
+            || runThrough(m_antiDiags[c][row + col], col) == 5;
+    }
+    return hasFiveThrough(m_rows[c][row], col)
+        || hasFiveThrough(m_cols[c][col], row)
+        || hasFiveThrough(m_diags[c][row - col + N - 1], col)
+        || hasFiveThrough(m_antiDiags[c][row + col], col);
 }
 
 /**
  * @brief 棋盘满状态检查实现
- * 详细实现逻辑（组员需补充）：
- * Step1：遍历整个m_grid数组
- * - 若发现任意位置为PieceType::None，返回false（棋盘未满）；
- * Step2：遍历完成后返回true（所有位置均有棋子，平局）。
+ * 实现逻辑：棋子计数等于格子总数即为满盘，O(1)完成。
  * @return bool 棋盘满状态
  */
-bool Board::isFull() const {
-    // 空实现：返回false，组员需补充检查逻辑
+template <int N, Rule R>
+bool BasicBoard<N, R>::isFull() const {
+    return m_stoneCount == N * N;
+}
+
+/**
+ * @brief 全量重建棋型编码实现
+ * 实现逻辑：逐格逐方向读取前后各4格的状态拼成窗口编码（越界记为EDGE），
+ * 再把所有空点的估值贡献累加到m_evalScore，棋型计入威胁计数；Renju下最后逐格重算禁手位。
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::rebuildPatterns() {
+    m_evalScore = 0;
+    std::memset(m_threatCount, 0, sizeof(m_threatCount));
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            const int idx = row * N + col;
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                uint16_t code = 0;
+                for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS; ++k) {
+                    if (k == 0) {
+                        continue;
+                    }
+                    const int r = row + k * DIR_DR[dir];
+                    const int c = col + k * DIR_DC[dir];
+                    uint16_t value = PatternCode::EDGE;
+                    if (inRange(r, c)) {
+                        const Config::PieceType piece = getPiece(r, c);
+                        value = piece == Config::PieceType::Black ? PatternCode::BLACK
+                              : piece == Config::PieceType::White ? PatternCode::WHITE
+                              : PatternCode::EMPTY;
+                    }
+                    code |= static_cast<uint16_t>(value << (PatternCode::slotOf(k) * 2));
+                }
+                m_patternCode[idx][dir] = code;
+                if (getPiece(row, col) == Config::PieceType::None) {
+                    const uint32_t entry = table().entries[code];
+                    m_evalScore += PatternTable::scoreOf(entry);
+                    countThreats(entry, +1);
+                }
+            }
+        }
+    }
+    if constexpr (R == Rule::Renju) {
+        for (int row = 0; row < N; ++row) {
+            for (int col = 0; col < N; ++col) {
+                refreshForbidden(row, col);
+            }
+        }
+        resolvePendingForbidden(0, 0);    // 重置后的待定点都是新记入的（依赖为ALL），任一格都会触发判定
+    }
+}
+
+/**
+ * @brief 增量更新棋型编码实现
+ * 实现逻辑：
+ * Step1：变化格子本身——落子前它是空点（其四个方向的贡献需扣除），提子后重新成为空点（贡献加回）；
+ * Step2：沿四个方向遍历±4范围内的格子，把“变化格子”所在槽位改写为新值，
+ *        若该格子为空点，则用新旧编码的估值差修正m_evalScore，并同步威胁计数；
+ * Step3（仅Renju）：变化格子、窗口内每个空点以及第±5格的禁手位随编码一起重算——表能判定的禁手只取决于空点的
+ *        四个窗口编码与第±5格是否为黑子；其余待定点由 resolvePendingForbidden() 按读取依赖重新做完整判定。
+ * 每次调用最多改写32个编码，与棋盘大小无关。
+ * @param row 变化格子的行坐标
+ * @param col 变化格子的列坐标
+ * @param value 该格子的新编码
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::updatePatterns(int row, int col, uint16_t value) {
+    const uint32_t* entries = table().entries;
+    const int idx = row * N + col;
+    if constexpr (R == Rule::Renju) {
+        refreshForbidden(row, col);
+    }
+
+    const int centerDelta = value == PatternCode::EMPTY ? +1 : -1;
+    int centerScore = 0;
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        const uint32_t entry = entries[m_patternCode[idx][dir]];
+        centerScore += PatternTable::scoreOf(entry);
+        countThreats(entry, centerDelta);
+    }
+    m_evalScore += value == PatternCode::EMPTY ? centerScore : -centerScore;
+
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS; ++k) {
+            if (k == 0) {
+                continue;
+            }
+            const int r = row + k * DIR_DR[dir];
+            const int c = col + k * DIR_DC[dir];
+            if (!inRange(r, c)) {
+                continue;
+            }
+            // 变化格子相对于(r, c)的偏移为-k
+            const int shift = PatternCode::slotOf(-k) * 2;
+            uint16_t& code = m_patternCode[r * N + c][dir];
+            const uint16_t old = code;
+            code = static_cast<uint16_t>((old & ~(3u << shift)) | (static_cast<unsigned>(value) << shift));
+            if (!(((m_rows[0][r] | m_rows[1][r]) >> c) & 1u)) {
+                const uint32_t oldEntry = entries[old];
+                const uint32_t newEntry = entries[code];
+                m_evalScore += PatternTable::scoreOf(newEntry) - PatternTable::scoreOf(oldEntry);
+                countThreats(oldEntry, -1);
+                countThreats(newEntry, +1);
+                if constexpr (R == Rule::Renju) {
+                    refreshForbidden(r, c);
+                }
+            }
+        }
+    }
+    if constexpr (R == Rule::Renju) {
+        // 第±5格的空点编码不变，只有该方向表判为四及以上时才读“窗口外第5格是否为黑子”（见 refreshForbidden()）
+        for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+            for (int sign = -1; sign <= 1; sign += 2) {
+                const int r = row + sign * (PatternCode::WINDOW_RADIUS + 1) * DIR_DR[dir];
+                const int c = col + sign * (PatternCode::WINDOW_RADIUS + 1) * DIR_DC[dir];
+                if (inRange(r, c) && !((occupancyRow(r) >> c) & 1u)
+                    && PatternTable::typeOf(entries[m_patternCode[r * N + c][dir]], Config::PieceType::Black) >= PatternType::Four) {
+                    refreshForbidden(r, c);
+                }
+            }
+        }
+        resolvePendingForbidden(row, col);
+    }
+}
+
+/**
+ * @brief 威胁计数更新实现：从同一个表项解出双方棋型
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::countThreats(uint32_t entry, int delta) {
+    m_threatCount[0][entry & 0x0F] += delta;
+    m_threatCount[1][(entry >> 4) & 0x0F] += delta;
+}
+
+/**
+ * @brief 禁手判定实现（黑方，只看四个方向的表项）
+ * 实现逻辑：
+ * Step1：任一方向成五 → 不是禁手（成五优先于一切禁手）；
+ * Step2：任一方向长连 → 禁手；
+ * Step3：四的个数 = 冲四/活四方向数 + 同线四四方向额外的一个，≥2为四四禁手；
+ * Step4：活三方向数≥2时还要排除假活三，交给调用方做完整判定（ForbiddenVerdict::Pending）。
+ */
+template <int N, Rule R>
+typename BasicBoard<N, R>::ForbiddenVerdict BasicBoard<N, R>::forbiddenByEntries(const uint32_t (&entries)[DIRECTION_COUNT]) {
+    int fours = 0;
+    int openThrees = 0;
+    bool overline = false;
+    for (const uint32_t entry : entries) {
+        const PatternType type = PatternTable::typeOf(entry, Config::PieceType::Black);
+        if (type == PatternType::Five) {
+            return ForbiddenVerdict::Allowed;
+        }
+        overline |= (entry & PatternTable::OVERLINE_FLAG) != 0;
+        fours += (type == PatternType::Four || type == PatternType::OpenFour) + ((entry & PatternTable::LINE_DOUBLE_FOUR_FLAG) != 0);
+        openThrees += type == PatternType::OpenThree;
+    }
+    if (overline || fours >= 2) {
+        return ForbiddenVerdict::Forbidden;
+    }
+    return openThrees >= 2 ? ForbiddenVerdict::Pending : ForbiddenVerdict::Allowed;
+}
+
+/**
+ * @brief 完整禁手判定实现：交给 RenjuArbiter（含假活三递归与整线长连判定）
+ */
+template <int N, Rule R>
+bool BasicBoard<N, R>::isForbiddenExact(int row, int col) const {
+    if constexpr (R == Rule::Renju) {
+        if (!inRange(row, col) || getPiece(row, col) != Config::PieceType::None) {
+            return false;
+        }
+        return RenjuArbiter<N>(m_rows[0], m_rows[1]).isForbidden(row, col);
+    } else {
+        (void)row;
+        (void)col;
+        return false;
+    }
+}
+
+/**
+ * @brief 窗口外第5格能否改变(row, col)沿dir方向sign一侧的棋型判定
+ * 表里受第5格影响的只有经过中心、一端落在第4格的五连：第1~4格不能有白子或边界，至多一个空点（成五点），
+ * 且第5格是黑子（五连实为长连）。满足时表的判定不可靠。
+ */
+template <int N, Rule R>
+bool BasicBoard<N, R>::reachesBeyondWindow(int row, int col, int dir, int sign) const {
+    int blacks = 0;
+    for (int k = 1; k <= PatternCode::WINDOW_RADIUS + 1; ++k) {
+        const int r = row + sign * k * DIR_DR[dir];
+        const int c = col + sign * k * DIR_DC[dir];
+        if (!inRange(r, c) || ((m_rows[1][r] >> c) & 1u)) {
+            return false;
+        }
+        blacks += (m_rows[0][r] >> c) & 1u;
+        if (k == PatternCode::WINDOW_RADIUS + 1) {
+            return ((m_rows[0][r] >> c) & 1u) && blacks >= PatternCode::WINDOW_RADIUS;
+        }
+    }
     return false;
 }
+
+/**
+ * @brief 禁手位重算实现：空点按四个方向的表项判定，有子的格子清零
+ * 窗口只看到±4格，表中的棋型只会比实际多：活三判多了至多把三三误判成待定，不影响结论；
+ * 但某方向表判为四或成五、且黑子连到第±5格时（见 reachesBeyondWindow()），五连可能实为长连、四可能实为活三，
+ * 表的判定不再可靠，与表判为三三的空点一样只记入待定掩码，禁手位由随后的 resolvePendingForbidden() 决定。
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::refreshForbidden(int row, int col) {
+    const LineMask bit = static_cast<LineMask>(1u << col);
+    ForbiddenVerdict verdict = ForbiddenVerdict::Allowed;
+    if (!(occupancyRow(row) & bit)) {
+        const uint16_t* codes = m_patternCode[row * N + col];
+        const uint32_t* entries = table().entries;
+        const uint32_t cellEntries[DIRECTION_COUNT] = { entries[codes[0]], entries[codes[1]], entries[codes[2]], entries[codes[3]] };
+        // 黑方棋型不到活三（类型值的第2位为0）且没有禁手标记的空点占绝大多数，不需要逐方向判定
+        constexpr uint32_t THREAT_BITS = static_cast<uint32_t>(PatternType::OpenThree) | PatternTable::OVERLINE_FLAG | PatternTable::LINE_DOUBLE_FOUR_FLAG;
+        static_assert(static_cast<uint32_t>(PatternType::OpenThree) == 4 && static_cast<uint32_t>(PatternType::Five) == 7,
+                      "types from OpenThree to Five share bit 2");
+        const bool quiet = ((cellEntries[0] | cellEntries[1] | cellEntries[2] | cellEntries[3]) & THREAT_BITS) == 0;
+        verdict = quiet ? ForbiddenVerdict::Allowed : forbiddenByEntries(cellEntries);
+        for (int dir = 0; dir < DIRECTION_COUNT && !quiet && verdict != ForbiddenVerdict::Pending; ++dir) {
+            if (PatternTable::typeOf(cellEntries[dir], Config::PieceType::Black) < PatternType::Four) {
+                continue;
+            }
+            for (int sign = -1; sign <= 1; sign += 2) {
+                if (reachesBeyondWindow(row, col, dir, sign)) {
+                    verdict = ForbiddenVerdict::Pending;
+                }
+            }
+        }
+    }
+    const bool wasPending = (m_pendingForbiddenRows[row] & bit) != 0;
+    const bool pending = verdict == ForbiddenVerdict::Pending;
+    m_pendingForbiddenCount += static_cast<int>(pending) - static_cast<int>(wasPending);
+    m_pendingForbiddenRows[row] = pending ? static_cast<LineMask>(m_pendingForbiddenRows[row] | bit)
+                                          : static_cast<LineMask>(m_pendingForbiddenRows[row] & ~bit);
+    if (pending) {
+        // 仍是待定点时保留缓存的结论（是否重判由读取依赖决定）；新记入的待定点必须重判
+        if (!wasPending) {
+            m_forbiddenDeps[row * N + col].count = ForbiddenDeps::ALL;
+        }
+        return;
+    }
+    m_forbiddenRows[row] = verdict == ForbiddenVerdict::Forbidden ? static_cast<LineMask>(m_forbiddenRows[row] | bit)
+                                                                  : static_cast<LineMask>(m_forbiddenRows[row] & ~bit);
+}
+
+/**
+ * @brief 待定点的快速判定实现
+ * 实现逻辑：
+ * Step1：四个方向都没有成五、长连，且表中四的个数<2（表中的棋型只会多于实际），否则交给完整判定；
+ * Step2：逐个表判为活三的方向，找落下后表中形成活四的空点Y，在±5格线段上逐格确认它确实形成活四
+ *        （两个成五点恰好相距5格，第±5格也参与判断，因此不受窗口边缘影响）：
+ *        - 一个都没有：该方向是假活三；
+ *        - Y在另外三个方向上表中没有四、没有长连、活三不超过一个：Y落下后只有这一个四、至多一个活三，
+ *          不可能是禁手（落子点只在Y的这一条线上，不影响另外三个方向），该方向是真活三；
+ *        - 否则Y是否为禁手需要递归，该方向记为不确定；
+ * Step3：真活三≥2时是禁手；真活三与不确定方向合计<2、且表中的四不受第±5格影响（即实际也是四，不是活三）时
+ *        不是禁手；其余交给完整判定。
+ * 读取依赖为待定点的四条线（±5）与每个用到的Y的四条线（±4）。
+ */
+template <int N, Rule R>
+typename BasicBoard<N, R>::ForbiddenVerdict BasicBoard<N, R>::resolveByTable(int row, int col, ForbiddenDeps& deps) const {
+    const uint32_t* entries = table().entries;
+    const uint16_t* codes = m_patternCode[row * N + col];
+    int fours = 0;
+    bool exactFours = true;
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        const uint32_t entry = entries[codes[dir]];
+        const PatternType type = PatternTable::typeOf(entry, Config::PieceType::Black);
+        if (type == PatternType::Five || (entry & PatternTable::OVERLINE_FLAG)) {
+            return ForbiddenVerdict::Pending;
+        }
+        if (type >= PatternType::Four) {
+            fours += 1 + ((entry & PatternTable::LINE_DOUBLE_FOUR_FLAG) != 0);
+            exactFours = exactFours && !reachesBeyondWindow(row, col, dir, 1) && !reachesBeyondWindow(row, col, dir, -1);
+        }
+    }
+    if (fours >= 2) {
+        return ForbiddenVerdict::Pending;
+    }
+    ForbiddenDeps checked = {};
+    checked.add(row, col, PatternCode::WINDOW_RADIUS + 1);
+    int threes = 0;
+    int unknown = 0;
+    for (int dir = 0; dir < DIRECTION_COUNT && threes < 2; ++dir) {
+        if (PatternTable::typeOf(entries[codes[dir]], Config::PieceType::Black) != PatternType::OpenThree) {
+            continue;
+        }
+        // 线段上偏移-5~+5的黑子与空点（第i位对应偏移i-5），中心落黑子
+        constexpr int REACH = PatternCode::WINDOW_RADIUS + 1;
+        unsigned black = 1u << REACH;
+        unsigned empty = 0;
+        for (int k = -REACH; k <= REACH; ++k) {
+            const int r = row + k * DIR_DR[dir];
+            const int c = col + k * DIR_DC[dir];
+            if (k != 0 && inRange(r, c)) {
+                black |= ((m_rows[0][r] >> c) & 1u) << (k + REACH);
+                empty |= (!((occupancyRow(r) >> c) & 1u)) << (k + REACH);
+            }
+        }
+        bool straightFour = false;
+        bool real = false;
+        for (int k = -PatternCode::WINDOW_RADIUS; k <= PatternCode::WINDOW_RADIUS && !real; ++k) {
+            const uint16_t placed = static_cast<uint16_t>(codes[dir] | (PatternCode::BLACK << (PatternCode::slotOf(k) * 2)));
+            if (!((empty >> (k + REACH)) & 1u) || PatternTable::typeOf(entries[placed], Config::PieceType::Black) != PatternType::OpenFour
+                || !isStraightFourLine(black | (1u << (k + REACH)), empty & ~(1u << (k + REACH)))) {
+                continue;
+            }
+            straightFour = true;
+            const int yr = row + k * DIR_DR[dir];
+            const int yc = col + k * DIR_DC[dir];
+            int otherThrees = 0;
+            real = true;
+            for (int other = 0; other < DIRECTION_COUNT && real; ++other) {
+                const uint32_t entry = entries[m_patternCode[yr * N + yc][other]];
+                const PatternType type = PatternTable::typeOf(entry, Config::PieceType::Black);
+                otherThrees += other != dir && type == PatternType::OpenThree;
+                real = other == dir || (type < PatternType::Four && !(entry & PatternTable::OVERLINE_FLAG));
+            }
+            real = real && otherThrees < 2;
+            if (real) {
+                checked.add(yr, yc, PatternCode::WINDOW_RADIUS);
+            }
+        }
+        threes += real;
+        unknown += straightFour && !real;
+    }
+    if (checked.count == ForbiddenDeps::ALL) {
+        return ForbiddenVerdict::Pending;
+    }
+    if (threes >= 2) {
+        deps = checked;
+        return ForbiddenVerdict::Forbidden;
+    }
+    if (exactFours && threes + unknown < 2) {
+        deps = checked;
+        return ForbiddenVerdict::Allowed;
+    }
+    return ForbiddenVerdict::Pending;
+}
+
+/**
+ * @brief 待定点的完整判定实现
+ * 假活三取决于成活四点本身是否为禁手，而后者又取决于更远处的棋子，超出任何固定窗口；
+ * 但判定是确定性的：上一次判定没有读到的格子变化时结论不变。因此每个待定点记录上一次判定的读取依赖（ForbiddenDeps），
+ * 只有变化格子落在依赖线段上时才重新判定，保证禁手位与 isForbiddenExact() 一致。
+ * 大多数待定点不需要递归就能判定（见 resolveByTable()），先查表判定，判定不了再做完整判定。
+ * 没有待定点时立即返回，一般局面的落子/提子没有额外开销。
+ * @param row 变化格子的行坐标
+ * @param col 变化格子的列坐标
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::resolvePendingForbidden(int row, int col) {
+    if (m_pendingForbiddenCount == 0) {
+        return;
+    }
+    RenjuArbiter<N> arbiter(m_rows[0], m_rows[1]);
+    for (int r = 0; r < N; ++r) {
+        for (unsigned bits = m_pendingForbiddenRows[r]; bits; bits &= bits - 1) {
+            const int c = BitUtils::countTrailingZeros(bits);
+            ForbiddenDeps& deps = m_forbiddenDeps[r * N + c];
+            if (!deps.affectedBy(row, col)) {
+                continue;
+            }
+            const ForbiddenVerdict verdict = resolveByTable(r, c, deps);
+            bool forbidden = verdict == ForbiddenVerdict::Forbidden;
+            if (verdict == ForbiddenVerdict::Pending) {
+                arbiter.resetDeps();
+                forbidden = arbiter.isForbidden(r, c);
+                deps = arbiter.deps();
+            }
+            const LineMask bit = static_cast<LineMask>(1u << c);
+            m_forbiddenRows[r] = forbidden ? static_cast<LineMask>(m_forbiddenRows[r] | bit)
+                                           : static_cast<LineMask>(m_forbiddenRows[r] & ~bit);
+        }
+    }
+}
+
+/**
+ * @brief 候选着法增量更新实现
+ * 实现逻辑：只有row-2~row+2这5行的候选掩码可能变化；对其中每一行，
+ * 把上下各2行的占用掩码按位或（列方向膨胀），再左右各移1、2位按位或（行方向膨胀），最后去掉已占用格。
+ * 提子时同样适用：被提走的格子若仍在其他棋子2格范围内，会重新成为候选点。
+ */
+template <int N, Rule R>
+void BasicBoard<N, R>::updateCandidates(int row) {
+    const int first = std::max(0, row - 2);
+    const int last = std::min(N - 1, row + 2);
+    for (int r = first; r <= last; ++r) {
+        unsigned near = 0;
+        for (int rr = std::max(0, r - 2); rr <= std::min(N - 1, r + 2); ++rr) {
+            near |= occupancyRow(rr);
+        }
+        near = (near | (near << 1) | (near << 2) | (near >> 1) | (near >> 2)) & ROW_FULL<N> & ~static_cast<unsigned>(occupancyRow(r));
+        m_candidateRows[r] = static_cast<LineMask>(near);
+    }
+}
+
+/**
+ * @brief 候选着法列举实现：逐行取出候选掩码（side有禁手时去掉禁手点）的置位
+ */
+template <int N, Rule R>
+int BasicBoard<N, R>::candidateMoves(int* out, Config::PieceType side) const {
+    if (m_stoneCount == 0) {
+        out[0] = (N / 2) * N + N / 2;
+        return 1;
+    }
+    int count = 0;
+    for (int row = 0; row < N; ++row) {
+        uint32_t bits = playableRow(side, row);
+        while (bits) {
+            out[count++] = row * N + BitUtils::countTrailingZeros(bits);
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 威胁优先着法列举实现
+ * 实现逻辑：
+ * Step1：对每个候选点取双方四个方向的最高棋型own/other，
+ *        排序级别 = max(2*own+1, 2*other)（同级棋型己方在前）；
+ * Step2：按级别做一次计数排序（级别只有16种），级别高的在前，同级保持行优先顺序。
+ */
+template <int N, Rule R>
+int BasicBoard<N, R>::threatOrderedMoves(Config::PieceType side, int* out) const {
+    constexpr int RANK_COUNT = 2 * PATTERN_TYPE_COUNT;
+    const int count = candidateMoves(out, side);
+    if (m_stoneCount == 0) {
+        return count;
+    }
+
+    const Config::PieceType other = Config::opponent(side);
+    uint8_t rank[N * N];
+    int bucketStart[RANK_COUNT + 1] = {};
+    for (int i = 0; i < count; ++i) {
+        const int row = out[i] / N;
+        const int col = out[i] % N;
+        int own = 0, opp = 0;
+        for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+            own = std::max(own, static_cast<int>(pattern(row, col, dir, side)));
+            opp = std::max(opp, static_cast<int>(pattern(row, col, dir, other)));
+        }
+        rank[i] = static_cast<uint8_t>(RANK_COUNT - 1 - std::max(2 * own + 1, 2 * opp));
+        ++bucketStart[rank[i] + 1];
+    }
+    for (int r = 0; r < RANK_COUNT; ++r) {
+        bucketStart[r + 1] += bucketStart[r];
+    }
+
+    int sorted[N * N];
+    for (int i = 0; i < count; ++i) {
+        sorted[bucketStart[rank[i]]++] = out[i];
+    }
+    std::copy(sorted, sorted + count, out);
+    return count;
+}
+
+template class BasicBoard<Config::BOARD_SIZE, Rule::Freestyle>;
+template class BasicBoard<Config::BOARD_SIZE, Rule::Standard>;
+template class BasicBoard<Config::BOARD_SIZE, Rule::Renju>;
+template class BasicBoard<Config::BOARD_SIZE, Rule::Caro>;
+template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Caro>;
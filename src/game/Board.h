@@ -2,26 +2,126 @@
 #ifndef BOARD_H  // 修正原宏定义笔误：BORD_H → BOARD_H
 #define BOARD_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
 #include <vector>
 #include "../utils/Utils.h"    // 工具类（坐标校验、日志等）
 #include "../story/Constants.h"// 全局配置（棋盘大小、棋子类型等，修正原路径错误：../story/Constants.h → ../utils/Constants.h）
+#include "Pattern.h"           // 棋型编码与棋型查找表
+#include "Zobrist.h"           // 编译期生成的Zobrist键表
+
+/**
+ * @brief 一次连珠禁手完整判定的读取依赖
+ * 判定只沿“被检查的空点”（待定点本身与递归检查的成活四点）的四条线读取棋子，
+ * 因此记录每个被检查点及其读到的最远距离即可：不在这些线段上的落子/提子不会改变判定结论。
+ * 被检查点超过 MAX_CELLS 个时记为 ALL（任何变化都重新判定）。
+ */
+struct ForbiddenDeps {
+    static constexpr int MAX_CELLS = 4;
+    static constexpr uint8_t ALL = 0xFF;
+
+    int8_t rows[MAX_CELLS];
+    int8_t cols[MAX_CELLS];
+    uint8_t radius[MAX_CELLS];
+    uint8_t count;
+
+    /**
+     * @brief 记录一个被检查点及其线上读到的最远距离
+     * @return int 该点在数组中的下标；超过 MAX_CELLS 个时记为 ALL 并返回-1
+     */
+    int add(int row, int col, int reach) {
+        if (count == ALL || count == MAX_CELLS) {
+            count = ALL;
+            return -1;
+        }
+        rows[count] = static_cast<int8_t>(row);
+        cols[count] = static_cast<int8_t>(col);
+        radius[count] = static_cast<uint8_t>(reach);
+        return count++;
+    }
+
+    /**
+     * @brief (row, col)的变化是否可能改变判定结论
+     */
+    bool affectedBy(int row, int col) const {
+        if (count == ALL) {
+            return true;
+        }
+        for (int i = 0; i < count; ++i) {
+            const int dr = row - rows[i];
+            const int dc = col - cols[i];
+            const int dist = std::max(std::abs(dr), std::abs(dc));
+            if ((dr == 0 || dc == 0 || dr == dc || dr == -dc) && dist <= radius[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
 
 /**
  * @brief 五子棋棋盘核心逻辑类
  * 核心职责：
- * 1. 维护15×15棋盘的状态（每个位置的棋子类型）；
+ * 1. 维护N×N棋盘的状态（每个位置的棋子类型）；
  * 2. 处理落子合法性校验（位置是否在棋盘内、是否为空）；
  * 3. 实现五子连珠的胜负判断（横、竖、斜四个方向）；
  * 4. 提供棋盘重置、状态查询等基础接口。
  * 设计特点：纯逻辑类（不继承QObject），仅负责棋盘数据与规则，与UI层解耦。
+ * 存储方式：按颜色分别维护行、列、主对角线、副对角线四组位掩码（bitboard），
+ * 每条线压缩为一个整数（N≤16时16位，否则32位），落子/提子/胜负判断/满盘判断均为若干次移位与按位运算。
+ * 棋型维护：每个格子在四个方向上各保存一个8邻居窗口编码（见Pattern.h），落子/提子时
+ * 只更新受影响的±4窗口（4方向×8格），同时增量维护全盘估值，evaluate()为O(1)。
+ * 局面哈希：落子/提子时异或对应的Zobrist键，hash()无需遍历棋盘即可唯一标识局面。
+ * 候选着法：按行维护“占用掩码膨胀2格后的空点”位掩码，落子/提子时只重算受影响的5行，
+ * AI搜索与提示功能只遍历候选集，不再扫描全部N×N个格子。
+ * 撤销栈：makeMove/unmakeMove把每手的格子与受影响的5行候选掩码压入对象内预分配的定长栈（容量N×N），
+ * 搜索与悔棋都在同一个棋盘对象上走子/退子，热路径上没有任何堆分配，也不必逐节点复制棋盘。
+ * 多尺寸：棋盘大小N为模板参数，全部循环边界、下标换算与数组大小都是编译期常量；
+ * Board.cpp 只显式实例化 15×15（Board）与 19×19（Board19）两种尺寸，
+ * 引擎各组件（SearchEngine、ThreatSolver、MctsEngine……）同样按N模板化，运行时由GameSession按棋盘大小分派。
+ * 规则变体：规则R同样是模板参数（编译期策略），决定棋型表、checkWin的成五判定与是否维护禁手；
+ * 每种规则各自实例化，热路径上没有按规则的运行时分支。
+ * 禁手（仅Renju）：按行维护黑方禁手点位掩码，与棋型编码一起在updatePatterns中增量更新
+ * （只重算落子点±5范围内约41个空点，每点4次查表），isForbidden()为O(1)，可直接用于搜索。
+ * 禁手位与连珠规则完全一致：棋型表能直接判定的（成五、长连、四四，且窗口外第5格不是黑子）直接写入；
+ * 表判为三三、或窗口外第5格的黑子可能改变判定的空点记为“待定”，由完整判定（递归排除成活四点本身是禁手的假活三）
+ * 决定，结果缓存在禁手位中，只有落子/提子落在上一次判定读到的线段上时才重判；isForbiddenExact() 是同一判定的非缓存版本。
+ * @tparam N 棋盘边长
+ * @tparam R 规则变体（默认无禁手）
  */
-class Board {
+template <int N, Rule R = Rule::Freestyle>
+class BasicBoard {
+    static_assert(N >= 5 && N <= 32, "board lines are stored in at most 32-bit masks");
+
 public:
+    /**
+     * @brief 一条线（行、列、斜线）的位掩码类型
+     */
+    using LineMask = std::conditional_t<(N <= 16), uint16_t, uint32_t>;
+
+    /**
+     * @brief 棋盘边长与格子总数（格子下标为row*SIZE+col）
+     */
+    static constexpr int SIZE = N;
+    static constexpr int CELL_COUNT = N * N;
+
+    /**
+     * @brief 规则变体
+     */
+    static constexpr Rule RULE = R;
+
     /**
      * @brief 构造函数
      * 初始化逻辑：将棋盘所有位置初始化为空棋子（PieceType::None）。
      */
-    Board();
+    BasicBoard();
+
+    /**
+     * @brief 获取规则变体
+     */
+    static constexpr Rule rule() { return R; }
 
     /**
      * @brief 重置棋盘
@@ -31,13 +131,45 @@ public:
 
     /**
      * @brief 落子操作
-     * @param row 目标行坐标（范围：0~Config::BOARD_SIZE-1）
-     * @param col 目标列坐标（范围：0~Config::BOARD_SIZE-1）
-     * @param type 棋子类型（黑棋/白棋）
+     * @param row 目标行坐标（范围：0~N-1）
+     * @param col 目标列坐标（范围：0~N-1）
+     * @param type 棋子类型（黑棋/白棋）；传入PieceType::None时等价于removePiece(row, col)（悔棋清除棋子）
      * @return bool 落子结果：true=落子成功（位置合法且为空），false=落子失败（位置越界或已有棋子）
      */
     bool placePiece(int row, int col, Config::PieceType type);
 
+    /**
+     * @brief 提子操作（悔棋、AI搜索回退时使用）
+     * @param row 目标行坐标
+     * @param col 目标列坐标
+     * @return bool 提子结果：true=成功清除棋子，false=位置越界或本来为空
+     */
+    bool removePiece(int row, int col);
+
+    /**
+     * @brief 可撤销落子（搜索、悔棋使用）
+     * 与placePiece相同的合法性校验；成功时把这一手压入撤销栈，之后必须按后进先出顺序由unmakeMove()撤销
+     * （不要用removePiece提走经makeMove落下的棋子）。
+     * @return bool 落子结果：true=成功并已入栈，false=type为None、位置越界或已有棋子（不入栈）
+     */
+    bool makeMove(int row, int col, Config::PieceType type);
+
+    /**
+     * @brief 撤销最近一次makeMove（恢复哈希、棋型编码、估值、威胁计数与候选着法）
+     * @return int 被撤销的格子下标（row*N+col）；撤销栈为空时返回-1
+     */
+    int unmakeMove();
+
+    /**
+     * @brief 撤销栈中的手数（即经makeMove落下、尚未撤销的棋子数）
+     */
+    int moveCount() const { return m_undoSize; }
+
+    /**
+     * @brief 撤销栈中第index手（0为最早）的格子下标（调用方保证0≤index<moveCount()）
+     */
+    int moveAt(int index) const { return m_undo[index].cell; }
+
     /**
      * @brief 获取指定位置的棋子类型
      * @param row 行坐标
@@ -53,7 +185,8 @@ public:
      * @param col 落子的列坐标
      * @param type 落子的棋子类型
      * @return bool 胜负结果：true=形成五子连珠，false=未获胜
-     * 核心逻辑：检查落子点的**横、竖、左上→右下、右上→左下**四个方向，是否存在连续5枚同色棋子。
+     * 核心逻辑：检查落子点的**横、竖、左上→右下、右上→左下**四个方向，是否存在连续5枚同色棋子
+     * （规则要求该方恰好五连时，长连不算获胜；Caro下两端都被对方堵住的连五不算获胜）。
      */
     bool checkWin(int row, int col, Config::PieceType type);
 
@@ -64,13 +197,313 @@ public:
      */
     bool isFull() const;
 
+    /**
+     * @brief 获取棋盘上的棋子总数
+     * @return int 已落棋子数量（0~N*N）
+     */
+    int stoneCount() const { return m_stoneCount; }
+
+    /**
+     * @brief 查询空点在指定方向上的棋型
+     * @param row 行坐标
+     * @param col 列坐标
+     * @param dir 方向（0=横，1=竖，2=左上→右下，3=右上→左下，见Pattern.h）
+     * @param color 假设在该点落子的一方
+     * @return PatternType 该点落子后在此方向上形成的棋型（调用方保证坐标合法）
+     */
+    PatternType pattern(int row, int col, int dir, Config::PieceType color) const {
+        return PatternTable::typeOf(table().entries[m_patternCode[row * N + col][dir]], color);
+    }
+
+    /**
+     * @brief 获取指定格子在指定方向上的8邻居窗口编码
+     */
+    uint16_t patternCode(int row, int col, int dir) const {
+        return m_patternCode[row * N + col][dir];
+    }
+
+    /**
+     * @brief 静态估值（增量维护，O(1)）
+     * @param side 估值视角（Black/White）
+     * @return int 对side一方的局面分：全部空点四个方向上(己方棋型分 - 对方棋型分)之和
+     */
+    int evaluate(Config::PieceType side) const {
+        return side == Config::PieceType::Black ? m_evalScore : -m_evalScore;
+    }
+
+    /**
+     * @brief 获取当前局面的64位Zobrist哈希
+     * @return uint64_t 所有棋子对应键的异或（空棋盘为0）；相同棋子分布必得相同哈希，与落子顺序无关
+     */
+    uint64_t hash() const { return m_hash; }
+
+    /**
+     * @brief 统计某方在全盘空点上能形成指定棋型的（空点, 方向）数量（增量维护，O(1)）
+     * 例如 threatCount(Black, Five) > 0 表示黑方下一手可成五。
+     * @param color 棋型所属方
+     * @param type 棋型
+     */
+    int threatCount(Config::PieceType color, PatternType type) const {
+        return m_threatCount[colorIndex(color)][static_cast<int>(type)];
+    }
+
+    /**
+     * @brief 获取某一行的占用位掩码（两种颜色合并，第col位为1表示(row, col)有子）
+     * @param row 行坐标（调用方保证合法）
+     */
+    LineMask occupancyRow(int row) const { return static_cast<LineMask>(m_rows[0][row] | m_rows[1][row]); }
+
+    /**
+     * @brief 获取某一行中指定颜色棋子的位掩码
+     * @param color 棋子颜色（Black/White）
+     * @param row 行坐标（调用方保证合法）
+     */
+    LineMask rowMask(Config::PieceType color, int row) const { return m_rows[colorIndex(color)][row]; }
+
+    /**
+     * @brief 获取某一行的候选着法位掩码（增量维护）
+     * 第col位为1表示(row, col)为空且与某枚已有棋子的行、列距离均不超过2（切比雪夫距离≤2）。
+     * @param row 行坐标（调用方保证合法）
+     */
+    LineMask candidateRow(int row) const { return m_candidateRows[row]; }
+
+    /**
+     * @brief 判断空点(row, col)对color一方是否为禁手（仅Renju黑方可能为true，增量维护，O(1)）
+     * @param row 行坐标（调用方保证合法）
+     * @param col 列坐标（调用方保证合法）
+     * @param color 落子方
+     */
+    bool isForbidden(int row, int col, Config::PieceType color = Config::PieceType::Black) const {
+        if constexpr (R == Rule::Renju) {
+            return color == Config::PieceType::Black && ((m_forbiddenRows[row] >> col) & 1u);
+        } else {
+            (void)row;
+            (void)col;
+            (void)color;
+            return false;
+        }
+    }
+
+    /**
+     * @brief 黑方在空点(row, col)落子是否为禁手的完整判定（仅Renju可能为true；越界或有子返回false）
+     * 不读缓存、直接逐线计数并递归排除假活三，结果与isForbidden()相同；用于裁决落子与校验增量禁手位。
+     */
+    bool isForbiddenExact(int row, int col) const;
+
+    /**
+     * @brief 获取某一行中color一方可以落子的候选着法位掩码（候选掩码去掉该方的禁手点）
+     * 非Renju规则或白方时与candidateRow()相同。
+     */
+    LineMask playableRow(Config::PieceType color, int row) const {
+        if constexpr (R == Rule::Renju) {
+            return color == Config::PieceType::Black ? static_cast<LineMask>(m_candidateRows[row] & ~m_forbiddenRows[row])
+                                                     : m_candidateRows[row];
+        } else {
+            (void)color;
+            return m_candidateRows[row];
+        }
+    }
+
+    /**
+     * @brief 按行优先顺序列出全部候选着法
+     * @param out 输出缓冲区（格子下标 row*N+col，容量至少N*N）
+     * @param side 落子方：为Black且规则有禁手时跳过禁手点；None表示不区分落子方
+     * @return int 候选着法数量；空棋盘时只返回天元
+     */
+    int candidateMoves(int* out, Config::PieceType side = Config::PieceType::None) const;
+
+    /**
+     * @brief 按威胁优先顺序列出全部候选着法
+     * 排序键为双方在该点的最高棋型，己方优先于对方同级棋型：
+     * 己方成五 > 堵对方成五 > 己方活四 > 堵对方活三（对方活四点）> 己方冲四 > 对方冲四点 > ……，
+     * 同级按行优先顺序，使必应着法（堵冲四、堵活三）总排在最前面；side的禁手点不列出。
+     * @param side 落子方
+     * @param out 输出缓冲区（容量至少N*N）
+     * @return int 候选着法数量；空棋盘时只返回天元
+     */
+    int threatOrderedMoves(Config::PieceType side, int* out) const;
+
 private:
     /**
-     * @brief 棋盘状态存储
-     * 15×15的二维数组，每个元素存储对应位置的棋子类型（None/Black/White）。
-     * 初始化时所有元素为PieceType::None。
+     * @brief 对角线条数：N×N棋盘每个斜方向共有2*N-1条斜线
+     */
+    static constexpr int DIAG_COUNT = 2 * N - 1;
+
+    /**
+     * @brief 规则R对应的棋型表（PATTERN_TABLES中的一张，只读共享，地址为链接期常量）
+     */
+    static const PatternTable& table() { return PatternTable::get(R); }
+
+    /**
+     * @brief 判断坐标是否在棋盘范围内
+     */
+    static bool inRange(int row, int col) {
+        return row >= 0 && row < N && col >= 0 && col < N;
+    }
+
+    /**
+     * @brief 棋子类型转颜色下标：Black→0，White→1（调用方保证type不为None）
+     */
+    static int colorIndex(Config::PieceType type) {
+        return type == Config::PieceType::Black ? 0 : 1;
+    }
+
+    /**
+     * @brief 根据当前棋子重新计算全部窗口编码与估值（仅reset时调用）
+     */
+    void rebuildPatterns();
+
+    /**
+     * @brief 落子/提子后增量更新±4窗口内的编码与估值
+     * @param row 变化格子的行坐标
+     * @param col 变化格子的列坐标
+     * @param value 该格子的新编码（PatternCode::EMPTY/BLACK/WHITE）
+     */
+    void updatePatterns(int row, int col, uint16_t value);
+
+    /**
+     * @brief 把一个空点棋型表项的双方棋型计入（delta=+1）或移出（delta=-1）威胁计数
+     */
+    void countThreats(uint32_t entry, int delta);
+
+    /**
+     * @brief 由棋型表项得到的禁手判定：不是禁手、是禁手（长连/四四）、待定（三三需排除假活三，或窗口外的棋子可能改变判定）
+     */
+    enum class ForbiddenVerdict : uint8_t { Allowed, Forbidden, Pending };
+
+    /**
+     * @brief 由空点四个方向的表项判断黑方在该点落子是否为禁手（仅Renju使用）
+     */
+    static ForbiddenVerdict forbiddenByEntries(const uint32_t (&entries)[DIRECTION_COUNT]);
+
+    /**
+     * @brief 黑子能否沿dir方向sign一侧连到窗口外第5格，使棋型表的判定不可靠（仅Renju使用）
+     */
+    bool reachesBeyondWindow(int row, int col, int dir, int sign) const;
+
+    /**
+     * @brief 重算(row, col)的禁手位与待定位（仅Renju使用；有子的格子一律清零）
+     */
+    void refreshForbidden(int row, int col);
+
+    /**
+     * @brief 待定点(row, col)的快速判定：只用棋型编码与±5格线段区分真假活三，不做递归（仅Renju使用）
+     * @return ForbiddenVerdict 能判定时返回Allowed/Forbidden并写入读取依赖；否则返回Pending，交给完整判定
+     */
+    ForbiddenVerdict resolveByTable(int row, int col, ForbiddenDeps& deps) const;
+
+    /**
+     * @brief (row, col)变化后，对读取依赖包含该格的待定点重新做完整判定并写入禁手位（仅Renju使用）
+     */
+    void resolvePendingForbidden(int row, int col);
+
+    /**
+     * @brief 落子/提子后重算row±2行的候选着法位掩码
+     */
+    void updateCandidates(int row);
+
+    /**
+     * @brief 在(row, col)置入/清除颜色下标为c的棋子：更新四组掩码、棋子计数、哈希与棋型估值（不含候选着法）
+     */
+    void addStone(int row, int col, int c);
+    void clearStone(int row, int col, int c);
+
+    /**
+     * @brief 撤销栈记录：落子格子与落子前row-2~row+2行的候选掩码（越界行不使用）
+     */
+    struct UndoEntry {
+        int16_t cell;
+        LineMask candidateRows[5];
+    };
+
+    /**
+     * @brief 按颜色分组的行位掩码：m_rows[颜色][行]的第col位表示(row, col)有该颜色棋子
      */
-    Config::PieceType m_grid[Config::BOARD_SIZE][Config::BOARD_SIZE];
+    LineMask m_rows[2][N];
+
+    /**
+     * @brief 按颜色分组的列位掩码：m_cols[颜色][列]的第row位表示(row, col)有该颜色棋子
+     */
+    LineMask m_cols[2][N];
+
+    /**
+     * @brief 主对角线（左上→右下）位掩码：下标为row-col+N-1，第col位对应(row, col)
+     */
+    LineMask m_diags[2][DIAG_COUNT];
+
+    /**
+     * @brief 副对角线（右上→左下）位掩码：下标为row+col，第col位对应(row, col)
+     */
+    LineMask m_antiDiags[2][DIAG_COUNT];
+
+    /**
+     * @brief 当前棋子总数（isFull直接与格子总数比较，无需遍历棋盘）
+     */
+    int m_stoneCount = 0;
+
+    /**
+     * @brief 棋型窗口编码表：m_patternCode[row*N+col][方向]
+     * 对所有格子（含已落子格子）都保持最新，提子后可直接恢复该格的估值贡献。
+     */
+    uint16_t m_patternCode[N * N][DIRECTION_COUNT];
+
+    /**
+     * @brief 黑方视角的全盘估值：所有空点四个方向PatternTable::score()之和
+     */
+    int m_evalScore = 0;
+
+    /**
+     * @brief 威胁计数：m_threatCount[颜色][棋型] = 该方能在此棋型上落子的（空点, 方向）数量
+     */
+    int m_threatCount[2][PATTERN_TYPE_COUNT];
+
+    /**
+     * @brief 局面Zobrist哈希（落子/提子时增量异或，reset时归零）
+     */
+    uint64_t m_hash = 0;
+
+    /**
+     * @brief 候选着法行位掩码：占用掩码在行、列方向各膨胀2格后去掉已占用格
+     */
+    LineMask m_candidateRows[N];
+
+    /**
+     * @brief 黑方禁手点行位掩码（仅Renju维护，其他规则恒为0）
+     */
+    LineMask m_forbiddenRows[N];
+
+    /**
+     * @brief 待定点行位掩码与个数（仅Renju维护）：禁手位由完整判定决定的空点，见 refreshForbidden()
+     */
+    LineMask m_pendingForbiddenRows[N];
+    int m_pendingForbiddenCount = 0;
+
+    /**
+     * @brief 每个待定点上一次完整判定的读取依赖；新记入的待定点为 ForbiddenDeps::ALL（仅Renju维护）
+     */
+    ForbiddenDeps m_forbiddenDeps[N * N];
+
+    /**
+     * @brief 撤销栈（定长、随棋盘对象分配）：每个格子至多落一子，N×N条记录足够
+     */
+    UndoEntry m_undo[N * N];
+    int m_undoSize = 0;
 };
 
+/**
+ * @brief 默认15×15棋盘与可选19×19棋盘（无禁手规则）
+ * 两种尺寸×四种规则共8个特化在Board.cpp中显式实例化。
+ */
+using Board = BasicBoard<Config::BOARD_SIZE>;
+using Board19 = BasicBoard<Config::LARGE_BOARD_SIZE>;
+
+extern template class BasicBoard<Config::BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicBoard<Config::BOARD_SIZE, Rule::Standard>;
+extern template class BasicBoard<Config::BOARD_SIZE, Rule::Renju>;
+extern template class BasicBoard<Config::BOARD_SIZE, Rule::Caro>;
+extern template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Freestyle>;
+extern template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Standard>;
+extern template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Renju>;
+extern template class BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Caro>;
+
 #endif // BOARD_H
@@ -0,0 +1,300 @@
+﻿#include "BoardEval.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BOARDEVAL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要按函数开启目标指令集（整个工程仍按基线指令集编译，运行时再决定是否调用）；MSVC 无需额外标记
+#if defined(BOARDEVAL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BOARDEVAL_TARGET_AVX2 __attribute__((target("avx2")))
+#define BOARDEVAL_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define BOARDEVAL_TARGET_AVX2
+#define BOARDEVAL_TARGET_SSE2
+#endif
+
+namespace {
+
+constexpr int PAD = PatternCode::WINDOW_RADIUS;
+
+/**
+ * @brief 一次处理的格子数（AVX2一个寄存器16个16位格子）
+ */
+constexpr int LANES = 16;
+
+/**
+ * @brief 四周补边界的格子网格：cells[row+PAD][col+PAD]为(row, col)的格子编码（PatternCode），棋盘外为EDGE；
+ *        棋盘宽度向上取整到LANES的倍数（15×15为1组，19×19为2组）
+ */
+template <int N>
+struct Grid {
+    static constexpr int CHUNKS = (N + LANES - 1) / LANES;
+    static constexpr int ROWS = N + 2 * PAD;
+    static constexpr int COLS = CHUNKS * LANES + 2 * PAD;
+    alignas(32) uint16_t cells[ROWS][COLS];
+};
+
+/**
+ * @brief 由棋子行位掩码展开格子网格
+ */
+template <int N, Rule R>
+void buildGrid(const BasicBoard<N, R>& board, Grid<N>& grid) {
+    std::fill(&grid.cells[0][0], &grid.cells[0][0] + Grid<N>::ROWS * Grid<N>::COLS, PatternCode::EDGE);
+    for (int row = 0; row < N; ++row) {
+        const unsigned black = board.rowMask(Config::PieceType::Black, row);
+        const unsigned white = board.rowMask(Config::PieceType::White, row);
+        uint16_t* out = &grid.cells[row + PAD][PAD];
+        for (int col = 0; col < N; ++col) {
+            out[col] = static_cast<uint16_t>(((black >> col) & 1u) | (((white >> col) & 1u) << 1));
+        }
+    }
+}
+
+/**
+ * @brief 标量实现（参考实现）：逐格逐方向拼编码、查表
+ */
+template <int N>
+int evaluateScalar(const Grid<N>& grid, const uint32_t* table, int* heat) {
+    int score = 0;
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            int cellHeat = 0;
+            if (grid.cells[row + PAD][col + PAD] == PatternCode::EMPTY) {
+                for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                    uint32_t code = 0;
+                    for (int k = -PAD; k <= PAD; ++k) {
+                        if (k != 0) {
+                            const uint32_t v = grid.cells[row + PAD + k * DIR_DR[dir]][col + PAD + k * DIR_DC[dir]];
+                            code |= v << (PatternCode::slotOf(k) * 2);
+                        }
+                    }
+                    const uint32_t entry = table[code];
+                    score += PatternTable::scoreOf(entry);
+                    cellHeat += PATTERN_SCORE[entry & 0x0F] + PATTERN_SCORE[(entry >> 4) & 0x0F];
+                }
+            }
+            if (heat) {
+                heat[row * N + col] = cellHeat;
+            }
+        }
+    }
+    return score;
+}
+
+#if defined(BOARDEVAL_X86)
+
+/**
+ * @brief SSE2实现：8格一组用向量移位/或运算拼出编码，再逐格查表（SSE2没有gather指令）
+ */
+template <int N>
+BOARDEVAL_TARGET_SSE2
+int evaluateSse2(const Grid<N>& grid, const uint32_t* table, int* heat) {
+    int score = 0;
+    alignas(16) uint16_t centers[8];
+    alignas(16) uint16_t codes[DIRECTION_COUNT][8];
+    for (int row = 0; row < N; ++row) {
+        for (int c0 = 0; c0 < N; c0 += 8) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(centers),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&grid.cells[row + PAD][c0 + PAD])));
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                __m128i code = _mm_setzero_si128();
+                for (int k = -PAD; k <= PAD; ++k) {
+                    if (k == 0) {
+                        continue;
+                    }
+                    const uint16_t* src = &grid.cells[row + PAD + k * DIR_DR[dir]][c0 + PAD + k * DIR_DC[dir]];
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    code = _mm_or_si128(code, _mm_sll_epi16(v, _mm_cvtsi32_si128(PatternCode::slotOf(k) * 2)));
+                }
+                _mm_store_si128(reinterpret_cast<__m128i*>(codes[dir]), code);
+            }
+            const int lanes = std::min(8, N - c0);
+            for (int lane = 0; lane < lanes; ++lane) {
+                int cellHeat = 0;
+                if (centers[lane] == PatternCode::EMPTY) {
+                    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                        const uint32_t entry = table[codes[dir][lane]];
+                        score += PatternTable::scoreOf(entry);
+                        cellHeat += PATTERN_SCORE[entry & 0x0F] + PATTERN_SCORE[(entry >> 4) & 0x0F];
+                    }
+                }
+                if (heat) {
+                    heat[row * N + c0 + lane] = cellHeat;
+                }
+            }
+        }
+    }
+    return score;
+}
+
+/**
+ * @brief AVX2实现：16格一组拼编码，零扩展为两组8×32位下标后gather查表，
+ *        估值（表项高16位，算术右移得到有符号值）与热度（棋型号经permutevar查PATTERN_SCORE）全部向量累加，
+ *        已落子格子与棋盘外格子由“中心为空”掩码清零。
+ */
+template <int N>
+BOARDEVAL_TARGET_AVX2
+int evaluateAvx2(const Grid<N>& grid, const uint32_t* table, int* heat) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i nibble = _mm256_set1_epi32(0x0F);
+    const __m256i patternScore = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(PATTERN_SCORE));
+    const int* base = reinterpret_cast<const int*>(table);
+    __m256i acc = zero;
+    alignas(32) int32_t rowHeat[Grid<N>::CHUNKS * LANES];
+
+    for (int row = 0; row < N; ++row) {
+        for (int chunk = 0; chunk < Grid<N>::CHUNKS; ++chunk) {
+            const int c0 = chunk * LANES;
+            const __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&grid.cells[row + PAD][c0 + PAD]));
+            const __m256i empty = _mm256_cmpeq_epi16(center, zero);
+            const __m256i maskLo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(empty));
+            const __m256i maskHi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(empty, 1));
+            __m256i heatLo = zero;
+            __m256i heatHi = zero;
+
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                __m256i code = zero;
+                for (int k = -PAD; k <= PAD; ++k) {
+                    if (k == 0) {
+                        continue;
+                    }
+                    const uint16_t* src = &grid.cells[row + PAD + k * DIR_DR[dir]][c0 + PAD + k * DIR_DC[dir]];
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+                    code = _mm256_or_si256(code, _mm256_sll_epi16(v, _mm_cvtsi32_si128(PatternCode::slotOf(k) * 2)));
+                }
+                const __m256i entryLo = _mm256_i32gather_epi32(base, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(code)), 4);
+                const __m256i entryHi = _mm256_i32gather_epi32(base, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(code, 1)), 4);
+                acc = _mm256_add_epi32(acc, _mm256_and_si256(_mm256_srai_epi32(entryLo, 16), maskLo));
+                acc = _mm256_add_epi32(acc, _mm256_and_si256(_mm256_srai_epi32(entryHi, 16), maskHi));
+                if (heat) {
+                    const __m256i lo = _mm256_add_epi32(
+                        _mm256_permutevar8x32_epi32(patternScore, _mm256_and_si256(entryLo, nibble)),
+                        _mm256_permutevar8x32_epi32(patternScore, _mm256_and_si256(_mm256_srli_epi32(entryLo, 4), nibble)));
+                    const __m256i hi = _mm256_add_epi32(
+                        _mm256_permutevar8x32_epi32(patternScore, _mm256_and_si256(entryHi, nibble)),
+                        _mm256_permutevar8x32_epi32(patternScore, _mm256_and_si256(_mm256_srli_epi32(entryHi, 4), nibble)));
+                    heatLo = _mm256_add_epi32(heatLo, _mm256_and_si256(lo, maskLo));
+                    heatHi = _mm256_add_epi32(heatHi, _mm256_and_si256(hi, maskHi));
+                }
+            }
+            if (heat) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(&rowHeat[c0]), heatLo);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(&rowHeat[c0 + 8]), heatHi);
+            }
+        }
+        if (heat) {
+            std::copy(rowHeat, rowHeat + N, heat + row * N);
+        }
+    }
+
+    const __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    const __m128i sum2 = _mm_add_epi32(sum4, _mm_shuffle_epi32(sum4, _MM_SHUFFLE(1, 0, 3, 2)));
+    const __m128i sum1 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum1);
+}
+
+/**
+ * @brief CPU能力检测：AVX2需要CPU支持且操作系统保存YMM寄存器状态（OSXSAVE + XCR0）
+ */
+bool detectAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool detectSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;    // x86-64基线指令集
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // BOARDEVAL_X86
+
+} // namespace
+
+namespace BoardEval {
+
+bool isSupported(Isa isa) {
+#if defined(BOARDEVAL_X86)
+    static const bool sse2 = detectSse2();
+    static const bool avx2 = sse2 && detectAvx2();
+    switch (isa) {
+    case Isa::AVX2: return avx2;
+    case Isa::SSE2: return sse2;
+    default: return true;
+    }
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+Isa bestIsa() {
+    static const Isa best = isSupported(Isa::AVX2) ? Isa::AVX2
+                          : isSupported(Isa::SSE2) ? Isa::SSE2 : Isa::Scalar;
+    return best;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+    case Isa::AVX2: return "AVX2";
+    case Isa::SSE2: return "SSE2";
+    default: return "Scalar";
+    }
+}
+
+/**
+ * @brief 估值入口实现：展开网格 → 按指令集分派到对应内核（不支持时退回标量实现）
+ */
+template <int N, Rule R>
+int evaluate(const BasicBoard<N, R>& board, int* heat, Isa isa) {
+    Grid<N> grid;
+    buildGrid(board, grid);
+    const uint32_t* table = PatternTable::get(R).entries;
+#if defined(BOARDEVAL_X86)
+    if (isa == Isa::AVX2 && isSupported(Isa::AVX2)) {
+        return evaluateAvx2(grid, table, heat);
+    }
+    if (isa == Isa::SSE2 && isSupported(Isa::SSE2)) {
+        return evaluateSse2(grid, table, heat);
+    }
+#endif
+    return evaluateScalar(grid, table, heat);
+}
+
+template int evaluate<Config::BOARD_SIZE, Rule::Freestyle>(const BasicBoard<Config::BOARD_SIZE, Rule::Freestyle>&, int*, Isa);
+template int evaluate<Config::BOARD_SIZE, Rule::Standard>(const BasicBoard<Config::BOARD_SIZE, Rule::Standard>&, int*, Isa);
+template int evaluate<Config::BOARD_SIZE, Rule::Renju>(const BasicBoard<Config::BOARD_SIZE, Rule::Renju>&, int*, Isa);
+template int evaluate<Config::BOARD_SIZE, Rule::Caro>(const BasicBoard<Config::BOARD_SIZE, Rule::Caro>&, int*, Isa);
+template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Freestyle>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Freestyle>&, int*, Isa);
+template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Standard>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Standard>&, int*, Isa);
+template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Renju>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Renju>&, int*, Isa);
+template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Caro>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Caro>&, int*, Isa);
+
+} // namespace BoardEval
@@ -0,0 +1,73 @@
+﻿#pragma once
+#ifndef BOARDEVAL_H
+#define BOARDEVAL_H
+
+#include <cstdint>
+#include "Board.h"
+
+/**
+ * @brief 全盘静态估值内核（从零计算，SIMD加速）
+ * 核心职责：不依赖Board的增量状态，直接由棋子位掩码重新计算全盘估值与每个空点的攻防热度，
+ * 结果与Board::evaluate()的增量估值逐位一致（全部为整数运算）。
+ * 使用现状：独立内核，应用内（搜索、界面、对局会话）尚无调用方，估值接口目前只由
+ * BoardEvalTest/BoardSizeTest 校验增量估值、EvalBench/MicroBench 测速使用；
+ * 其余模块仅复用这里的指令集检测（bestIsa/isSupported，见Nnue）。
+ * 计算方式：先把棋盘展开为四周各补4格边界的16位格子网格，再逐行处理——
+ * 同一行的全部格子在四个方向上的8邻居窗口编码，都可以由网格中相邻若干行的错位加载拼出
+ * （横向：同一行左右错位；纵向：上下各行同列；两条斜线：上下各行再左右错位），
+ * 因此一次向量运算同时得到一整行格子在某个方向上的编码，再查PatternTable表项累加。
+ * 指令集：AVX2（16格/次，查表用gather）→ SSE2（8格/次拼编码，标量查表）→ 标量，运行时按CPU能力自动选择。
+ */
+namespace BoardEval {
+
+/**
+ * @brief 内核指令集
+ */
+enum class Isa : uint8_t { Scalar, SSE2, AVX2 };
+
+/**
+ * @brief 当前CPU是否支持指定指令集（非x86平台只支持Scalar）
+ */
+bool isSupported(Isa isa);
+
+/**
+ * @brief 当前CPU支持的最快指令集（首次调用时检测，之后直接返回缓存结果）
+ */
+Isa bestIsa();
+
+/**
+ * @brief 指令集名称（用于日志与基准输出）
+ */
+const char* isaName(Isa isa);
+
+/**
+ * @brief 全盘估值（指定指令集；CPU不支持时退回标量实现，供测试与基准比对）
+ * @param board 局面（按其规则R选择棋型表；两种尺寸×四种规则已在BoardEval.cpp中实例化）
+ * @param heat 可选输出：N*N个格子的攻防热度——
+ *             空点为四个方向上(黑方棋型分 + 白方棋型分)之和，已落子格子为0；可为nullptr
+ * @param isa 指令集
+ * @return int 黑方视角的估值，与board.evaluate(Black)相等
+ */
+template <int N, Rule R>
+int evaluate(const BasicBoard<N, R>& board, int* heat, Isa isa);
+
+/**
+ * @brief 全盘估值（使用bestIsa()）
+ */
+template <int N, Rule R>
+int evaluate(const BasicBoard<N, R>& board, int* heat = nullptr) {
+    return evaluate(board, heat, bestIsa());
+}
+
+extern template int evaluate<Config::BOARD_SIZE, Rule::Freestyle>(const BasicBoard<Config::BOARD_SIZE, Rule::Freestyle>&, int*, Isa);
+extern template int evaluate<Config::BOARD_SIZE, Rule::Standard>(const BasicBoard<Config::BOARD_SIZE, Rule::Standard>&, int*, Isa);
+extern template int evaluate<Config::BOARD_SIZE, Rule::Renju>(const BasicBoard<Config::BOARD_SIZE, Rule::Renju>&, int*, Isa);
+extern template int evaluate<Config::BOARD_SIZE, Rule::Caro>(const BasicBoard<Config::BOARD_SIZE, Rule::Caro>&, int*, Isa);
+extern template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Freestyle>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Freestyle>&, int*, Isa);
+extern template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Standard>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Standard>&, int*, Isa);
+extern template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Renju>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Renju>&, int*, Isa);
+extern template int evaluate<Config::LARGE_BOARD_SIZE, Rule::Caro>(const BasicBoard<Config::LARGE_BOARD_SIZE, Rule::Caro>&, int*, Isa);
+
+} // namespace BoardEval
+
+#endif // BOARDEVAL_H
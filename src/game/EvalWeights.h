@@ -0,0 +1,13 @@
+﻿#pragma once
+#ifndef EVALWEIGHTS_H
+#define EVALWEIGHTS_H
+
+// 由 tools/TexelTuner 生成（重新调参后整个文件被覆盖，请勿手工修改）
+// 来源：初始手工权重（尚未用自对弈数据调参）
+
+/**
+ * @brief 棋型估值表（按PatternType下标）：空点在某方向上对某方可形成的棋型分值
+ */
+constexpr int PATTERN_SCORE[] = { 0, 2, 8, 10, 60, 80, 500, 5000 };
+
+#endif // EVALWEIGHTS_H
@@ -1,9 +1,46 @@
 ﻿#include "GameController.h"
+#include <QCoreApplication> // 开局库路径（可执行文件所在目录）
 #include <QDebug>       // 调试日志打印
 #include <QTimer>       // AI 思考延迟
 #include <cstdlib>      // AI 随机落子的随机数生成
+#include <string>
 #include "../story/Constants.h" // 全局配置（棋子类型、棋盘大小）
 
+namespace {
+
+/**
+ * @brief 把格子下标序列转为“列字母+行号”坐标串（如 "h8 i9 h9"），用于显示主要变例
+ */
+QString formatMoves(const std::vector<int>& cells, int boardSize)
+{
+    std::string text;
+    for (const int cell : cells) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += static_cast<char>('a' + cell % boardSize);
+        text += std::to_string(cell / boardSize + 1);
+    }
+    return QString::fromStdString(text);
+}
+
+/**
+ * @brief 把各轮迭代耗时转为 "深度:毫秒" 串（如 "1:0 2:1 3:4"），用于调试面板与日志
+ */
+QString formatIterations(const std::vector<IterationStats>& iterations)
+{
+    std::string text;
+    for (const IterationStats& iteration : iterations) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += std::to_string(iteration.depth) + ':' + std::to_string(iteration.timeMs);
+    }
+    return QString::fromStdString(text);
+}
+
+} // namespace
+
 /**
  * @brief 构造函数实现：初始化玩家与游戏状态
  * 详细实现逻辑：
@@ -12,8 +49,10 @@
  * 3. 初始化白棋玩家：名称“白方”，棋子类型 White，默认人类玩家（人机模式下动态修改）；
  * 4. 设置当前玩家为黑方（五子棋规则：黑方先手）；
  * 5. 初始化游戏结束标记为 false；
- * 6. （可选）清空落子历史记录（m_moveHistory.clear()）；
- * 7. 打印初始化日志，便于调试。
+ * 6. 创建默认尺寸（Config::BOARD_SIZE）的对局会话（落子历史由棋盘撤销栈记录）；
+ * 7. 映射可执行文件同目录下的开局库（Config::OPENING_BOOK_FILE），文件不存在时 AI 直接搜索；
+ * 8. 映射当前尺寸的神经网络估值权重（Config::NNUE_FILE），文件不存在时困难 AI 使用棋型估值；
+ * 9. 打印初始化日志，便于调试。
  * @param parent 父对象指针（由 AppController 传入）
  */
 GameController::GameController(QObject *parent)
@@ -23,114 +62,298 @@ GameController::GameController(QObject *parent)
     , m_whitePlayer("白方", Config::PieceType::White, Player::Type::Human)
     , m_currentPlayer(&m_blackPlayer) // 黑方先手
     , m_isGameOver(false)
+    , m_session(GameSession::create(Config::BOARD_SIZE))
+{
+    m_session->setThreadCount(Config::AI_THREAD_COUNT);
+    if (m_book.load(QCoreApplication::applicationDirPath() + "/" + Config::OPENING_BOOK_FILE)) {
+        qInfo() << "[GameController] 开局库已加载，条目数" << m_book.entryCount();
+    }
+    loadNetwork();
+    qInfo() << "[GameController] 初始化完成，默认黑方先手，AI 搜索线程数" << m_session->threadCount();
+}
+
+/**
+ * @brief 装载神经网络估值实现
+ * 实现逻辑：
+ * Step1：开关关闭时直接返回（会话默认即棋型估值）；
+ * Step2：已映射的网络尺寸与会话不同时，解除映射并映射该尺寸的权重文件（文件不存在时保持未加载）；
+ * Step3：把已加载的网络交给会话，成功时打印日志。
+ */
+void GameController::loadNetwork()
+{
+    if (!Config::AI_NNUE_ENABLED) {
+        return;
+    }
+    const int boardSize = m_session->boardSize();
+    if (m_network.boardSize() != boardSize) {
+        m_network.load(QCoreApplication::applicationDirPath() + "/" + Config::NNUE_FILE.arg(boardSize));
+    }
+    if (m_network.isLoaded() && m_session->setNetwork(&m_network)) {
+        qInfo() << "[GameController] 困难 AI 使用神经网络估值，棋盘" << boardSize << "x" << boardSize;
+    }
+}
+
+/**
+ * @brief 设置 AI 搜索线程数实现
+ * 实现逻辑：AI 正在工作线程上搜索时先取消（搜索引擎不能在搜索中途重建辅助实例），
+ * 线程数实际变化时才重建辅助搜索实例并发射 aiThreadCountChanged()，之后按新线程数重新发起这一步的搜索。
+ * @param threads 线程总数，<=0 表示使用全部硬件线程
+ */
+void GameController::setAiThreadCount(int threads)
+{
+    const bool restart = m_aiWorker.isBusy();
+    if (restart) {
+        cancelAIMove();
+    }
+    stopPondering();
+    const int before = m_session->threadCount();
+    m_session->setThreadCount(threads);
+    if (m_session->threadCount() != before) {
+        qInfo() << "[GameController] AI 搜索线程数" << before << "->" << m_session->threadCount();
+        emit aiThreadCountChanged();
+    }
+    if (restart) {
+        processAIMove();
+    }
+    startPondering();
+}
+
+/**
+ * @brief 设置后台思考开关实现
+ * 实现逻辑：关闭时立即停止后台思考；开启时若正轮到人类，则立即开始后台思考。
+ * @param enabled 是否开启
+ */
+void GameController::setPonderEnabled(bool enabled)
+{
+    if (m_ponderEnabled == enabled) {
+        return;
+    }
+    m_ponderEnabled = enabled;
+    if (enabled) {
+        startPondering();
+    } else {
+        stopPondering();
+    }
+    emit ponderEnabledChanged();
+}
+
+/**
+ * @brief 开始后台思考实现
+ * 实现逻辑：仅当开关开启、游戏未结束、当前为人类回合且对手是困难 AI 时，
+ * 以“人类行棋方”的当前局面启动 Ponderer；人类落子后 AI 的正式搜索将复用置换表中的结果。
+ */
+void GameController::startPondering()
 {
-    // 初始化落子历史记录（可选，悔棋功能用）
-    m_moveHistory.clear();
-    qInfo() << "[GameController] 初始化完成，默认黑方先手";
+    if (!m_ponderEnabled || m_isGameOver || m_currentPlayer->isAI()) {
+        return;
+    }
+    const Player& opponent = m_currentPlayer == &m_blackPlayer ? m_whitePlayer : m_blackPlayer;
+    if (opponent.type() != Player::Type::AI_Hard) {
+        return;
+    }
+    m_session->startPondering(m_currentPlayer->color(), Config::AI_PONDER_MAX_MS);
+}
+
+/**
+ * @brief 停止后台思考实现
+ * 实现逻辑：GameSession::stopPondering() 立即中断后台搜索并等待线程退出；
+ * 若由人类落子触发，则打印后台思考深度与预测应手是否命中。
+ * @param playedCell 人类实际落子的格子下标，-1 表示非落子原因停止
+ */
+void GameController::stopPondering(int playedCell)
+{
+    const SearchResult result = m_session->stopPondering();
+    if (playedCell >= 0 && result.row >= 0) {
+        const bool hit = result.row * m_session->boardSize() + result.col == playedCell;
+        qInfo() << "[GameController] 后台思考结束：深度" << result.depth << "节点" << result.nodes
+                << "预测应手" << (hit ? "命中" : "未命中");
+    }
 }
 
 /**
  * @brief 开始新游戏函数实现
- * 详细实现逻辑（组员需补充完善）：
- * Step1：重置棋盘状态
- * - 调用 m_board.reset()，将棋盘所有位置恢复为空。
- * Step2：重置游戏状态与玩家类型
- * - 将 m_isGameOver 设为 false；
- * - 根据 mode 参数设置玩家类型：mode=1 时，将 m_whitePlayer 的类型改为 Player::Type::AI；
- * - 重置当前玩家为黑方（&m_blackPlayer）。
- * Step3：同步 UI 与日志
- * - 发射 turnChanged() 信号，通知 QML 更新当前玩家显示；
- * - 打印游戏模式日志，便于调试。
- * Step4：清空历史记录（悔棋用）
- * - 调用 m_moveHistory.clear()。
- * @param mode 游戏模式：0=人人对战，1=人机对战
- */
-void GameController::startGame(int mode)
-{
-    // 基础空实现（已完成部分逻辑，需补充）
+ * 实现逻辑：
+ * Step1：立即停止后台思考，取消 AI 搜索并作废尚未执行的 AI 落子（cancelAIMove），重置游戏结束标记；
+ *        棋盘尺寸变化时按新尺寸重建 GameSession（保留 AI 线程数）并发射 boardSizeChanged()，否则只重置棋盘；
+ * Step2：根据 mode 设置玩家类型：mode=1 时白方为困难 AI（Player::Type::AI_Hard），mode=2 时白方为 MCTS AI（Player::Type::AI_MCTS），否则双方均为人类；
+ * Step3：重置当前玩家为黑方（先手），清空 AI 置换表（落子历史随棋盘一起重置）；
+ * Step4：发射 turnChanged() 信号同步 UI，并打印游戏模式日志。
+ * @param mode 游戏模式：0=人人对战，1=人机对战（困难AI），2=人机对战（MCTS AI）
+ * @param boardSize 棋盘边长（15 或 19），不支持的尺寸打印警告并回退为 Config::BOARD_SIZE
+ */
+void GameController::startGame(int mode, int boardSize, int rule)
+{
+    stopPondering();
+    cancelAIMove();
     m_isGameOver = false;
-    // 重置棋盘（组员补充：m_board.reset();）
-    // 重置玩家类型（组员补充：人机模式下修改白方类型）
+    if (!GameSession::isSupportedSize(boardSize)) {
+        qWarning() << "[GameController] 不支持的棋盘尺寸" << boardSize << "，使用默认尺寸" << Config::BOARD_SIZE;
+        boardSize = Config::BOARD_SIZE;
+    }
+    if (rule < 0 || rule >= RULE_COUNT) {
+        qWarning() << "[GameController] 未知规则" << rule << "，使用无禁手规则";
+        rule = static_cast<int>(Rule::Freestyle);
+    }
+    const bool sizeChanged = boardSize != m_session->boardSize();
+    const bool ruleChanged = rule != static_cast<int>(m_session->rule());
+    if (sizeChanged || ruleChanged) {
+        const int threads = m_session->threadCount();
+        m_session.reset(); // 先释放旧会话（置换表、节点池），再分配新会话
+        m_session = GameSession::create(boardSize, static_cast<Rule>(rule));
+        m_session->setThreadCount(threads);
+        loadNetwork();
+        if (sizeChanged) {
+            emit boardSizeChanged();
+        }
+        if (ruleChanged) {
+            emit this->ruleChanged();
+        }
+    } else {
+        m_session->reset();
+    }
+    m_whitePlayer = Player("白方", Config::PieceType::White,
+                           mode == 1 ? Player::Type::AI_Hard
+                                     : (mode == 2 ? Player::Type::AI_MCTS : Player::Type::Human));
     m_currentPlayer = &m_blackPlayer; // 黑方先手
+    m_session->clearEngine();
     emit turnChanged(); // 发送换手信号，更新 UI 显示
-    // 清空落子历史（组员补充：m_moveHistory.clear();）
-    qInfo() << "[GameController] 游戏开始，模式：" << (mode == 0 ? "人人对战" : "人机对战");
+    qInfo() << "[GameController] 游戏开始，模式：" << (mode == 0 ? "人人对战" : (mode == 2 ? "人机对战（MCTS）" : "人机对战"))
+            << "棋盘" << boardSize << "x" << boardSize << "规则" << rule;
 }
 
 /**
  * @brief 处理 QML 落子输入函数实现
- * 详细实现逻辑（组员需补充核心逻辑）：
+ * 实现逻辑：
  * Step1：前置校验（快速失败）
  * - 若 m_isGameOver 为 true，打印警告并返回（游戏已结束，禁止落子）；
- * - 若当前玩家是 AI，打印警告并返回（AI 落子由 processAIMove 处理）；
- * - 调用 m_board.placePiece() 执行落子，传入（row, col, 当前玩家棋子类型），接收落子结果。
- * Step2：落子失败处理
- * - 若 placePiece 返回 false，打印“落子失败（位置越界/已有棋子）”日志并返回。
- * Step3：落子成功处理
- * - 记录落子坐标到历史记录：m_moveHistory.append(QPair<int, int>(row, col));
- * - 转换棋子类型为编码（None=0, Black=1, White=2），发射 pieceAdded 信号通知 QML 渲染棋子；
- * - 播放落子音效（组员补充：调用 ResourceManager::instance().playSound("drop_chess.wav")）。
- * Step4：胜负与平局判定
- * - 调用 m_board.checkWin(row, col, m_currentPlayer->pieceType()) 判断是否获胜：
- *   → 获胜：设置 m_isGameOver = true，发射 gameOver(m_currentPlayer->name()) 信号，返回；
- * - 调用 m_board.isFull() 判断是否平局：
- *   → 平局：设置 m_isGameOver = true，发射 gameOver("平局") 信号，返回；
- * Step5：切换回合与 AI 落子
- * - 调用 switchTurn() 切换玩家；
- * - 若新的当前玩家是 AI，调用 processAIMove() 触发 AI 落子。
+ * - 若当前玩家是 AI，打印警告并返回（AI 落子由 processAIMove 处理）。
+ * Step2：停止后台思考（其结果已留在置换表中，供随后的 AI 搜索复用），
+ *        调用 applyMove() 完成落子、胜负判定与回合切换；落子无效时恢复后台思考。
  * @param row 落子行坐标
  * @param col 落子列坐标
  */
 void GameController::handleInput(int row, int col)
 {
-    // 基础空实现（需补充核心逻辑）
     qInfo() << "[GameController] 收到落子输入：行" << row << "列" << col;
 
-    // 组员补充：前置校验（游戏是否结束、当前玩家是否为人类）
-    // 组员补充：落子合法性校验（m_board.placePiece）
-    // 组员补充：落子成功后的历史记录、信号发射、胜负判断
-    // 组员补充：切换回合与 AI 落子触发
+    if (m_isGameOver) {
+        qWarning() << "[GameController] 游戏已结束，忽略落子";
+        return;
+    }
+    if (m_currentPlayer->isAI()) {
+        qWarning() << "[GameController] 当前为 AI 回合，忽略人类输入";
+        return;
+    }
+    stopPondering(row * m_session->boardSize() + col);
+    const Player* mover = m_currentPlayer;
+    applyMove(row, col);
+    if (m_currentPlayer == mover) {
+        startPondering(); // 落子无效，仍是人类回合
+    }
+}
+
+/**
+ * @brief 执行落子函数实现
+ * 实现逻辑：
+ * Step1：禁手点（连珠规则下的黑方）直接拒绝；调用 m_session->makeMove() 执行落子（同时压入棋盘撤销栈），
+ *        失败（越界/已有棋子）则打印日志并返回；
+ * Step2：发射 pieceAdded 信号通知 QML 渲染棋子；
+ * Step3：m_session->checkWin() 判断获胜、m_session->isFull() 判断平局，结束则发射 gameOver 信号；
+ * Step4：未结束则切换回合，若新的当前玩家是 AI，调用 processAIMove() 触发 AI 落子，
+ *        否则（人机模式下 AI 刚落子、轮到人类）开始后台思考。
+ * @param row 落子行坐标
+ * @param col 落子列坐标
+ */
+void GameController::applyMove(int row, int col)
+{
+    const Config::PieceType type = m_currentPlayer->color();
+    if (m_session->isForbidden(row, col, type)) {
+        qWarning() << "[GameController] 禁手点，不能落子：行" << row << "列" << col;
+        return;
+    }
+    if (!m_session->makeMove(row, col, type)) {
+        qWarning() << "[GameController] 落子失败（位置越界/已有棋子）：行" << row << "列" << col;
+        return;
+    }
+    emit pieceAdded(row, col, static_cast<int>(type));
+
+    if (m_session->checkWin(row, col, type)) {
+        m_isGameOver = true;
+        emit gameOver(m_currentPlayer->name());
+        return;
+    }
+    if (m_session->isFull()) {
+        m_isGameOver = true;
+        emit gameOver("平局");
+        return;
+    }
+
+    switchTurn();
+    if (m_currentPlayer->isAI()) {
+        processAIMove();
+    } else {
+        startPondering();
+    }
 }
 
 /**
  * @brief 获取棋盘状态函数实现
- * 详细实现逻辑（组员需补充）：
- * Step1：调用 m_board.getPiece(row, col) 获取指定位置的棋子类型；
- * Step2：将 PieceType 枚举转换为 int 编码（便于 QML 处理）：
- *   → PieceType::None → 0，PieceType::Black → 1，PieceType::White → 2；
- * Step3：返回转换后的编码。
+ * 实现逻辑：调用 m_session->getPiece(row, col) 获取棋子类型，
+ * 按枚举顺序转换为 int 编码（None=0，Black=1，White=2）返回，越界位置返回 0。
  * @param row 行坐标
  * @param col 列坐标
  * @return int 棋子状态编码
  */
 int GameController::getBoardState(int row, int col)
 {
-    // 基础空实现（需补充转换逻辑）
-    Config::PieceType pieceType = m_board.getPiece(row, col);
-    // 组员补充：将 pieceType 转换为 int 编码并返回
-    return 0; // 临时返回 0（空），需修改
+    return static_cast<int>(m_session->getPiece(row, col));
 }
 
 /**
  * @brief 悔棋功能实现
- * 详细实现逻辑（组员需补充）：
- * Step1：前置校验
- * - 若 m_isGameOver 为 true，打印警告并返回（游戏结束无法悔棋）；
- * - 若 m_moveHistory 为空，打印警告并返回（无落子记录无法悔棋）；
- * Step2：回退上一步落子
- * - 获取最后一次落子的坐标：QPair<int, int> lastMove = m_moveHistory.takeLast();
- * - 调用 m_board.placePiece(lastMove.first, lastMove.second, Config::PieceType::None)（清除棋子）；
- * - 发射 pieceAdded 信号，传入（lastMove.first, lastMove.second, 0）通知 QML 移除棋子；
- * Step3：切换回上一玩家
- * - 调用 switchTurn()（因为上一步切换过，再次调用即可回退）；
- * Step4：人机模式特殊处理
- * - 若回退后的当前玩家是 AI，需取消未执行的 AI 落子（如停止 QTimer 延迟）。
+ * 实现逻辑：
+ * Step1：前置校验——游戏已结束或无落子记录时打印警告并返回；
+ * Step2：立即停止后台思考，取消 AI 搜索并作废尚未执行的 AI 落子（cancelAIMove）；
+ * Step3：回退最后一步落子（undoLastMove：清除棋子、通知 QML、切换回上一玩家）；
+ * Step4：人机模式下若回退后轮到 AI，再回退一步，把回合交还给人类玩家，并对回退后的局面重新后台思考。
  */
 void GameController::undo()
 {
-    // 基础空实现（需补充核心逻辑）
     qInfo() << "[GameController] 执行悔棋操作";
-    // 组员补充：前置校验、回退落子、切换玩家、通知 UI
+    if (m_isGameOver) {
+        qWarning() << "[GameController] 游戏已结束，无法悔棋";
+        return;
+    }
+    if (m_session->moveCount() == 0) {
+        qWarning() << "[GameController] 没有可悔的落子";
+        return;
+    }
+
+    stopPondering();
+    cancelAIMove();
+    undoLastMove();
+    if (m_currentPlayer->isAI()) {
+        undoLastMove();
+    }
+    startPondering();
+}
+
+/**
+ * @brief 回退最后一步落子实现
+ * 实现逻辑：GameSession::unmakeMove() 弹出棋盘撤销栈顶的一手（恢复哈希、棋型与候选着法）并给出其坐标，
+ * 发射 pieceAdded(row, col, 0) 通知 QML 移除棋子，再调用 switchTurn() 切换回上一玩家。
+ * @return bool 是否成功回退
+ */
+bool GameController::undoLastMove()
+{
+    int row = -1;
+    int col = -1;
+    if (!m_session->unmakeMove(row, col)) {
+        return false;
+    }
+    emit pieceAdded(row, col, 0);
+    switchTurn();
+    return true;
 }
 
 /**
@@ -154,21 +377,197 @@ void GameController::switchTurn()
 
 /**
  * @brief AI 落子逻辑实现
- * 详细实现逻辑（组员需补充）：
- * 方案一：简单随机落子（适合初期测试）
- * Step1：生成随机坐标（row: 0~14，col: 0~14）；
- * Step2：循环校验坐标是否为空（调用 m_board.getPiece(row, col) == PieceType::None）；
- * Step3：找到空位置后，延迟 500ms 调用 handleInput(row, col)（用 QTimer::singleShot 实现延迟）；
- * 方案二：进阶 AI 落子（极大极小值算法）
- * Step1：遍历棋盘所有空位置，计算每个位置的得分（进攻/防守权重）；
- * Step2：选择得分最高的位置作为落子点；
- * Step3：延迟调用 handleInput 执行落子。
- * 注意：添加延迟是为了模拟 AI“思考”的过程，提升用户体验。
+ * 实现逻辑：
+ * Step1：校验当前玩家是否为 AI，游戏已结束则直接返回；
+ * Step2：开局库（困难/MCTS AI 在前 Config::OPENING_BOOK_MAX_PLY 手查询，命中则直接采用；开局库仅覆盖 15x15 无禁手）
+ *   与 AI_Easy（在 Board 增量维护的候选着法中随机选择）计算量很小，在界面线程上直接调用 finishAIMove()；
+ * Step3：AI_Hard / AI_MCTS 把搜索提交到 AiWorker 工作线程，界面线程立即返回：
+ * - AI_Hard：SearchEngine::search() 在 Config::AI_THINK_TIME_MS 预算内迭代加深，每完成一轮迭代报告深度、得分与主要变例；
+ * - AI_MCTS：MctsEngine::search() 以相同时间预算与线程数做蒙特卡洛树搜索，定期报告当前最佳着法与胜率；
+ * - 进度经 ProgressThrottle 节流后由 postAIProgress() 排队投递，搜索结束后把结果（连同统计日志）排队交给 finishAIMove()；
+ * - 停止函数为 GameSession::stopSearch()，悔棋/重开时 cancelAIMove() 用它中断搜索。
+ * 工作线程只读取会话中的棋盘（搜索入口复制一份），界面线程在搜索期间不修改棋盘（人类输入在 AI 回合被拒绝，
+ * 悔棋/重开/调整线程数都先取消搜索），因此两者不需要额外加锁。
  */
 void GameController::processAIMove()
 {
-    // 基础空实现（需补充核心逻辑）
+    if (m_isGameOver || !m_currentPlayer->isAI()) {
+        return;
+    }
     qInfo() << "[GameController] AI 正在思考落子...";
-    // 组员补充：AI 算法计算落子位置
-    // 组员补充：用 QTimer 延迟触发 handleInput 执行落子
+
+    const int requestId = m_aiRequestId;
+    BookMove bookMove;
+    if (m_currentPlayer->type() != Player::Type::AI_Easy
+        && m_session->stoneCount() < Config::OPENING_BOOK_MAX_PLY && m_session->bookMove(m_book, bookMove)) {
+        qInfo() << "[GameController] 开局库命中：对局数" << bookMove.games << "得分率" << bookMove.score;
+        finishAIMove(requestId, bookMove.row, bookMove.col);
+        return;
+    }
+    if (m_currentPlayer->type() == Player::Type::AI_Easy) {
+        int candidates[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+        const int count = m_session->candidateMoves(candidates, m_currentPlayer->color());
+        const int pick = count > 0 ? candidates[std::rand() % count] : -1;
+        finishAIMove(requestId, pick < 0 ? -1 : pick / m_session->boardSize(), pick < 0 ? -1 : pick % m_session->boardSize());
+        return;
+    }
+
+    m_aiDepth = 0;
+    m_aiScore = 0;
+    m_aiPv.clear();
+    m_aiNodes = 0;
+    m_aiNps = 0;
+    m_aiStats = SearchStats();
+    emit aiProgressChanged();
+    emit aiStatsChanged();
+    setAiThinking(true);
+
+    GameSession* session = m_session.get();
+    const Config::PieceType side = m_currentPlayer->color();
+    const int threads = m_session->threadCount();
+    auto stop = [session]() { session->stopSearch(); };
+    if (m_currentPlayer->type() == Player::Type::AI_Hard) {
+        m_aiWorker.submit([this, session, side, requestId]() {
+            ProgressThrottle throttle(Config::AI_PROGRESS_INTERVAL_MS);
+            SearchLimits limits;
+            limits.timeMs = Config::AI_THINK_TIME_MS;
+            limits.onIteration = [this, requestId, &throttle](const SearchResult& progress) {
+                if (throttle.tryAcquire()) {
+                    postAIProgress(requestId, progress.depth, progress.score, progress.pv);
+                    postAIStats(requestId, progress);
+                }
+            };
+            const SearchResult result = session->search(side, limits);
+            postAIProgress(requestId, result.depth, result.score, result.pv);
+            postAIStats(requestId, result);
+            QMetaObject::invokeMethod(this, [this, requestId, result]() {
+                if (requestId == m_aiRequestId) {
+                    qInfo() << "[GameController] AI 搜索完成：深度" << result.depth << "得分" << result.score
+                            << "节点" << result.nodes << "耗时(ms)" << result.timeMs << "NPS" << result.nps;
+                    if constexpr (SearchStats::ENABLED) {
+                        const SearchStats& stats = result.stats;
+                        qInfo() << "[GameController] 搜索统计：选择性深度" << stats.selDepth
+                                << "置换表命中率" << stats.ttHitRate() << "填充率" << stats.ttFillRate
+                                << "冲突" << stats.ttCollisions << "首着截断率" << stats.firstMoveCutoffRate()
+                                << "有效分支因子" << stats.branchingFactor()
+                                << "每轮耗时(深度:ms)" << formatIterations(stats.iterations)
+                                << "主要变例" << formatMoves(result.pv, m_session->boardSize());
+                    }
+                }
+                finishAIMove(requestId, result.row, result.col);
+            }, Qt::QueuedConnection);
+        }, stop);
+    } else {
+        const int boardSize = m_session->boardSize();
+        m_aiWorker.submit([this, session, side, requestId, threads, boardSize]() {
+            ProgressThrottle throttle(Config::AI_PROGRESS_INTERVAL_MS);
+            MctsLimits limits;
+            limits.timeMs = Config::AI_THINK_TIME_MS;
+            limits.threads = threads;
+            limits.onProgress = [this, requestId, boardSize, &throttle](const MctsResult& progress) {
+                if (progress.row >= 0 && throttle.tryAcquire()) {
+                    postAIProgress(requestId, 0, static_cast<int>(progress.winRate * 100.0 + 0.5),
+                                   { progress.row * boardSize + progress.col });
+                }
+            };
+            const MctsResult result = session->searchMcts(side, limits);
+            if (result.row >= 0) {
+                postAIProgress(requestId, 0, static_cast<int>(result.winRate * 100.0 + 0.5), { result.row * boardSize + result.col });
+            }
+            QMetaObject::invokeMethod(this, [this, requestId, result]() {
+                if (requestId == m_aiRequestId) {
+                    qInfo() << "[GameController] MCTS 搜索完成：胜率" << result.winRate << "模拟" << result.playouts
+                            << "耗时(ms)" << result.timeMs << "每秒模拟" << result.playoutsPerSec
+                            << "峰值树内存(KB)" << result.peakMemoryBytes / 1024;
+                }
+                finishAIMove(requestId, result.row, result.col);
+            }, Qt::QueuedConnection);
+        }, stop);
+    }
+}
+
+/**
+ * @brief AI 落子收尾实现
+ * 实现逻辑：请求已作废（悔棋/重开）或游戏已结束时直接丢弃；否则结束思考状态，
+ * 延迟 Config::AI_MOVE_DELAY_MS 后调用 applyMove() 执行落子（QTimer::singleShot），延迟期间再次作废同样放弃。
+ */
+void GameController::finishAIMove(int requestId, int row, int col)
+{
+    if (requestId != m_aiRequestId || m_isGameOver) {
+        return;
+    }
+    setAiThinking(false);
+    if (row < 0 || col < 0) {
+        qWarning() << "[GameController] AI 未找到可落子位置";
+        return;
+    }
+    QTimer::singleShot(Config::AI_MOVE_DELAY_MS, this, [this, requestId, row, col]() {
+        if (requestId != m_aiRequestId || m_isGameOver) {
+            return; // 悔棋/重开后作废
+        }
+        applyMove(row, col);
+    });
+}
+
+/**
+ * @brief 投递思考进度实现
+ * 实现逻辑：在工作线程上把进度值按值捕获，排队到界面线程后再核对请求编号并更新属性、发射 aiProgressChanged()；
+ * 属性只在界面线程读写，QML 绑定无需加锁。
+ */
+void GameController::postAIProgress(int requestId, int depth, int score, const std::vector<int>& pv)
+{
+    QMetaObject::invokeMethod(this, [this, requestId, depth, score, pv]() {
+        if (requestId != m_aiRequestId) {
+            return;
+        }
+        m_aiDepth = depth;
+        m_aiScore = score;
+        m_aiPv = formatMoves(pv, m_session->boardSize());
+        emit aiProgressChanged();
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 投递搜索统计实现：与 postAIProgress() 相同，按值捕获后在界面线程核对请求编号再更新；
+ * 进度回调中的 nps 尚未计算，按节点数与耗时补算。
+ */
+void GameController::postAIStats(int requestId, const SearchResult& result)
+{
+    const qint64 nps = result.nps > 0 ? static_cast<qint64>(result.nps)
+                                      : (result.timeMs > 0 ? static_cast<qint64>(result.nodes * 1000 / static_cast<uint64_t>(result.timeMs)) : 0);
+    QMetaObject::invokeMethod(this, [this, requestId, nodes = static_cast<qint64>(result.nodes), nps, stats = result.stats]() {
+        if (requestId != m_aiRequestId) {
+            return;
+        }
+        m_aiNodes = nodes;
+        m_aiNps = nps;
+        m_aiStats = stats;
+        emit aiStatsChanged();
+    }, Qt::QueuedConnection);
+}
+
+QString GameController::aiIterationTimes() const
+{
+    return formatIterations(m_aiStats.iterations);
+}
+
+/**
+ * @brief 取消 AI 思考实现
+ * 实现逻辑：先递增 m_aiRequestId，使已经排队的进度/结果与延迟落子全部失效；
+ * 再由 AiWorker::cancel() 反复调用 GameSession::stopSearch() 直到搜索返回（通常在一次节点检查间隔内），
+ * 返回后界面线程即可安全地修改或重建会话。
+ */
+void GameController::cancelAIMove()
+{
+    ++m_aiRequestId;
+    m_aiWorker.cancel();
+    setAiThinking(false);
+}
+
+void GameController::setAiThinking(bool thinking)
+{
+    if (m_aiThinking != thinking) {
+        m_aiThinking = thinking;
+        emit aiThinkingChanged();
+    }
 }
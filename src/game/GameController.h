@@ -4,10 +4,12 @@
 
 #include <QObject>
 #include <QString>
-#include <QList> // 新增：用于悔棋的历史落子记录（后续扩展）
+#include <vector>
 // 修正路径：GameController与Player同属src/game目录，直接包含即可
 #include "Player.h"
-#include "Board.h"
+#include "GameSession.h"         // 棋盘与AI组件（按棋盘尺寸分派）
+#include "../ai/OpeningBook.h"  // 开局库
+#include "../ai/AiWorker.h"     // AI 工作线程（搜索不占用界面线程）
 // 引入全局配置（棋子类型、游戏状态）
 #include "../story/Constants.h"
 
@@ -16,8 +18,10 @@
  * 核心职责：
  * 1. 管理游戏全流程：开局（选择模式）→ 回合切换 → 落子处理 → 胜负/平局判定 → 游戏结束；
  * 2. 桥接棋盘逻辑（Board）与表现层（QML）：转发棋盘状态、落子事件、游戏结果；
+ *    棋盘与 AI 组件封装在 GameSession 中，开局时按所选棋盘尺寸（15x15/19x19）创建对应的编译期特化；
  * 3. 管理玩家数据（Player）：区分人类/AI 玩家，控制当前行动方；
  * 4. 实现核心功能：人机对战（AI 落子）、悔棋、游戏重置；
+ *    困难/MCTS AI 的搜索在 AiWorker 工作线程上执行，结果与节流后的思考进度以排队调用交回界面线程；
  * 5. 与存档模块（SaveManager）联动：支持保存/读取游戏进度（后续扩展）。
  * 设计特点：继承 QObject 支持信号槽，所有 QML 可调用接口均标记 Q_INVOKABLE，属性变更通过 NOTIFY 信号同步 UI。
  */
@@ -38,6 +42,61 @@ class GameController : public QObject
      * QML 绑定场景：GameView 中禁用落子按钮、显示游戏结束弹窗。
      */
     Q_PROPERTY(bool isGameOver READ isGameOver NOTIFY gameOver)
+    /**
+     * @brief 困难 AI 的搜索线程数（Lazy SMP，含主线程）
+     * READ/WRITE：读取/设置线程数；NOTIFY：线程数变化时发射 aiThreadCountChanged 信号
+     * QML 绑定场景：设置界面中调整 AI 使用的 CPU 核数（写入 0 表示使用全部硬件线程）。
+     */
+    Q_PROPERTY(int aiThreadCount READ aiThreadCount WRITE setAiThreadCount NOTIFY aiThreadCountChanged)
+    /**
+     * @brief 困难 AI 是否在人类思考期间后台思考（Pondering）
+     * READ/WRITE：读取/设置开关；NOTIFY：开关变化时发射 ponderEnabledChanged 信号
+     * QML 绑定场景：设置界面中的“后台思考”开关。
+     */
+    Q_PROPERTY(bool ponderEnabled READ ponderEnabled WRITE setPonderEnabled NOTIFY ponderEnabledChanged)
+    /**
+     * @brief 当前棋盘边长（15 或 19）
+     * READ：读取棋盘边长；NOTIFY：startGame() 切换尺寸时发射 boardSizeChanged 信号
+     * QML 绑定场景：GameView 按边长生成棋盘网格与落子区域。
+     */
+    Q_PROPERTY(int boardSize READ boardSize NOTIFY boardSizeChanged)
+    /**
+     * @brief 当前规则变体（0=无禁手，1=标准（双方恰好五连），2=连珠（黑方禁手），3=Caro（两端被堵的五连无效），对应 Rule 枚举）
+     * READ：读取规则；NOTIFY：startGame() 切换规则时发射 ruleChanged 信号
+     * QML 绑定场景：GameView 显示当前规则、连珠规则下提示黑方禁手。
+     */
+    Q_PROPERTY(int rule READ rule NOTIFY ruleChanged)
+    /**
+     * @brief AI 是否正在工作线程上思考
+     * READ：读取状态；NOTIFY：开始/结束/取消思考时发射 aiThinkingChanged 信号
+     * QML 绑定场景：GameView 显示“AI 思考中”、思考期间禁用悔棋以外的操作。
+     */
+    Q_PROPERTY(bool aiThinking READ aiThinking NOTIFY aiThinkingChanged)
+    /**
+     * @brief AI 思考进度：已完成的搜索深度（MCTS 为 0）、得分（Alpha-Beta 为局面分，MCTS 为胜率百分比）、
+     * 主要变例（“列字母+行号”坐标串，空格分隔，如 "h8 i9 h9"）
+     * READ：读取最近一次进度；NOTIFY：进度更新时发射 aiProgressChanged 信号（至多每 Config::AI_PROGRESS_INTERVAL_MS 一次）
+     * QML 绑定场景：GameView 的 AI 分析栏。
+     */
+    Q_PROPERTY(int aiDepth READ aiDepth NOTIFY aiProgressChanged)
+    Q_PROPERTY(int aiScore READ aiScore NOTIFY aiProgressChanged)
+    Q_PROPERTY(QString aiPv READ aiPv NOTIFY aiProgressChanged)
+    /**
+     * @brief 困难 AI 的搜索统计（供可选的调试面板使用）：节点数、NPS、选择性深度、置换表命中率/填充率（0~1）与冲突次数、首着截断率（0~1）、
+     * 有效分支因子、每轮迭代耗时（"深度:毫秒" 空格分隔，如 "1:0 2:1 3:4"）；深度与主要变例见 aiDepth/aiPv
+     * aiStatsEnabled 为编译期开关 LQHJ_SEARCH_STATS，关闭时只有节点数与 NPS 有效，其余保持为0/空
+     * READ：读取最近一次统计；NOTIFY：随思考进度更新（已节流）与搜索结束时发射 aiStatsChanged 信号
+     */
+    Q_PROPERTY(bool aiStatsEnabled READ aiStatsEnabled CONSTANT)
+    Q_PROPERTY(qint64 aiNodes READ aiNodes NOTIFY aiStatsChanged)
+    Q_PROPERTY(qint64 aiNps READ aiNps NOTIFY aiStatsChanged)
+    Q_PROPERTY(int aiSelDepth READ aiSelDepth NOTIFY aiStatsChanged)
+    Q_PROPERTY(double aiTtHitRate READ aiTtHitRate NOTIFY aiStatsChanged)
+    Q_PROPERTY(double aiTtFillRate READ aiTtFillRate NOTIFY aiStatsChanged)
+    Q_PROPERTY(qint64 aiTtCollisions READ aiTtCollisions NOTIFY aiStatsChanged)
+    Q_PROPERTY(double aiFirstMoveCutoffRate READ aiFirstMoveCutoffRate NOTIFY aiStatsChanged)
+    Q_PROPERTY(double aiBranchingFactor READ aiBranchingFactor NOTIFY aiStatsChanged)
+    Q_PROPERTY(QString aiIterationTimes READ aiIterationTimes NOTIFY aiStatsChanged)
 
 public:
     /**
@@ -47,32 +106,34 @@ public:
      * 1. 初始化黑白玩家（默认均为人类玩家，人机模式下动态修改白方类型）；
      * 2. 设置黑方为先手玩家；
      * 3. 初始化游戏结束标记为 false；
-     * 4. （可选）初始化悔棋历史记录容器。
+     * 4. 创建默认尺寸的对局会话（落子历史即棋盘撤销栈，悔棋直接撤销）。
      */
     explicit GameController(QObject *parent = nullptr);
 
     /**
      * @brief 开始新游戏（QML 可调用）
-     * @param mode 游戏模式：0=人人对战，1=人机对战
+     * @param mode 游戏模式：0=人人对战，1=人机对战（困难AI），2=人机对战（MCTS AI）
+     * @param boardSize 棋盘边长：Config::BOARD_SIZE（15）或 Config::LARGE_BOARD_SIZE（19），其他值回退为 15
+     * @param rule 规则变体（Rule 枚举值 0~RULE_COUNT-1），其他值回退为无禁手
      * 功能逻辑：
-     * 1. 重置棋盘（调用 Board::reset()）；
+     * 1. 取消正在进行的 AI 搜索，重置棋盘（尺寸或规则变化时重建对应特化的 GameSession，否则调用 reset()）；
      * 2. 重置游戏结束标记为 false；
      * 3. 根据模式设置玩家类型（人机模式下将白方设为 AI）；
      * 4. 重置当前玩家为黑方（先手）；
      * 5. 发射 turnChanged 信号更新 UI；
-     * 6. （可选）清空悔棋历史记录。
+     * 6. 重置棋盘时一并清空落子历史（棋盘撤销栈）。
      */
-    Q_INVOKABLE void startGame(int mode);
+    Q_INVOKABLE void startGame(int mode, int boardSize = Config::BOARD_SIZE, int rule = 0);
 
     /**
      * @brief 处理 QML 落子输入（QML 可调用）
-     * @param row 落子行坐标（0~Config::BOARD_SIZE-1）
-     * @param col 落子列坐标（0~Config::BOARD_SIZE-1）
+     * @param row 落子行坐标（0~boardSize-1）
+     * @param col 落子列坐标（0~boardSize-1）
      * 核心逻辑：
      * 1. 校验游戏是否已结束（结束则直接返回）；
      * 2. 校验当前玩家是否为人类（AI 玩家则忽略输入）；
-     * 3. 调用 Board::placePiece() 执行落子，校验落子合法性；
-     * 4. 落子成功后：记录历史落子（悔棋用）、发射 pieceAdded 信号触发 UI 动画；
+     * 3. 调用 Board::placePiece() 执行落子，校验落子合法性（连珠规则下黑方禁手点同样拒绝）；
+     * 4. 落子成功后（GameSession::makeMove 同时压入撤销栈，悔棋用）发射 pieceAdded 信号触发 UI 动画；
      * 5. 调用 Board::checkWin() 判断是否获胜，获胜则发射 gameOver 信号；
      * 6. 未获胜则调用 Board::isFull() 判断是否平局，平局则发射 gameOver 信号；
      * 7. 未结束则切换回合（switchTurn()），若新回合是 AI 玩家则触发 AI 落子（processAIMove()）。
@@ -92,11 +153,11 @@ public:
      * @brief 悔棋功能（QML 可调用）
      * 功能逻辑：
      * 1. 校验游戏是否已结束（结束则无法悔棋）；
-     * 2. 校验历史落子记录是否为空（无记录则无法悔棋）；
-     * 3. 回退上一步落子（从 Board 中清除棋子，删除历史记录最后一项）；
+     * 2. 校验棋盘撤销栈是否为空（无落子则无法悔棋）；
+     * 3. 回退上一步落子（GameSession::unmakeMove 按撤销栈恢复棋盘）；
      * 4. 切换回上一玩家（再次调用 switchTurn()）；
      * 5. 发射 pieceAdded 信号（传空棋子类型）通知 UI 移除棋子；
-     * 6. （人机模式）若回退后是 AI 玩家，需取消未执行的 AI 落子。
+     * 6. （人机模式）取消正在进行的 AI 搜索与未执行的 AI 落子，若回退后是 AI 玩家再回退一步。
      */
     Q_INVOKABLE void undo();
 
@@ -114,6 +175,63 @@ public:
      */
     bool isGameOver() const { return m_isGameOver; }
 
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：获取困难 AI 的搜索线程数
+     */
+    int aiThreadCount() const { return m_session->threadCount(); }
+
+    /**
+     * @brief Q_PROPERTY 对应的 WRITE 函数：设置困难 AI 的搜索线程数
+     * @param threads 线程总数（含主线程），<=0 表示使用全部硬件线程；下一次 AI 搜索生效
+     */
+    void setAiThreadCount(int threads);
+
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：后台思考是否开启
+     */
+    bool ponderEnabled() const { return m_ponderEnabled; }
+
+    /**
+     * @brief Q_PROPERTY 对应的 WRITE 函数：开启/关闭后台思考（关闭时立即停止正在进行的后台思考）
+     */
+    void setPonderEnabled(bool enabled);
+
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：获取当前棋盘边长
+     */
+    int boardSize() const { return m_session->boardSize(); }
+
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：获取当前规则变体（Rule 枚举值）
+     */
+    int rule() const { return static_cast<int>(m_session->rule()); }
+
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：AI 是否正在思考
+     */
+    bool aiThinking() const { return m_aiThinking; }
+
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：AI 思考进度（深度、得分、主要变例）
+     */
+    int aiDepth() const { return m_aiDepth; }
+    int aiScore() const { return m_aiScore; }
+    QString aiPv() const { return m_aiPv; }
+
+    /**
+     * @brief Q_PROPERTY 对应的 READ 函数：困难 AI 的搜索统计
+     */
+    bool aiStatsEnabled() const { return SearchStats::ENABLED; }
+    qint64 aiNodes() const { return m_aiNodes; }
+    qint64 aiNps() const { return m_aiNps; }
+    int aiSelDepth() const { return m_aiStats.selDepth; }
+    double aiTtHitRate() const { return m_aiStats.ttHitRate(); }
+    double aiTtFillRate() const { return m_aiStats.ttFillRate; }
+    qint64 aiTtCollisions() const { return static_cast<qint64>(m_aiStats.ttCollisions); }
+    double aiFirstMoveCutoffRate() const { return m_aiStats.firstMoveCutoffRate(); }
+    double aiBranchingFactor() const { return m_aiStats.branchingFactor(); }
+    QString aiIterationTimes() const;
+
 signals:
     /**
      * @brief 回合切换信号（NOTIFY 信号）
@@ -138,6 +256,41 @@ signals:
      */
     void gameOver(QString winnerName);
 
+    /**
+     * @brief AI 搜索线程数变化信号（NOTIFY 信号）
+     */
+    void aiThreadCountChanged();
+
+    /**
+     * @brief 后台思考开关变化信号（NOTIFY 信号）
+     */
+    void ponderEnabledChanged();
+
+    /**
+     * @brief 棋盘尺寸变化信号（NOTIFY 信号）
+     */
+    void boardSizeChanged();
+
+    /**
+     * @brief 规则变体变化信号（NOTIFY 信号）
+     */
+    void ruleChanged();
+
+    /**
+     * @brief AI 思考状态变化信号（NOTIFY 信号）
+     */
+    void aiThinkingChanged();
+
+    /**
+     * @brief AI 思考进度更新信号（NOTIFY 信号，已节流）
+     */
+    void aiProgressChanged();
+
+    /**
+     * @brief AI 搜索统计更新信号（NOTIFY 信号，已节流）
+     */
+    void aiStatsChanged();
+
 private:
     /**
      * @brief 切换当前行动玩家（私有辅助函数）
@@ -149,19 +302,74 @@ private:
      * @brief 处理 AI 落子逻辑（私有辅助函数）
      * 核心逻辑：
      * 1. 校验当前玩家是否为 AI（非 AI 则直接返回）；
-     * 2. AI 算法计算最优落子位置（简单版：随机空位置；进阶版：极大极小值/蒙特卡洛算法）；
-     * 3. 调用 handleInput() 执行 AI 落子（模拟人类输入）；
-     * 4. （可选）添加 AI 思考延迟（用 QTimer 实现，模拟真实思考过程）。
+     * 2. 开局库与 AI_Easy（已有棋子附近的随机空位）在界面线程上直接得出落子；
+     * 3. AI_Hard（SearchEngine 迭代加深 Alpha-Beta 搜索）与 AI_MCTS（MctsEngine 多线程蒙特卡洛树搜索）提交到 AiWorker，
+     *    搜索进度经 postAIProgress()、结果经 finishAIMove() 排队交回界面线程；
+     * 4. 悔棋/重开时通过 cancelAIMove() 取消搜索，并以 m_aiRequestId 作废已排队的结果。
      */
     void processAIMove();
 
-    // 私有成员变量
     /**
-     * @brief 棋盘实例（核心逻辑依赖，负责落子校验、胜负判断）
-     * 说明：直接实例化而非指针，利用栈内存管理，无需手动释放。
+     * @brief AI 得出落子后的收尾（界面线程）
+     * @param requestId 发起搜索时的 m_aiRequestId，与当前值不同说明已被悔棋/重开作废
+     * 逻辑：结束思考状态，延迟 Config::AI_MOVE_DELAY_MS 后调用 applyMove() 执行落子。
+     */
+    void finishAIMove(int requestId, int row, int col);
+
+    /**
+     * @brief 把一条思考进度排队投递到界面线程（可在工作线程调用）
+     * @param pv 主要变例（格子下标 row*boardSize+col）
+     */
+    void postAIProgress(int requestId, int depth, int score, const std::vector<int>& pv);
+
+    /**
+     * @brief 把一份搜索统计排队投递到界面线程（可在工作线程调用）
+     * @param result 搜索进度或最终结果（nodes、nps 与 stats 有效）
+     */
+    void postAIStats(int requestId, const SearchResult& result);
+
+    /**
+     * @brief 取消 AI 思考：作废请求编号，停止并等待工作线程上的搜索返回，结束思考状态
+     */
+    void cancelAIMove();
+
+    /**
+     * @brief 设置思考状态，变化时发射 aiThinkingChanged()
+     */
+    void setAiThinking(bool thinking);
+
+    /**
+     * @brief 执行一次落子并推进对局（人类输入与 AI 落子共用）
+     * @param row 落子行坐标
+     * @param col 落子列坐标
+     * 逻辑：落子 → 记录历史 → 发射 pieceAdded → 胜负/平局判定 → 切换回合 → 必要时触发 AI。
      */
-    Board m_board;
+    void applyMove(int row, int col);
 
+    /**
+     * @brief 回退最后一步落子（悔棋辅助函数）
+     * @return bool 是否成功回退（撤销栈为空时返回 false）
+     */
+    bool undoLastMove();
+
+    /**
+     * @brief 为当前会话装载神经网络估值：按棋盘尺寸映射 Config::NNUE_FILE（已映射同尺寸文件时复用），
+     * 文件不存在、格式不符或 Config::AI_NNUE_ENABLED 关闭时会话保持棋型估值
+     */
+    void loadNetwork();
+
+    /**
+     * @brief 人机模式下轮到人类时开始后台思考（开关关闭、人人对战或游戏结束时不启动）
+     */
+    void startPondering();
+
+    /**
+     * @brief 立即停止后台思考
+     * @param playedCell 人类实际落子的格子下标（row*boardSize+col），用于统计预测命中；-1 表示非落子原因停止
+     */
+    void stopPondering(int playedCell = -1);
+
+    // 私有成员变量
     /**
      * @brief 黑棋玩家实例（固定为黑棋，先手）
      */
@@ -185,10 +393,47 @@ private:
     bool m_isGameOver = false;
 
     /**
-     * @brief 落子历史记录（用于悔棋功能，后续扩展）
-     * 存储格式：QList<QPair<int, int>>，每个元素是（行，列）的落子坐标。
+     * @brief 困难 AI 的神经网络估值权重（按当前棋盘尺寸映射 Config::NNUE_FILE，文件不存在时为空，使用棋型估值）
+     * 声明在 m_session 之前：会话（含后台思考线程）先于网络析构。
+     */
+    NnueNetwork m_network;
+
+    /**
+     * @brief 对局会话：当前尺寸的棋盘（落子校验、胜负判断，其撤销栈即落子历史）、困难 AI 搜索引擎（内含置换表）、
+     * 后台思考控制器与 MCTS 引擎；同尺寸跨对局复用，切换棋盘尺寸时重建
+     */
+    std::unique_ptr<GameSession> m_session;
+
+    /**
+     * @brief 开局库（构造时映射，文件不存在时为空库，查询总是未命中）
+     */
+    OpeningBook m_book;
+
+    /**
+     * @brief 后台思考开关（默认 Config::AI_PONDER_ENABLED）
+     */
+    bool m_ponderEnabled = Config::AI_PONDER_ENABLED;
+
+    /**
+     * @brief AI 落子请求编号：每次悔棋/重开时递增，使工作线程排队交回的结果与尚未执行的延迟落子失效
+     */
+    int m_aiRequestId = 0;
+
+    /**
+     * @brief AI 思考状态与最近一次思考进度（只在界面线程读写）
+     */
+    bool m_aiThinking = false;
+    int m_aiDepth = 0;
+    int m_aiScore = 0;
+    QString m_aiPv;
+    qint64 m_aiNodes = 0;
+    qint64 m_aiNps = 0;
+    SearchStats m_aiStats;
+
+    /**
+     * @brief AI 工作线程（声明在 m_session 之后：析构时先取消并等待搜索，再销毁其引用的会话）
      */
-    QList<QPair<int, int>> m_moveHistory;
+    AiWorker m_aiWorker;
 };
 
 #endif // GAMECONTROLLER_H
@@ -0,0 +1,130 @@
+﻿#include "GameSession.h"
+#include "../ai/Ponderer.h"
+
+namespace {
+
+/**
+ * @brief 固定尺寸N、规则R的会话实现：持有该特化的棋盘与AI组件
+ * 成员声明顺序保证析构时先停止后台思考线程，再销毁其引用的搜索引擎。
+ */
+template <int N, Rule R>
+class SizedSession final : public GameSession {
+public:
+    explicit SizedSession(size_t ttSizeMB)
+        : m_engine(ttSizeMB, Config::AI_TT_HUGE_PAGES)
+        , m_ponderer(m_engine)
+        , m_mcts(Config::AI_MCTS_MEMORY_MB)
+    {
+    }
+
+    int boardSize() const override { return N; }
+    Rule rule() const override { return R; }
+
+    void reset() override { m_board.reset(); }
+    bool placePiece(int row, int col, Config::PieceType type) override { return m_board.placePiece(row, col, type); }
+    bool removePiece(int row, int col) override { return m_board.removePiece(row, col); }
+    Config::PieceType getPiece(int row, int col) const override { return m_board.getPiece(row, col); }
+    bool checkWin(int row, int col, Config::PieceType type) override { return m_board.checkWin(row, col, type); }
+    bool isFull() const override { return m_board.isFull(); }
+    int stoneCount() const override { return m_board.stoneCount(); }
+    bool isForbidden(int row, int col, Config::PieceType type) const override {
+        return type == Config::PieceType::Black && m_board.isForbiddenExact(row, col);
+    }
+    int threatCount(Config::PieceType color, PatternType type) const override { return m_board.threatCount(color, type); }
+    bool makeMove(int row, int col, Config::PieceType type) override { return m_board.makeMove(row, col, type); }
+    int moveCount() const override { return m_board.moveCount(); }
+
+    bool unmakeMove(int& row, int& col) override {
+        const int cell = m_board.unmakeMove();
+        if (cell < 0) {
+            return false;
+        }
+        row = cell / N;
+        col = cell % N;
+        return true;
+    }
+    int candidateMoves(int* out, Config::PieceType side) const override { return m_board.candidateMoves(out, side); }
+
+    SearchResult search(Config::PieceType side, const SearchLimits& limits) override {
+        return m_engine.search(m_board, side, limits);
+    }
+
+    MctsResult searchMcts(Config::PieceType side, const MctsLimits& limits) override {
+        return m_mcts.search(m_board, side, limits);
+    }
+
+    bool bookMove(const OpeningBook& book, BookMove& out) const override {
+        if constexpr (N == Config::BOARD_SIZE && R == Rule::Freestyle) {
+            return book.bestMove(m_board, out);
+        } else {
+            (void)book;
+            (void)out;
+            return false;
+        }
+    }
+
+    void stopSearch() override {
+        m_engine.stop();
+        m_mcts.stop();
+    }
+
+    void clearEngine() override { m_engine.clear(); }
+    bool setNetwork(const NnueNetwork* network) override { return m_engine.setNetwork(network); }
+    int threadCount() const override { return m_engine.threadCount(); }
+    void setThreadCount(int threads) override { m_engine.setThreadCount(threads); }
+
+    void startPondering(Config::PieceType side, int maxTimeMs) override {
+        m_ponderer.start(m_board, side, maxTimeMs);
+    }
+
+    SearchResult stopPondering() override { return m_ponderer.stop(); }
+
+private:
+    BasicBoard<N, R> m_board;
+    BasicSearchEngine<N, R> m_engine;
+    BasicPonderer<N, R> m_ponderer;
+    BasicMctsEngine<N, R> m_mcts;
+};
+
+/**
+ * @brief 按规则选择尺寸N下的编译期特化
+ */
+template <int N>
+std::unique_ptr<GameSession> createForRule(Rule rule, size_t ttSizeMB)
+{
+    switch (rule) {
+    case Rule::Standard:
+        return std::make_unique<SizedSession<N, Rule::Standard>>(ttSizeMB);
+    case Rule::Renju:
+        return std::make_unique<SizedSession<N, Rule::Renju>>(ttSizeMB);
+    case Rule::Caro:
+        return std::make_unique<SizedSession<N, Rule::Caro>>(ttSizeMB);
+    case Rule::Freestyle:
+    default:
+        return std::make_unique<SizedSession<N, Rule::Freestyle>>(ttSizeMB);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 创建会话实现
+ * 实现逻辑：按边长、再按规则选择对应的编译期特化；
+ * 新增尺寸或规则需同时在Board等模板的显式实例化中加入对应组合。
+ */
+std::unique_ptr<GameSession> GameSession::create(int boardSize, Rule rule, size_t ttSizeMB)
+{
+    switch (boardSize) {
+    case Config::BOARD_SIZE:
+        return createForRule<Config::BOARD_SIZE>(rule, ttSizeMB);
+    case Config::LARGE_BOARD_SIZE:
+        return createForRule<Config::LARGE_BOARD_SIZE>(rule, ttSizeMB);
+    default:
+        return nullptr;
+    }
+}
+
+bool GameSession::isSupportedSize(int boardSize)
+{
+    return boardSize == Config::BOARD_SIZE || boardSize == Config::LARGE_BOARD_SIZE;
+}
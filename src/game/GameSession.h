@@ -0,0 +1,136 @@
+﻿#pragma once
+#ifndef GAMESESSION_H
+#define GAMESESSION_H
+
+#include <memory>
+#include "Board.h"
+#include "../ai/SearchEngine.h"
+#include "../ai/MctsEngine.h"
+#include "../ai/OpeningBook.h"
+#include "../story/Constants.h"
+
+/**
+ * @brief 对局会话：一种棋盘尺寸与规则下的棋盘与全部AI组件的组合（运行时尺寸/规则分派的唯一入口）
+ * 核心职责：
+ * 1. Board/SearchEngine/Ponderer/MctsEngine 均为以棋盘边长N与规则R为模板参数的编译期特化，
+ *    本接口把它们包装成与尺寸、规则无关的虚函数，GameController 只持有一个 GameSession 指针；
+ * 2. 每个虚函数调用内部直接落到对应特化的实现，搜索热路径不再有任何运行时尺寸或规则判断；
+ * 3. 换棋盘尺寸或规则即重建会话（置换表、节点池随之重建），同尺寸同规则的新对局只需 reset()。
+ * 坐标约定：row/col 范围为 0~boardSize()-1，格子下标为 row*boardSize()+col。
+ */
+class GameSession {
+public:
+    virtual ~GameSession() = default;
+
+    /**
+     * @brief 创建指定尺寸与规则的会话
+     * @param boardSize 棋盘边长（Config::BOARD_SIZE 或 Config::LARGE_BOARD_SIZE）
+     * @param rule 规则变体
+     * @param ttSizeMB 困难AI置换表大小（MB），自对弈等同时持有大量会话的场景应传较小值
+     * @return std::unique_ptr<GameSession> 不支持的尺寸返回 nullptr
+     */
+    static std::unique_ptr<GameSession> create(int boardSize, Rule rule = Rule::Freestyle,
+                                               size_t ttSizeMB = Config::AI_TT_SIZE_MB);
+
+    /**
+     * @brief 判断棋盘尺寸是否有编译期特化
+     */
+    static bool isSupportedSize(int boardSize);
+
+    /**
+     * @brief 棋盘边长
+     */
+    virtual int boardSize() const = 0;
+
+    /**
+     * @brief 规则变体
+     */
+    virtual Rule rule() const = 0;
+
+    // 棋盘操作（语义与 BasicBoard 同名函数一致）
+    virtual void reset() = 0;
+    virtual bool placePiece(int row, int col, Config::PieceType type) = 0;
+    virtual bool removePiece(int row, int col) = 0;
+    virtual Config::PieceType getPiece(int row, int col) const = 0;
+    virtual bool checkWin(int row, int col, Config::PieceType type) = 0;
+    virtual bool isFull() const = 0;
+    virtual int stoneCount() const = 0;
+
+    /**
+     * @brief 空点对type一方是否为禁手（只有Renju规则的黑方可能为true）
+     * 用于裁决落子：完整判定（见 BasicBoard::isForbiddenExact()），假活三构成的三三不算禁手；
+     * 结果与 AI 候选着法使用的增量禁手位一致。
+     */
+    virtual bool isForbidden(int row, int col, Config::PieceType type) const = 0;
+
+    /**
+     * @brief 某方在全盘空点上能形成指定棋型的（空点, 方向）数量（语义同 BasicBoard::threatCount）
+     */
+    virtual int threatCount(Config::PieceType color, PatternType type) const = 0;
+
+    /**
+     * @brief 可撤销落子/撤销（对局落子历史即棋盘撤销栈，悔棋不需要另存历史）
+     * @param row 输出：被撤销一手的行坐标
+     * @param col 输出：被撤销一手的列坐标
+     * @return bool unmakeMove 在撤销栈为空时返回 false
+     */
+    virtual bool makeMove(int row, int col, Config::PieceType type) = 0;
+    virtual bool unmakeMove(int& row, int& col) = 0;
+    virtual int moveCount() const = 0;
+
+    /**
+     * @brief 候选着法（out 至少容纳 Config::MAX_BOARD_SIZE² 个格子下标；side 有禁手时不含禁手点，None 表示不区分）
+     */
+    virtual int candidateMoves(int* out, Config::PieceType side) const = 0;
+
+    /**
+     * @brief 困难 AI 搜索（Alpha-Beta），以当前棋盘为根
+     */
+    virtual SearchResult search(Config::PieceType side, const SearchLimits& limits) = 0;
+
+    /**
+     * @brief MCTS AI 搜索，以当前棋盘为根
+     */
+    virtual MctsResult searchMcts(Config::PieceType side, const MctsLimits& limits) = 0;
+
+    /**
+     * @brief 请求停止正在进行的 search()/searchMcts()（可在其他线程调用，搜索尽快返回已有结果）
+     * 搜索入口会复位停止标志，调用方需循环请求直到搜索确认结束（见 AiWorker::cancel）。
+     */
+    virtual void stopSearch() = 0;
+
+    /**
+     * @brief 查询开局库（开局库只收录 15x15 无禁手局面，其他尺寸与规则总是未命中）
+     */
+    virtual bool bookMove(const OpeningBook& book, BookMove& out) const = 0;
+
+    /**
+     * @brief 清空搜索引擎的置换表与历史表（新对局开始时调用）
+     */
+    virtual void clearEngine() = 0;
+
+    /**
+     * @brief 设置困难 AI 的神经网络估值（nullptr 恢复棋型估值）
+     * 网络由调用方持有，生命周期须长于会话（后台思考线程同样使用它）。
+     * @return bool 网络未加载或棋盘大小与会话不符时返回 false，估值方式不变
+     */
+    virtual bool setNetwork(const NnueNetwork* network) = 0;
+
+    /**
+     * @brief 困难 AI 搜索线程数（含主线程）
+     */
+    virtual int threadCount() const = 0;
+    virtual void setThreadCount(int threads) = 0;
+
+    /**
+     * @brief 以当前棋盘启动后台思考（side 为即将行棋的人类一方）
+     */
+    virtual void startPondering(Config::PieceType side, int maxTimeMs) = 0;
+
+    /**
+     * @brief 停止后台思考并返回其结果（未在后台思考时返回空结果）
+     */
+    virtual SearchResult stopPondering() = 0;
+};
+
+#endif // GAMESESSION_H
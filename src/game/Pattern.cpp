@@ -0,0 +1,78 @@
+﻿#include "Pattern.h"
+
+namespace {
+
+/**
+ * @brief 由“左侧4格、右侧4格”（由近到远）拼出窗口编码，仅用于下方的编译期自检
+ */
+constexpr uint16_t makeCode(const uint16_t (&left)[4], const uint16_t (&right)[4]) {
+    uint16_t code = 0;
+    for (int i = 0; i < 4; ++i) {
+        code = static_cast<uint16_t>(code | (left[i] << (PatternCode::slotOf(-1 - i) * 2)));
+        code = static_cast<uint16_t>(code | (right[i] << (PatternCode::slotOf(1 + i) * 2)));
+    }
+    return code;
+}
+
+/**
+ * @brief 生成的棋型分值是否合法：无棋型为0，其余在 [0, PATTERN_SCORE_LIMIT] 内（表项估值字段不溢出）
+ */
+constexpr bool patternScoresValid() {
+    if (PATTERN_SCORE[0] != 0) {
+        return false;
+    }
+    for (int type = 1; type < PATTERN_TYPE_COUNT; ++type) {
+        if (PATTERN_SCORE[type] < 0 || PATTERN_SCORE[type] > PATTERN_SCORE_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr uint16_t E = PatternCode::EMPTY;
+constexpr uint16_t X = PatternCode::BLACK;
+constexpr uint16_t O = PatternCode::WHITE;
+
+} // namespace
+
+/**
+ * @brief 全部规则的棋型表：构建时由 tools/PatternTableGen 生成（见CMakeLists.txt），constexpr初始化
+ */
+constexpr PatternTable PATTERN_TABLES[RULE_COUNT] = {
+#include "PatternTables.inc"
+};
+
+// 编译期自检：生成的表格与规则定义一致（生成器或规则改动导致不一致时直接编译失败）
+static_assert(patternScoresValid(), "PATTERN_SCORE (EvalWeights.h) out of range");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Freestyle)].lookup(
+                  makeCode({ X, X, E, E }, { X, X, E, E }), Config::PieceType::Black) == PatternType::Five,
+              "XX.XX must be five");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Freestyle)].lookup(
+                  makeCode({ X, X, X, E }, { X, X, E, E }), Config::PieceType::Black) == PatternType::Five,
+              "overline counts as five in freestyle");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Standard)].lookup(
+                  makeCode({ X, X, X, E }, { X, X, E, E }), Config::PieceType::Black) != PatternType::Five,
+              "overline is not five in standard");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Renju)].lookup(
+                  makeCode({ O, O, O, E }, { O, O, E, E }), Config::PieceType::White) == PatternType::Five,
+              "white overline is five in renju");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Freestyle)].lookup(
+                  makeCode({ X, X, E, E }, { E, E, E, E }), Config::PieceType::Black) == PatternType::OpenThree,
+              ".XX*.. must be open three");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Freestyle)].score(makeCode({ E, E, E, E }, { E, E, E, E })) == 0,
+              "empty window scores zero");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Caro)].lookup(
+                  makeCode({ X, X, O, E }, { X, X, O, E }), Config::PieceType::Black) != PatternType::Five,
+              "OXX*XXO is not five in caro");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Caro)].lookup(
+                  makeCode({ X, X, O, E }, { X, X, E, E }), Config::PieceType::Black) == PatternType::Five,
+              "OXX*XX. is five in caro");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Renju)].entries[makeCode({ X, X, X, E }, { X, X, E, E })]
+                  & PatternTable::OVERLINE_FLAG,
+              "XXX*XX is a black overline in renju");
+static_assert(PATTERN_TABLES[static_cast<int>(Rule::Renju)].entries[makeCode({ X, E, X, E }, { X, E, X, E })]
+                  & PatternTable::LINE_DOUBLE_FOUR_FLAG,
+              "X.X*X.X is a same-line double four in renju");
+static_assert(!(PATTERN_TABLES[static_cast<int>(Rule::Renju)].entries[makeCode({ X, X, E, E }, { X, E, E, E })]
+                  & PatternTable::LINE_DOUBLE_FOUR_FLAG),
+              ".XX*X. is a straight four, not a double four");
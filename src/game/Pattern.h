@@ -0,0 +1,174 @@
+﻿#pragma once
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <cstdint>
+#include "../story/Constants.h"
+#include "EvalWeights.h"
+
+/**
+ * @brief 棋型等级枚举（按威胁程度从低到高排列，数值越大威胁越大）
+ * - None：无有效棋型；
+ * - Two / OpenTwo：眠二 / 活二（再下一手可成眠三 / 活三）；
+ * - Three / OpenThree：眠三 / 活三（再下一手可成冲四 / 活四）；
+ * - Four：冲四（只有一个成五点）；
+ * - OpenFour：活四（两个及以上成五点，对方无法同时封堵）；
+ * - Five：成五。
+ */
+enum class PatternType : uint8_t { None, Two, OpenTwo, Three, OpenThree, Four, OpenFour, Five };
+
+/**
+ * @brief 棋型种类数（用于定义按棋型索引的数组）
+ */
+constexpr int PATTERN_TYPE_COUNT = 8;
+
+/**
+ * @brief 棋型估值表 PATTERN_SCORE 定义于 EvalWeights.h（由 tools/TexelTuner 用自对弈数据拟合后生成）
+ * 表项的估值字段为16位有符号数，各棋型分值须在 [0, PATTERN_SCORE_LIMIT] 内，两方之差才不会溢出。
+ */
+constexpr int PATTERN_SCORE_LIMIT = 16383;
+static_assert(sizeof(PATTERN_SCORE) / sizeof(PATTERN_SCORE[0]) == PATTERN_TYPE_COUNT, "one score per PatternType");
+
+/**
+ * @brief 四个判断方向：0=横向，1=纵向，2=左上→右下，3=右上→左下
+ */
+constexpr int DIRECTION_COUNT = 4;
+constexpr int DIR_DR[DIRECTION_COUNT] = { 0, 1, 1, 1 };
+constexpr int DIR_DC[DIRECTION_COUNT] = { 1, 0, 1, -1 };
+
+/**
+ * @brief 棋型窗口编码相关常量
+ * 以某个格子为中心，沿一个方向取前后各4格共8个邻居，每格2位编码：
+ * 0=空，1=黑，2=白，3=棋盘外（边界）；偏移-4~-1存于槽位0~3，+1~+4存于槽位4~7。
+ * 整个窗口恰好压缩成一个16位整数，作为棋型查找表的下标。
+ */
+namespace PatternCode {
+constexpr uint16_t EMPTY = 0;
+constexpr uint16_t BLACK = 1;
+constexpr uint16_t WHITE = 2;
+constexpr uint16_t EDGE = 3;
+constexpr int WINDOW_RADIUS = 4;
+constexpr int TABLE_SIZE = 1 << 16;
+
+/**
+ * @brief 邻居偏移（-4~-1, 1~4）转槽位号（0~7）
+ */
+constexpr int slotOf(int offset) { return offset < 0 ? offset + 4 : offset + 3; }
+} // namespace PatternCode
+
+/**
+ * @brief 规则变体（决定“成五”的判定方式与禁手，每种规则对应一张独立的棋型表）
+ * - Freestyle：无禁手，五连及以上（长连）均获胜；
+ * - Standard：双方都必须恰好五连，长连不算胜；
+ * - Renju：黑方必须恰好五连（长连不算胜），且不得下三三、四四、长连禁手；白方五连及以上均获胜；
+ * - Caro：五连及以上获胜，但两端都被对方棋子堵住的连五不算胜（棋盘边缘不算堵）。
+ * Board与各AI组件以规则为模板参数（BasicBoard<N, R>），每种规则编译出各自的特化，
+ * 下方的规则谓词都是constexpr，在特化内部以if constexpr展开，热路径上没有按规则的分支。
+ */
+enum class Rule : uint8_t { Freestyle, Standard, Renju, Caro };
+
+/**
+ * @brief 规则变体数量
+ */
+constexpr int RULE_COUNT = 4;
+
+/**
+ * @brief 某规则下color一方是否要求恰好五连
+ */
+constexpr bool requiresExactFive(Rule rule, Config::PieceType color) {
+    return rule == Rule::Standard || (rule == Rule::Renju && color == Config::PieceType::Black);
+}
+
+/**
+ * @brief 某规则下两端都被对方堵住的连五是否不算胜（Caro）
+ */
+constexpr bool requiresUnblockedFive(Rule rule) {
+    return rule == Rule::Caro;
+}
+
+/**
+ * @brief 某规则下color一方是否受禁手约束（Renju黑方）
+ */
+constexpr bool hasForbiddenMoves(Rule rule, Config::PieceType color) {
+    return rule == Rule::Renju && color == Config::PieceType::Black;
+}
+
+/**
+ * @brief 棋型查找表（构建期生成的constexpr数组，每种规则一张）
+ * 核心职责：对全部65536种窗口编码，预先计算“中心空点落下黑子/白子后形成的棋型”与估值贡献，
+ * 使Board在增量维护棋型时每个方向只需读取一个表项。
+ * 表项格式（32位）：低4位为黑方棋型，4~7位为白方棋型，第8位为黑方长连标记（中心落黑子后经过中心≥6连），
+ * 第9位为黑方同线四四标记（同一方向上形成两个独立的冲四），高16位为估值（PATTERN_SCORE[黑] - PATTERN_SCORE[白]），
+ * 一次读取同时得到双方棋型、禁手判定所需的标记与估值。
+ * 计算方式（PatternGen.h）：编码按从大到小的顺序处理——在空槽补一颗己方棋子会使编码变大，
+ * 因此计算某个编码时，它“再下一手”的所有后继编码都已算好：
+ * - 经过中心的连续己方棋子构成“成五”（按规则判定是否允许长连）→ Five；
+ * - 否则统计再下一手可成五的空槽数：≥2 → OpenFour，=1 → Four；
+ * - 否则若再下一手可成OpenFour → OpenThree，可成Four → Three；
+ * - 否则若再下一手可成OpenThree → OpenTwo，可成Three → Two。
+ * 要求恰好五连时，窗口只能看到中心±4格：五连一端恰好落在窗口边缘时，无法得知第±5格是否为己方棋子，
+ * 此时按成五处理（最终胜负以Board::checkWin()为准）；Caro的“两端被堵”同理，看不到的一端按未堵处理。
+ * 生成方式：构建时由 tools/PatternTableGen 生成 PatternTables.inc，作为constexpr数组编译进只读数据段，
+ * 程序启动时无任何初始化开销，多线程查询无需同步。
+ */
+struct PatternTable {
+    uint32_t entries[PatternCode::TABLE_SIZE];
+
+    /**
+     * @brief 获取指定规则的棋型表
+     */
+    static const PatternTable& get(Rule rule = Rule::Freestyle);
+
+    /**
+     * @brief 查询窗口编码对应的棋型
+     * @param code 8邻居窗口编码
+     * @param color 中心落子方（Black/White）
+     * @return PatternType 中心落子后形成的棋型
+     */
+    constexpr PatternType lookup(uint16_t code, Config::PieceType color) const {
+        return typeOf(entries[code], color);
+    }
+
+    /**
+     * @brief 查询窗口编码对黑方的估值贡献（黑方棋型分 - 白方棋型分）
+     */
+    constexpr int score(uint16_t code) const { return scoreOf(entries[code]); }
+
+    /**
+     * @brief 从表项解出color一方的棋型
+     */
+    static constexpr PatternType typeOf(uint32_t entry, Config::PieceType color) {
+        return static_cast<PatternType>(color == Config::PieceType::Black ? (entry & 0x0F) : ((entry >> 4) & 0x0F));
+    }
+
+    /**
+     * @brief 从表项解出估值
+     */
+    static constexpr int scoreOf(uint32_t entry) { return static_cast<int16_t>(entry >> 16); }
+
+    /**
+     * @brief 表项中的黑方禁手标记位
+     */
+    static constexpr uint32_t OVERLINE_FLAG = 1u << 8;
+    static constexpr uint32_t LINE_DOUBLE_FOUR_FLAG = 1u << 9;
+
+    /**
+     * @brief 由双方棋型打包表项
+     */
+    static constexpr uint32_t packEntry(PatternType black, PatternType white) {
+        const int score = PATTERN_SCORE[static_cast<int>(black)] - PATTERN_SCORE[static_cast<int>(white)];
+        return static_cast<uint32_t>(black) | (static_cast<uint32_t>(white) << 4)
+             | (static_cast<uint32_t>(static_cast<uint16_t>(score)) << 16);
+    }
+};
+
+/**
+ * @brief 全部规则的棋型表（按Rule下标，定义于Pattern.cpp）
+ */
+extern const PatternTable PATTERN_TABLES[RULE_COUNT];
+
+inline const PatternTable& PatternTable::get(Rule rule) {
+    return PATTERN_TABLES[static_cast<int>(rule)];
+}
+
+#endif // PATTERN_H
@@ -0,0 +1,164 @@
+﻿#pragma once
+#ifndef PATTERNGEN_H
+#define PATTERNGEN_H
+
+#include <cstdint>
+#include "Pattern.h"
+
+/**
+ * @brief 棋型表生成算法（供构建期生成器 tools/PatternTableGen 使用）
+ * 全部函数均为constexpr，不依赖运行时状态；生成器在构建时调用它们计算每种规则的表项，
+ * 再写出 PatternTables.inc 供 Pattern.cpp 以constexpr数组的形式编译进只读数据段。
+ * （直接在编译器内做constexpr求值需要数千万次解释执行步骤，远超编译器默认上限，故改为构建期生成。）
+ */
+namespace PatternGen {
+
+/**
+ * @brief 读取窗口编码中某个槽位的值
+ */
+constexpr uint16_t slotValue(uint32_t code, int slot) {
+    return static_cast<uint16_t>((code >> (slot * 2)) & 3u);
+}
+
+/**
+ * @brief 中心视为own方棋子时，经过中心的连续own方棋子数
+ */
+constexpr int runThroughCenter(uint32_t code, uint16_t own) {
+    int len = 1;
+    for (int slot = 3; slot >= 0 && slotValue(code, slot) == own; --slot) ++len;
+    for (int slot = 4; slot < 8 && slotValue(code, slot) == own; ++slot) ++len;
+    return len;
+}
+
+/**
+ * @brief 中心视为own方棋子时，经过中心的连子两端是否都是对方棋子
+ * 连子延伸到窗口边缘（看不到外侧格子）或端点为棋盘边界时按未堵处理。
+ */
+constexpr bool runBlockedBothEnds(uint32_t code, uint16_t own) {
+    const uint16_t opp = own == PatternCode::BLACK ? PatternCode::WHITE : PatternCode::BLACK;
+    int left = 3;
+    while (left >= 0 && slotValue(code, left) == own) --left;
+    int right = 4;
+    while (right < 8 && slotValue(code, right) == own) ++right;
+    return left >= 0 && right < 8 && slotValue(code, left) == opp && slotValue(code, right) == opp;
+}
+
+/**
+ * @brief 中心落下own方棋子后是否成五（按rule判定长连与Caro的两端被堵）
+ */
+constexpr bool isFive(uint32_t code, uint16_t own, Rule rule) {
+    const int len = runThroughCenter(code, own);
+    const Config::PieceType color = own == PatternCode::BLACK ? Config::PieceType::Black : Config::PieceType::White;
+    if (requiresExactFive(rule, color)) {
+        return len == 5;
+    }
+    return len >= 5 && !(requiresUnblockedFive(rule) && runBlockedBothEnds(code, own));
+}
+
+/**
+ * @brief 中心落下own方棋子后，再下一手可以成五的空槽数（即中心这一手形成的“四”的成五点数）
+ */
+constexpr int fivePointCount(uint32_t code, uint16_t own, Rule rule) {
+    int count = 0;
+    for (int slot = 0; slot < 8; ++slot) {
+        if (slotValue(code, slot) == PatternCode::EMPTY && isFive(code | (static_cast<uint32_t>(own) << (slot * 2)), own, rule)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 黑方在中心落子后是否在这一条线上同时形成两个冲四（如 X.X*X.X、XX.*X.XX）
+ * 成五点≥2时，只有“连续四子、两端都是成五点”的活四算作一个四，其余都是同线四四。
+ */
+constexpr bool isLineDoubleFour(uint32_t code, Rule rule) {
+    const uint16_t own = PatternCode::BLACK;
+    if (fivePointCount(code, own, rule) < 2) {
+        return false;
+    }
+    int left = 3;
+    while (left >= 0 && slotValue(code, left) == own) --left;
+    int right = 4;
+    while (right < 8 && slotValue(code, right) == own) ++right;
+    const bool straightFour = runThroughCenter(code, own) == 4 && fivePointCount(code, own, rule) == 2
+        && left >= 0 && right < 8
+        && isFive(code | (static_cast<uint32_t>(own) << (left * 2)), own, rule)
+        && isFive(code | (static_cast<uint32_t>(own) << (right * 2)), own, rule);
+    return !straightFour;
+}
+
+/**
+ * @brief 计算own方在全部窗口编码上的棋型（规则见PatternTable类说明）
+ * @param out 输出：out[code]为中心落下own方棋子后的棋型
+ * @param own 落子方编码（PatternCode::BLACK/WHITE）
+ * @param rule 规则变体（决定成五判定）
+ */
+constexpr void classifyAll(PatternType* out, uint16_t own, Rule rule) {
+    for (int code = PatternCode::TABLE_SIZE - 1; code >= 0; --code) {
+        if (isFive(code, own, rule)) {
+            out[code] = PatternType::Five;
+            continue;
+        }
+
+        int fiveCount = 0;
+        bool makesOpenFour = false, makesFour = false, makesOpenThree = false, makesThree = false;
+        for (int slot = 0; slot < 8; ++slot) {
+            if (slotValue(code, slot) != PatternCode::EMPTY) {
+                continue;
+            }
+            const PatternType next = out[code + (own << (slot * 2))];
+            fiveCount += next == PatternType::Five;
+            makesOpenFour |= next == PatternType::OpenFour;
+            makesFour |= next == PatternType::Four;
+            makesOpenThree |= next == PatternType::OpenThree;
+            makesThree |= next == PatternType::Three;
+        }
+
+        PatternType type = PatternType::None;
+        if (fiveCount >= 2) {
+            type = PatternType::OpenFour;
+        } else if (fiveCount == 1) {
+            type = PatternType::Four;
+        } else if (makesOpenFour) {
+            type = PatternType::OpenThree;
+        } else if (makesFour) {
+            type = PatternType::Three;
+        } else if (makesOpenThree) {
+            type = PatternType::OpenTwo;
+        } else if (makesThree) {
+            type = PatternType::Two;
+        }
+        out[code] = type;
+    }
+}
+
+/**
+ * @brief 生成指定规则的全部表项
+ * 规则不同时双方的成五判定可能不同（如Renju），因此白方不由黑方颜色互换得到，而是独立计算；
+ * 黑方受禁手约束的规则另外写入长连与同线四四标记（其他规则这两位恒为0）。
+ * @param rule 规则变体
+ * @param entries 输出：TABLE_SIZE个表项
+ * @param black 工作区：TABLE_SIZE个黑方棋型
+ * @param white 工作区：TABLE_SIZE个白方棋型
+ */
+constexpr void buildEntries(Rule rule, uint32_t* entries, PatternType* black, PatternType* white) {
+    classifyAll(black, PatternCode::BLACK, rule);
+    classifyAll(white, PatternCode::WHITE, rule);
+    const bool forbidden = hasForbiddenMoves(rule, Config::PieceType::Black);
+    for (int code = 0; code < PatternCode::TABLE_SIZE; ++code) {
+        uint32_t entry = PatternTable::packEntry(black[code], white[code]);
+        if (forbidden && black[code] != PatternType::Five) {
+            if (runThroughCenter(code, PatternCode::BLACK) >= 6) {
+                entry |= PatternTable::OVERLINE_FLAG;
+            } else if (isLineDoubleFour(code, rule)) {
+                entry |= PatternTable::LINE_DOUBLE_FOUR_FLAG;
+            }
+        }
+        entries[code] = entry;
+    }
+}
+
+} // namespace PatternGen
+
+#endif // PATTERNGEN_H
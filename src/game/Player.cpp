@@ -31,11 +31,11 @@ Player::Player(QString name, Config::PieceType color, Player::Type type)
 
 /**
  * @brief 判断是否为AI玩家的实现
- * 核心逻辑：检查玩家类型是否为AI_Easy或AI_Hard，只要满足其一则判定为AI玩家。
+ * 核心逻辑：检查玩家类型是否为AI_Easy、AI_Hard或AI_MCTS，只要满足其一则判定为AI玩家。
  * @return bool AI玩家判断结果。
  */
 bool Player::isAI() const {
-    return m_type == Type::AI_Easy || m_type == Type::AI_Hard;
+    return m_type == Type::AI_Easy || m_type == Type::AI_Hard || m_type == Type::AI_MCTS;
 }
 
 /**
@@ -55,3 +55,12 @@ QString Player::name() const {
 Config::PieceType Player::color() const {
     return m_color;
 }
+
+/**
+ * @brief 获取玩家类型的实现
+ * 直接返回私有成员m_type的值，确保数据只读性（外部无法修改类型）。
+ * @return Type 玩家类型。
+ */
+Player::Type Player::type() const {
+    return m_type;
+}
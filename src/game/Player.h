@@ -20,9 +20,10 @@ public:
      * 用于区分不同类型的玩家，支持后续扩展更多AI难度等级。
      * - Human：人类玩家（通过QML界面输入落子）；
      * - AI_Easy：简单AI（随机落子，适合新手）；
-     * - AI_Hard：困难AI（极大极小值算法，适合进阶玩家）。
+     * - AI_Hard：困难AI（极大极小值算法，适合进阶玩家）；
+     * - AI_MCTS：蒙特卡洛树搜索AI（多线程MCTS，风格不同于Alpha-Beta）。
      */
-    enum class Type { Human, AI_Easy, AI_Hard };
+    enum class Type { Human, AI_Easy, AI_Hard, AI_MCTS };
 
     /**
      * @brief 默认构造函数
@@ -36,7 +37,7 @@ public:
      * 用传入的参数初始化玩家属性，支持创建自定义配置的玩家。
      * @param name 玩家名称（如“黑方”“白方”“AI（简单）”）；
      * @param color 玩家对应的棋子颜色（黑棋/白棋）；
-     * @param type 玩家类型（人类/AI_Easy/AI_Hard）。
+     * @param type 玩家类型（人类/AI_Easy/AI_Hard/AI_MCTS）。
      */
     Player(QString name, Config::PieceType color, Type type);
 
@@ -57,11 +58,18 @@ public:
     /**
      * @brief 判断当前玩家是否为AI的接口
      * @return bool 结果：true=AI玩家，false=人类玩家。
-     * 核心逻辑：检查玩家类型是否为AI_Easy或AI_Hard。
+     * 核心逻辑：检查玩家类型是否为AI_Easy、AI_Hard或AI_MCTS。
      * @note const修饰：函数不修改成员变量，仅做查询。
      */
     bool isAI() const;
 
+    /**
+     * @brief 获取玩家类型的只读接口
+     * @return Type 玩家类型（Human/AI_Easy/AI_Hard/AI_MCTS），GameController据此选择AI算法。
+     * @note const修饰：函数不修改成员变量，仅做查询。
+     */
+    Type type() const;
+
 private:
     /**
      * @brief 玩家名称（如“黑方”“白方”）
@@ -0,0 +1,165 @@
+﻿#include "SparseBoard.h"
+
+SparseBoard::SparseBoard(Rule rule)
+    : m_rule(rule)
+{
+}
+
+void SparseBoard::reset() {
+    m_tiles.clear();
+    m_nearCount.clear();
+    m_stoneCount = 0;
+}
+
+/**
+ * @brief 分块查找实现
+ * 实现逻辑：块坐标取算术右移（负坐标向下取整），未分配的分块返回nullptr。
+ */
+const SparseBoard::Tile* SparseBoard::findTile(int row, int col) const {
+    const auto it = m_tiles.find(packKey(row >> TILE_SHIFT, col >> TILE_SHIFT));
+    return it == m_tiles.end() ? nullptr : &it->second;
+}
+
+/**
+ * @brief 落子实现
+ * 实现逻辑：
+ * Step1：校验坐标与棋子类型（None转为提子）；
+ * Step2：取（必要时创建）所在分块，已有棋子则失败；
+ * Step3：写入格子并给周围5×5范围的候选计数加一。
+ */
+bool SparseBoard::placePiece(int row, int col, Config::PieceType type) {
+    if (type == Config::PieceType::None) {
+        return removePiece(row, col);
+    }
+    if (!inRange(row, col)) {
+        return false;
+    }
+    Tile& tile = m_tiles[packKey(row >> TILE_SHIFT, col >> TILE_SHIFT)];
+    uint8_t& cell = tile.cells[cellInTile(row, col)];
+    if (cell != static_cast<uint8_t>(Config::PieceType::None)) {
+        return false;
+    }
+    cell = static_cast<uint8_t>(type);
+    ++tile.stones;
+    ++m_stoneCount;
+    updateCandidates(row, col, 1);
+    return true;
+}
+
+/**
+ * @brief 提子实现
+ * 实现逻辑：清除格子、回退候选计数；分块内已无棋子时释放分块，保证内存只随棋子数增长。
+ */
+bool SparseBoard::removePiece(int row, int col) {
+    if (!inRange(row, col)) {
+        return false;
+    }
+    const auto it = m_tiles.find(packKey(row >> TILE_SHIFT, col >> TILE_SHIFT));
+    if (it == m_tiles.end()) {
+        return false;
+    }
+    uint8_t& cell = it->second.cells[cellInTile(row, col)];
+    if (cell == static_cast<uint8_t>(Config::PieceType::None)) {
+        return false;
+    }
+    cell = static_cast<uint8_t>(Config::PieceType::None);
+    if (--it->second.stones == 0) {
+        m_tiles.erase(it);
+    }
+    --m_stoneCount;
+    updateCandidates(row, col, -1);
+    return true;
+}
+
+Config::PieceType SparseBoard::getPiece(int row, int col) const {
+    if (!inRange(row, col)) {
+        return Config::PieceType::None;
+    }
+    const Tile* tile = findTile(row, col);
+    return tile ? static_cast<Config::PieceType>(tile->cells[cellInTile(row, col)]) : Config::PieceType::None;
+}
+
+/**
+ * @brief 单方向连子计数实现：从(row,col)的下一格起沿(dr,dc)数同色棋子，最多数limit个
+ * （数到5个就不影响“至少五连”与“恰好五连”的判定；Caro需要找到连子端点，不设上限）。
+ */
+int SparseBoard::runLength(int row, int col, int dr, int dc, Config::PieceType type, int limit) const {
+    int count = 0;
+    for (int step = 1; step <= limit && getPiece(row + dr * step, col + dc * step) == type; ++step) {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief 胜负判断实现
+ * 实现逻辑：四个方向分别累加正反两侧的连子数（含落子点本身），
+ * 规则要求恰好五连时长度必须等于5，否则大于等于5即获胜；
+ * Caro另外检查连子两端外侧的格子，都是对方棋子时这条线不算获胜。
+ */
+bool SparseBoard::checkWin(int row, int col, Config::PieceType type) const {
+    if (type == Config::PieceType::None || getPiece(row, col) != type) {
+        return false;
+    }
+    const bool exactFive = requiresExactFive(m_rule, type);
+    const bool unblocked = requiresUnblockedFive(m_rule);
+    const int limit = unblocked ? COORD_LIMIT : 5;
+    const Config::PieceType opp = Config::opponent(type);
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        const int dr = DIR_DR[dir];
+        const int dc = DIR_DC[dir];
+        const int forward = runLength(row, col, dr, dc, type, limit);
+        const int backward = runLength(row, col, -dr, -dc, type, limit);
+        const int length = 1 + forward + backward;
+        if (exactFive ? length != 5 : length < 5) {
+            continue;
+        }
+        if (unblocked && getPiece(row + dr * (forward + 1), col + dc * (forward + 1)) == opp
+                      && getPiece(row - dr * (backward + 1), col - dc * (backward + 1)) == opp) {
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 候选计数增量维护实现
+ * 实现逻辑：落子（delta=+1）/提子（delta=-1）时更新周围5×5格子的计数，计数归零即删除条目，
+ * 表的大小始终不超过 25×棋子数。
+ */
+void SparseBoard::updateCandidates(int row, int col, int delta) {
+    for (int dr = -CANDIDATE_RADIUS; dr <= CANDIDATE_RADIUS; ++dr) {
+        for (int dc = -CANDIDATE_RADIUS; dc <= CANDIDATE_RADIUS; ++dc) {
+            const uint64_t key = packKey(row + dr, col + dc);
+            if (delta > 0) {
+                ++m_nearCount[key];
+                continue;
+            }
+            const auto it = m_nearCount.find(key);
+            if (it != m_nearCount.end() && --it->second == 0) {
+                m_nearCount.erase(it);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 候选着法列举实现：遍历候选计数表，跳过已有棋子与超出坐标上限的格子
+ */
+int SparseBoard::candidateMoves(std::vector<Cell>& out) const {
+    out.clear();
+    if (m_stoneCount == 0) {
+        out.push_back(Cell{});
+        return 1;
+    }
+    out.reserve(m_nearCount.size());
+    for (const auto& entry : m_nearCount) {
+        const int row = static_cast<int32_t>(entry.first >> 32);
+        const int col = static_cast<int32_t>(static_cast<uint32_t>(entry.first));
+        if (inRange(row, col) && getPiece(row, col) == Config::PieceType::None) {
+            out.push_back(Cell{ row, col });
+        }
+    }
+    return static_cast<int>(out.size());
+}
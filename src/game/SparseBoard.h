@@ -0,0 +1,132 @@
+﻿#pragma once
+#ifndef SPARSEBOARD_H
+#define SPARSEBOARD_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../story/Constants.h"
+#include "Pattern.h"
+
+/**
+ * @brief 无界棋盘（无限五子棋/自由规则变体）的稀疏存储后端
+ * 核心职责：与BasicBoard相同的落子/提子/查询/胜负判断接口（placePiece、removePiece、getPiece、checkWin……），
+ * 但坐标为任意有符号整数（|row|、|col| ≤ COORD_LIMIT），不存在“棋盘边缘”。
+ * 存储方式：只为有棋子的区域分配16×16的分块（Tile），分块按块坐标存入哈希表；
+ * 分块内是稠密的格子数组，胜负判断沿同一方向走的相邻格子通常落在同一分块内。
+ * 开销：内存与各操作耗时只与已落棋子数成正比，与棋盘“面积”无关——
+ * - placePiece/removePiece/getPiece：一次分块查找，O(1)；
+ * - checkWin：四个方向各最多走8格，O(1)；
+ * - candidateMoves：遍历增量维护的“棋子两格范围内格子”计数表，O(棋子数)。
+ * 注意：无界棋盘永远不会下满，isFull()恒为false；Renju禁手不适用，rule只决定成五判定（长连、Caro两端被堵）。
+ * 与稠密BasicBoard不同，这里的规则是运行时参数：稀疏后端只做落子与胜负判断，不在搜索热路径上。
+ */
+class SparseBoard {
+public:
+    /**
+     * @brief 格子坐标
+     */
+    struct Cell {
+        int row = 0;
+        int col = 0;
+    };
+
+    /**
+     * @brief 坐标绝对值上限（保证坐标加减窗口半径与打包为64位键时不溢出）
+     */
+    static constexpr int COORD_LIMIT = 1 << 30;
+
+    /**
+     * @brief 构造函数
+     * @param rule 规则变体（只决定成五判定：Standard要求双方恰好五连，Renju要求黑方恰好五连，Caro两端被堵不算）
+     */
+    explicit SparseBoard(Rule rule = Rule::Freestyle);
+
+    /**
+     * @brief 获取当前规则变体
+     */
+    Rule rule() const { return m_rule; }
+
+    /**
+     * @brief 重置棋盘（释放全部分块与候选计数）
+     */
+    void reset();
+
+    /**
+     * @brief 落子操作
+     * @param type 棋子类型；传入PieceType::None时等价于removePiece(row, col)
+     * @return bool true=落子成功，false=坐标超出COORD_LIMIT或已有棋子
+     */
+    bool placePiece(int row, int col, Config::PieceType type);
+
+    /**
+     * @brief 提子操作（分块内棋子全部提走后释放该分块）
+     * @return bool true=成功清除棋子，false=本来为空
+     */
+    bool removePiece(int row, int col);
+
+    /**
+     * @brief 获取指定位置的棋子类型（未分配分块的位置均为空）
+     */
+    Config::PieceType getPiece(int row, int col) const;
+
+    /**
+     * @brief 判断指定位置落子后是否获胜（横、竖、两条斜线，规则要求恰好五连时长连不算胜，Caro两端都被对方堵住不算胜）
+     */
+    bool checkWin(int row, int col, Config::PieceType type) const;
+
+    /**
+     * @brief 无界棋盘永远不满
+     */
+    bool isFull() const { return false; }
+
+    /**
+     * @brief 获取棋盘上的棋子总数
+     */
+    int stoneCount() const { return m_stoneCount; }
+
+    /**
+     * @brief 已分配的分块数（用于观察内存占用）
+     */
+    size_t tileCount() const { return m_tiles.size(); }
+
+    /**
+     * @brief 列举候选着法：已有棋子两格范围内的空点（空棋盘时为原点）
+     * @param out 输出容器（先清空，顺序不保证）
+     * @return int 候选点数量
+     */
+    int candidateMoves(std::vector<Cell>& out) const;
+
+private:
+    static constexpr int TILE_SHIFT = 4;
+    static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+    static constexpr int TILE_MASK = TILE_SIZE - 1;
+    static constexpr int CANDIDATE_RADIUS = 2;
+
+    /**
+     * @brief 16×16分块：格子按行优先存放PieceType编码
+     */
+    struct Tile {
+        uint8_t cells[TILE_SIZE * TILE_SIZE] = {};
+        int stones = 0;
+    };
+
+    static bool inRange(int row, int col) {
+        return row >= -COORD_LIMIT && row <= COORD_LIMIT && col >= -COORD_LIMIT && col <= COORD_LIMIT;
+    }
+    static uint64_t packKey(int row, int col) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(col);
+    }
+    static int cellInTile(int row, int col) { return ((row & TILE_MASK) << TILE_SHIFT) | (col & TILE_MASK); }
+
+    const Tile* findTile(int row, int col) const;
+    int runLength(int row, int col, int dr, int dc, Config::PieceType type, int limit) const;
+    void updateCandidates(int row, int col, int delta);
+
+    Rule m_rule;
+    std::unordered_map<uint64_t, Tile> m_tiles;         // 分块坐标(row>>4, col>>4) → 分块
+    std::unordered_map<uint64_t, int> m_nearCount;     // 格子 → 其两格范围内的棋子数（>0才保存）
+    int m_stoneCount = 0;
+};
+
+#endif // SPARSEBOARD_H
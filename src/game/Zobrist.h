@@ -0,0 +1,73 @@
+﻿#pragma once
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "../story/Constants.h"
+
+/**
+ * @brief Zobrist 哈希键表（编译期生成）
+ * 核心职责：为每个“颜色×格子”分配一个64位随机键，局面哈希 = 所有棋子对应键的异或。
+ * 落子与提子都只需对同一个键做一次异或，因此Board可以O(1)增量维护哈希，
+ * 供置换表、搜索缓存与开局库查询使用。
+ * 生成方式：splitmix64 伪随机序列，全部为constexpr计算，程序启动时无任何初始化开销，
+ * 且不同平台、不同编译器生成的键完全一致（开局库文件可跨平台复用）。
+ */
+namespace Zobrist {
+
+/**
+ * @brief splitmix64 单步：推进状态并返回下一个伪随机数
+ */
+constexpr uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief 键表结构：keys[颜色][格子]，颜色下标0=黑、1=白，格子下标为row*N+col
+ */
+template <int N>
+struct KeyTable {
+    uint64_t keys[2][N * N];
+};
+
+/**
+ * @brief 编译期生成N×N棋盘的键表（各尺寸使用同一种子，15×15的键与引入多尺寸之前完全相同）
+ */
+template <int N>
+constexpr KeyTable<N> makeKeyTable() {
+    KeyTable<N> table{};
+    uint64_t state = 0x4C51484A32303236ull;  // 固定种子，保证哈希值可复现
+    for (int color = 0; color < 2; ++color) {
+        for (int cell = 0; cell < N * N; ++cell) {
+            table.keys[color][cell] = splitmix64(state);
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief 全局键表（constexpr，每种棋盘尺寸一张，存放于只读数据段）
+ */
+template <int N>
+inline constexpr KeyTable<N> KEYS = makeKeyTable<N>();
+
+static_assert(KEYS<Config::BOARD_SIZE>.keys[0][0] != KEYS<Config::BOARD_SIZE>.keys[1][0], "Zobrist keys must be distinct");
+
+/**
+ * @brief 查询指定颜色、指定格子的键
+ * @tparam N 棋盘大小（默认Config::BOARD_SIZE）
+ * @param colorIndex 颜色下标（0=黑，1=白）
+ * @param row 行坐标
+ * @param col 列坐标
+ */
+template <int N = Config::BOARD_SIZE>
+constexpr uint64_t key(int colorIndex, int row, int col) {
+    return KEYS<N>.keys[colorIndex][row * N + col];
+}
+
+} // namespace Zobrist
+
+#endif // ZOBRIST_H
@@ -0,0 +1,288 @@
+﻿#include "PiskvorkProtocol.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+std::string toUpper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return text;
+}
+
+/**
+ * @brief 解析 "x,y" 坐标（协议的 x 为列、y 为行）
+ */
+bool parseCell(const std::string& text, int& row, int& col) {
+    return std::sscanf(text.c_str(), "%d,%d", &col, &row) == 2;
+}
+
+/**
+ * @brief INFO rule 位掩码到规则变体的映射（连珠与Caro优先于“恰好五连”）
+ */
+Rule ruleFromMask(int mask) {
+    if (mask & 4) {
+        return Rule::Renju;
+    }
+    if (mask & 8) {
+        return Rule::Caro;
+    }
+    if (mask & 1) {
+        return Rule::Standard;
+    }
+    return Rule::Freestyle;
+}
+
+} // namespace
+
+PiskvorkProtocol::PiskvorkProtocol(std::ostream& out)
+    : m_out(out)
+{
+}
+
+/**
+ * @brief 命令分派实现
+ * 实现逻辑：
+ * Step1：去掉行尾的 '\r' 与空白（Windows 管理器按 CRLF 发送）；
+ * Step2：BOARD 块内逐行收集 "x,y,f"，遇到 DONE 结束并思考；
+ * Step3：否则取第一个单词（不区分大小写）为命令，其余为参数，逐一分派；需要棋盘的命令在 START 之前应答 ERROR。
+ */
+bool PiskvorkProtocol::handleLine(const std::string& line) {
+    std::string text = line;
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.pop_back();
+    }
+
+    if (m_inBoard) {
+        if (toUpper(text) == "DONE") {
+            m_inBoard = false;
+            finishBoard();
+            return true;
+        }
+        int row = 0, col = 0, field = 0;
+        if (std::sscanf(text.c_str(), "%d,%d,%d", &col, &row, &field) == 3) {
+            // 3 为连续对局中管理器标出的上一局连五棋子，按对方棋子占位
+            m_boardStones.push_back(Move{ row, col, field == 1 ? Config::PieceType::Black : Config::PieceType::White });
+        } else {
+            reply("ERROR bad BOARD line: " + text);
+        }
+        return true;
+    }
+
+    std::istringstream stream(text);
+    std::string command;
+    stream >> command;
+    command = toUpper(command);
+    std::string args;
+    std::getline(stream >> std::ws, args);
+
+    if (command.empty()) {
+        return true;
+    }
+    if (command == "END") {
+        return false;
+    }
+    if (command == "ABOUT") {
+        reply("name=\"LQHJ\", version=\"2.0\", author=\"LQHJ2.0\", country=\"CN\"");
+        return true;
+    }
+    if (command == "START") {
+        start(std::atoi(args.c_str()));
+        return true;
+    }
+    if (command == "RECTSTART") {
+        int width = 0, height = 0;
+        if (std::sscanf(args.c_str(), "%d,%d", &width, &height) != 2 || width != height) {
+            reply("ERROR only square boards are supported");
+        } else {
+            start(width);
+        }
+        return true;
+    }
+    if (command == "INFO") {
+        std::istringstream info(args);
+        std::string key, value;
+        info >> key >> value;
+        this->info(key, value);
+        return true;
+    }
+    if (!m_session) {
+        reply(command == "BEGIN" || command == "TURN" || command == "BOARD" || command == "RESTART" || command == "TAKEBACK"
+                  ? "ERROR no START received" : "UNKNOWN " + command);
+        return true;
+    }
+
+    if (command == "RESTART") {
+        m_session->reset();
+        m_moves.clear();
+        reply("OK");
+    } else if (command == "BEGIN") {
+        m_ownColor = Config::PieceType::Black;
+        think();
+    } else if (command == "TURN") {
+        int row = 0, col = 0;
+        if (m_moves.empty()) {
+            m_ownColor = Config::PieceType::White;
+        }
+        if (!parseCell(args, row, col) || !play(row, col, opponentColor())) {
+            reply("ERROR invalid move: " + args);
+            return true;
+        }
+        think();
+    } else if (command == "BOARD") {
+        m_inBoard = true;
+        m_boardStones.clear();
+    } else if (command == "TAKEBACK") {
+        int row = 0, col = 0;
+        if (m_moves.empty() || !m_session->unmakeMove(row, col)) {
+            reply("ERROR nothing to take back");
+            return true;
+        }
+        m_moves.pop_back();
+        reply("OK");
+    } else {
+        reply("UNKNOWN " + command);
+    }
+    return true;
+}
+
+int PiskvorkProtocol::run(std::istream& in) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!handleLine(line)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 每步预算实现
+ * 实现逻辑：以 timeout_turn 为上限（0 表示尽快落子，取 FAST_TURN_MS）；有局时限制时不超过剩余局时的 1/MOVES_TO_GO；
+ * 再扣除通信余量。搜索引擎在用掉一半预算后不再开始新的迭代，实际耗时通常明显低于预算。
+ */
+int PiskvorkProtocol::moveBudgetMs() const {
+    int budget = m_timeoutTurn > 0 ? m_timeoutTurn : FAST_TURN_MS;
+    if (m_timeoutMatch > 0 && m_timeLeft > 0) {
+        budget = std::min(budget, m_timeLeft / MOVES_TO_GO);
+    }
+    return std::max(1, budget - TIME_MARGIN_MS);
+}
+
+/**
+ * @brief 开局实现：只接受有编译期特化的尺寸，按当前规则与线程数创建会话
+ */
+void PiskvorkProtocol::start(int size) {
+    if (!GameSession::isSupportedSize(size)) {
+        reply("ERROR unsupported board size " + std::to_string(size));
+        return;
+    }
+    m_session = GameSession::create(size, m_rule);
+    m_session->setThreadCount(m_threads);
+    m_moves.clear();
+    m_inBoard = false;
+    reply("OK");
+}
+
+/**
+ * @brief INFO 实现：时间参数直接记录；thread_num 立即作用于会话；rule 变化时重建会话并重放已有着法
+ */
+void PiskvorkProtocol::info(const std::string& key, const std::string& value) {
+    const long number = std::strtol(value.c_str(), nullptr, 10);
+    const int clamped = static_cast<int>(std::min<long>(std::max<long>(number, 0), 0x7FFFFFFF));
+    if (key == "timeout_turn") {
+        m_timeoutTurn = clamped;
+    } else if (key == "timeout_match") {
+        m_timeoutMatch = clamped;
+    } else if (key == "time_left") {
+        m_timeLeft = clamped;
+    } else if (key == "thread_num") {
+        m_threads = std::max(1, clamped);
+        if (m_session) {
+            m_session->setThreadCount(m_threads);
+        }
+    } else if (key == "rule") {
+        const Rule rule = ruleFromMask(clamped);
+        if (rule != m_rule) {
+            m_rule = rule;
+            if (m_session) {
+                rebuildSession();
+            }
+        }
+    }
+}
+
+/**
+ * @brief BOARD 块收尾实现
+ * 实现逻辑：清空棋盘后按给出的顺序重放；轮到本方落子，双方子数相同说明本方先手（黑），否则本方为白；
+ * 任一棋子非法时应答 ERROR，否则思考并给出着法。
+ */
+void PiskvorkProtocol::finishBoard() {
+    m_session->reset();
+    m_moves.clear();
+    const auto own = std::count_if(m_boardStones.begin(), m_boardStones.end(),
+                                   [](const Move& m) { return m.type == Config::PieceType::Black; });
+    m_ownColor = own * 2 == static_cast<long>(m_boardStones.size()) ? Config::PieceType::Black : Config::PieceType::White;
+    for (const Move& stone : m_boardStones) {
+        const Config::PieceType type = stone.type == Config::PieceType::Black ? m_ownColor : opponentColor();
+        if (!play(stone.row, stone.col, type)) {
+            reply("ERROR invalid BOARD stone " + std::to_string(stone.col) + "," + std::to_string(stone.row));
+            return;
+        }
+    }
+    think();
+}
+
+bool PiskvorkProtocol::play(int row, int col, Config::PieceType type) {
+    if (!m_session->makeMove(row, col, type)) {
+        return false;
+    }
+    m_moves.push_back(Move{ row, col, type });
+    return true;
+}
+
+/**
+ * @brief 思考实现
+ * 实现逻辑：以 moveBudgetMs() 为时间预算调用困难 AI 搜索；搜索无着法（满盘等）时退回第一个合法候选点；
+ * 先输出 MESSAGE 统计行，再落子并输出 "x,y"。
+ */
+void PiskvorkProtocol::think() {
+    SearchLimits limits;
+    limits.timeMs = moveBudgetMs();
+    const SearchResult result = m_session->search(m_ownColor, limits);
+    int row = result.row;
+    int col = result.col;
+    if (row < 0 || col < 0) {
+        int candidates[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+        const int size = m_session->boardSize();
+        if (m_session->candidateMoves(candidates, m_ownColor) == 0) {
+            reply("ERROR no legal move");
+            return;
+        }
+        row = candidates[0] / size;
+        col = candidates[0] % size;
+    }
+    reply("MESSAGE depth " + std::to_string(result.depth) + " score " + std::to_string(result.score)
+          + " nodes " + std::to_string(result.nodes) + " nps " + std::to_string(result.nps)
+          + " time " + std::to_string(result.timeMs));
+    play(row, col, m_ownColor);
+    reply(std::to_string(col) + "," + std::to_string(row));
+}
+
+/**
+ * @brief 重建会话实现：以新规则创建同尺寸会话，恢复线程数并按顺序重放已有着法
+ */
+void PiskvorkProtocol::rebuildSession() {
+    const int size = m_session->boardSize();
+    m_session = GameSession::create(size, m_rule);
+    m_session->setThreadCount(m_threads);
+    for (const Move& move : m_moves) {
+        m_session->makeMove(move.row, move.col, move.type);
+    }
+}
+
+void PiskvorkProtocol::reply(const std::string& text) {
+    m_out << text << std::endl;
+}
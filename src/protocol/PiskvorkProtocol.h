@@ -0,0 +1,96 @@
+﻿#pragma once
+#ifndef PISKVORKPROTOCOL_H
+#define PISKVORKPROTOCOL_H
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../game/GameSession.h"
+
+/**
+ * @brief Piskvork/Gomocup 文本协议的引擎端实现（无界面，逐行读命令、逐行写应答）
+ * 支持的命令：
+ * - START n / RECTSTART w,h：开局（只支持有编译期特化的正方形棋盘 15、19），应答 OK 或 ERROR；
+ * - RESTART：清空棋盘，应答 OK；
+ * - BEGIN：本方先手，直接给出着法；
+ * - TURN x,y：对方着法，随后给出本方着法；
+ * - BOARD … DONE：逐行 "x,y,f"（f=1 本方、2 对方、3 连续对局的已有棋子）摆出整盘，随后给出本方着法；
+ * - INFO key value：timeout_turn/timeout_match/time_left（毫秒）、thread_num、rule（位掩码：
+ *   1=恰好五连，4=连珠禁手，8=Caro），max_memory 等其他键忽略；
+ * - TAKEBACK x,y：撤销最后一手，应答 OK；
+ * - ABOUT：引擎信息；END：退出；其他命令应答 UNKNOWN。
+ * 坐标约定：协议的 x 为列、y 为行，均从 0 开始；本方着法输出为 "x,y"。
+ * 棋盘与AI由 GameSession 承载（按尺寸与规则分派到编译期特化），规则在对局中途改变时
+ * 以新规则重建会话并重放已有着法。每次思考前输出一行 MESSAGE（深度、得分、节点数、NPS、耗时），
+ * 便于脱离界面测量每步耗时。
+ */
+class PiskvorkProtocol {
+public:
+    /**
+     * @brief 构造函数
+     * @param out 应答输出流（每条应答后刷新）
+     */
+    explicit PiskvorkProtocol(std::ostream& out);
+
+    /**
+     * @brief 处理一行命令
+     * @param line 命令行（行尾的 '\r' 会被忽略）
+     * @return bool 收到 END 时返回 false，否则返回 true
+     */
+    bool handleLine(const std::string& line);
+
+    /**
+     * @brief 读取输入流直到 END 或输入结束
+     * @return int 进程退出码（0）
+     */
+    int run(std::istream& in);
+
+    /**
+     * @brief 当前每步思考预算（毫秒），由 INFO 的时间参数推算
+     */
+    int moveBudgetMs() const;
+
+private:
+    /**
+     * @brief 一手已落下的棋（规则变化重建会话时按顺序重放）
+     */
+    struct Move {
+        int row;
+        int col;
+        Config::PieceType type;
+    };
+
+    void start(int size);
+    void info(const std::string& key, const std::string& value);
+    void finishBoard();
+    bool play(int row, int col, Config::PieceType type);
+    void think();
+    void rebuildSession();
+    void reply(const std::string& text);
+
+    Config::PieceType opponentColor() const {
+        return Config::opponent(m_ownColor);
+    }
+
+    static constexpr int DEFAULT_TURN_MS = 5000;     // 未收到 timeout_turn 时的每步时间
+    static constexpr int FAST_TURN_MS = 100;         // timeout_turn=0（尽快落子）时的每步时间
+    static constexpr int MOVES_TO_GO = 15;           // 按剩余局时分配：假定还需走的步数
+    static constexpr int TIME_MARGIN_MS = 30;        // 预留给通信与进程调度的余量
+
+    std::ostream& m_out;
+    std::unique_ptr<GameSession> m_session;
+    std::vector<Move> m_moves;
+    Config::PieceType m_ownColor = Config::PieceType::Black;
+    Rule m_rule = Rule::Freestyle;
+    int m_threads = 1;
+    int m_timeoutTurn = DEFAULT_TURN_MS;
+    int m_timeoutMatch = 0;
+    int m_timeLeft = 0;
+
+    bool m_inBoard = false;                          // 正在接收 BOARD 块
+    std::vector<Move> m_boardStones;                 // BOARD 块中的棋子（type：Black=本方，White=对方，收齐后再换算为实际颜色）
+};
+
+#endif // PISKVORKPROTOCOL_H
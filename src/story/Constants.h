@@ -6,19 +6,39 @@
 
 namespace Config {
 // 棋盘配置
-constexpr int BOARD_SIZE = 15;      // 15x15
+constexpr int BOARD_SIZE = 15;      // 默认棋盘 15x15
+constexpr int LARGE_BOARD_SIZE = 19; // 可选大棋盘 19x19（Board/AI引擎均按这两种尺寸编译，见Board.h）
+constexpr int MAX_BOARD_SIZE = LARGE_BOARD_SIZE; // 支持的最大棋盘（与尺寸无关的表按此分配）
 constexpr int CELL_SIZE = 40;       // 格子像素大小（用于界面计算）
 
+// AI配置
+constexpr int AI_THINK_TIME_MS = 1000;  // 困难AI每步搜索时间预算（毫秒）
+constexpr int AI_MOVE_DELAY_MS = 300;   // AI落子前的展示延迟（毫秒），模拟思考过程
+constexpr int AI_THREAD_COUNT = 0;      // 困难AI搜索线程数（Lazy SMP），0表示使用全部硬件线程
+constexpr bool AI_PONDER_ENABLED = true; // 人类思考期间困难AI是否后台思考（Pondering）
+constexpr int AI_PONDER_MAX_MS = 60000; // 单次后台思考的时间上限（毫秒）
+constexpr int AI_TT_SIZE_MB = 32;       // 困难AI置换表大小（MB）
+constexpr bool AI_TT_HUGE_PAGES = true; // 困难AI置换表是否请求大页内存（仅Linux生效，内核不支持时回退普通内存）
+constexpr int AI_MCTS_MEMORY_MB = 64;   // MCTS AI节点池大小（MB），限制搜索树的峰值内存
+constexpr int AI_PROGRESS_INTERVAL_MS = 100; // AI思考进度（深度、得分、主要变例）通知界面的最小间隔（毫秒）
+constexpr bool AI_NNUE_ENABLED = true;  // 找到权重文件（NNUE_FILE）时困难AI是否改用神经网络估值
+constexpr int OPENING_BOOK_MAX_PLY = 12; // 开局库只在前若干手查询（与建库深度一致）
+
 
 // 棋子类型枚举
 enum class PieceType { None, Black, White };
 
+// 对手的棋子颜色（Black与White互换，全部模块共用这一处定义）
+constexpr PieceType opponent(PieceType side) { return side == PieceType::Black ? PieceType::White : PieceType::Black; }
+
 // 游戏结果状态
 enum class GameState { Playing, BlackWin, WhiteWin, Draw };
 
 // 路径配置 (适配 qml.qrc)
 const QString IMG_PATH = "qrc:/res/images/";
 const QString AUDIO_PATH = "qrc:/res/audio/";
+const QString OPENING_BOOK_FILE = "opening.book"; // 开局库文件名（位于可执行文件同目录）
+const QString NNUE_FILE = "eval%1.nnue";          // 神经网络估值权重文件名（%1为棋盘边长，位于可执行文件同目录）
 }
 
 #endif // CONSTANTS_H
@@ -0,0 +1,428 @@
+﻿#include "Tournament.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief 开局随机着法的范围（天元周围 ±RANDOM_OPENING_RADIUS）
+ */
+constexpr int RANDOM_OPENING_RADIUS = 3;
+
+/**
+ * @brief 95% 双侧置信区间对应的标准正态分位数
+ */
+constexpr double Z_95 = 1.959964;
+
+/**
+ * @brief SPRT 计算时给胜、负各加的伪计数（正则化：避免方差为0，也避免开头几局一边倒时过早判定）
+ */
+constexpr double SPRT_PSEUDO_COUNT = 0.5;
+
+/**
+ * @brief 解析非负整数（整串都须是数字）
+ */
+bool parseNumber(const std::string& text, uint64_t& out) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    out = std::strtoull(text.c_str(), nullptr, 10);
+    return true;
+}
+
+/**
+ * @brief 单局得分方差（以平均得分m为中心，胜/和/负可为带伪计数的实数）
+ */
+double scoreVariance(double wins, double draws, double losses, double m) {
+    const double n = wins + draws + losses;
+    if (n <= 0.0) {
+        return 0.0;
+    }
+    return (wins * (1.0 - m) * (1.0 - m) + draws * (0.5 - m) * (0.5 - m) + losses * m * m) / n;
+}
+
+double expectedScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/**
+ * @brief 由执子方引擎按配置选一手（搜索无着法时退回第一个合法候选点）
+ * @return bool 是否有着法（false表示执子方已无合法着法）
+ */
+bool chooseMove(GameSession& session, const EngineConfig& config, Config::PieceType side, int& row, int& col) {
+    row = -1;
+    col = -1;
+    if (config.kind == EngineConfig::Kind::Mcts) {
+        MctsLimits limits;
+        limits.timeMs = config.timeMs;
+        limits.maxPlayouts = config.maxPlayouts;
+        limits.threads = 1;
+        const MctsResult result = session.searchMcts(side, limits);
+        row = result.row;
+        col = result.col;
+    } else {
+        SearchLimits limits;
+        limits.timeMs = config.timeMs;
+        limits.maxDepth = config.maxDepth;
+        limits.maxNodes = config.maxNodes;
+        const SearchResult result = session.search(side, limits);
+        row = result.row;
+        col = result.col;
+    }
+    if (row >= 0 && col >= 0) {
+        return true;
+    }
+    int candidates[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+    if (session.candidateMoves(candidates, side) == 0) {
+        return false;
+    }
+    row = candidates[0] / session.boardSize();
+    col = candidates[0] % session.boardSize();
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 配置串解析实现：先取类型，再逐个解析 "键=值"；未设任何限制（会无限思考）的配置视为非法
+ */
+bool EngineConfig::parse(const std::string& spec, EngineConfig& out) {
+    EngineConfig config;
+    const size_t colon = spec.find(':');
+    const std::string kind = spec.substr(0, colon);
+    if (kind == "ab") {
+        config.kind = Kind::AlphaBeta;
+    } else if (kind == "mcts") {
+        config.kind = Kind::Mcts;
+    } else {
+        return false;
+    }
+
+    size_t pos = colon == std::string::npos ? spec.size() : colon + 1;
+    while (pos < spec.size()) {
+        size_t end = spec.find(',', pos);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        const std::string item = spec.substr(pos, end - pos);
+        pos = end + 1;
+        const size_t eq = item.find('=');
+        uint64_t value = 0;
+        if (eq == std::string::npos || !parseNumber(item.substr(eq + 1), value)) {
+            return false;
+        }
+        const std::string key = item.substr(0, eq);
+        if (key == "nodes") {
+            config.maxNodes = value;
+        } else if (key == "playouts") {
+            config.maxPlayouts = value;
+        } else if (key == "depth" && value >= 1 && value <= 64) {
+            config.maxDepth = static_cast<int>(value);
+        } else if (key == "time" && value <= static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            config.timeMs = static_cast<int>(value);
+        } else {
+            return false;
+        }
+    }
+
+    const bool limited = config.timeMs > 0
+        || (config.kind == Kind::Mcts ? config.maxPlayouts > 0 : config.maxNodes > 0 || config.maxDepth < 64);
+    if (!limited) {
+        return false;
+    }
+    out = config;
+    return true;
+}
+
+std::string EngineConfig::describe() const {
+    if (kind == Kind::Mcts) {
+        return "mcts:playouts=" + std::to_string(maxPlayouts) + ",time=" + std::to_string(timeMs);
+    }
+    return "ab:nodes=" + std::to_string(maxNodes) + ",depth=" + std::to_string(maxDepth) + ",time=" + std::to_string(timeMs);
+}
+
+double MatchScore::score() const {
+    const int n = games();
+    return n == 0 ? 0.5 : (wins + 0.5 * draws) / n;
+}
+
+double eloFromScore(double score) {
+    if (score <= 0.0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    if (score >= 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+/**
+ * @brief Elo 估计实现：平均得分 m 的标准误为 sqrt(σ²/n)，区间端点 m±1.96·SE 分别换算为 Elo
+ */
+EloEstimate estimateElo(const MatchScore& score) {
+    EloEstimate estimate;
+    const int n = score.games();
+    if (n == 0) {
+        return estimate;
+    }
+    const double m = score.score();
+    const double se = std::sqrt(scoreVariance(score.wins, score.draws, score.losses, m) / n);
+    estimate.elo = eloFromScore(m);
+    estimate.lower = eloFromScore(m - Z_95 * se);
+    estimate.upper = eloFromScore(m + Z_95 * se);
+    return estimate;
+}
+
+double sprtLlr(const MatchScore& score, const SprtParams& params) {
+    const int n = score.games();
+    if (n == 0) {
+        return 0.0;
+    }
+    const double wins = score.wins + SPRT_PSEUDO_COUNT;
+    const double draws = score.draws;
+    const double losses = score.losses + SPRT_PSEUDO_COUNT;
+    const double m = (wins + 0.5 * draws) / (wins + draws + losses);
+    const double variance = scoreVariance(wins, draws, losses, m);
+    const double s0 = expectedScore(params.elo0);
+    const double s1 = expectedScore(params.elo1);
+    return n * (s1 - s0) * (2.0 * m - s0 - s1) / (2.0 * variance);
+}
+
+SprtVerdict sprtVerdict(const MatchScore& score, const SprtParams& params) {
+    const double llr = sprtLlr(score, params);
+    if (llr >= std::log((1.0 - params.beta) / params.alpha)) {
+        return SprtVerdict::AcceptH1;
+    }
+    if (llr <= std::log(params.beta / (1.0 - params.alpha))) {
+        return SprtVerdict::AcceptH0;
+    }
+    return SprtVerdict::Continue;
+}
+
+std::vector<std::vector<int>> standardOpenings(int boardSize) {
+    const int c = boardSize / 2;
+    const int center = c * boardSize + c;
+    std::vector<std::vector<int>> openings;
+    for (int diagonal = 0; diagonal < 2; ++diagonal) {
+        const int second = diagonal ? (c + 1) * boardSize + c + 1 : c * boardSize + c + 1;
+        for (int dr = -2; dr <= 2; ++dr) {
+            for (int dc = -2; dc <= 2; ++dc) {
+                // 对称去重：直指保留黑1白2所在行及其一侧，斜指保留对角线及其一侧
+                if (diagonal ? dr > dc : dr < 0) {
+                    continue;
+                }
+                const int third = (c + dr) * boardSize + c + dc;
+                if (third != center && third != second) {
+                    openings.push_back({ center, second, third });
+                }
+            }
+        }
+    }
+    return openings;
+}
+
+/**
+ * @brief 开局扩展实现：重放开局后，每手收集范围内既非禁手也不成五的空点，按种子随机选一个
+ */
+std::vector<int> extendOpening(GameSession& session, const std::vector<int>& opening, int plies, uint32_t seed) {
+    const int size = session.boardSize();
+    std::vector<int> line;
+    session.reset();
+    Config::PieceType side = Config::PieceType::Black;
+    for (int cell : opening) {
+        if (!session.makeMove(cell / size, cell % size, side)) {
+            break;
+        }
+        line.push_back(cell);
+        side = Config::opponent(side);
+    }
+
+    std::mt19937 rng(seed);
+    const int c = size / 2;
+    for (int ply = 0; ply < plies; ++ply) {
+        std::vector<int> choices;
+        for (int row = c - RANDOM_OPENING_RADIUS; row <= c + RANDOM_OPENING_RADIUS; ++row) {
+            for (int col = c - RANDOM_OPENING_RADIUS; col <= c + RANDOM_OPENING_RADIUS; ++col) {
+                if (session.getPiece(row, col) != Config::PieceType::None || session.isForbidden(row, col, side)) {
+                    continue;
+                }
+                session.makeMove(row, col, side);
+                const bool wins = session.checkWin(row, col, side);
+                int undoRow = 0, undoCol = 0;
+                session.unmakeMove(undoRow, undoCol);
+                if (!wins) {
+                    choices.push_back(row * size + col);
+                }
+            }
+        }
+        if (choices.empty()) {
+            break;
+        }
+        const int cell = choices[rng() % choices.size()];
+        session.makeMove(cell / size, cell % size, side);
+        line.push_back(cell);
+        side = Config::opponent(side);
+    }
+    return line;
+}
+
+GameRecord playGame(GameSession& black, const EngineConfig& blackConfig,
+                    GameSession& white, const EngineConfig& whiteConfig, const std::vector<int>& opening) {
+    const int size = black.boardSize();
+    GameRecord record;
+    GameSession* sessions[2] = { &black, &white };
+    const EngineConfig* configs[2] = { &blackConfig, &whiteConfig };
+    for (GameSession* session : sessions) {
+        session->reset();
+        session->clearEngine();
+        session->setThreadCount(1);
+    }
+
+    Config::PieceType side = Config::PieceType::Black;
+    for (int cell : opening) {
+        const int row = cell / size;
+        const int col = cell % size;
+        if (!black.makeMove(row, col, side) || !white.makeMove(row, col, side)) {
+            break;
+        }
+        record.moves.push_back(cell);
+        if (black.checkWin(row, col, side)) {
+            record.openingPlies = static_cast<int>(record.moves.size());
+            record.result = side == Config::PieceType::Black ? 1 : -1;
+            return record;
+        }
+        side = Config::opponent(side);
+    }
+    record.openingPlies = static_cast<int>(record.moves.size());
+
+    while (!black.isFull()) {
+        const int mover = side == Config::PieceType::Black ? 0 : 1;
+        int row = -1, col = -1;
+        if (!chooseMove(*sessions[mover], *configs[mover], side, row, col)) {
+            break;  // 已无合法着法（如连珠黑方只剩禁手点）：和棋
+        }
+        if (black.getPiece(row, col) != Config::PieceType::None || black.isForbidden(row, col, side)) {
+            record.result = side == Config::PieceType::Black ? -1 : 1;
+            return record;
+        }
+        black.makeMove(row, col, side);
+        white.makeMove(row, col, side);
+        record.moves.push_back(row * size + col);
+        if (black.checkWin(row, col, side)) {
+            record.result = side == Config::PieceType::Black ? 1 : -1;
+            return record;
+        }
+        side = Config::opponent(side);
+    }
+    record.result = 0;
+    return record;
+}
+
+std::string formatRecord(const TournamentGame& game, int boardSize) {
+    std::string text;
+    for (int cell : game.record.moves) {
+        text += static_cast<char>('a' + cell % boardSize);
+        text += std::to_string(cell / boardSize + 1);
+    }
+    text += game.record.result > 0 ? " 1-0" : game.record.result < 0 ? " 0-1" : " 1/2";
+    text += game.engineABlack ? " A " : " B ";
+    text += std::to_string(game.opening);
+    return text;
+}
+
+bool parseOpening(const std::string& line, int boardSize, std::vector<int>& cells) {
+    cells.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        const char c = line[i];
+        if (c == ' ' || c == '\t' || c == '\r') {
+            ++i;
+            continue;
+        }
+        if (c < 'a' || c >= 'a' + boardSize) {
+            return false;
+        }
+        ++i;
+        int row = 0;
+        const size_t digits = i;
+        while (i < line.size() && line[i] >= '0' && line[i] <= '9') {
+            row = row * 10 + (line[i++] - '0');
+        }
+        if (i == digits || row < 1 || row > boardSize) {
+            return false;
+        }
+        cells.push_back((row - 1) * boardSize + (c - 'a'));
+    }
+    return !cells.empty();
+}
+
+MatchScore runTournament(const TournamentOptions& options,
+                         const std::function<void(const TournamentGame&, const MatchScore&)>& onGame) {
+    const std::vector<std::vector<int>> openings =
+        options.openings.empty() ? standardOpenings(options.boardSize) : options.openings;
+    MatchScore score;
+    if (openings.empty() || options.games <= 0 || !GameSession::isSupportedSize(options.boardSize)) {
+        return score;
+    }
+    const int total = (options.games + 1) / 2 * 2;
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, std::min(threads, total));
+
+    std::atomic<int> next{0};
+    std::atomic<bool> stop{false};
+    std::mutex mutex;
+
+    auto worker = [&]() {
+        std::unique_ptr<GameSession> sessionA = GameSession::create(options.boardSize, options.rule, options.ttSizeMB);
+        std::unique_ptr<GameSession> sessionB = GameSession::create(options.boardSize, options.rule, options.ttSizeMB);
+        while (!stop.load()) {
+            const int index = next.fetch_add(1);
+            if (index >= total) {
+                break;
+            }
+            const int pair = index / 2;
+            TournamentGame game;
+            game.index = index;
+            game.opening = pair % static_cast<int>(openings.size());
+            game.engineABlack = index % 2 == 0;
+            const std::vector<int> opening = extendOpening(*sessionA, openings[game.opening], options.randomPlies,
+                                                           options.seed + static_cast<uint32_t>(pair) * 0x9E3779B9u);
+            game.record = game.engineABlack
+                ? playGame(*sessionA, options.engineA, *sessionB, options.engineB, opening)
+                : playGame(*sessionB, options.engineB, *sessionA, options.engineA, opening);
+
+            const int resultA = game.engineABlack ? game.record.result : -game.record.result;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (resultA > 0) {
+                ++score.wins;
+            } else if (resultA < 0) {
+                ++score.losses;
+            } else {
+                ++score.draws;
+            }
+            if (onGame) {
+                onGame(game, score);
+            }
+            if (options.useSprt && sprtVerdict(score, options.sprt) != SprtVerdict::Continue) {
+                stop = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    return score;
+}
@@ -0,0 +1,183 @@
+﻿#pragma once
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../game/GameSession.h"
+
+/**
+ * @brief 自对弈中一方引擎的配置
+ * 配置串格式 "类型[:键=值,...]"：类型 ab（困难AI，Alpha-Beta）或 mcts（大师AI，MCTS）；
+ * 键 nodes（节点预算）、depth（最大深度）、playouts（模拟次数预算）、time（每步毫秒，0表示不限时）。
+ * 默认按节点/模拟次数限制而不限时：结果与机器负载无关，同一局面可复现。
+ */
+struct EngineConfig {
+    enum class Kind { AlphaBeta, Mcts };
+
+    Kind kind = Kind::AlphaBeta;
+    int timeMs = 0;                 // 每步时间预算（毫秒），<=0 表示不限时
+    int maxDepth = 64;              // Alpha-Beta 最大迭代深度
+    uint64_t maxNodes = 20000;      // Alpha-Beta 节点预算
+    uint64_t maxPlayouts = 5000;    // MCTS 模拟次数预算
+
+    /**
+     * @brief 解析配置串
+     * @return bool 格式是否合法（非法时out不变）
+     */
+    static bool parse(const std::string& spec, EngineConfig& out);
+
+    /**
+     * @brief 规范化的配置串（写入棋谱文件头与报告）
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief 对局比分（以引擎A为视角）
+ */
+struct MatchScore {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    /**
+     * @brief 平均得分率（胜1、和0.5、负0），无对局时为0.5
+     */
+    double score() const;
+};
+
+/**
+ * @brief Elo 差估计（A 相对 B）与 95% 置信区间
+ */
+struct EloEstimate {
+    double elo = 0.0;
+    double lower = 0.0;
+    double upper = 0.0;
+};
+
+/**
+ * @brief SPRT 参数：H0 为 Elo 差 = elo0，H1 为 Elo 差 = elo1，alpha/beta 为两类错误率
+ */
+struct SprtParams {
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+enum class SprtVerdict { Continue, AcceptH0, AcceptH1 };
+
+/**
+ * @brief 得分率换算为 Elo 差（logistic 模型），得分率为0/1时返回 ∓∞
+ */
+double eloFromScore(double score);
+
+/**
+ * @brief 由胜/和/负估计 Elo 差及 95% 置信区间（按单局得分方差的正态近似）
+ */
+EloEstimate estimateElo(const MatchScore& score);
+
+/**
+ * @brief SPRT 对数似然比（三项分布的广义SPRT近似，与常见引擎测试框架一致）
+ * LLR ≈ n·(s1−s0)·(2m−s0−s1) / (2σ²)，m 为平均得分、σ² 为单局得分方差、s0/s1 为 elo0/elo1 对应的期望得分；
+ * 胜、负各加半局伪计数再计算 m 与 σ²：全胜、全和时方差不为0，开头几局一边倒也不会立即判定。
+ */
+double sprtLlr(const MatchScore& score, const SprtParams& params);
+
+/**
+ * @brief SPRT 判定：LLR 越过 ln((1−β)/α) 接受 H1，低于 ln(β/(1−α)) 接受 H0，否则继续
+ */
+SprtVerdict sprtVerdict(const MatchScore& score, const SprtParams& params);
+
+/**
+ * @brief 固定开局集：26 种标准三手开局（13 种直指、13 种斜指）
+ * 黑1在天元，白2紧贴（直指）或斜贴（斜指），黑3取天元周围 5×5 内的其余空点，
+ * 按保持前两手不变的对称（直指：关于黑1白2所在直线镜像；斜指：关于该对角线镜像）去重后恰为各13种。
+ * @return 着法序列（格子下标 row*boardSize+col，黑先交替）
+ */
+std::vector<std::vector<int>> standardOpenings(int boardSize);
+
+/**
+ * @brief 在开局后追加随机着法（开局多样化，同一seed结果相同）
+ * 追加的着法落在天元周围 ±RANDOM_OPENING_RADIUS 内的空点，不走禁手点，也不走成五点。
+ */
+std::vector<int> extendOpening(GameSession& session, const std::vector<int>& opening, int plies, uint32_t seed);
+
+/**
+ * @brief 单局结果
+ */
+struct GameRecord {
+    std::vector<int> moves;         // 全部着法（含开局，格子下标，黑先交替）
+    int openingPlies = 0;           // 其中开局着法数
+    int result = 0;                 // 1=黑胜，-1=白胜，0=和棋
+};
+
+/**
+ * @brief 下一局
+ * 实现逻辑：两个会话各自维护同一盘面（各自的置换表互不干扰），摆好开局后轮流由执子方的引擎搜索，
+ * 成五即胜；满盘（isFull）或执子方已无合法着法判和；引擎给出被占或禁手的点判负。
+ * @param black 执黑引擎的会话（同尺寸同规则）
+ * @param white 执白引擎的会话
+ * @return GameRecord 对局记录
+ */
+GameRecord playGame(GameSession& black, const EngineConfig& blackConfig,
+                    GameSession& white, const EngineConfig& whiteConfig, const std::vector<int>& opening);
+
+/**
+ * @brief 自对弈锦标赛中的一局（含编号、开局与执色信息）
+ */
+struct TournamentGame {
+    int index = 0;                  // 对局编号（从0开始，相邻两局为同一开局、交换执色）
+    int opening = 0;                // 开局编号（开局集中的下标）
+    bool engineABlack = true;       // 引擎A是否执黑
+    GameRecord record;
+};
+
+/**
+ * @brief 紧凑棋谱行："<着法坐标串> <结果> <黑方引擎A|B> <开局编号>"，如 "h8i8h10j9k10 1-0 A 3"
+ * 着法为“列字母+行号”坐标串（与 BookBuilder 的棋谱格式一致，可直接导入建库），结果 1-0/0-1/1/2。
+ */
+std::string formatRecord(const TournamentGame& game, int boardSize);
+
+/**
+ * @brief 解析开局行（“列字母+行号”坐标串，如 "h8i9h10"），非法坐标返回false
+ */
+bool parseOpening(const std::string& line, int boardSize, std::vector<int>& cells);
+
+/**
+ * @brief 锦标赛参数
+ */
+struct TournamentOptions {
+    int boardSize = Config::BOARD_SIZE;
+    Rule rule = Rule::Freestyle;
+    EngineConfig engineA;
+    EngineConfig engineB;
+    int games = 1000;               // 总局数（按开局成对，奇数时向上取偶）
+    int threads = 0;                // 并行对局数，<=0 表示使用全部硬件线程
+    int randomPlies = 2;            // 每个开局后追加的随机着法数（每轮不同，同一对局对内相同）
+    uint32_t seed = 20260301;
+    size_t ttSizeMB = 4;            // 每个会话的置换表大小（MB）：每个工作线程持有两个会话，节点预算小的自对弈无需界面对局的大表
+    std::vector<std::vector<int>> openings; // 为空时使用 standardOpenings()
+    bool useSprt = false;           // 启用SPRT：判定结束后不再开始新对局
+    SprtParams sprt;
+};
+
+/**
+ * @brief 并行运行自对弈锦标赛
+ * 实现逻辑：
+ * Step1：第 i 局使用第 i/2 对开局（开局集循环使用，第 r 轮追加的随机着法以 seed 与对号为种子），
+ *        偶数局引擎A执黑、奇数局交换执色；
+ * Step2：每个工作线程持有一对会话（引擎A、引擎B，单线程搜索，置换表按 ttSizeMB 分配），以原子计数器领取对局编号；
+ * Step3：每局结束后在锁内累计比分并回调 onGame（回调按完成顺序串行执行，可直接写文件）；
+ *        启用SPRT时判定一旦得出即停止领取新对局（进行中的对局下完并计入）。
+ * @param onGame 每局结束的回调（参数为该局与累计比分），可为空
+ * @return MatchScore 最终比分（引擎A视角）
+ */
+MatchScore runTournament(const TournamentOptions& options,
+                         const std::function<void(const TournamentGame&, const MatchScore&)>& onGame);
+
+#endif // TOURNAMENT_H
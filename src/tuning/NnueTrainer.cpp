@@ -0,0 +1,372 @@
+﻿#include "NnueTrainer.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace {
+
+using namespace Nnue;
+
+/**
+ * @brief 每个线程至少分到的样本数（每个样本的前向+反向约数万次乘加，样本太少时少开线程）
+ */
+constexpr size_t MIN_SAMPLES_PER_THREAD = 512;
+
+/**
+ * @brief 量化后可表示的权重范围：特征权重 ×ACTIVATION_MAX 存为 int16（上限取1，
+ * 即使一方占满棋盘累加器也不会溢出）；隐藏层与输出层权重 ×2^WEIGHT_SHIFT 存为 int8
+ */
+constexpr float FEATURE_WEIGHT_LIMIT = 1.0f;
+constexpr float WEIGHT_LIMIT = 127.0f / (1 << WEIGHT_SHIFT);
+
+/**
+ * @brief Adam 的一阶/二阶矩衰减率与数值稳定项
+ */
+constexpr double ADAM_BETA1 = 0.9;
+constexpr double ADAM_BETA2 = 0.999;
+constexpr double ADAM_EPSILON = 1e-8;
+
+double softplus(double x) {
+    return x > 0.0 ? x + std::log1p(std::exp(-x)) : std::log1p(std::exp(x));
+}
+
+float clamp01(float x) {
+    return std::min(std::max(x, 0.0f), 1.0f);
+}
+
+/**
+ * @brief 一次前向计算的中间结果（反向计算复用）
+ */
+struct Activations {
+    float accumulator[2][ACCUMULATOR_SIZE];     // [0=行棋方视角, 1=对方视角]，未激活
+    float input[HIDDEN_INPUTS];
+    float hiddenSum[HIDDEN_SIZE];               // 隐藏层未激活值
+    float hidden[HIDDEN_SIZE];
+    double output;
+};
+
+/**
+ * @brief 行棋方视角的特征在对方视角下的下标（己方/对方两个平面互换）
+ */
+int mirrorFeature(int feature, int cells) {
+    return feature < cells ? feature + cells : feature - cells;
+}
+
+} // namespace
+
+NnueSample makeNnueSample(const GameSession& session, Config::PieceType side) {
+    const int boardSize = session.boardSize();
+    const int cells = boardSize * boardSize;
+    NnueSample sample;
+    for (int cell = 0; cell < cells; ++cell) {
+        const Config::PieceType piece = session.getPiece(cell / boardSize, cell % boardSize);
+        if (piece != Config::PieceType::None) {
+            sample.features.push_back(static_cast<uint16_t>(piece == side ? cell : cells + cell));
+        }
+    }
+    return sample;
+}
+
+int extractNnueSamples(GameSession& session, const TuningGame& game, int skipPlies, std::vector<NnueSample>& out) {
+    const size_t first = out.size();
+    std::vector<Config::PieceType> sides;
+    int result = 0;
+    const bool legal = replayGame(session, game, skipPlies, [&](Config::PieceType side) {
+        out.push_back(makeNnueSample(session, side));
+        sides.push_back(side);
+    }, result);
+    if (!legal) {
+        out.resize(first);
+        return -1;
+    }
+    const float black = result > 0 ? 1.0f : (result < 0 ? 0.0f : 0.5f);
+    for (size_t i = first; i < out.size(); ++i) {
+        out[i].result = sides[i - first] == Config::PieceType::Black ? black : 1.0f - black;
+    }
+    return static_cast<int>(out.size() - first);
+}
+
+NnueFloatNetwork::NnueFloatNetwork(int boardSize, uint32_t seed)
+    : m_boardSize(boardSize)
+{
+    const size_t features = static_cast<size_t>(INPUT_PLANES) * boardSize * boardSize * ACCUMULATOR_SIZE;
+    m_params.assign(features + ACCUMULATOR_SIZE + HIDDEN_SIZE * HIDDEN_INPUTS + HIDDEN_SIZE + HIDDEN_SIZE + 1, 0.0f);
+
+    std::mt19937 rng(seed);
+    auto fill = [&](size_t begin, size_t end, float low, float high) {
+        std::uniform_real_distribution<float> dist(low, high);
+        for (size_t i = begin; i < end; ++i) {
+            m_params[i] = dist(rng);
+        }
+    };
+    fill(0, features, -0.05f, 0.05f);
+    fill(featureBiasOffset(), hiddenWeightOffset(), 0.3f, 0.3f);
+    fill(hiddenWeightOffset(), hiddenBiasOffset(), -0.13f, 0.13f);
+    fill(hiddenBiasOffset(), outputWeightOffset(), 0.3f, 0.3f);
+    fill(outputWeightOffset(), outputBiasOffset(), -0.3f, 0.3f);
+}
+
+size_t NnueFloatNetwork::featureBiasOffset() const {
+    return static_cast<size_t>(INPUT_PLANES) * m_boardSize * m_boardSize * ACCUMULATOR_SIZE;
+}
+size_t NnueFloatNetwork::hiddenWeightOffset() const { return featureBiasOffset() + ACCUMULATOR_SIZE; }
+size_t NnueFloatNetwork::hiddenBiasOffset() const { return hiddenWeightOffset() + HIDDEN_SIZE * HIDDEN_INPUTS; }
+size_t NnueFloatNetwork::outputWeightOffset() const { return hiddenBiasOffset() + HIDDEN_SIZE; }
+size_t NnueFloatNetwork::outputBiasOffset() const { return outputWeightOffset() + HIDDEN_SIZE; }
+
+namespace {
+
+/**
+ * @brief 前向计算（与 NnueNetwork 的整数实现同一结构，只是不取整）
+ */
+void forwardPass(const float* params, size_t featureBias, size_t hiddenWeights, size_t hiddenBias,
+                 size_t outputWeights, size_t outputBias, int cells, const NnueSample& sample, Activations& a) {
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        std::copy(params + featureBias, params + featureBias + ACCUMULATOR_SIZE, a.accumulator[perspective]);
+    }
+    for (const uint16_t feature : sample.features) {
+        const float* own = params + static_cast<size_t>(feature) * ACCUMULATOR_SIZE;
+        const float* other = params + static_cast<size_t>(mirrorFeature(feature, cells)) * ACCUMULATOR_SIZE;
+        for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+            a.accumulator[0][i] += own[i];
+            a.accumulator[1][i] += other[i];
+        }
+    }
+    for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+        a.input[i] = clamp01(a.accumulator[0][i]);
+        a.input[ACCUMULATOR_SIZE + i] = clamp01(a.accumulator[1][i]);
+    }
+    double output = params[outputBias];
+    for (int j = 0; j < HIDDEN_SIZE; ++j) {
+        const float* weights = params + hiddenWeights + j * HIDDEN_INPUTS;
+        float sum = params[hiddenBias + j];
+        for (int k = 0; k < HIDDEN_INPUTS; ++k) {
+            sum += a.input[k] * weights[k];
+        }
+        a.hiddenSum[j] = sum;
+        a.hidden[j] = clamp01(sum);
+        output += static_cast<double>(a.hidden[j]) * params[outputWeights + j];
+    }
+    a.output = output;
+}
+
+} // namespace
+
+double NnueFloatNetwork::forward(const NnueSample& sample) const {
+    Activations a;
+    forwardPass(m_params.data(), featureBiasOffset(), hiddenWeightOffset(), hiddenBiasOffset(), outputWeightOffset(),
+                outputBiasOffset(), m_boardSize * m_boardSize, sample, a);
+    return a.output;
+}
+
+/**
+ * @brief 反向计算实现
+ * 实现逻辑：损失 L = r·softplus(−y) + (1−r)·softplus(y)，∂L/∂y = σ(y) − r；
+ * 逐层回传，截断ReLU只在 (0, 1) 区间内传递梯度；特征权重只有样本中出现的特征行（两个视角各一行）有梯度。
+ */
+double NnueFloatNetwork::backward(const NnueSample& sample, float* gradient) const {
+    const int cells = m_boardSize * m_boardSize;
+    const float* params = m_params.data();
+    Activations a;
+    forwardPass(params, featureBiasOffset(), hiddenWeightOffset(), hiddenBiasOffset(), outputWeightOffset(),
+                outputBiasOffset(), cells, sample, a);
+    const double r = sample.result;
+    const double loss = r * softplus(-a.output) + (1.0 - r) * softplus(a.output);
+    const float dOutput = static_cast<float>(1.0 / (1.0 + std::exp(-a.output)) - r);
+
+    gradient[outputBiasOffset()] += dOutput;
+    float dInput[HIDDEN_INPUTS] = {};
+    for (int j = 0; j < HIDDEN_SIZE; ++j) {
+        gradient[outputWeightOffset() + j] += dOutput * a.hidden[j];
+        if (a.hiddenSum[j] <= 0.0f || a.hiddenSum[j] >= 1.0f) {
+            continue;
+        }
+        const float dSum = dOutput * params[outputWeightOffset() + j];
+        const float* weights = params + hiddenWeightOffset() + j * HIDDEN_INPUTS;
+        float* dWeights = gradient + hiddenWeightOffset() + j * HIDDEN_INPUTS;
+        gradient[hiddenBiasOffset() + j] += dSum;
+        for (int k = 0; k < HIDDEN_INPUTS; ++k) {
+            dWeights[k] += dSum * a.input[k];
+            dInput[k] += dSum * weights[k];
+        }
+    }
+
+    float dAccumulator[2][ACCUMULATOR_SIZE];
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+            const float value = a.accumulator[perspective][i];
+            dAccumulator[perspective][i] = value > 0.0f && value < 1.0f ? dInput[perspective * ACCUMULATOR_SIZE + i] : 0.0f;
+            gradient[featureBiasOffset() + i] += dAccumulator[perspective][i];
+        }
+    }
+    for (const uint16_t feature : sample.features) {
+        float* own = gradient + static_cast<size_t>(feature) * ACCUMULATOR_SIZE;
+        float* other = gradient + static_cast<size_t>(mirrorFeature(feature, cells)) * ACCUMULATOR_SIZE;
+        for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+            own[i] += dAccumulator[0][i];
+            other[i] += dAccumulator[1][i];
+        }
+    }
+    return loss;
+}
+
+void NnueFloatNetwork::clampWeights() {
+    auto clampRange = [this](size_t begin, size_t end, float limit) {
+        for (size_t i = begin; i < end; ++i) {
+            m_params[i] = std::min(std::max(m_params[i], -limit), limit);
+        }
+    };
+    clampRange(0, hiddenWeightOffset(), FEATURE_WEIGHT_LIMIT);
+    clampRange(hiddenWeightOffset(), hiddenBiasOffset(), WEIGHT_LIMIT);
+    clampRange(outputWeightOffset(), outputBiasOffset(), WEIGHT_LIMIT);
+}
+
+/**
+ * @brief 量化实现：激活值 1.0 对应 ACTIVATION_MAX，隐藏层与输出层权重 1.0 对应 2^WEIGHT_SHIFT，
+ * 偏置按其所在累加值的单位取整（隐藏层偏置与输出偏置的单位均为 ACTIVATION_MAX × 2^WEIGHT_SHIFT）；
+ * 隐藏层偏置另加半个单位，使推理时的算术右移（向下取整）变为四舍五入，避免每个隐藏单元都系统性偏小
+ */
+NnueWeights NnueFloatNetwork::quantize(int32_t outputScale) const {
+    NnueWeights weights(m_boardSize);
+    const double weightUnit = 1 << WEIGHT_SHIFT;
+    const double sumUnit = ACTIVATION_MAX * weightUnit;
+    auto round = [](double value, double low, double high) {
+        return std::min(std::max(std::round(value), low), high);
+    };
+    const float* params = m_params.data();
+    for (size_t i = 0; i < weights.featureWeights.size(); ++i) {
+        weights.featureWeights[i] = static_cast<int16_t>(round(params[i] * ACTIVATION_MAX, INT16_MIN, INT16_MAX));
+    }
+    for (int i = 0; i < ACCUMULATOR_SIZE; ++i) {
+        weights.featureBias[i] = static_cast<int16_t>(round(params[featureBiasOffset() + i] * ACTIVATION_MAX, INT16_MIN, INT16_MAX));
+    }
+    for (size_t i = 0; i < weights.hiddenWeights.size(); ++i) {
+        weights.hiddenWeights[i] = static_cast<int8_t>(round(params[hiddenWeightOffset() + i] * weightUnit, INT8_MIN, INT8_MAX));
+    }
+    for (int j = 0; j < HIDDEN_SIZE; ++j) {
+        weights.hiddenBias[j] = static_cast<int32_t>(round(params[hiddenBiasOffset() + j] * sumUnit + (1 << (WEIGHT_SHIFT - 1)),
+                                                           INT32_MIN, INT32_MAX));
+        weights.outputWeights[j] = static_cast<int8_t>(round(params[outputWeightOffset() + j] * weightUnit, INT8_MIN, INT8_MAX));
+    }
+    weights.outputBias = static_cast<int32_t>(round(params[outputBiasOffset()] * sumUnit, INT32_MIN, INT32_MAX));
+    weights.outputScale = outputScale;
+    return weights;
+}
+
+namespace {
+
+/**
+ * @brief 一组样本（按下标给出）的平均损失与平均梯度
+ * 实现逻辑：按线程数切成连续的块，每个线程累加到自己的梯度数组，最后按块顺序求和（结果与线程调度无关）。
+ */
+double batchLoss(const NnueFloatNetwork& network, const std::vector<NnueSample>& samples, const uint32_t* indices,
+                 size_t count, int threads, float* gradient) {
+    const size_t parameters = network.parameterCount();
+    if (gradient) {
+        std::fill(gradient, gradient + parameters, 0.0f);
+    }
+    if (count == 0) {
+        return 0.0;
+    }
+    size_t chunks = threads > 0 ? static_cast<size_t>(threads) : std::max(1u, std::thread::hardware_concurrency());
+    chunks = std::max<size_t>(1, std::min(chunks, count / MIN_SAMPLES_PER_THREAD));
+
+    std::vector<double> losses(chunks, 0.0);
+    std::vector<std::vector<float>> gradients(gradient ? chunks : 0);
+    auto run = [&](size_t chunk) {
+        float* chunkGradient = nullptr;
+        if (gradient) {
+            gradients[chunk].assign(parameters, 0.0f);
+            chunkGradient = gradients[chunk].data();
+        }
+        double loss = 0.0;
+        for (size_t i = count * chunk / chunks; i < count * (chunk + 1) / chunks; ++i) {
+            const NnueSample& sample = samples[indices[i]];
+            if (chunkGradient) {
+                loss += network.backward(sample, chunkGradient);
+            } else {
+                const double y = network.forward(sample);
+                loss += sample.result * softplus(-y) + (1.0 - sample.result) * softplus(y);
+            }
+        }
+        losses[chunk] = loss;
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        workers.emplace_back(run, chunk);
+    }
+    run(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    const double scale = 1.0 / static_cast<double>(count);
+    double loss = 0.0;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        loss += losses[chunk];
+        if (gradient) {
+            for (size_t i = 0; i < parameters; ++i) {
+                gradient[i] += gradients[chunk][i];
+            }
+        }
+    }
+    if (gradient) {
+        for (size_t i = 0; i < parameters; ++i) {
+            gradient[i] = static_cast<float>(gradient[i] * scale);
+        }
+    }
+    return loss * scale;
+}
+
+} // namespace
+
+double nnueLoss(const NnueFloatNetwork& network, const std::vector<NnueSample>& samples, int threads,
+                std::vector<float>* gradient) {
+    std::vector<uint32_t> indices(samples.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    if (gradient) {
+        gradient->resize(network.parameterCount());
+    }
+    return batchLoss(network, samples, indices.data(), indices.size(), threads, gradient ? gradient->data() : nullptr);
+}
+
+NnueFloatNetwork trainNnue(const std::vector<NnueSample>& samples, int boardSize, const NnueTrainerOptions& options,
+                           const std::function<void(int, double)>& onEpoch) {
+    NnueFloatNetwork network(boardSize, options.seed);
+    const size_t parameters = network.parameterCount();
+    std::vector<float> gradient(parameters);
+    std::vector<float> moment1(parameters, 0.0f);
+    std::vector<float> moment2(parameters, 0.0f);
+    std::vector<uint32_t> indices(samples.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    std::mt19937 rng(options.seed);
+    const size_t batchSize = static_cast<size_t>(std::max(1, options.batchSize));
+
+    int step = 0;
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        std::shuffle(indices.begin(), indices.end(), rng);
+        double epochLoss = 0.0;
+        for (size_t begin = 0; begin < indices.size(); begin += batchSize) {
+            const size_t count = std::min(batchSize, indices.size() - begin);
+            epochLoss += batchLoss(network, samples, indices.data() + begin, count, options.threads, gradient.data()) * count;
+            ++step;
+            const double correction1 = 1.0 - std::pow(ADAM_BETA1, step);
+            const double correction2 = 1.0 - std::pow(ADAM_BETA2, step);
+            float* params = network.parameters();
+            for (size_t i = 0; i < parameters; ++i) {
+                moment1[i] = static_cast<float>(ADAM_BETA1 * moment1[i] + (1.0 - ADAM_BETA1) * gradient[i]);
+                moment2[i] = static_cast<float>(ADAM_BETA2 * moment2[i] + (1.0 - ADAM_BETA2) * gradient[i] * gradient[i]);
+                params[i] -= static_cast<float>(options.learningRate * (moment1[i] / correction1)
+                                                / (std::sqrt(moment2[i] / correction2) + ADAM_EPSILON));
+            }
+            network.clampWeights();
+        }
+        if (onEpoch) {
+            onEpoch(epoch, samples.empty() ? 0.0 : epochLoss / static_cast<double>(samples.size()));
+        }
+    }
+    return network;
+}
@@ -0,0 +1,114 @@
+﻿#pragma once
+#ifndef NNUETRAINER_H
+#define NNUETRAINER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "TexelTuner.h"
+#include "../ai/Nnue.h"
+
+/**
+ * @brief 神经网络训练样本：一个平静局面（行棋方视角）与对局结果
+ * 只保存行棋方视角的特征下标（plane*N*N+cell，plane 0=己方棋子、1=对方棋子），
+ * 对方视角的特征即把两个平面互换，训练时按需推出，不再另存。
+ */
+struct NnueSample {
+    std::vector<uint16_t> features;     // 行棋方视角下的全部棋子特征
+    float result = 0.5f;                // 行棋方得分：1胜、0.5和、0负
+};
+
+/**
+ * @brief 由会话的当前局面构造样本（side 为行棋方，结果留给调用方填写）
+ */
+NnueSample makeNnueSample(const GameSession& session, Config::PieceType side);
+
+/**
+ * @brief 重放一局并提取神经网络训练样本（样本选取与 extractPositions() 相同，见 replayGame()）
+ * @param session 同尺寸同规则的会话（会被reset）
+ * @return int 追加到out的样本数，整局作废时为-1
+ */
+int extractNnueSamples(GameSession& session, const TuningGame& game, int skipPlies, std::vector<NnueSample>& out);
+
+/**
+ * @brief 浮点网络（训练用，结构与 NnueNetwork 相同）
+ * 全部参数连续存放在一个数组中（特征权重、特征偏置、隐藏层权重、隐藏层偏置、输出层权重、输出偏置），
+ * 梯度与 Adam 矩估计使用同样布局的数组，逐元素更新。
+ * 激活为截断到 [0, 1] 的 ReLU，与量化后的 [0, ACTIVATION_MAX] 一一对应；输出为行棋方胜率的 logit。
+ */
+class NnueFloatNetwork {
+public:
+    /**
+     * @brief 按棋盘大小分配参数并以固定种子随机初始化（累加器初值落在激活区间中部）
+     */
+    explicit NnueFloatNetwork(int boardSize = Config::BOARD_SIZE, uint32_t seed = 1);
+
+    int boardSize() const { return m_boardSize; }
+    size_t parameterCount() const { return m_params.size(); }
+    float* parameters() { return m_params.data(); }
+    const float* parameters() const { return m_params.data(); }
+
+    /**
+     * @brief 前向计算：样本的输出（行棋方胜率的 logit）
+     */
+    double forward(const NnueSample& sample) const;
+
+    /**
+     * @brief 前向与反向计算：返回样本的对数损失，并把各参数的偏导数累加到 gradient（与 parameters() 同布局）
+     */
+    double backward(const NnueSample& sample, float* gradient) const;
+
+    /**
+     * @brief 把权重截断到量化后可表示的范围（每次更新后调用，保证量化时不溢出）
+     */
+    void clampWeights();
+
+    /**
+     * @brief 量化为权重文件格式（取整规则见 Nnue 命名空间的说明）
+     * @param outputScale 估值缩放：估值 = logit × outputScale（通常取 1/K，K 为棋型估值拟合的缩放系数）
+     */
+    NnueWeights quantize(int32_t outputScale) const;
+
+private:
+    size_t featureBiasOffset() const;
+    size_t hiddenWeightOffset() const;
+    size_t hiddenBiasOffset() const;
+    size_t outputWeightOffset() const;
+    size_t outputBiasOffset() const;
+
+    int m_boardSize;
+    std::vector<float> m_params;
+};
+
+/**
+ * @brief 平均对数损失及其梯度（多线程，按块顺序求和，同样的线程数结果可复现）
+ * @param threads 线程数，<=0 表示使用全部硬件线程
+ * @param gradient 可选输出：与 parameters() 同布局的平均梯度（会被调整为 parameterCount() 个元素）；可为nullptr
+ * @return double 平均损失（无样本时为0）
+ */
+double nnueLoss(const NnueFloatNetwork& network, const std::vector<NnueSample>& samples, int threads,
+                std::vector<float>* gradient = nullptr);
+
+/**
+ * @brief 训练参数
+ */
+struct NnueTrainerOptions {
+    int threads = 0;                // 梯度计算线程数，<=0 表示使用全部硬件线程
+    int epochs = 20;                // 遍历全部样本的轮数
+    int batchSize = 4096;           // 每次更新使用的样本数
+    double learningRate = 1e-3;     // Adam 步长
+    uint32_t seed = 1;              // 初始化与样本打乱的随机种子
+};
+
+/**
+ * @brief 训练浮点网络
+ * 实现逻辑：
+ * Step1：以 seed 初始化网络；
+ * Step2：每轮打乱样本顺序，按 batchSize 切成小批，多线程计算小批的平均梯度，Adam 更新全部参数后截断到可量化范围；
+ * Step3：每轮结束回调（轮次从1开始、本轮各小批的平均损失）。
+ * @param onEpoch 每轮结束的回调，可为空
+ */
+NnueFloatNetwork trainNnue(const std::vector<NnueSample>& samples, int boardSize, const NnueTrainerOptions& options,
+                           const std::function<void(int, double)>& onEpoch);
+
+#endif // NNUETRAINER_H
@@ -0,0 +1,289 @@
+﻿#include "TexelTuner.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "../tournament/Tournament.h"
+
+namespace {
+
+/**
+ * @brief 每个线程至少分到的样本数（样本太少时少开线程，避免创建线程的开销超过计算本身）
+ */
+constexpr size_t MIN_POSITIONS_PER_THREAD = 4096;
+
+/**
+ * @brief fitScale() 的搜索区间（K 的对数）与黄金分割迭代次数
+ */
+constexpr double LOG_SCALE_MIN = -14.0;     // K ≈ 8e-7
+constexpr double LOG_SCALE_MAX = 0.0;       // K = 1
+constexpr int SCALE_ITERATIONS = 60;
+
+/**
+ * @brief Adam 的一阶/二阶矩衰减率与数值稳定项
+ */
+constexpr double ADAM_BETA1 = 0.9;
+constexpr double ADAM_BETA2 = 0.999;
+constexpr double ADAM_EPSILON = 1e-8;
+
+/**
+ * @brief ln(1 + e^x)，x 很大或很小时都不溢出
+ */
+double softplus(double x) {
+    return x > 0.0 ? x + std::log1p(std::exp(-x)) : std::log1p(std::exp(x));
+}
+
+/**
+ * @brief 当前局面是否平静（双方都没有成五点）
+ */
+bool isQuiet(const GameSession& session) {
+    return session.threatCount(Config::PieceType::Black, PatternType::Five) == 0
+        && session.threatCount(Config::PieceType::White, PatternType::Five) == 0;
+}
+
+TuningPosition makePosition(const GameSession& session) {
+    TuningPosition position;
+    for (int type = 1; type < PATTERN_TYPE_COUNT; ++type) {
+        const PatternType pattern = static_cast<PatternType>(type);
+        position.features[type] = static_cast<int16_t>(session.threatCount(Config::PieceType::Black, pattern)
+                                                       - session.threatCount(Config::PieceType::White, pattern));
+    }
+    return position;
+}
+
+/**
+ * @brief 一块样本 [begin, end) 的损失之和与梯度之和（未除以样本数）
+ */
+double chunkLoss(const TuningPosition* begin, const TuningPosition* end, const double* weights, double scale,
+                 double* gradient) {
+    double loss = 0.0;
+    for (const TuningPosition* position = begin; position != end; ++position) {
+        const double z = scale * positionEval(*position, weights);
+        const double r = position->result;
+        loss += r * softplus(-z) + (1.0 - r) * softplus(z);
+        if (gradient) {
+            const double delta = (1.0 / (1.0 + std::exp(-z)) - r) * scale;
+            for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+                gradient[type] += delta * position->features[type];
+            }
+        }
+    }
+    return loss;
+}
+
+/**
+ * @brief 投影回约束：None为0，其余在 [0, PATTERN_SCORE_LIMIT] 内且按棋型等级单调不减
+ */
+template <typename T>
+void project(T* weights) {
+    weights[0] = 0;
+    for (int type = 1; type < PATTERN_TYPE_COUNT; ++type) {
+        weights[type] = std::min(std::max(weights[type], weights[type - 1]), static_cast<T>(PATTERN_SCORE_LIMIT));
+    }
+}
+
+} // namespace
+
+bool parseGameRecord(const std::string& line, int boardSize, TuningGame& game) {
+    game = TuningGame();
+    std::string moves;
+    size_t i = 0;
+    while (i < line.size()) {
+        const size_t begin = line.find_first_not_of(" \t\r", i);
+        if (begin == std::string::npos) {
+            break;
+        }
+        const size_t end = std::min(line.find_first_of(" \t\r", begin), line.size());
+        const std::string token = line.substr(begin, end - begin);
+        i = end;
+        if (token == "1-0" || token == "0-1" || token == "1/2") {
+            game.result = token == "1-0" ? 1 : (token == "0-1" ? -1 : 0);
+            game.hasResult = true;
+            break;
+        }
+        moves += token;
+    }
+    return parseOpening(moves, boardSize, game.moves);
+}
+
+bool replayGame(GameSession& session, const TuningGame& game, int skipPlies,
+                const std::function<void(Config::PieceType)>& onPosition, int& result) {
+    const int boardSize = session.boardSize();
+    session.reset();
+    Config::PieceType side = Config::PieceType::Black;
+    int winner = 0;
+    for (size_t ply = 0; ply < game.moves.size(); ++ply) {
+        if (static_cast<int>(ply) >= skipPlies && isQuiet(session)) {
+            onPosition(side);
+        }
+        const int row = game.moves[ply] / boardSize;
+        const int col = game.moves[ply] % boardSize;
+        if (session.isForbidden(row, col, side) || !session.makeMove(row, col, side)) {
+            return false;
+        }
+        if (session.checkWin(row, col, side)) {
+            winner = side == Config::PieceType::Black ? 1 : -1;
+            break;
+        }
+        side = Config::opponent(side);
+    }
+    result = game.hasResult ? game.result : winner;
+    return true;
+}
+
+int extractPositions(GameSession& session, const TuningGame& game, int skipPlies, std::vector<TuningPosition>& out) {
+    const size_t first = out.size();
+    int result = 0;
+    if (!replayGame(session, game, skipPlies, [&](Config::PieceType) { out.push_back(makePosition(session)); }, result)) {
+        out.resize(first);
+        return -1;
+    }
+    const float score = result > 0 ? 1.0f : (result < 0 ? 0.0f : 0.5f);
+    for (size_t i = first; i < out.size(); ++i) {
+        out[i].result = score;
+    }
+    return static_cast<int>(out.size() - first);
+}
+
+double positionEval(const TuningPosition& position, const double* weights) {
+    double eval = 0.0;
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        eval += weights[type] * position.features[type];
+    }
+    return eval;
+}
+
+double tuningLoss(const std::vector<TuningPosition>& positions, const double* weights, double scale, int threads,
+                  double* gradient) {
+    if (gradient) {
+        std::fill(gradient, gradient + PATTERN_TYPE_COUNT, 0.0);
+    }
+    if (positions.empty()) {
+        return 0.0;
+    }
+    size_t chunks = threads > 0 ? static_cast<size_t>(threads) : std::max(1u, std::thread::hardware_concurrency());
+    chunks = std::max<size_t>(1, std::min(chunks, positions.size() / MIN_POSITIONS_PER_THREAD));
+
+    std::vector<double> losses(chunks, 0.0);
+    std::vector<double> gradients(gradient ? chunks * PATTERN_TYPE_COUNT : 0, 0.0);
+    auto run = [&](size_t chunk) {
+        const TuningPosition* data = positions.data();
+        const size_t begin = positions.size() * chunk / chunks;
+        const size_t end = positions.size() * (chunk + 1) / chunks;
+        losses[chunk] = chunkLoss(data + begin, data + end, weights, scale,
+                                  gradient ? gradients.data() + chunk * PATTERN_TYPE_COUNT : nullptr);
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        workers.emplace_back(run, chunk);
+    }
+    run(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // 按块顺序求和：结果与线程调度无关
+    const double count = static_cast<double>(positions.size());
+    double loss = 0.0;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        loss += losses[chunk];
+        if (gradient) {
+            for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+                gradient[type] += gradients[chunk * PATTERN_TYPE_COUNT + type];
+            }
+        }
+    }
+    if (gradient) {
+        for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+            gradient[type] /= count;
+        }
+    }
+    return loss / count;
+}
+
+double fitScale(const std::vector<TuningPosition>& positions, const double* weights, int threads) {
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double lo = LOG_SCALE_MIN;
+    double hi = LOG_SCALE_MAX;
+    double x1 = hi - ratio * (hi - lo);
+    double x2 = lo + ratio * (hi - lo);
+    double f1 = tuningLoss(positions, weights, std::exp(x1), threads);
+    double f2 = tuningLoss(positions, weights, std::exp(x2), threads);
+    for (int i = 0; i < SCALE_ITERATIONS; ++i) {
+        if (f1 <= f2) {
+            hi = x2;
+            x2 = x1;
+            f2 = f1;
+            x1 = hi - ratio * (hi - lo);
+            f1 = tuningLoss(positions, weights, std::exp(x1), threads);
+        } else {
+            lo = x1;
+            x1 = x2;
+            f1 = f2;
+            x2 = lo + ratio * (hi - lo);
+            f2 = tuningLoss(positions, weights, std::exp(x2), threads);
+        }
+    }
+    return std::exp((lo + hi) / 2.0);
+}
+
+TunerResult tuneWeights(const std::vector<TuningPosition>& positions, const int* initialWeights, const TunerOptions& options,
+                        const std::function<void(int, double, const double*)>& onEpoch) {
+    TunerResult result;
+    double weights[PATTERN_TYPE_COUNT];
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        weights[type] = initialWeights[type];
+    }
+    project(weights);
+    result.scale = options.scale > 0.0 ? options.scale : fitScale(positions, weights, options.threads);
+    result.initialLoss = tuningLoss(positions, weights, result.scale, options.threads);
+
+    double moment1[PATTERN_TYPE_COUNT] = {};
+    double moment2[PATTERN_TYPE_COUNT] = {};
+    double gradient[PATTERN_TYPE_COUNT];
+    for (int epoch = 1; epoch <= options.epochs; ++epoch) {
+        const double loss = tuningLoss(positions, weights, result.scale, options.threads, gradient);
+        const double correction1 = 1.0 - std::pow(ADAM_BETA1, epoch);
+        const double correction2 = 1.0 - std::pow(ADAM_BETA2, epoch);
+        for (int type = 1; type < PATTERN_TYPE_COUNT; ++type) {
+            moment1[type] = ADAM_BETA1 * moment1[type] + (1.0 - ADAM_BETA1) * gradient[type];
+            moment2[type] = ADAM_BETA2 * moment2[type] + (1.0 - ADAM_BETA2) * gradient[type] * gradient[type];
+            weights[type] -= options.learningRate * (moment1[type] / correction1)
+                           / (std::sqrt(moment2[type] / correction2) + ADAM_EPSILON);
+        }
+        project(weights);
+        if (onEpoch) {
+            onEpoch(epoch, loss, weights);
+        }
+    }
+
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        result.weights[type] = static_cast<int>(std::lround(weights[type]));
+    }
+    project(result.weights);
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        weights[type] = result.weights[type];
+    }
+    result.finalLoss = tuningLoss(positions, weights, result.scale, options.threads);
+    return result;
+}
+
+std::string formatWeightsHeader(const int* weights, const std::string& source) {
+    std::string values;
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        values += (type > 0 ? ", " : "") + std::to_string(weights[type]);
+    }
+    return "\xEF\xBB\xBF#pragma once\n"
+           "#ifndef EVALWEIGHTS_H\n"
+           "#define EVALWEIGHTS_H\n"
+           "\n"
+           "// 由 tools/TexelTuner 生成（重新调参后整个文件被覆盖，请勿手工修改）\n"
+           "// 来源：" + source + "\n"
+           "\n"
+           "/**\n"
+           " * @brief 棋型估值表（按PatternType下标）：空点在某方向上对某方可形成的棋型分值\n"
+           " */\n"
+           "constexpr int PATTERN_SCORE[] = { " + values + " };\n"
+           "\n"
+           "#endif // EVALWEIGHTS_H\n";
+}
@@ -0,0 +1,126 @@
+﻿#pragma once
+#ifndef TEXELTUNER_H
+#define TEXELTUNER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../game/GameSession.h"
+
+/**
+ * @brief 调参样本：一个局面的棋型特征与对局结果
+ * 静态估值对棋型分值是线性的：evaluate(Black) = Σ PATTERN_SCORE[t] ×（黑方棋型t的数量 − 白方棋型t的数量），
+ * 数量即 threatCount() 统计的（空点, 方向）数，因此每个局面只需保存这8个差值，调参时不必再重放棋盘。
+ */
+struct TuningPosition {
+    int16_t features[PATTERN_TYPE_COUNT] = {};  // 按PatternType下标：黑方数量 − 白方数量
+    float result = 0.5f;                        // 黑方得分：1胜、0.5和、0负
+};
+
+/**
+ * @brief 一局棋谱（着法与结果）
+ */
+struct TuningGame {
+    std::vector<int> moves;         // 格子下标 row*boardSize+col，黑先交替
+    int result = 0;                 // 1=黑胜，-1=白胜，0=和棋
+    bool hasResult = false;         // 棋谱行是否注明了结果（未注明时按重放判定）
+};
+
+/**
+ * @brief 解析一行棋谱
+ * 支持 Tournament 的紧凑棋谱行（"h8i8h10 1-0 A 3"）与 BookBuilder 的棋谱格式（着法间可有空格，结果可省略）：
+ * 结果记号 1-0 / 0-1 / 1/2 之前的内容为着法坐标串，之后的内容忽略。
+ * @return bool 着法坐标是否合法且非空
+ */
+bool parseGameRecord(const std::string& line, int boardSize, TuningGame& game);
+
+/**
+ * @brief 重放一局，对每个可作为样本的局面回调
+ * 实现逻辑：
+ * Step1：在会话上从空盘逐手落子，着法被占或为禁手时整局作废；成五即终局（之后的多余着法忽略），
+ *        未注明结果时以成五一方为胜者，无人成五记为和棋；
+ * Step2：第 skipPlies 手之后的每个局面（落子之前）若为“平静”局面——双方都没有成五点——则回调 onPosition(行棋方)，
+ *        有成五点的局面胜负已在一两手内决定，与估值无关，只会干扰拟合。
+ * 整局作废前已经发生的回调不会撤销，调用方需自行丢弃该局的样本。
+ * @param session 同尺寸同规则的会话（会被reset）
+ * @param result 输出：对局结果（1=黑胜，-1=白胜，0=和棋）
+ * @return bool 整局是否合法
+ */
+bool replayGame(GameSession& session, const TuningGame& game, int skipPlies,
+                const std::function<void(Config::PieceType)>& onPosition, int& result);
+
+/**
+ * @brief 重放一局并提取调参样本（样本选取见 replayGame()）
+ * @param session 同尺寸同规则的会话（会被reset）
+ * @return int 追加到out的样本数，整局作废时为-1
+ */
+int extractPositions(GameSession& session, const TuningGame& game, int skipPlies, std::vector<TuningPosition>& out);
+
+/**
+ * @brief 样本的静态估值（黑方视角）：Σ weights[t] × features[t]
+ */
+double positionEval(const TuningPosition& position, const double* weights);
+
+/**
+ * @brief 平均对数损失（交叉熵）及其梯度
+ * 模型：黑方期望得分 p = σ(K × eval)，损失 L = −mean(r·ln p + (1−r)·ln(1−p))，
+ * 梯度 ∂L/∂w[t] = mean((p − r) × K × features[t])。
+ * 实现逻辑：样本按线程数切成连续的块，每个线程累加自己那块的损失与梯度，最后按块顺序求和
+ * （同样的线程数结果逐位可复现）。
+ * @param weights 各棋型分值（PATTERN_TYPE_COUNT个）
+ * @param scale 估值到胜率的缩放系数 K
+ * @param threads 线程数，<=0 表示使用全部硬件线程
+ * @param gradient 可选输出：PATTERN_TYPE_COUNT个偏导数；可为nullptr
+ * @return double 平均损失（无样本时为0）
+ */
+double tuningLoss(const std::vector<TuningPosition>& positions, const double* weights, double scale, int threads,
+                  double* gradient = nullptr);
+
+/**
+ * @brief 拟合缩放系数 K：固定分值，在对数尺度上黄金分割搜索使损失最小的 K
+ * 调参前先拟合 K，再固定 K 调分值，调出的分值与原分值处于同一量级（搜索中与估值相关的常数仍然适用）。
+ */
+double fitScale(const std::vector<TuningPosition>& positions, const double* weights, int threads);
+
+/**
+ * @brief 调参参数
+ */
+struct TunerOptions {
+    int threads = 0;                // 梯度计算线程数，<=0 表示使用全部硬件线程
+    int epochs = 1000;              // 全量梯度迭代轮数
+    double learningRate = 2.0;      // Adam 步长（分值单位）
+    double scale = 0.0;             // 缩放系数 K，<=0 表示先用 fitScale() 拟合
+};
+
+/**
+ * @brief 调参结果
+ */
+struct TunerResult {
+    int weights[PATTERN_TYPE_COUNT] = {};   // 取整后的分值（可直接写入 EvalWeights.h）
+    double scale = 0.0;                     // 使用的缩放系数 K
+    double initialLoss = 0.0;               // 初始分值的损失
+    double finalLoss = 0.0;                 // 取整后分值的损失
+};
+
+/**
+ * @brief Texel 式调参：固定 K，以 Adam 做全量梯度下降，使对数损失最小
+ * 实现逻辑：
+ * Step1：未指定 K 时用初始分值拟合 K；
+ * Step2：每轮多线程计算全量梯度，Adam 更新除 None 以外的分值，再投影回约束：
+ *        分值在 [0, PATTERN_SCORE_LIMIT] 内，且按棋型等级单调不减（等级越高的棋型分值不低于低一级的棋型），
+ *        样本中从不出现的棋型（如成五）梯度为0，保持初始分值；
+ * Step3：取整并再次投影，报告取整后分值的损失。
+ * @param initialWeights 初始分值（通常为当前的 PATTERN_SCORE）
+ * @param onEpoch 每轮结束的回调（轮次从1开始、本轮损失、当前分值），可为空
+ */
+TunerResult tuneWeights(const std::vector<TuningPosition>& positions, const int* initialWeights, const TunerOptions& options,
+                        const std::function<void(int, double, const double*)>& onEpoch);
+
+/**
+ * @brief 生成 EvalWeights.h 的完整内容（UTF-8 BOM、头文件保护与 PATTERN_SCORE 定义）
+ * @param source 写入文件头注释的数据来源说明（一行）
+ */
+std::string formatWeightsHeader(const int* weights, const std::string& source);
+
+#endif // TEXELTUNER_H
@@ -0,0 +1,44 @@
+﻿#pragma once
+#ifndef BITUTILS_H
+#define BITUTILS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief 位运算工具（跨编译器封装）
+ * 棋盘以位掩码存储，遍历置位格子、统计棋子数都依赖这两个操作；
+ * GCC/Clang使用内建函数，MSVC使用对应的intrinsic，均编译为单条指令。
+ */
+namespace BitUtils {
+
+/**
+ * @brief 最低置位的位序号（x不能为0）
+ */
+inline int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+/**
+ * @brief 置位个数
+ */
+inline int popCount(uint64_t x) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+} // namespace BitUtils
+
+#endif // BITUTILS_H
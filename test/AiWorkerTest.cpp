@@ -0,0 +1,166 @@
+﻿/**
+ * @brief AiWorker 单元测试（AI 工作线程、取消与进度回调）
+ * 测试内容：
+ * 1. 任务在常驻工作线程上执行（不在提交线程上），提交立即返回，连续任务复用同一线程；
+ * 2. 取消：无限预算的搜索（包括刚提交、尚未进入搜索入口时）cancel() 都能在极短时间内返回；
+ *    新任务提交时自动取消旧任务；经 GameSession::stopSearch() 取消同样有效；
+ * 3. 进度：SearchLimits::onIteration 每轮迭代回调一次且深度递增，最后一次与结果一致；
+ *    MctsLimits::onProgress 按模拟批次回调，模拟数递增；ProgressThrottle 按间隔放行。
+ */
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TestCommon.h"
+#include "ai/AiWorker.h"
+#include "ai/MctsEngine.h"
+#include "ai/SearchEngine.h"
+#include "game/GameSession.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+/**
+ * @brief 取消的响应时间上限（毫秒）：搜索每隔少量节点检查停止标志，正常机器上取消在1~2毫秒内完成，
+ * 上限留出负载较高或带 sanitizer 运行时的余量
+ */
+constexpr int64_t CANCEL_BOUND_MS = 100;
+
+void testRunsOffThread() {
+    AiWorker worker;
+    CHECK(!worker.isBusy());
+    worker.cancel(); // 空闲时取消立即返回
+
+    std::atomic<int> runs{0};
+    std::thread::id first;
+    std::thread::id second;
+    worker.submit([&]() { first = std::this_thread::get_id(); ++runs; }, nullptr);
+    CHECK(waitFor([&]() { return runs.load() == 1 && !worker.isBusy(); }));
+    worker.submit([&]() { second = std::this_thread::get_id(); ++runs; }, nullptr);
+    CHECK(waitFor([&]() { return runs.load() == 2 && !worker.isBusy(); }));
+    CHECK(first != std::this_thread::get_id());
+    CHECK(first == second);
+}
+
+void testCancelSearch() {
+    Board board;
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+    SearchEngine engine(8);
+    engine.setThreadCount(2);
+    AiWorker worker;
+
+    std::atomic<int> finished{0};
+    std::atomic<int> iterations{0};
+    SearchResult result;
+    auto task = [&]() {
+        SearchLimits limits;
+        limits.timeMs = 0;
+        limits.onIteration = [&](const SearchResult&) { ++iterations; };
+        result = engine.search(board, B, limits);
+        ++finished;
+    };
+    auto stop = [&]() { engine.stop(); };
+
+    // 等到至少完成一轮迭代再取消（单核且负载较高时固定的等待时间可能还不够完成第一轮）
+    worker.submit(task, stop);
+    CHECK(waitFor([&]() { return iterations.load() > 0; }));
+    CHECK(worker.isBusy());
+    auto start = std::chrono::steady_clock::now();
+    worker.cancel();
+    CHECK(elapsedMs(start) < CANCEL_BOUND_MS);
+    CHECK(!worker.isBusy());
+    CHECK(finished.load() == 1);
+    CHECK(result.depth >= 1 && result.row >= 0);
+
+    // 刚提交立即取消（任务可能尚未开始或尚未进入search()），以及新任务顶替旧任务
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        worker.submit(task, stop);
+        if (i % 2) {
+            worker.cancel();
+        }
+    }
+    worker.cancel();
+    CHECK(elapsedMs(start) < 3000);
+    CHECK(!worker.isBusy());
+    CHECK(finished.load() <= 101);
+
+    // 经会话接口取消（GameController 的用法）
+    std::unique_ptr<GameSession> session = GameSession::create(Config::LARGE_BOARD_SIZE);
+    session->placePiece(9, 9, B);
+    session->placePiece(9, 10, W);
+    std::atomic<bool> done{false};
+    std::atomic<int> sessionIterations{0};
+    worker.submit([&]() {
+        SearchLimits limits;
+        limits.timeMs = 0;
+        limits.onIteration = [&](const SearchResult&) { ++sessionIterations; };
+        session->search(B, limits);
+        MctsLimits mctsLimits;
+        mctsLimits.timeMs = 0;
+        session->searchMcts(B, mctsLimits);
+        done = true;
+    }, [&]() { session->stopSearch(); });
+    // 在搜索进行中取消：随后的 searchMcts() 复位停止标志、首次分配节点池，都必须仍能及时响应
+    CHECK(waitFor([&]() { return sessionIterations.load() > 0; }));
+    start = std::chrono::steady_clock::now();
+    worker.cancel();
+    CHECK(elapsedMs(start) < CANCEL_BOUND_MS);
+    CHECK(done.load());
+}
+
+void testProgress() {
+    Board board;
+    playMoves(board, "h8i9h9h10j8g8i8");
+    SearchEngine engine(8);
+    engine.setThreadCount(1);
+    std::vector<int> depths;
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 6;
+    limits.onIteration = [&](const SearchResult& progress) {
+        depths.push_back(progress.depth);
+        CHECK(!progress.pv.empty());
+    };
+    const SearchResult result = engine.search(board, W, limits);
+    CHECK(!depths.empty());
+    for (size_t i = 1; i < depths.size(); ++i) {
+        CHECK(depths[i] > depths[i - 1]);
+    }
+    CHECK(depths.empty() || depths.back() == result.depth);
+
+    MctsEngine mcts(8);
+    std::vector<uint64_t> playouts;
+    MctsLimits mctsLimits;
+    mctsLimits.timeMs = 0;
+    mctsLimits.maxPlayouts = 20000;
+    mctsLimits.onProgress = [&](const MctsResult& progress) {
+        playouts.push_back(progress.playouts);
+        CHECK(progress.row >= 0 && progress.winRate >= 0.0 && progress.winRate <= 1.0);
+    };
+    mcts.search(board, W, mctsLimits);
+    CHECK(playouts.size() >= 2);
+    for (size_t i = 1; i < playouts.size(); ++i) {
+        CHECK(playouts[i] > playouts[i - 1]);
+    }
+
+    ProgressThrottle throttle(30);
+    CHECK(throttle.tryAcquire());
+    CHECK(!throttle.tryAcquire());
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    CHECK(throttle.tryAcquire());
+    CHECK(!throttle.tryAcquire());
+}
+
+} // namespace
+
+int main() {
+    testRunsOffThread();
+    testCancelSearch();
+    testProgress();
+    return testResult("AiWorkerTest");
+}
@@ -0,0 +1,122 @@
+﻿/**
+ * @brief BoardEval 单元测试（SIMD全盘估值内核 vs 增量估值/标量实现）
+ * 测试内容：
+ * 1. 随机局面（全部规则、空盘到近满盘）：每种当前CPU支持的指令集，估值与board.evaluate(Black)逐位相等；
+ * 2. 热度图：各指令集输出与标量实现逐格相等，且与按board.pattern()朴素累加的结果一致；
+ * 3. 边界：空盘估值为0、满盘热度全为0，不支持的指令集退回标量实现而不是崩溃。
+ */
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "TestCommon.h"
+#include "game/BoardEval.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+const BoardEval::Isa ISAS[] = { BoardEval::Isa::Scalar, BoardEval::Isa::SSE2, BoardEval::Isa::AVX2 };
+
+/**
+ * @brief 随机落stones子（黑白交替，不检查胜负，覆盖长连/成五等各种窗口）
+ */
+template <typename BoardT>
+void randomFill(BoardT& board, std::mt19937& rng, int stones) {
+    Config::PieceType side = B;
+    for (int placed = 0; placed < stones;) {
+        if (board.placePiece(static_cast<int>(rng() % N), static_cast<int>(rng() % N), side)) {
+            side = Config::opponent(side);
+            ++placed;
+        }
+    }
+}
+
+template <typename BoardT>
+std::vector<int> naiveHeat(const BoardT& board) {
+    std::vector<int> heat(N * N, 0);
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            if (board.getPiece(r, c) != Config::PieceType::None) {
+                continue;
+            }
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                heat[r * N + c] += PATTERN_SCORE[static_cast<int>(board.pattern(r, c, dir, B))]
+                                 + PATTERN_SCORE[static_cast<int>(board.pattern(r, c, dir, W))];
+            }
+        }
+    }
+    return heat;
+}
+
+/**
+ * @brief 单一规则下的随机局面比对（规则是棋盘的编译期参数，逐规则实例化）
+ */
+template <Rule R>
+void testRandomPositionsFor(std::mt19937& rng) {
+    std::vector<int> scalarHeat(N * N);
+    std::vector<int> heat(N * N);
+    int scoreMismatches = 0;
+    int heatMismatches = 0;
+    for (int i = 0; i < 400; ++i) {
+        BasicBoard<N, R> board;
+        randomFill(board, rng, static_cast<int>(rng() % (N * N - 5)));
+        const int expected = board.evaluate(B);
+        CHECK(BoardEval::evaluate(board, scalarHeat.data(), BoardEval::Isa::Scalar) == expected);
+        if (i % 20 == 0) {
+            CHECK(scalarHeat == naiveHeat(board));
+        }
+        for (BoardEval::Isa isa : ISAS) {
+            if (!BoardEval::isSupported(isa)) {
+                continue;
+            }
+            scoreMismatches += BoardEval::evaluate(board, heat.data(), isa) != expected;
+            heatMismatches += heat != scalarHeat;
+            scoreMismatches += BoardEval::evaluate(board, nullptr, isa) != expected;
+        }
+    }
+    CHECK(scoreMismatches == 0);
+    CHECK(heatMismatches == 0);
+}
+
+void testRandomPositions() {
+    std::printf("BoardEval best ISA: %s\n", BoardEval::isaName(BoardEval::bestIsa()));
+    std::mt19937 rng(14);
+    testRandomPositionsFor<Rule::Freestyle>(rng);
+    testRandomPositionsFor<Rule::Standard>(rng);
+    testRandomPositionsFor<Rule::Renju>(rng);
+    testRandomPositionsFor<Rule::Caro>(rng);
+}
+
+void testEdgeCases() {
+    CHECK(BoardEval::isSupported(BoardEval::Isa::Scalar));
+    CHECK(BoardEval::isSupported(BoardEval::bestIsa()));
+
+    Board empty;
+    std::vector<int> heat(N * N, -1);
+    for (BoardEval::Isa isa : ISAS) {
+        // 不支持的指令集同样可以调用（退回标量）
+        CHECK(BoardEval::evaluate(empty, heat.data(), isa) == 0);
+        CHECK(heat == naiveHeat(empty));
+    }
+
+    Board full;
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            full.placePiece(r, c, ((r / 2 + c) & 1) ? B : W);
+        }
+    }
+    for (BoardEval::Isa isa : ISAS) {
+        std::fill(heat.begin(), heat.end(), -1);
+        CHECK(BoardEval::evaluate(full, heat.data(), isa) == full.evaluate(B));
+        CHECK(std::count(heat.begin(), heat.end(), 0) == N * N);
+    }
+}
+
+} // namespace
+
+int main() {
+    testRandomPositions();
+    testEdgeCases();
+    return testResult("BoardEvalTest");
+}
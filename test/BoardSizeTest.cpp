@@ -0,0 +1,218 @@
+﻿/**
+ * @brief 多棋盘尺寸单元测试（BasicBoard<19>与19x19引擎特化、GameSession运行时分派）
+ * 测试内容：
+ * 1. 19x19 棋盘：边角落子、越界拒绝、第19列/最后一行/两条对角线成五判定、满盘判定；
+ * 2. 19x19 随机局面：增量估值与 BoardEval 各指令集一致，候选点、哈希在落子/悔棋后正确恢复；
+ * 3. 19x19 AI：SearchEngine、ThreatSolver、MctsEngine 在棋盘边缘找到必胜/必堵着法；
+ * 4. GameSession：按尺寸创建对应特化，不支持的尺寸返回空，19x19 开局库总是未命中。
+ */
+#include <random>
+#include <vector>
+#include "TestCommon.h"
+#include "game/BoardEval.h"
+#include "game/GameSession.h"
+#include "ai/MctsEngine.h"
+#include "ai/SearchEngine.h"
+#include "ai/ThreatSolver.h"
+
+namespace {
+
+constexpr int N = Config::LARGE_BOARD_SIZE;
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+const BoardEval::Isa ISAS[] = { BoardEval::Isa::Scalar, BoardEval::Isa::SSE2, BoardEval::Isa::AVX2 };
+
+static_assert(Board19::SIZE == 19 && Board19::CELL_COUNT == 361, "19x19 specialisation");
+static_assert(sizeof(Board19::LineMask) == 4, "19 columns need a 32-bit line mask");
+static_assert(sizeof(Board::LineMask) == 2, "15x15 keeps the 16-bit line mask");
+
+void testPlacementAndWin() {
+    Board19 board;
+    CHECK(board.placePiece(N - 1, N - 1, B));
+    CHECK(board.getPiece(N - 1, N - 1) == B);
+    CHECK(!board.placePiece(N, 0, W));
+    CHECK(!board.placePiece(0, N, W));
+    CHECK(board.getPiece(0, N) == Config::PieceType::None);
+    CHECK(board.removePiece(N - 1, N - 1));
+
+    // 最后一行靠右边缘横向成五
+    for (int c = N - 5; c < N; ++c) {
+        board.placePiece(N - 1, c, B);
+    }
+    CHECK(board.checkWin(N - 1, N - 1, B));
+    CHECK(board.checkWin(N - 1, N - 3, B));
+
+    // 第19列纵向成五
+    board.reset();
+    for (int r = 0; r < 5; ++r) {
+        board.placePiece(r, N - 1, W);
+    }
+    CHECK(board.checkWin(2, N - 1, W));
+    CHECK(!board.checkWin(2, N - 1, B));
+
+    // 主对角线（右下角）与副对角线（左下角到右上角中段）
+    board.reset();
+    for (int i = N - 5; i < N; ++i) {
+        board.placePiece(i, i, B);
+    }
+    CHECK(board.checkWin(N - 1, N - 1, B));
+    board.reset();
+    for (int i = 0; i < 5; ++i) {
+        board.placePiece(N - 1 - i, i, W);
+    }
+    CHECK(board.checkWin(N - 3, 2, W));
+
+    // 四子不成五
+    board.reset();
+    for (int c = 15; c < N; ++c) {
+        board.placePiece(0, c, B);
+    }
+    CHECK(!board.checkWin(0, N - 1, B));
+
+    Board19 full;
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            CHECK(!full.isFull());
+            full.placePiece(r, c, ((r / 2 + c) & 1) ? B : W);
+        }
+    }
+    CHECK(full.isFull());
+    CHECK(full.stoneCount() == N * N);
+}
+
+template <Rule R>
+void testRandomPositionsFor(std::mt19937& rng) {
+    std::vector<int> heat(N * N);
+    int scoreMismatches = 0;
+    for (int i = 0; i < 100; ++i) {
+        BasicBoard<N, R> board;
+        const uint64_t emptyHash = board.hash();
+        std::vector<int> placed;
+        Config::PieceType side = B;
+        const int stones = static_cast<int>(rng() % (N * N - 5));
+        while (static_cast<int>(placed.size()) < stones) {
+            const int cell = static_cast<int>(rng() % (N * N));
+            if (board.placePiece(cell / N, cell % N, side)) {
+                placed.push_back(cell);
+                side = Config::opponent(side);
+            }
+        }
+        const int expected = board.evaluate(B);
+        for (BoardEval::Isa isa : ISAS) {
+            scoreMismatches += BoardEval::evaluate(board, heat.data(), isa) != expected;
+        }
+
+        int candidates[N * N];
+        const int count = board.candidateMoves(candidates);
+        for (int k = 0; k < count; ++k) {
+            CHECK(candidates[k] >= 0 && candidates[k] < N * N);
+            CHECK(board.getPiece(candidates[k] / N, candidates[k] % N) == Config::PieceType::None);
+        }
+
+        for (auto it = placed.rbegin(); it != placed.rend(); ++it) {
+            board.removePiece(*it / N, *it % N);
+        }
+        CHECK(board.hash() == emptyHash);
+        CHECK(board.evaluate(B) == 0);
+    }
+    CHECK(scoreMismatches == 0);
+}
+
+void testRandomPositions() {
+    std::mt19937 rng(19);
+    testRandomPositionsFor<Rule::Freestyle>(rng);
+    testRandomPositionsFor<Rule::Standard>(rng);
+}
+
+void testEngines() {
+    // 黑方在最后一列冲四（上端被白子挡住）：黑方应在边缘补成五
+    Board19 board;
+    for (int r = 10; r < 14; ++r) {
+        board.placePiece(r, N - 1, B);
+    }
+    board.placePiece(9, N - 1, W);
+    board.placePiece(5, 5, W);
+    board.placePiece(5, 6, W);
+
+    BasicSearchEngine<N> engine(8);
+    engine.setThreadCount(1);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 4;
+    const SearchResult result = engine.search(board, B, limits);
+    CHECK(result.row == 14 && result.col == N - 1);
+    CHECK(BasicSearchEngine<N>::isWinScore(result.score));
+
+    // 白方必须堵同一点
+    const SearchResult defend = engine.search(board, W, limits);
+    CHECK(defend.row == 14 && defend.col == N - 1);
+
+    // 右下角附近的 VCF：两条冲四线交汇
+    Board19 vcfBoard;
+    vcfBoard.placePiece(N - 1, N - 2, B);
+    vcfBoard.placePiece(N - 1, N - 3, B);
+    vcfBoard.placePiece(N - 1, N - 4, B);
+    vcfBoard.placePiece(N - 1, N - 6, W);
+    vcfBoard.placePiece(N - 2, N - 1, B);
+    vcfBoard.placePiece(N - 3, N - 1, B);
+    vcfBoard.placePiece(N - 4, N - 1, B);
+    vcfBoard.placePiece(N - 6, N - 1, W);
+    BasicThreatSolver<N> solver(10);
+    const ThreatResult vcf = solver.solveVCF(vcfBoard, B);
+    CHECK(vcf.found);
+    CHECK(vcf.row >= 0 && vcf.row < N && vcf.col >= 0 && vcf.col < N);
+
+    BasicMctsEngine<N> mcts(4);
+    MctsLimits mctsLimits;
+    mctsLimits.timeMs = 0;
+    mctsLimits.maxPlayouts = 2000;
+    const MctsResult mctsResult = mcts.search(board, B, mctsLimits);
+    CHECK(mctsResult.row == 14 && mctsResult.col == N - 1);
+}
+
+void testSessionDispatch() {
+    CHECK(GameSession::create(13) == nullptr);
+    CHECK(!GameSession::isSupportedSize(13));
+
+    const std::unique_ptr<GameSession> small = GameSession::create(Config::BOARD_SIZE);
+    const std::unique_ptr<GameSession> large = GameSession::create(Config::LARGE_BOARD_SIZE);
+    CHECK(small && small->boardSize() == Config::BOARD_SIZE);
+    CHECK(large && large->boardSize() == Config::LARGE_BOARD_SIZE);
+
+    CHECK(!small->placePiece(Config::BOARD_SIZE, 0, B));
+    CHECK(large->placePiece(Config::BOARD_SIZE, 0, B));
+    CHECK(large->getPiece(Config::BOARD_SIZE, 0) == B);
+    CHECK(large->stoneCount() == 1);
+    int candidates[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+    CHECK(large->candidateMoves(candidates, W) > 0);
+    CHECK(large->rule() == Rule::Freestyle);
+
+    large->setThreadCount(1);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 2;
+    const SearchResult result = large->search(W, limits);
+    CHECK(result.row >= 0 && result.row < N && result.col >= 0 && result.col < N);
+    CHECK(large->getPiece(result.row, result.col) == Config::PieceType::None);
+
+    OpeningBook book;
+    BookMove move;
+    CHECK(!large->bookMove(book, move));
+
+    large->startPondering(W, 50);
+    const SearchResult pondered = large->stopPondering();
+    CHECK(pondered.row < N && pondered.col < N);
+
+    large->reset();
+    CHECK(large->stoneCount() == 0);
+}
+
+} // namespace
+
+int main() {
+    testPlacementAndWin();
+    testRandomPositions();
+    testEngines();
+    testSessionDispatch();
+    return testResult("BoardSizeTest");
+}
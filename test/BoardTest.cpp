@@ -1 +1,372 @@
-﻿
\ No newline at end of file
+﻿/**
+ * @brief Board 单元测试
+ * 测试内容：
+ * 1. 基础接口：落子/提子合法性、越界查询、满盘判断；
+ * 2. 差分测试：与逐格扫描的朴素参考实现（NaiveBoard）在数百万个随机局面上逐一比对
+ *    placePiece / removePiece / getPiece / checkWin / isFull 的结果；
+ * 3. 棋型：典型棋型识别，以及增量维护的窗口编码/估值/威胁计数与全量重算结果一致；
+ * 4. 候选着法：增量维护的候选集与朴素判断一致，威胁优先顺序中必应着法排在最前；
+ * 5. Zobrist哈希：增量哈希与全量重算一致、与落子顺序无关、reset后归零。
+ * 运行方式：ctest 或直接执行 BoardTest，全部通过返回0，否则打印失败位置并返回1。
+ */
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "TestCommon.h"
+#include "game/Board.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+
+/**
+ * @brief 朴素参考实现：二维数组存储 + 四方向逐格计数判断五连
+ */
+struct NaiveBoard {
+    Config::PieceType grid[N][N] = {};
+    int count = 0;
+
+    bool place(int r, int c, Config::PieceType t) {
+        if (r < 0 || r >= N || c < 0 || c >= N || grid[r][c] != Config::PieceType::None) {
+            return false;
+        }
+        grid[r][c] = t;
+        ++count;
+        return true;
+    }
+
+    bool remove(int r, int c) {
+        if (r < 0 || r >= N || c < 0 || c >= N || grid[r][c] == Config::PieceType::None) {
+            return false;
+        }
+        grid[r][c] = Config::PieceType::None;
+        --count;
+        return true;
+    }
+
+    Config::PieceType get(int r, int c) const {
+        if (r < 0 || r >= N || c < 0 || c >= N) {
+            return Config::PieceType::None;
+        }
+        return grid[r][c];
+    }
+
+    bool win(int r, int c, Config::PieceType t) const {
+        static const int dirs[4][2] = { {0, 1}, {1, 0}, {1, 1}, {1, -1} };
+        if (get(r, c) != t || t == Config::PieceType::None) return false;
+        for (const auto& d : dirs) {
+            int len = 1;
+            for (int s = 1; get(r + d[0] * s, c + d[1] * s) == t; ++s) ++len;
+            for (int s = 1; get(r - d[0] * s, c - d[1] * s) == t; ++s) ++len;
+            if (len >= 5) return true;
+        }
+        return false;
+    }
+};
+
+void testBasics() {
+    Board board;
+    CHECK(board.stoneCount() == 0);
+    CHECK(!board.isFull());
+    CHECK(board.getPiece(-1, 0) == Config::PieceType::None);
+    CHECK(board.getPiece(0, N) == Config::PieceType::None);
+    CHECK(!board.placePiece(N, 0, Config::PieceType::Black));
+    CHECK(board.placePiece(7, 7, Config::PieceType::Black));
+    CHECK(!board.placePiece(7, 7, Config::PieceType::White));
+    CHECK(board.getPiece(7, 7) == Config::PieceType::Black);
+
+    // 横向五连（贴右边界）
+    for (int c = N - 5; c < N; ++c) {
+        CHECK(board.placePiece(0, c, Config::PieceType::White));
+    }
+    CHECK(board.checkWin(0, N - 1, Config::PieceType::White));
+    CHECK(!board.checkWin(0, N - 1, Config::PieceType::Black));
+
+    // placePiece(None) 按悔棋语义清除棋子
+    CHECK(board.placePiece(0, N - 3, Config::PieceType::None));
+    CHECK(!board.checkWin(0, N - 1, Config::PieceType::White));
+    CHECK(!board.removePiece(0, N - 3));
+
+    board.reset();
+    CHECK(board.stoneCount() == 0);
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            CHECK(board.placePiece(r, c, (r + c) % 2 ? Config::PieceType::White : Config::PieceType::Black));
+        }
+    }
+    CHECK(board.isFull());
+}
+
+void testDifferential() {
+    std::mt19937_64 rng(20260216);
+    const int games = 20000;
+    long long positions = 0;
+
+    for (int g = 0; g < games && testFailures() == 0; ++g) {
+        Board board;
+        NaiveBoard ref;
+        Config::PieceType side = Config::PieceType::Black;
+        const int moves = 1 + static_cast<int>(rng() % (N * N));
+
+        for (int m = 0; m < moves; ++m) {
+            const int r = static_cast<int>(rng() % N);
+            const int c = static_cast<int>(rng() % N);
+
+            // 约1/8概率执行提子，覆盖悔棋/搜索回退路径
+            if (rng() % 8 == 0) {
+                CHECK(board.removePiece(r, c) == ref.remove(r, c));
+            } else {
+                const bool placed = board.placePiece(r, c, side);
+                CHECK(placed == ref.place(r, c, side));
+                if (placed) {
+                    side = Config::opponent(side);
+                }
+            }
+
+            // 对落子点与一个随机点分别比对两种颜色的胜负判断
+            const int pr = static_cast<int>(rng() % N);
+            const int pc = static_cast<int>(rng() % N);
+            for (Config::PieceType t : { Config::PieceType::Black, Config::PieceType::White }) {
+                CHECK(board.checkWin(r, c, t) == ref.win(r, c, t));
+                CHECK(board.checkWin(pr, pc, t) == ref.win(pr, pc, t));
+            }
+            CHECK(board.getPiece(pr, pc) == ref.get(pr, pc));
+            CHECK(board.isFull() == (ref.count == N * N));
+            CHECK(board.stoneCount() == ref.count);
+            ++positions;
+        }
+
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                CHECK(board.getPiece(r, c) == ref.get(r, c));
+            }
+        }
+    }
+    std::printf("differential: %lld positions compared\n", positions);
+}
+
+void testPatternShapes() {
+    Board board;
+    const Config::PieceType B = Config::PieceType::Black;
+    const Config::PieceType W = Config::PieceType::White;
+
+    // 横向 _XXX_ ：两端空点落子成活四，中心三子左侧再隔一格落子成冲四
+    board.placePiece(7, 6, B);
+    board.placePiece(7, 7, B);
+    board.placePiece(7, 8, B);
+    CHECK(board.pattern(7, 5, 0, B) == PatternType::OpenFour);
+    CHECK(board.pattern(7, 9, 0, B) == PatternType::OpenFour);
+    CHECK(board.pattern(7, 4, 0, B) == PatternType::Four);
+    CHECK(board.pattern(7, 5, 0, W) == PatternType::None);
+    CHECK(board.pattern(7, 5, 1, B) == PatternType::None);
+
+    // 一端被白子封堵后，只剩冲四
+    board.placePiece(7, 5, W);
+    CHECK(board.pattern(7, 9, 0, B) == PatternType::Four);
+
+    // 四子连成后中间空点即成五
+    board.reset();
+    for (int r : { 3, 4, 6, 7 }) {
+        board.placePiece(r, 2, W);
+    }
+    CHECK(board.pattern(5, 2, 1, W) == PatternType::Five);
+
+    // 活二 → 活三（含跳活三），隔两格只能成眠三
+    board.reset();
+    board.placePiece(7, 7, B);
+    board.placePiece(8, 8, B);
+    CHECK(board.pattern(9, 9, 2, B) == PatternType::OpenThree);
+    CHECK(board.pattern(10, 10, 2, B) == PatternType::OpenThree);
+    CHECK(board.pattern(11, 11, 2, B) == PatternType::Three);
+    CHECK(board.evaluate(B) > 0);
+    CHECK(board.evaluate(W) == -board.evaluate(B));
+}
+
+/**
+ * @brief 参考实现：按当前棋子全量计算某格某方向的窗口编码
+ */
+uint16_t naiveCode(const NaiveBoard& ref, int row, int col, int dir) {
+    uint16_t code = 0;
+    for (int k = -4; k <= 4; ++k) {
+        if (k == 0) continue;
+        const int r = row + k * DIR_DR[dir];
+        const int c = col + k * DIR_DC[dir];
+        uint16_t v = PatternCode::EDGE;
+        if (r >= 0 && r < N && c >= 0 && c < N) {
+            v = static_cast<uint16_t>(ref.get(r, c));  // None=0, Black=1, White=2
+        }
+        code |= static_cast<uint16_t>(v << (PatternCode::slotOf(k) * 2));
+    }
+    return code;
+}
+
+void testIncrementalPatterns() {
+    std::mt19937_64 rng(7);
+    const PatternTable& table = PatternTable::get();
+    for (int g = 0; g < 500 && testFailures() == 0; ++g) {
+        Board board;
+        NaiveBoard ref;
+        Config::PieceType side = Config::PieceType::Black;
+        for (int m = 0; m < 150; ++m) {
+            const int r = static_cast<int>(rng() % N);
+            const int c = static_cast<int>(rng() % N);
+            if (rng() % 4 == 0) {
+                board.removePiece(r, c);
+                ref.remove(r, c);
+            } else if (board.placePiece(r, c, side)) {
+                ref.place(r, c, side);
+                side = Config::opponent(side);
+            }
+
+            int eval = 0;
+            int threats[2][PATTERN_TYPE_COUNT] = {};
+            bool codesMatch = true;
+            for (int row = 0; row < N; ++row) {
+                for (int col = 0; col < N; ++col) {
+                    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                        const uint16_t code = naiveCode(ref, row, col, dir);
+                        codesMatch &= board.patternCode(row, col, dir) == code;
+                        if (ref.get(row, col) == Config::PieceType::None) {
+                            eval += table.score(code);
+                            ++threats[0][static_cast<int>(table.lookup(code, Config::PieceType::Black))];
+                            ++threats[1][static_cast<int>(table.lookup(code, Config::PieceType::White))];
+                        }
+                    }
+                }
+            }
+            CHECK(codesMatch);
+            CHECK(board.evaluate(Config::PieceType::Black) == eval);
+            for (int t = 1; t < PATTERN_TYPE_COUNT; ++t) {
+                CHECK(board.threatCount(Config::PieceType::Black, static_cast<PatternType>(t)) == threats[0][t]);
+                CHECK(board.threatCount(Config::PieceType::White, static_cast<PatternType>(t)) == threats[1][t]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 候选着法：随机落子/提子序列中，增量维护的候选集与逐格朴素判断一致，威胁优先顺序正确
+ */
+void testCandidates() {
+    std::mt19937_64 rng(11);
+    int moves[N * N];
+    for (int g = 0; g < 500 && testFailures() == 0; ++g) {
+        Board board;
+        NaiveBoard ref;
+        Config::PieceType side = Config::PieceType::Black;
+        for (int m = 0; m < 120; ++m) {
+            const int r = static_cast<int>(rng() % N);
+            const int c = static_cast<int>(rng() % N);
+            if (rng() % 4 == 0) {
+                board.removePiece(r, c);
+                ref.remove(r, c);
+            } else if (board.placePiece(r, c, side)) {
+                ref.place(r, c, side);
+                side = Config::opponent(side);
+            }
+
+            std::vector<int> expected;
+            for (int row = 0; row < N; ++row) {
+                for (int col = 0; col < N; ++col) {
+                    bool near = false;
+                    for (int dr = -2; dr <= 2; ++dr) {
+                        for (int dc = -2; dc <= 2; ++dc) {
+                            near |= ref.get(row + dr, col + dc) != Config::PieceType::None;
+                        }
+                    }
+                    if (near && ref.get(row, col) == Config::PieceType::None) {
+                        expected.push_back(row * N + col);
+                    }
+                }
+            }
+            if (expected.empty()) {
+                expected.push_back((N / 2) * N + N / 2);
+            }
+            const int count = board.candidateMoves(moves);
+            CHECK(std::vector<int>(moves, moves + count) == expected);
+
+            const int ordered = board.threatOrderedMoves(side, moves);
+            std::sort(moves, moves + ordered);
+            CHECK(std::vector<int>(moves, moves + ordered) == expected);
+        }
+    }
+
+    // 白方冲四（h8~k8，g8被堵）、黑方活三：堵冲四排第一，其次己方活三成活四的两个点
+    Board board;
+    board.placePiece(7, 7, Config::PieceType::White);
+    board.placePiece(7, 8, Config::PieceType::White);
+    board.placePiece(7, 9, Config::PieceType::White);
+    board.placePiece(7, 10, Config::PieceType::White);
+    board.placePiece(7, 6, Config::PieceType::Black);
+    board.placePiece(10, 5, Config::PieceType::Black);
+    board.placePiece(10, 6, Config::PieceType::Black);
+    board.placePiece(10, 7, Config::PieceType::Black);
+    const int count = board.threatOrderedMoves(Config::PieceType::Black, moves);
+    CHECK(count > 3);
+    CHECK(moves[0] == 7 * N + 11);
+    CHECK((moves[1] == 10 * N + 4 && moves[2] == 10 * N + 8));
+}
+
+uint64_t naiveHash(const NaiveBoard& ref) {
+    uint64_t h = 0;
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            if (ref.get(r, c) != Config::PieceType::None) {
+                h ^= Zobrist::key(ref.get(r, c) == Config::PieceType::Black ? 0 : 1, r, c);
+            }
+        }
+    }
+    return h;
+}
+
+void testZobrist() {
+    static_assert(Zobrist::key(0, 7, 7) != 0, "keys are generated at compile time");
+
+    Board a;
+    Board b;
+    CHECK(a.hash() == 0);
+    a.placePiece(7, 7, Config::PieceType::Black);
+    a.placePiece(7, 8, Config::PieceType::White);
+    a.placePiece(8, 8, Config::PieceType::Black);
+    b.placePiece(8, 8, Config::PieceType::Black);
+    b.placePiece(7, 8, Config::PieceType::White);
+    b.placePiece(7, 7, Config::PieceType::Black);
+    CHECK(a.hash() == b.hash());
+    b.removePiece(7, 8);
+    CHECK(a.hash() != b.hash());
+    b.placePiece(7, 8, Config::PieceType::Black);
+    CHECK(a.hash() != b.hash());
+    a.reset();
+    CHECK(a.hash() == 0);
+
+    std::mt19937_64 rng(99);
+    Board board;
+    NaiveBoard ref;
+    for (int m = 0; m < 200000; ++m) {
+        const int r = static_cast<int>(rng() % N);
+        const int c = static_cast<int>(rng() % N);
+        if (rng() % 3 == 0) {
+            board.removePiece(r, c);
+            ref.remove(r, c);
+        } else {
+            const Config::PieceType t = rng() % 2 ? Config::PieceType::Black : Config::PieceType::White;
+            board.placePiece(r, c, t);
+            ref.place(r, c, t);
+        }
+        if (m % 64 == 0) {
+            CHECK(board.hash() == naiveHash(ref));
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testBasics();
+    testDifferential();
+    testPatternShapes();
+    testIncrementalPatterns();
+    testCandidates();
+    testZobrist();
+    return testResult("BoardTest");
+}
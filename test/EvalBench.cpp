@@ -0,0 +1,79 @@
+﻿/**
+ * @brief BoardEval 全盘估值内核基准
+ * 生成一组固定随机种子的局面（10~120子），对每种当前CPU支持的指令集分别反复整盘估值，
+ * 输出每秒估值局面数及相对标量实现的加速比；“+heat”一列同时输出热度图。
+ * 用法：EvalBench [每种指令集的评估轮数，默认200]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "game/BoardEval.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+constexpr int POSITION_COUNT = 256;
+
+std::vector<Board> makePositions() {
+    std::mt19937 rng(2024);
+    std::vector<Board> positions(POSITION_COUNT);
+    for (Board& board : positions) {
+        const int stones = 10 + static_cast<int>(rng() % 111);
+        Config::PieceType side = Config::PieceType::Black;
+        for (int placed = 0; placed < stones;) {
+            if (board.placePiece(static_cast<int>(rng() % N), static_cast<int>(rng() % N), side)) {
+                side = Config::opponent(side);
+                ++placed;
+            }
+        }
+    }
+    return positions;
+}
+
+/**
+ * @brief 返回每秒估值局面数；checksum防止编译器优化掉估值调用
+ */
+double measure(const std::vector<Board>& positions, int rounds, BoardEval::Isa isa, int* heat, long long& checksum) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const Board& board : positions) {
+            checksum += BoardEval::evaluate(board, heat, isa);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0 ? static_cast<double>(rounds) * positions.size() / seconds : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    const std::vector<Board> positions = makePositions();
+    std::vector<int> heat(N * N);
+    long long checksum = 0;
+    double scalarScore = 0.0, scalarHeat = 0.0;
+
+    std::printf("best ISA: %s\n", BoardEval::isaName(BoardEval::bestIsa()));
+    std::printf("%-8s %14s %9s %14s %9s\n", "ISA", "pos/s", "speedup", "pos/s +heat", "speedup");
+    const BoardEval::Isa isas[] = { BoardEval::Isa::Scalar, BoardEval::Isa::SSE2, BoardEval::Isa::AVX2 };
+    for (BoardEval::Isa isa : isas) {
+        if (!BoardEval::isSupported(isa)) {
+            std::printf("%-8s (not supported on this CPU)\n", BoardEval::isaName(isa));
+            continue;
+        }
+        const double score = measure(positions, rounds, isa, nullptr, checksum);
+        const double withHeat = measure(positions, rounds, isa, heat.data(), checksum);
+        if (isa == BoardEval::Isa::Scalar) {
+            scalarScore = score;
+            scalarHeat = withHeat;
+        }
+        std::printf("%-8s %14.0f %8.2fx %14.0f %8.2fx\n", BoardEval::isaName(isa),
+                    score, scalarScore > 0 ? score / scalarScore : 0.0,
+                    withHeat, scalarHeat > 0 ? withHeat / scalarHeat : 0.0);
+    }
+    std::printf("checksum %lld\n", checksum);
+    return 0;
+}
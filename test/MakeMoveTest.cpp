@@ -0,0 +1,253 @@
+﻿/**
+ * @brief Board::makeMove/unmakeMove 单元测试（撤销栈与零分配热路径）
+ * 测试内容：
+ * 1. 正确性：随机走子到不同深度后逐手撤销，每一层的哈希、估值、威胁计数、棋型编码、候选着法
+ *    都与落子前完全一致（四种规则、两种棋盘尺寸，Renju另比对禁手位）；非法落子不入栈，空栈撤销返回-1；
+ * 2. 零分配：替换全部全局分配函数计数——纯走子/退子循环不分配；
+ *    SearchEngine（复用结果对象，单线程与带常驻辅助线程的 Lazy SMP）与 MctsEngine 预热后，
+ *    浅搜与深搜、少模拟与多模拟都是零次堆分配；
+ *    ThreatSolver 只为返回给调用方的变例分配。
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+#include "TestCommon.h"
+#include "game/Board.h"
+#include "ai/MctsEngine.h"
+#include "ai/SearchEngine.h"
+#include "ai/ThreatSolver.h"
+
+namespace {
+
+std::atomic<long> g_allocations{0};
+
+/**
+ * @brief 替换全部全局分配函数（普通/数组、nothrow、对齐版本）：都经由 malloc/aligned_alloc 并计数，
+ * 释放函数统一用 free，避免部分替换时分配与释放来自不同实现
+ */
+void* countedAlloc(std::size_t size, std::size_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size = size ? size : 1;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* countedAllocOrThrow(std::size_t size, std::size_t alignment) {
+    if (void* p = countedAlloc(size, alignment)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAllocOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return countedAllocOrThrow(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return countedAlloc(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return countedAlloc(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+/**
+ * @brief 棋盘全部增量状态的快照（用于逐层比对）
+ */
+template <int N, Rule R>
+struct Snapshot {
+    uint64_t hash = 0;
+    int eval = 0;
+    int stones = 0;
+    int threats[2][PATTERN_TYPE_COUNT] = {};
+    std::vector<uint16_t> codes;
+    std::vector<uint32_t> candidates;
+
+    explicit Snapshot(const BasicBoard<N, R>& board)
+        : hash(board.hash())
+        , eval(board.evaluate(B))
+        , stones(board.stoneCount())
+    {
+        for (int t = 0; t < PATTERN_TYPE_COUNT; ++t) {
+            threats[0][t] = board.threatCount(B, static_cast<PatternType>(t));
+            threats[1][t] = board.threatCount(W, static_cast<PatternType>(t));
+        }
+        for (int r = 0; r < N; ++r) {
+            candidates.push_back(board.candidateRow(r));
+            candidates.push_back(board.occupancyRow(r));
+            candidates.push_back(board.playableRow(B, r));
+            for (int c = 0; c < N; ++c) {
+                for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                    codes.push_back(board.patternCode(r, c, dir));
+                }
+            }
+        }
+    }
+
+    bool operator==(const Snapshot& o) const {
+        for (int t = 0; t < PATTERN_TYPE_COUNT; ++t) {
+            if (threats[0][t] != o.threats[0][t] || threats[1][t] != o.threats[1][t]) {
+                return false;
+            }
+        }
+        return hash == o.hash && eval == o.eval && stones == o.stones && codes == o.codes && candidates == o.candidates;
+    }
+};
+
+template <int N, Rule R>
+void testRoundTripFor(std::mt19937& rng) {
+    BasicBoard<N, R> board;
+    // 先用placePiece摆几颗不入栈的子，验证两种落子方式可以混用
+    board.placePiece(N / 2, N / 2, B);
+    board.placePiece(N / 2, N / 2 + 1, W);
+    CHECK(board.moveCount() == 0);
+    CHECK(board.unmakeMove() == -1);
+
+    int mismatches = 0;
+    for (int round = 0; round < 60; ++round) {
+        const int depth = 1 + static_cast<int>(rng() % (N * N / 2));
+        std::vector<Snapshot<N, R>> before;
+        std::vector<int> cells;
+        Config::PieceType side = round % 2 ? W : B;
+        while (static_cast<int>(cells.size()) < depth) {
+            const int cell = static_cast<int>(rng() % (N * N));
+            if (board.getPiece(cell / N, cell % N) != Config::PieceType::None) {
+                CHECK(!board.makeMove(cell / N, cell % N, side));
+                continue;
+            }
+            before.emplace_back(board);
+            CHECK(board.makeMove(cell / N, cell % N, side));
+            cells.push_back(cell);
+            side = Config::opponent(side);
+        }
+        CHECK(board.moveCount() == depth);
+        CHECK(board.moveAt(depth - 1) == cells.back());
+        for (int i = depth - 1; i >= 0; --i) {
+            mismatches += board.unmakeMove() != cells[i];
+            mismatches += !(Snapshot<N, R>(board) == before[i]);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(!board.makeMove(0, 0, Config::PieceType::None));
+    CHECK(!board.makeMove(-1, 0, B));
+    CHECK(board.moveCount() == 0);
+}
+
+template <int N>
+void testRoundTrip(unsigned seed) {
+    std::mt19937 rng(seed);
+    testRoundTripFor<N, Rule::Freestyle>(rng);
+    testRoundTripFor<N, Rule::Standard>(rng);
+    testRoundTripFor<N, Rule::Renju>(rng);
+    testRoundTripFor<N, Rule::Caro>(rng);
+}
+
+/**
+ * @brief 统计fn执行期间的堆分配次数
+ */
+template <typename Fn>
+long countAllocations(Fn&& fn) {
+    const long before = g_allocations.load();
+    fn();
+    return g_allocations.load() - before;
+}
+
+void testNoAllocation() {
+    Board board;
+    std::mt19937 rng(17);
+    const long walk = countAllocations([&]() {
+        for (int i = 0; i < 200000; ++i) {
+            const int cell = static_cast<int>(rng() % (Board::CELL_COUNT));
+            if (board.moveCount() < 100 && board.makeMove(cell / Board::SIZE, cell % Board::SIZE, i % 2 ? B : W)) {
+                continue;
+            }
+            board.unmakeMove();
+        }
+    });
+    CHECK(walk == 0);
+
+    Board position;
+    const int stones[][3] = { {7, 7, 1}, {7, 8, 2}, {8, 8, 1}, {6, 6, 2}, {8, 7, 1}, {9, 6, 2}, {6, 8, 1}, {8, 6, 2} };
+    for (const auto& s : stones) {
+        position.placePiece(s[0], s[1], static_cast<Config::PieceType>(s[2]));
+    }
+
+    SearchEngine engine(4);
+    engine.setThreadCount(1);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    SearchResult result;    // 复用结果对象：主要变例与迭代统计的缓冲区也不再分配
+    auto search = [&](int depth) {
+        limits.maxDepth = depth;
+        return countAllocations([&]() { engine.search(position, B, limits, result); });
+    };
+    search(6); // 预热：各缓冲区达到稳定容量
+    const long shallow = search(2);
+    const long deep = search(6);
+    std::printf("search allocations: depth2=%ld depth6=%ld\n", shallow, deep);
+    CHECK(shallow == 0 && deep == 0);
+    CHECK(result.depth == 6 && !result.pv.empty());
+
+    // Lazy SMP：辅助线程常驻、各自的结果缓冲区跨搜索复用，预热后同样不分配
+    engine.setThreadCount(3);
+    search(6);
+    const long smpShallow = search(2);
+    const long smpDeep = search(6);
+    std::printf("smp search allocations: depth2=%ld depth6=%ld\n", smpShallow, smpDeep);
+    CHECK(smpShallow == 0 && smpDeep == 0);
+    CHECK(result.depth == 6 && !result.pv.empty());
+
+    ThreatSolver solver(10);
+    solver.findForcedWin(position, B);
+    const long vct = countAllocations([&]() { solver.findForcedWin(position, B); });
+    const long vctAgain = countAllocations([&]() { solver.findForcedWin(position, W); });
+    std::printf("threat solver allocations: %ld %ld\n", vct, vctAgain);
+    // 只有返回给调用方的变例会分配（VCF、VCT结果各至多一条）
+    CHECK(vct <= 2 && vctAgain <= 2);
+
+    MctsEngine mcts(4);
+    MctsLimits mctsLimits;
+    mctsLimits.timeMs = 0;
+    mctsLimits.maxPlayouts = 100;
+    mcts.search(position, B, mctsLimits);
+    const long few = countAllocations([&]() { mcts.search(position, B, mctsLimits); });
+    mctsLimits.maxPlayouts = 3000;
+    const long many = countAllocations([&]() { mcts.search(position, B, mctsLimits); });
+    std::printf("mcts allocations: 100 playouts=%ld 3000 playouts=%ld\n", few, many);
+    CHECK(few == 0 && many == 0);
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip<Config::BOARD_SIZE>(17);
+    testRoundTrip<Config::LARGE_BOARD_SIZE>(18);
+    testNoAllocation();
+    return testResult("MakeMoveTest");
+}
@@ -0,0 +1,109 @@
+﻿/**
+ * @brief MctsEngine 单元测试
+ * 测试内容：
+ * 1. 战术正确性：能成五必成五、对方冲四必堵；
+ * 2. 多线程（树并行）搜索返回合法着法，并报告模拟次数、每秒模拟数与峰值树内存；
+ * 3. 节点池：分配节点数不超过容量，小容量节点池耗尽后搜索仍正常结束，重复搜索复用节点池；
+ * 4. 空棋盘开局走天元，stop() 可从其他线程终止不限时搜索。
+ */
+#include <chrono>
+#include <string>
+#include <thread>
+#include "TestCommon.h"
+#include "ai/MctsEngine.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+void testTactics() {
+    MctsEngine engine(16);
+    MctsLimits limits;
+    limits.timeMs = 0;
+    limits.maxPlayouts = 2000;
+
+    // 黑方横向四连（h8~k8），黑走应成五
+    Board board;
+    for (int c = 7; c <= 10; ++c) board.placePiece(7, c, B);
+    for (int c = 7; c <= 9; ++c) board.placePiece(9, c, W);
+    board.placePiece(0, 0, W);
+    MctsResult r = engine.search(board, B, limits);
+    CHECK(r.row == 7 && (r.col == 6 || r.col == 11));
+
+    // 白方冲四（一端被堵），黑方必须堵住唯一成五点
+    board.reset();
+    for (int c = 3; c <= 6; ++c) board.placePiece(3, c, W);
+    board.placePiece(3, 2, B);
+    board.placePiece(10, 10, B);
+    board.placePiece(12, 12, B);
+    r = engine.search(board, B, limits);
+    CHECK(r.row == 3 && r.col == 7);
+}
+
+void testParallel() {
+    Board board;
+    playMoves(board, "h8i9h9h10i8g8j7");
+    MctsEngine engine(16);
+    MctsLimits limits;
+    limits.timeMs = 300;
+    limits.threads = 4;
+
+    const MctsResult r = engine.search(board, W, limits);
+    CHECK(r.row >= 0 && r.col >= 0);
+    CHECK(board.getPiece(r.row, r.col) == Config::PieceType::None);
+    CHECK(r.playouts > 0 && r.playoutsPerSec > 0);
+    CHECK(r.winRate >= 0.0 && r.winRate <= 1.0);
+    CHECK(r.nodes > 1 && r.nodes <= engine.nodeCapacity());
+    CHECK(r.peakMemoryBytes >= r.nodes * 16 && r.peakMemoryBytes % r.nodes == 0);
+    CHECK(r.timeMs < 1000);
+
+    // 重复搜索复用同一节点池，结果同样合法
+    const MctsResult again = engine.search(board, W, limits);
+    CHECK(again.row >= 0 && board.getPiece(again.row, again.col) == Config::PieceType::None);
+    CHECK(again.nodes <= engine.nodeCapacity());
+}
+
+void testArenaExhaustion() {
+    Board board;
+    playMoves(board, "h8i9h9h10i8");
+    MctsEngine engine(0);   // 最小节点池（1024个节点），很快耗尽
+    MctsLimits limits;
+    limits.timeMs = 0;
+    limits.maxPlayouts = 20000;
+    limits.threads = 2;
+
+    const MctsResult r = engine.search(board, W, limits);
+    CHECK(r.playouts >= 20000);
+    CHECK(r.nodes == engine.nodeCapacity());
+    CHECK(r.row >= 0 && board.getPiece(r.row, r.col) == Config::PieceType::None);
+}
+
+void testEmptyBoardAndStop() {
+    MctsEngine engine(16);
+    Board board;
+    MctsLimits limits;
+    const MctsResult first = engine.search(board, B, limits);
+    CHECK(first.row == Config::BOARD_SIZE / 2 && first.col == Config::BOARD_SIZE / 2);
+
+    playMoves(board, "h8i9");
+    limits.timeMs = 0;   // 不限时，只能由stop()终止
+    limits.threads = 2;
+    std::thread stopper([&engine]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        engine.stop();
+    });
+    const MctsResult r = engine.search(board, B, limits);
+    stopper.join();
+    CHECK(r.row >= 0 && r.playouts > 0);
+}
+
+} // namespace
+
+int main() {
+    testTactics();
+    testParallel();
+    testArenaExhaustion();
+    testEmptyBoardAndStop();
+    return testResult("MctsEngineTest");
+}
@@ -0,0 +1,428 @@
+﻿/**
+ * @brief 棋盘与引擎热路径微基准（输出 JSON，用于逐提交跟踪性能回退）
+ * 语料：固定随机种子生成的对局片段（在已有棋子附近随机落子、不成五，10~60子）与 SearchBench 的 6 个中盘局面，
+ * 每次运行完全相同。各项目在语料上反复执行，直到累计耗时不少于给定毫秒数，报告 ns/op 与 op/s：
+ * - placePiece：从空盘逐手落子（含每局开头的 reset）；
+ * - checkWin：对局面上每枚棋子判定是否成五；
+ * - makeUnmake / makeUnmakeRenju：对每个候选点 makeMove + unmakeMove（连珠含禁手增量维护）；
+ * - evaluateFull：BoardEval 整盘估值（当前CPU最优指令集）；
+ * - nnueEvaluate / nnueAddRemove：神经网络估值（固定种子随机权重，当前CPU最优指令集）与累加器增量更新（落子+撤销一次）；
+ * - candidateMoves / threatOrderedMoves：着法生成；
+ * - perft / perftRenju：固定深度全展开的叶子数（成五处截止），报告节点数与 nodes/s；
+ * - searchFixedDepth：单线程困难AI固定深度搜索的节点数与 nodes/s。
+ * perft 与固定深度搜索的节点数是确定值，与基线不同说明走子生成或搜索行为变了（而不只是变快或变慢）。
+ * 用法：MicroBench [--min-ms 每项最少毫秒数，默认300] [--out JSON文件，默认标准输出]
+ *                  [--baseline 基线JSON] [--tolerance 允许变慢的百分比，默认10]
+ * 指定基线时逐项打印相对变化到标准错误，任一项 ns/op 变慢超过容差或确定性节点数改变时返回1。
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "TestCommon.h"
+#include "ai/Nnue.h"
+#include "ai/SearchEngine.h"
+#include "game/BoardEval.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+constexpr int GAME_COUNT = 128;
+constexpr unsigned CORPUS_SEED = 20260310;
+constexpr int PERFT_DEPTH = 3;
+constexpr int SEARCH_DEPTH = 6;
+constexpr uint32_t NNUE_SEED = 20261016;
+const char* const NNUE_PATH = "MicroBench.nnue";
+
+using RenjuBoard = BasicBoard<N, Rule::Renju>;
+
+/**
+ * @brief 中盘局面（与 SearchBench 相同），用于 perft 与固定深度搜索
+ */
+const char* const POSITIONS[] = {
+    "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11",
+    "j5j11h7g9i10g8k9h11f9f6h9f8g11i5f5j9",
+    "k7j6e6g5k8e8f11h8e9f6g7j8i6e5j10h9",
+    "e9g9j5i6j10k6g8h8f9e8j8i8k5e5f7i11",
+    "e10k9i9i8e7h11i11k6h9f10g10j10j6e11i6f6",
+    "h11g10j10i11j9f10h10g11k9f7e9h7i5h8h5i10",
+};
+
+/**
+ * @brief 防止编译器把被测调用优化掉
+ */
+uint64_t g_sink = 0;
+
+/**
+ * @brief 生成对局片段语料：每手在候选点中随机选一个不成五的点，黑先交替
+ */
+std::vector<std::vector<int>> makeGames() {
+    std::mt19937 rng(CORPUS_SEED);
+    std::vector<std::vector<int>> games(GAME_COUNT);
+    int candidates[N * N];
+    for (std::vector<int>& game : games) {
+        Board board;
+        const int stones = 10 + static_cast<int>(rng() % 51);
+        Config::PieceType side = Config::PieceType::Black;
+        while (static_cast<int>(game.size()) < stones) {
+            const int count = board.candidateMoves(candidates, side);
+            const int cell = candidates[rng() % count];
+            board.makeMove(cell / N, cell % N, side);
+            if (board.checkWin(cell / N, cell % N, side)) {
+                board.unmakeMove();
+                continue;
+            }
+            game.push_back(cell);
+            side = Config::opponent(side);
+        }
+    }
+    return games;
+}
+
+template <typename BoardT>
+std::vector<BoardT> makePositions(const std::vector<std::vector<int>>& games) {
+    std::vector<BoardT> positions(games.size());
+    for (size_t i = 0; i < games.size(); ++i) {
+        Config::PieceType side = Config::PieceType::Black;
+        for (int cell : games[i]) {
+            positions[i].makeMove(cell / N, cell % N, side);
+            side = Config::opponent(side);
+        }
+    }
+    return positions;
+}
+
+Config::PieceType sideToMove(int stones) {
+    return stones % 2 == 0 ? Config::PieceType::Black : Config::PieceType::White;
+}
+
+/**
+ * @brief 一项基准的结果；nodes>0 表示该项有确定性节点数
+ */
+struct BenchResult {
+    std::string name;
+    uint64_t ops = 0;
+    int passes = 0;
+    double seconds = 0.0;
+    uint64_t nodes = 0;
+
+    double nsPerOp() const { return ops > 0 ? seconds * 1e9 / ops : 0.0; }
+    double opsPerSec() const { return seconds > 0 ? ops / seconds : 0.0; }
+};
+
+/**
+ * @brief 反复执行一遍语料（pass 返回本遍的操作数），直到累计耗时不少于minMs
+ * @param warmup 是否先不计时地执行一遍（单遍本身就很长的项目不需要）
+ */
+BenchResult runBench(const char* name, int minMs, const std::function<uint64_t()>& pass, bool warmup = true) {
+    BenchResult result;
+    result.name = name;
+    if (warmup) {
+        pass();  // 填充缓存、触发惰性初始化
+    }
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        result.ops += pass();
+        ++result.passes;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (result.seconds * 1000.0 < minMs);
+    return result;
+}
+
+template <typename BoardT>
+uint64_t perft(BoardT& board, Config::PieceType side, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+    int moves[N * N];
+    const int count = board.candidateMoves(moves, side);
+    uint64_t nodes = 0;
+    for (int i = 0; i < count; ++i) {
+        const int row = moves[i] / N;
+        const int col = moves[i] % N;
+        board.makeMove(row, col, side);
+        nodes += board.checkWin(row, col, side) ? 1 : perft(board, Config::opponent(side), depth - 1);
+        board.unmakeMove();
+    }
+    return nodes;
+}
+
+/**
+ * @brief perft 基准：每遍对全部中盘局面做一次固定深度展开，操作数即叶子数（每遍相同）
+ */
+template <typename BoardT>
+BenchResult perftBench(const char* name, int minMs) {
+    std::vector<BoardT> boards(sizeof(POSITIONS) / sizeof(POSITIONS[0]));
+    for (size_t i = 0; i < boards.size(); ++i) {
+        playMoves(boards[i], POSITIONS[i]);
+    }
+    BenchResult result = runBench(name, minMs, [&]() {
+        uint64_t nodes = 0;
+        for (BoardT& board : boards) {
+            nodes += perft(board, sideToMove(board.stoneCount()), PERFT_DEPTH);
+        }
+        return nodes;
+    }, false);
+    result.nodes = result.ops / result.passes;
+    return result;
+}
+
+/**
+ * @brief 固定深度搜索基准：每个局面清空置换表后单线程搜到 SEARCH_DEPTH，节点数为确定值
+ */
+BenchResult searchBench(int minMs) {
+    SearchEngine engine(16);
+    engine.setThreadCount(1);
+    std::vector<Board> boards(sizeof(POSITIONS) / sizeof(POSITIONS[0]));
+    for (size_t i = 0; i < boards.size(); ++i) {
+        playMoves(boards[i], POSITIONS[i]);
+    }
+    auto pass = [&]() {
+        uint64_t nodes = 0;
+        for (const Board& board : boards) {
+            engine.clear();
+            SearchLimits limits;
+            limits.timeMs = 0;
+            limits.maxDepth = SEARCH_DEPTH;
+            nodes += engine.search(board, sideToMove(board.stoneCount()), limits).nodes;
+        }
+        return nodes;
+    };
+    BenchResult result = runBench("searchFixedDepth", minMs, pass);
+    result.nodes = result.ops / result.passes;
+    return result;
+}
+
+std::string toJson(const std::vector<BenchResult>& results, int minMs) {
+    std::string json = "{\n  \"benchmark\": \"MicroBench\",\n  \"board_size\": " + std::to_string(N)
+        + ",\n  \"isa\": \"" + BoardEval::isaName(BoardEval::bestIsa()) + "\",\n  \"min_ms\": " + std::to_string(minMs)
+        + ",\n  \"perft_depth\": " + std::to_string(PERFT_DEPTH) + ",\n  \"search_depth\": " + std::to_string(SEARCH_DEPTH)
+        + ",\n  \"results\": [\n";
+    char line[256];
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        // 每项一行，便于 --baseline 按行解析与文本 diff
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f, \"nodes\": %llu}%s\n",
+                      r.name.c_str(), static_cast<unsigned long long>(r.ops), r.nsPerOp(), r.opsPerSec(),
+                      static_cast<unsigned long long>(r.nodes), i + 1 < results.size() ? "," : "");
+        json += line;
+    }
+    json += "  ],\n  \"checksum\": " + std::to_string(g_sink) + "\n}\n";
+    return json;
+}
+
+/**
+ * @brief 读取基线 JSON（本程序输出的格式，每项一行）
+ */
+bool loadBaseline(const char* path, std::vector<BenchResult>& baseline) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        char name[64];
+        unsigned long long ops = 0, nodes = 0;
+        double nsPerOp = 0.0, opsPerSec = 0.0;
+        const size_t brace = line.find('{');
+        if (brace == std::string::npos
+            || std::sscanf(line.c_str() + brace,
+                           "{\"name\": \"%63[^\"]\", \"ops\": %llu, \"ns_per_op\": %lf, \"ops_per_sec\": %lf, \"nodes\": %llu}",
+                           name, &ops, &nsPerOp, &opsPerSec, &nodes) != 5) {
+            continue;
+        }
+        BenchResult r;
+        r.name = name;
+        r.ops = ops;
+        r.seconds = nsPerOp * ops / 1e9;
+        r.nodes = nodes;
+        baseline.push_back(r);
+    }
+    return !baseline.empty();
+}
+
+/**
+ * @brief 与基线逐项比较
+ * @return bool 是否存在回退（ns/op 变慢超过容差，或确定性节点数改变）
+ */
+bool compareBaseline(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline, double tolerance) {
+    bool regressed = false;
+    for (const BenchResult& r : results) {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&](const BenchResult& b) { return b.name == r.name; });
+        if (it == baseline.end() || it->nsPerOp() <= 0.0) {
+            std::fprintf(stderr, "%-20s (no baseline)\n", r.name.c_str());
+            continue;
+        }
+        const double change = (r.nsPerOp() / it->nsPerOp() - 1.0) * 100.0;
+        const bool slower = change > tolerance;
+        const bool nodesChanged = r.nodes != it->nodes;
+        std::fprintf(stderr, "%-20s %10.3f -> %10.3f ns/op  %+6.1f%%%s%s\n", r.name.c_str(), it->nsPerOp(), r.nsPerOp(), change,
+                     slower ? "  REGRESSION" : "", nodesChanged ? "  NODE COUNT CHANGED" : "");
+        regressed = regressed || slower || nodesChanged;
+    }
+    return regressed;
+}
+
+void printUsage() {
+    std::printf("用法：MicroBench [--min-ms 每项最少毫秒数] [--out JSON文件] [--baseline 基线JSON] [--tolerance 百分比]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int minMs = 300;
+    const char* outputPath = nullptr;
+    const char* baselinePath = nullptr;
+    double tolerance = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--min-ms") == 0 && hasValue) {
+            minMs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+            tolerance = std::atof(argv[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const std::vector<std::vector<int>> games = makeGames();
+    const std::vector<Board> positions = makePositions<Board>(games);
+    std::vector<Board> mutablePositions = positions;
+    std::vector<RenjuBoard> renjuPositions = makePositions<RenjuBoard>(games);
+    std::vector<BenchResult> results;
+    int moves[N * N];
+
+    Board scratch;
+    results.push_back(runBench("placePiece", minMs, [&]() {
+        uint64_t ops = 0;
+        for (const std::vector<int>& game : games) {
+            scratch.reset();
+            Config::PieceType side = Config::PieceType::Black;
+            for (int cell : game) {
+                g_sink += scratch.placePiece(cell / N, cell % N, side);
+                side = Config::opponent(side);
+            }
+            ops += game.size();
+        }
+        return ops;
+    }));
+
+    results.push_back(runBench("checkWin", minMs, [&]() {
+        uint64_t ops = 0;
+        for (size_t i = 0; i < games.size(); ++i) {
+            Config::PieceType side = Config::PieceType::Black;
+            for (int cell : games[i]) {
+                g_sink += mutablePositions[i].checkWin(cell / N, cell % N, side);
+                side = Config::opponent(side);
+            }
+            ops += games[i].size();
+        }
+        return ops;
+    }));
+
+    auto makeUnmake = [&](auto& boards) {
+        uint64_t ops = 0;
+        for (auto& board : boards) {
+            const Config::PieceType side = sideToMove(board.stoneCount());
+            const int count = board.candidateMoves(moves, side);
+            for (int i = 0; i < count; ++i) {
+                board.makeMove(moves[i] / N, moves[i] % N, side);
+                g_sink += board.unmakeMove();
+            }
+            ops += count;
+        }
+        return ops;
+    };
+    results.push_back(runBench("makeUnmake", minMs, [&]() { return makeUnmake(mutablePositions); }));
+    results.push_back(runBench("makeUnmakeRenju", minMs, [&]() { return makeUnmake(renjuPositions); }));
+
+    results.push_back(runBench("evaluateFull", minMs, [&]() {
+        for (const Board& board : positions) {
+            g_sink += static_cast<uint64_t>(BoardEval::evaluate(board));
+        }
+        return static_cast<uint64_t>(positions.size());
+    }));
+
+    NnueNetwork network;
+    if (NnueWeights::random(N, NNUE_SEED).write(NNUE_PATH) && network.load(NNUE_PATH)) {
+        std::vector<NnueAccumulator> accumulators(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            accumulators[i].refresh(network, positions[i]);
+        }
+        results.push_back(runBench("nnueEvaluate", minMs, [&]() {
+            for (size_t i = 0; i < positions.size(); ++i) {
+                g_sink += static_cast<uint64_t>(network.evaluate(accumulators[i], sideToMove(positions[i].stoneCount())));
+            }
+            return static_cast<uint64_t>(positions.size());
+        }));
+        results.push_back(runBench("nnueAddRemove", minMs, [&]() {
+            uint64_t ops = 0;
+            for (size_t i = 0; i < positions.size(); ++i) {
+                const Config::PieceType side = sideToMove(positions[i].stoneCount());
+                const int count = positions[i].candidateMoves(moves, side);
+                for (int j = 0; j < count; ++j) {
+                    accumulators[i].addStone(network, moves[j], side);
+                    accumulators[i].removeStone(network, moves[j], side);
+                }
+                g_sink += static_cast<uint64_t>(accumulators[i].values[0][0]);
+                ops += count;
+            }
+            return ops;
+        }));
+        network.unload();
+    } else {
+        std::fprintf(stderr, "无法写出或映射 %s，跳过神经网络估值项目\n", NNUE_PATH);
+    }
+    std::remove(NNUE_PATH);
+
+    results.push_back(runBench("candidateMoves", minMs, [&]() {
+        for (const Board& board : positions) {
+            g_sink += board.candidateMoves(moves, sideToMove(board.stoneCount()));
+        }
+        return static_cast<uint64_t>(positions.size());
+    }));
+
+    results.push_back(runBench("threatOrderedMoves", minMs, [&]() {
+        for (const Board& board : positions) {
+            g_sink += board.threatOrderedMoves(sideToMove(board.stoneCount()), moves);
+        }
+        return static_cast<uint64_t>(positions.size());
+    }));
+
+    results.push_back(perftBench<Board>("perft", minMs));
+    results.push_back(perftBench<RenjuBoard>("perftRenju", minMs));
+    results.push_back(searchBench(minMs));
+
+    const std::string json = toJson(results, minMs);
+    if (outputPath) {
+        std::ofstream out(outputPath);
+        if (!out || !(out << json)) {
+            std::fprintf(stderr, "无法写出：%s\n", outputPath);
+            return 1;
+        }
+    } else {
+        std::fputs(json.c_str(), stdout);
+    }
+
+    if (baselinePath) {
+        std::vector<BenchResult> baseline;
+        if (!loadBaseline(baselinePath, baseline)) {
+            std::fprintf(stderr, "无法读取基线：%s\n", baselinePath);
+            return 1;
+        }
+        return compareBaseline(results, baseline, tolerance) ? 1 : 0;
+    }
+    return 0;
+}
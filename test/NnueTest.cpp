@@ -0,0 +1,365 @@
+﻿/**
+ * @brief 神经网络估值单元测试（权重文件、增量累加器、SIMD 一致性、搜索接入与训练）
+ * 测试内容：
+ * 1. 权重文件：写出后映射加载成功，文件头、大小不符或文件不存在时拒绝加载；
+ * 2. 增量累加器：15x15 与 19x19 上逐手 addStone / removeStone 的结果与按棋盘 refresh 逐位一致；
+ * 3. 指令集：AVX2（CPU支持时）、SSE2 与标量的估值完全相同；
+ * 4. 搜索接入：棋盘大小不符的网络被拒绝，1层搜索的得分等于最佳着法之后的网络估值，多线程搜索返回合法着法；
+ * 5. 训练：样本提取（行棋方视角与结果），解析梯度与数值差分一致、多线程与单线程一致，训练降低损失，
+ *    量化后网络的估值与浮点网络一致（误差在量化精度内）。
+ */
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "TestCommon.h"
+#include "ai/SearchEngine.h"
+#include "tuning/NnueTrainer.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+const char* const NET_PATH = "NnueTest.nnue";
+const char* const NET19_PATH = "NnueTest19.nnue";
+constexpr uint32_t SEED = 20261016;
+
+bool sameAccumulator(const NnueAccumulator& a, const NnueAccumulator& b) {
+    for (int p = 0; p < 2; ++p) {
+        for (int i = 0; i < Nnue::ACCUMULATOR_SIZE; ++i) {
+            if (a.values[p][i] != b.values[p][i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 在候选点中随机落子（不判胜负），返回落子数
+ */
+template <int N>
+int randomMoves(BasicBoard<N>& board, std::mt19937& rng, int count) {
+    int moves[N * N];
+    Config::PieceType side = B;
+    int played = 0;
+    for (; played < count; ++played) {
+        const int n = board.candidateMoves(moves, side);
+        if (n == 0) {
+            break;
+        }
+        const int cell = moves[rng() % n];
+        board.makeMove(cell / N, cell % N, side);
+        side = Config::opponent(side);
+    }
+    return played;
+}
+
+void testFileFormat() {
+    const int N = Config::BOARD_SIZE;
+    CHECK(NnueWeights::random(N, SEED).write(NET_PATH));
+    NnueNetwork network;
+    CHECK(network.load(NET_PATH));
+    CHECK(network.isLoaded() && network.boardSize() == N);
+    {
+        std::ifstream in(NET_PATH, std::ios::binary | std::ios::ate);
+        CHECK(static_cast<int64_t>(in.tellg()) == NnueNetwork::fileSize(N));
+    }
+    network.unload();
+    CHECK(!network.isLoaded() && network.boardSize() == 0);
+    CHECK(!network.load("NnueTest.missing"));
+
+    // 截断的文件、错误的魔数与版本都被拒绝
+    std::vector<char> bytes(static_cast<size_t>(NnueNetwork::fileSize(N)));
+    {
+        std::ifstream in(NET_PATH, std::ios::binary);
+        in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    auto writeBytes = [](const std::vector<char>& data, size_t size) {
+        std::ofstream out(NET_PATH, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(size));
+    };
+    writeBytes(bytes, bytes.size() - 1);
+    CHECK(!network.load(NET_PATH) && !network.isLoaded());
+    std::vector<char> corrupted = bytes;
+    corrupted[0] = 'X';
+    writeBytes(corrupted, corrupted.size());
+    CHECK(!network.load(NET_PATH));
+    corrupted = bytes;
+    corrupted[4] = static_cast<char>(NnueNetwork::FORMAT_VERSION + 1);
+    writeBytes(corrupted, corrupted.size());
+    CHECK(!network.load(NET_PATH));
+    writeBytes(bytes, bytes.size());
+    CHECK(network.load(NET_PATH));
+
+    CHECK(NnueWeights::random(Config::LARGE_BOARD_SIZE, SEED).write(NET19_PATH));
+    NnueNetwork large;
+    CHECK(large.load(NET19_PATH) && large.boardSize() == Config::LARGE_BOARD_SIZE);
+}
+
+template <int N>
+void testIncremental(const char* path) {
+    CHECK(NnueWeights::random(N, SEED + N).write(path));
+    NnueNetwork network;
+    CHECK(network.load(path));
+    if (!network.isLoaded()) {
+        return;
+    }
+    std::mt19937 rng(SEED);
+    for (int game = 0; game < 8; ++game) {
+        BasicBoard<N> board;
+        NnueAccumulator incremental;
+        incremental.refresh(network, board);
+        NnueAccumulator expected;
+        int moves[N * N];
+        std::vector<int> played;
+        Config::PieceType side = B;
+        for (int ply = 0; ply < 40; ++ply) {
+            const int count = board.candidateMoves(moves, side);
+            const int cell = moves[rng() % count];
+            board.makeMove(cell / N, cell % N, side);
+            incremental.addStone(network, cell, side);
+            played.push_back(cell);
+            expected.refresh(network, board);
+            CHECK(sameAccumulator(incremental, expected));
+            side = Config::opponent(side);
+        }
+        while (!played.empty()) {
+            board.unmakeMove();
+            side = Config::opponent(side);
+            incremental.removeStone(network, played.back(), side);
+            played.pop_back();
+        }
+        expected.refresh(network, board);
+        CHECK(sameAccumulator(incremental, expected));
+    }
+}
+
+void testIsaAgreement() {
+    NnueNetwork network;
+    CHECK(network.load(NET_PATH));
+    if (!network.isLoaded()) {
+        return;
+    }
+    std::mt19937 rng(SEED);
+    int nonZero = 0;
+    for (int i = 0; i < 200; ++i) {
+        Board board;
+        randomMoves(board, rng, static_cast<int>(rng() % 60));
+        NnueAccumulator accumulator;
+        accumulator.refresh(network, board);
+        for (const Config::PieceType side : { B, W }) {
+            const int scalar = network.evaluate(accumulator, side, BoardEval::Isa::Scalar);
+            CHECK(network.evaluate(accumulator, side, BoardEval::Isa::SSE2) == scalar);
+            if (BoardEval::isSupported(BoardEval::Isa::AVX2)) {
+                CHECK(network.evaluate(accumulator, side, BoardEval::Isa::AVX2) == scalar);
+            }
+            CHECK(network.evaluate(accumulator, side) == scalar);
+            nonZero += scalar != 0 ? 1 : 0;
+        }
+    }
+    CHECK(nonZero > 200);   // 随机权重的输出不是平凡的常数
+}
+
+void testSearch() {
+    NnueNetwork network;
+    NnueNetwork large;
+    CHECK(network.load(NET_PATH) && large.load(NET19_PATH));
+    NnueNetwork empty;
+
+    SearchEngine engine(4);
+    CHECK(!engine.setNetwork(&large));
+    CHECK(!engine.setNetwork(&empty));
+    CHECK(engine.network() == nullptr);
+    CHECK(engine.setNetwork(&network) && engine.network() == &network);
+
+    // 1层搜索：得分等于最佳着法之后对方视角网络估值的相反数
+    Board board;
+    board.makeMove(7, 7, B);
+    board.makeMove(7, 8, W);
+    board.makeMove(8, 8, B);
+    SearchLimits limits;
+    limits.maxDepth = 1;
+    limits.timeMs = 0;
+    SearchResult result = engine.search(board, W, limits);
+    CHECK(result.depth == 1 && !result.pv.empty());
+    if (!result.pv.empty()) {
+        Board child = board;
+        CHECK(child.makeMove(result.pv[0] / Config::BOARD_SIZE, result.pv[0] % Config::BOARD_SIZE, W));
+        NnueAccumulator accumulator;
+        accumulator.refresh(network, child);
+        CHECK(result.score == -network.evaluate(accumulator, B));
+    }
+
+    // 恢复棋型估值后得分回到棋型估值
+    CHECK(engine.setNetwork(nullptr) && engine.network() == nullptr);
+    result = engine.search(board, W, limits);
+    if (!result.pv.empty()) {
+        Board child = board;
+        child.makeMove(result.pv[0] / Config::BOARD_SIZE, result.pv[0] % Config::BOARD_SIZE, W);
+        CHECK(result.score == -child.evaluate(B));
+    }
+
+    // 多线程：先设线程数或先设网络，辅助线程都使用网络估值
+    engine.setThreadCount(2);
+    CHECK(engine.setNetwork(&network));
+    engine.setThreadCount(3);
+    limits.maxDepth = 64;
+    limits.timeMs = 200;
+    result = engine.search(board, W, limits);
+    CHECK(result.row >= 0 && board.getPiece(result.row, result.col) == Config::PieceType::None);
+
+    // 会话接口：尺寸不符拒绝，成五着法不受估值方式影响
+    std::unique_ptr<GameSession> session = GameSession::create(Config::BOARD_SIZE);
+    CHECK(!session->setNetwork(&large));
+    CHECK(session->setNetwork(&network));
+    for (int col = 3; col < 7; ++col) {
+        session->makeMove(5, col, B);
+        session->makeMove(10, col + 5, W);
+    }
+    limits.timeMs = 500;
+    result = session->search(B, limits);
+    CHECK(result.row == 5 && (result.col == 2 || result.col == 7));
+}
+
+/**
+ * @brief 随机局面样本：结果由“上半盘己方棋子多于对方”决定（网络可以学到的简单规律）
+ */
+std::vector<NnueSample> syntheticSamples(int count, unsigned seed) {
+    const int N = Config::BOARD_SIZE;
+    std::mt19937 rng(seed);
+    std::unique_ptr<GameSession> session = GameSession::create(N);
+    std::vector<NnueSample> samples;
+    samples.reserve(count);
+    while (static_cast<int>(samples.size()) < count) {
+        session->reset();
+        const int stones = 4 + static_cast<int>(rng() % 24);
+        Config::PieceType side = B;
+        int balance = 0;
+        for (int i = 0; i < stones; ++i) {
+            const int cell = static_cast<int>(rng() % (N * N));
+            if (session->makeMove(cell / N, cell % N, side)) {
+                balance += cell / N < N / 2 ? (side == B ? 1 : -1) : 0;
+                side = Config::opponent(side);
+            }
+        }
+        NnueSample sample = makeNnueSample(*session, side);
+        const int own = side == B ? balance : -balance;
+        sample.result = own > 0 ? 1.0f : (own < 0 ? 0.0f : 0.5f);
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+void testSampleExtraction() {
+    const int N = Config::BOARD_SIZE;
+    std::unique_ptr<GameSession> session = GameSession::create(N);
+    TuningGame game;
+    CHECK(parseGameRecord("h8h9i8i9j8j9k8k9l8a15", N, game));
+    std::vector<NnueSample> samples;
+    const int count = extractNnueSamples(*session, game, 0, samples);
+    std::vector<TuningPosition> positions;
+    CHECK(count > 0 && count == extractPositions(*session, game, 0, positions));
+    if (count < 2) {
+        return;
+    }
+    CHECK(samples[0].features.empty() && samples[0].result == 1.0f);        // 黑方行棋，黑胜
+    CHECK(samples[1].features.size() == 1 && samples[1].result == 0.0f);    // 白方行棋，黑子在对方平面
+    CHECK(samples[1].features[0] == N * N + game.moves[0]);
+    for (int i = 0; i < count; ++i) {
+        CHECK(static_cast<int>(samples[i].features.size()) == i);
+    }
+
+    CHECK(parseGameRecord("h8i9h10h8 0-1", N, game));
+    CHECK(extractNnueSamples(*session, game, 0, samples) == -1);
+    CHECK(static_cast<int>(samples.size()) == count);
+}
+
+void testTrainer() {
+    const int N = Config::BOARD_SIZE;
+    const std::vector<NnueSample> samples = syntheticSamples(4096, 3);
+
+    // 解析梯度与数值差分一致（取各层若干参数）
+    const NnueFloatNetwork initial(N, 5);
+    std::vector<float> gradient;
+    const double loss = nnueLoss(initial, samples, 1, &gradient);
+    CHECK(loss > 0.0 && gradient.size() == initial.parameterCount());
+    const size_t last = initial.parameterCount() - 1;
+    const int feature = samples[0].features.empty() ? 0 : samples[0].features[0];
+    const size_t probes[] = { last, last - 3, last - Nnue::HIDDEN_SIZE - 2,
+                              static_cast<size_t>(Nnue::INPUT_PLANES * N * N * Nnue::ACCUMULATOR_SIZE + 7),
+                              static_cast<size_t>(feature * Nnue::ACCUMULATOR_SIZE + 1) };
+    for (const size_t index : probes) {
+        const float h = 1e-3f;
+        NnueFloatNetwork plus = initial;
+        NnueFloatNetwork minus = initial;
+        plus.parameters()[index] += h;
+        minus.parameters()[index] -= h;
+        const double numeric = (nnueLoss(plus, samples, 1) - nnueLoss(minus, samples, 1)) / (2.0 * h);
+        CHECK(std::fabs(numeric - gradient[index]) < 1e-4 + 0.05 * std::fabs(gradient[index]));
+    }
+
+    std::vector<float> threaded;
+    const double threadedLoss = nnueLoss(initial, samples, 4, &threaded);
+    CHECK(std::fabs(threadedLoss - loss) < 1e-9);
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < gradient.size(); ++i) {
+        maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(threaded[i] - gradient[i])));
+    }
+    CHECK(maxDiff < 1e-6);
+
+    // 训练降低损失
+    NnueTrainerOptions options;
+    options.threads = 2;
+    options.epochs = 8;
+    options.batchSize = 256;
+    options.learningRate = 3e-3;
+    options.seed = 5;
+    int epochs = 0;
+    const NnueFloatNetwork trained = trainNnue(samples, N, options, [&](int epoch, double) { CHECK(epoch == ++epochs); });
+    CHECK(epochs == options.epochs);
+    const double trainedLoss = nnueLoss(trained, samples, 2);
+    CHECK(trainedLoss < loss - 0.05);
+
+    // 量化后的整数网络与浮点网络输出一致（误差在量化精度内）
+    const int32_t outputScale = 1000;
+    CHECK(trained.quantize(outputScale).write(NET_PATH));
+    NnueNetwork network;
+    CHECK(network.load(NET_PATH));
+    if (!network.isLoaded()) {
+        return;
+    }
+    double maxError = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        const NnueSample& sample = samples[i];
+        const Config::PieceType side = sample.features.size() % 2 == 0 ? B : W;
+        NnueAccumulator accumulator;
+        std::copy(network.featureBias(), network.featureBias() + Nnue::ACCUMULATOR_SIZE, accumulator.values[0]);
+        std::copy(network.featureBias(), network.featureBias() + Nnue::ACCUMULATOR_SIZE, accumulator.values[1]);
+        for (const uint16_t f : sample.features) {
+            accumulator.addStone(network, f % (N * N), f < N * N ? side : Config::opponent(side));
+        }
+        const double logit = static_cast<double>(network.evaluate(accumulator, side)) / outputScale;
+        maxError = std::max(maxError, std::fabs(logit - trained.forward(sample)));
+    }
+    CHECK(maxError < 0.25);     // 训练后 logit 分布在 ±5 左右，量化误差约为其 2%
+}
+
+} // namespace
+
+int main() {
+    testFileFormat();
+    testIncremental<Config::BOARD_SIZE>(NET_PATH);
+    testIncremental<Config::LARGE_BOARD_SIZE>(NET19_PATH);
+    NnueWeights::random(Config::BOARD_SIZE, SEED).write(NET_PATH);
+    NnueWeights::random(Config::LARGE_BOARD_SIZE, SEED).write(NET19_PATH);
+    testIsaAgreement();
+    testSearch();
+    testSampleExtraction();
+    testTrainer();
+    std::remove(NET_PATH);
+    std::remove(NET19_PATH);
+    return testResult("NnueTest");
+}
@@ -0,0 +1,153 @@
+﻿/**
+ * @brief OpeningBook 单元测试
+ * 测试内容：
+ * 1. 对称变换：变换与逆变换互逆，8种对称变换下的局面规范化键相同，不同局面的键不同；
+ * 2. 建库与查询：写出文件后映射加载，对称等价局面查到的着法按同一变换对应，统计数据正确合并；
+ * 3. 最佳着法按平滑得分率选择，最少对局数过滤生效，库外局面查询为空；
+ * 4. 损坏文件（魔数错误、大小不符）与不存在的文件加载失败。
+ */
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "TestCommon.h"
+#include "ai/OpeningBook.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+constexpr int N = Config::BOARD_SIZE;
+const char* const BOOK_PATH = "OpeningBookTest.book";
+
+/**
+ * @brief 把“列字母+行号”坐标串解析为格子下标序列（黑先），如 "h8i9h9"
+ */
+std::vector<int> parseMoves(const std::string& moves) {
+    std::vector<int> cells;
+    size_t i = 0;
+    while (i < moves.size()) {
+        const int col = moves[i++] - 'a';
+        int row = 0;
+        while (i < moves.size() && moves[i] >= '0' && moves[i] <= '9') {
+            row = row * 10 + (moves[i++] - '0');
+        }
+        cells.push_back((row - 1) * N + col);
+    }
+    return cells;
+}
+
+/**
+ * @brief 按对称变换s落下着法序列
+ */
+Board playTransformed(const std::vector<int>& cells, int symmetry) {
+    Board board;
+    Config::PieceType side = B;
+    for (int cell : cells) {
+        const int t = OpeningBook::transformCell(cell, symmetry);
+        board.placePiece(t / N, t % N, side);
+        side = Config::opponent(side);
+    }
+    return board;
+}
+
+void testSymmetry() {
+    for (int s = 0; s < OpeningBook::SYMMETRY_COUNT; ++s) {
+        for (int cell = 0; cell < N * N; ++cell) {
+            CHECK(OpeningBook::inverseTransformCell(OpeningBook::transformCell(cell, s), s) == cell);
+        }
+    }
+
+    const std::vector<int> cells = parseMoves("h8i9h9h10i8g8j7");
+    const uint64_t key = OpeningBook::canonicalKey(playTransformed(cells, 0));
+    for (int s = 1; s < OpeningBook::SYMMETRY_COUNT; ++s) {
+        CHECK(OpeningBook::canonicalKey(playTransformed(cells, s)) == key);
+    }
+    CHECK(OpeningBook::canonicalKey(playTransformed(parseMoves("h8i9h9h10i8g8j8"), 0)) != key);
+
+    // 天元单子局面8种变换全部对称
+    uint8_t mask = 0;
+    OpeningBook::canonicalKey(playTransformed(parseMoves("h8"), 0), &mask);
+    CHECK(mask == 0xFF);
+}
+
+void testBuildAndProbe() {
+    OpeningBookBuilder builder(6);
+    // 同一开局的两个对称版本各记一局黑胜，另一个应手记两局白胜
+    const std::vector<int> main = parseMoves("h8i9h9h10i8g8j7");
+    std::vector<int> mirrored;
+    for (int cell : main) {
+        mirrored.push_back(OpeningBook::transformCell(cell, 5));
+    }
+    CHECK(builder.addGame(main.data(), static_cast<int>(main.size()), 1));
+    CHECK(builder.addGame(mirrored.data(), static_cast<int>(mirrored.size()), 1));
+    const std::vector<int> other = parseMoves("h8i9h9h10j10");
+    CHECK(builder.addGame(other.data(), static_cast<int>(other.size()), -1));
+    CHECK(builder.addGame(other.data(), static_cast<int>(other.size()), -1));
+    const std::vector<int> illegal = parseMoves("h8h8");
+    CHECK(!builder.addGame(illegal.data(), static_cast<int>(illegal.size()), 0));
+    CHECK(builder.write(BOOK_PATH));
+
+    OpeningBook book;
+    CHECK(book.load(BOOK_PATH));
+    CHECK(book.isLoaded() && book.entryCount() == builder.entryCount());
+
+    // 黑方第5手：库内有 i8（2局黑胜）与 j10（2局白胜），任一对称变换下都能查到并正确换算
+    for (int s = 0; s < OpeningBook::SYMMETRY_COUNT; ++s) {
+        const Board board = playTransformed(parseMoves("h8i9h9h10"), s);
+        BookMove moves[8];
+        const int count = book.probe(board, moves, 8);
+        CHECK(count == 2);
+        BookMove best;
+        CHECK(book.bestMove(board, best));
+        const int expected = OpeningBook::transformCell(parseMoves("i8")[0], s);
+        CHECK(best.row * N + best.col == expected);
+        CHECK(best.games == 2 && best.score == 1.0);
+        CHECK(!book.bestMove(board, best, 3));
+    }
+
+    // 空棋盘：天元5局（含非法对局中合法的第一手）全部合并到一个条目
+    BookMove moves[8];
+    CHECK(book.probe(Board(), moves, 8) == 1);
+    CHECK(moves[0].row == 7 && moves[0].col == 7 && moves[0].games == 5 && moves[0].score == 0.5);
+
+    // 超出收录深度（第7手）与库外局面
+    CHECK(book.probe(playTransformed(parseMoves("h8i9h9h10i8g8"), 0), moves, 8) == 0);
+    CHECK(book.probe(playTransformed(parseMoves("a1"), 0), moves, 8) == 0);
+
+    book.unload();
+    CHECK(!book.isLoaded() && book.probe(Board(), moves, 8) == 0);
+}
+
+void testCorruptFiles() {
+    OpeningBook book;
+    CHECK(!book.load("OpeningBookTest.missing"));
+
+    std::string data;
+    {
+        std::ifstream in(BOOK_PATH, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    CHECK(data.size() > sizeof(OpeningBook::Header));
+
+    std::string truncated = data.substr(0, data.size() - 1);
+    std::ofstream(BOOK_PATH, std::ios::binary | std::ios::trunc) << truncated;
+    CHECK(!book.load(BOOK_PATH));
+
+    std::string badMagic = data;
+    badMagic[0] = 'X';
+    std::ofstream(BOOK_PATH, std::ios::binary | std::ios::trunc) << badMagic;
+    CHECK(!book.load(BOOK_PATH));
+    CHECK(!book.isLoaded());
+
+    std::remove(BOOK_PATH);
+}
+
+} // namespace
+
+int main() {
+    testSymmetry();
+    testBuildAndProbe();
+    testCorruptFiles();
+    return testResult("OpeningBookTest");
+}
@@ -0,0 +1,294 @@
+﻿/**
+ * @brief PatternTable 单元测试（构建期生成的棋型表 vs 慢速参考分类器）
+ * 测试内容：
+ * 1. 成五/冲四/活四判定：全部65536种窗口编码、全部规则、双方逐一与参考分类器比对；
+ * 2. 全部棋型：随机抽样窗口编码与参考分类器比对（参考分类器递归展开，代价较高）；
+ * 3. 估值字段与PATTERN_SCORE一致，典型棋型（活三、眠三、长连、Caro两端被堵）符合各规则的定义；
+ * 4. Renju黑方禁手标记（长连、同线四四）：全部窗口编码与参考实现比对，其他规则标记位恒为0；
+ * 5. Board按模板参数选表：不同规则的特化对同一局面给出各自的成五与胜负判定。
+ * 参考分类器直接在9格数组上按定义递归计算，不使用编码顺序、位运算或任何查找表。
+ */
+#include <random>
+#include <string>
+#include "TestCommon.h"
+#include "game/Board.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+const Rule RULES[RULE_COUNT] = { Rule::Freestyle, Rule::Standard, Rule::Renju, Rule::Caro };
+
+/**
+ * @brief 9格线段：下标4为中心，0~3为偏移-4~-1，5~8为偏移+1~+4；取值同PatternCode（0空/1黑/2白/3边界）
+ */
+struct Line {
+    int cells[9];
+};
+
+Line decode(uint16_t code) {
+    Line line{};
+    for (int offset = -4; offset <= 4; ++offset) {
+        if (offset != 0) {
+            line.cells[offset + 4] = (code >> (PatternCode::slotOf(offset) * 2)) & 3;
+        }
+    }
+    return line;
+}
+
+/**
+ * @brief 中心为own方时经过中心的连子范围[left, right]
+ */
+void refRun(const Line& line, int own, int& left, int& right) {
+    left = 4;
+    while (left > 0 && line.cells[left - 1] == own) --left;
+    right = 4;
+    while (right < 8 && line.cells[right + 1] == own) ++right;
+}
+
+/**
+ * @brief 中心为own方时是否经过中心成五（按rule：恰好五连 / Caro两端都被对方堵住不算）
+ */
+bool refFive(const Line& line, int own, Rule rule) {
+    int left = 0, right = 0;
+    refRun(line, own, left, right);
+    const int len = right - left + 1;
+    if (requiresExactFive(rule, own == PatternCode::BLACK ? B : W)) {
+        return len == 5;
+    }
+    const int opp = own == PatternCode::BLACK ? PatternCode::WHITE : PatternCode::BLACK;
+    const bool blocked = left > 0 && right < 8 && line.cells[left - 1] == opp && line.cells[right + 1] == opp;
+    return len >= 5 && !(rule == Rule::Caro && blocked);
+}
+
+/**
+ * @brief 慢速参考分类器：按棋型定义递归
+ * Five：中心成五；否则数出“再下一手可成五”的空格：≥2为活四，1为冲四；
+ * 否则看再下一手能否成活四/冲四（活三/眠三），再否则看能否成活三/眠三（活二/眠二）。
+ */
+PatternType refClassify(Line line, int own, Rule rule) {
+    if (refFive(line, own, rule)) {
+        return PatternType::Five;
+    }
+    int fives = 0;
+    bool openFour = false, four = false, openThree = false, three = false;
+    for (int i = 0; i < 9; ++i) {
+        if (i == 4 || line.cells[i] != PatternCode::EMPTY) {
+            continue;
+        }
+        line.cells[i] = own;
+        if (refFive(line, own, rule)) {
+            ++fives;
+        } else if (fives == 0) {
+            const PatternType next = refClassify(line, own, rule);
+            openFour |= next == PatternType::OpenFour;
+            four |= next == PatternType::Four;
+            openThree |= next == PatternType::OpenThree;
+            three |= next == PatternType::Three;
+        }
+        line.cells[i] = PatternCode::EMPTY;
+    }
+    if (fives >= 2) return PatternType::OpenFour;
+    if (fives == 1) return PatternType::Four;
+    if (openFour) return PatternType::OpenThree;
+    if (four) return PatternType::Three;
+    if (openThree) return PatternType::OpenTwo;
+    if (three) return PatternType::Two;
+    return PatternType::None;
+}
+
+/**
+ * @brief 仅计算成五/冲四/活四层级（其余归为None），用于全量比对
+ */
+PatternType refFourLevel(Line line, int own, Rule rule) {
+    if (refFive(line, own, rule)) {
+        return PatternType::Five;
+    }
+    int fives = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (i != 4 && line.cells[i] == PatternCode::EMPTY) {
+            line.cells[i] = own;
+            fives += refFive(line, own, rule);
+            line.cells[i] = PatternCode::EMPTY;
+        }
+    }
+    return fives >= 2 ? PatternType::OpenFour : (fives == 1 ? PatternType::Four : PatternType::None);
+}
+
+PatternType fourLevel(PatternType type) {
+    return type >= PatternType::Four ? type : PatternType::None;
+}
+
+/**
+ * @brief 由形如 "..XX*X..." 的9字符串构造编码：'*'为中心，'X'黑，'O'白，'#'边界，其余为空
+ */
+uint16_t codeOf(const std::string& s) {
+    uint16_t code = 0;
+    for (int offset = -4; offset <= 4; ++offset) {
+        const char ch = s[offset + 4];
+        const uint16_t v = ch == 'X' ? PatternCode::BLACK : ch == 'O' ? PatternCode::WHITE
+                         : ch == '#' ? PatternCode::EDGE : PatternCode::EMPTY;
+        if (offset != 0) {
+            code = static_cast<uint16_t>(code | (v << (PatternCode::slotOf(offset) * 2)));
+        }
+    }
+    return code;
+}
+
+void testExhaustiveFours() {
+    for (Rule rule : RULES) {
+        const PatternTable& table = PatternTable::get(rule);
+        bool match = true;
+        for (int code = 0; code < PatternCode::TABLE_SIZE && match; ++code) {
+            const Line line = decode(static_cast<uint16_t>(code));
+            match &= fourLevel(table.lookup(code, B)) == refFourLevel(line, PatternCode::BLACK, rule);
+            match &= fourLevel(table.lookup(code, W)) == refFourLevel(line, PatternCode::WHITE, rule);
+            match &= table.score(code) == PATTERN_SCORE[static_cast<int>(table.lookup(code, B))]
+                                        - PATTERN_SCORE[static_cast<int>(table.lookup(code, W))];
+        }
+        CHECK(match);
+    }
+}
+
+void testSampledAllTypes() {
+    std::mt19937 rng(13);
+    for (Rule rule : RULES) {
+        const PatternTable& table = PatternTable::get(rule);
+        int mismatches = 0;
+        for (int i = 0; i < 3000; ++i) {
+            // 偏向己方棋子较多的窗口，覆盖二、三、四各级棋型
+            uint16_t code = 0;
+            for (int slot = 0; slot < 8; ++slot) {
+                const unsigned r = rng() % 10;
+                const uint16_t v = r < 4 ? PatternCode::EMPTY : r < 7 ? PatternCode::BLACK
+                                 : r < 9 ? PatternCode::WHITE : PatternCode::EDGE;
+                code = static_cast<uint16_t>(code | (v << (slot * 2)));
+            }
+            const Line line = decode(code);
+            mismatches += table.lookup(code, B) != refClassify(line, PatternCode::BLACK, rule);
+            mismatches += table.lookup(code, W) != refClassify(line, PatternCode::WHITE, rule);
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+void testKnownShapes() {
+    const PatternTable& free = PatternTable::get(Rule::Freestyle);
+    const PatternTable& standard = PatternTable::get(Rule::Standard);
+    const PatternTable& renju = PatternTable::get(Rule::Renju);
+    const PatternTable& caro = PatternTable::get(Rule::Caro);
+
+    CHECK(free.lookup(codeOf("...X*X..."), B) == PatternType::OpenThree);
+    CHECK(free.lookup(codeOf("..OX*X..."), B) == PatternType::Three);
+    CHECK(free.lookup(codeOf("..XX*X..."), B) == PatternType::OpenFour);
+    CHECK(free.lookup(codeOf("#XXX*...."), B) == PatternType::Four);
+    CHECK(free.lookup(codeOf("...O*O..."), W) == PatternType::OpenThree);
+    CHECK(free.lookup(codeOf("....*...."), B) == PatternType::None);
+
+    // 长连：无禁手为成五，标准规则双方均不算，连珠规则仅白方算
+    CHECK(free.lookup(codeOf(".XXX*XX.."), B) == PatternType::Five);
+    CHECK(standard.lookup(codeOf(".XXX*XX.."), B) != PatternType::Five);
+    CHECK(standard.lookup(codeOf(".OOO*OO.."), W) != PatternType::Five);
+    CHECK(renju.lookup(codeOf(".XXX*XX.."), B) != PatternType::Five);
+    CHECK(renju.lookup(codeOf(".OOO*OO.."), W) == PatternType::Five);
+    // 恰好五连时，补一子会形成长连的一侧不算成五点：X X X X * _ X → 只有左侧成五点
+    CHECK(standard.lookup(codeOf("..XX*X.X."), B) == PatternType::Four);
+    CHECK(free.lookup(codeOf("..XX*X.X."), B) == PatternType::OpenFour);
+
+    // Caro：两端都被对方堵住的五连不算，一端为空、为边界或在窗口外都算
+    CHECK(caro.lookup(codeOf(".OXX*XXO."), B) != PatternType::Five);
+    CHECK(caro.lookup(codeOf(".XOO*OOX."), W) != PatternType::Five);
+    CHECK(caro.lookup(codeOf(".OXX*XX.."), B) == PatternType::Five);
+    CHECK(caro.lookup(codeOf("##XX*XXO."), B) == PatternType::Five);
+    CHECK(caro.lookup(codeOf("XXXX*O..."), B) == PatternType::Five);
+    CHECK(caro.lookup(codeOf("OXXX*XXO."), B) != PatternType::Five);
+    CHECK(caro.lookup(codeOf("OXXX*XX.."), B) == PatternType::Five);
+    // 两端被堵的连五不是成五点，.OXX*X.O. 补哪一格都成不了五
+    CHECK(caro.lookup(codeOf(".OXX*X.O."), B) == PatternType::None);
+}
+
+/**
+ * @brief 参考实现：中心落黑子后这一条线上的禁手标记（长连 / 同线四四）
+ */
+uint32_t refForbiddenFlags(Line line) {
+    const int own = PatternCode::BLACK;
+    if (refFive(line, own, Rule::Renju)) {
+        return 0;
+    }
+    int left = 0, right = 0;
+    refRun(line, own, left, right);
+    if (right - left + 1 >= 6) {
+        return PatternTable::OVERLINE_FLAG;
+    }
+    int fivePoints[8];
+    int fives = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (i != 4 && line.cells[i] == PatternCode::EMPTY) {
+            line.cells[i] = own;
+            if (refFive(line, own, Rule::Renju)) {
+                fivePoints[fives++] = i;
+            }
+            line.cells[i] = PatternCode::EMPTY;
+        }
+    }
+    // 活四：连续四子，成五点恰为两端
+    const bool straight = fives == 2 && right - left + 1 == 4 && fivePoints[0] == left - 1 && fivePoints[1] == right + 1;
+    return fives >= 2 && !straight ? PatternTable::LINE_DOUBLE_FOUR_FLAG : 0;
+}
+
+void testForbiddenFlags() {
+    constexpr uint32_t FLAGS = PatternTable::OVERLINE_FLAG | PatternTable::LINE_DOUBLE_FOUR_FLAG;
+    const PatternTable& renju = PatternTable::get(Rule::Renju);
+    int mismatches = 0;
+    int overlines = 0, doubleFours = 0;
+    for (int code = 0; code < PatternCode::TABLE_SIZE; ++code) {
+        const uint32_t flags = renju.entries[code] & FLAGS;
+        mismatches += flags != refForbiddenFlags(decode(static_cast<uint16_t>(code)));
+        overlines += (flags & PatternTable::OVERLINE_FLAG) != 0;
+        doubleFours += (flags & PatternTable::LINE_DOUBLE_FOUR_FLAG) != 0;
+        for (Rule rule : { Rule::Freestyle, Rule::Standard, Rule::Caro }) {
+            mismatches += (PatternTable::get(rule).entries[code] & FLAGS) != 0;
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(overlines > 0 && doubleFours > 0);
+
+    CHECK(renju.entries[codeOf(".X.X*X.X.")] & PatternTable::LINE_DOUBLE_FOUR_FLAG);
+    CHECK(renju.entries[codeOf("XX.X*.XX.")] & PatternTable::LINE_DOUBLE_FOUR_FLAG);
+    CHECK(!(renju.entries[codeOf("..XX*X...")] & FLAGS));
+    CHECK(renju.entries[codeOf(".XXX*XX..")] & PatternTable::OVERLINE_FLAG);
+    CHECK(!(renju.entries[codeOf(".XXX*X...")] & FLAGS));
+}
+
+static_assert(Board::rule() == Rule::Freestyle, "Board defaults to freestyle");
+static_assert(BasicBoard<Config::BOARD_SIZE, Rule::Renju>::rule() == Rule::Renju, "rule is a template parameter");
+
+void testBoardRules() {
+    BasicBoard<Config::BOARD_SIZE, Rule::Standard> board;
+    Board free;
+    // 黑方 c8 d8 e8 f8 _ h8 i8：落g8成长连
+    for (int c : { 2, 3, 4, 5, 7, 8 }) {
+        board.placePiece(7, c, B);
+        free.placePiece(7, c, B);
+    }
+    board.placePiece(0, 0, W);
+    free.placePiece(0, 0, W);
+    CHECK(board.pattern(7, 6, 0, B) != PatternType::Five);
+    CHECK(free.pattern(7, 6, 0, B) == PatternType::Five);
+    CHECK(free.threatCount(B, PatternType::Five) > 0);
+    board.placePiece(7, 6, B);
+    free.placePiece(7, 6, B);
+    CHECK(!board.checkWin(7, 6, B));
+    CHECK(free.checkWin(7, 6, B));
+}
+
+} // namespace
+
+int main() {
+    testExhaustiveFours();
+    testSampledAllTypes();
+    testKnownShapes();
+    testForbiddenFlags();
+    testBoardRules();
+    return testResult("PatternTableTest");
+}
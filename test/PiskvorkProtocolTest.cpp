@@ -0,0 +1,127 @@
+﻿/**
+ * @brief PiskvorkProtocol 单元测试（Gomocup 文本协议引擎端）
+ * 测试内容：
+ * 1. 握手：START/RECTSTART 支持与不支持的尺寸、ABOUT、未知命令、START 之前的落子命令；
+ * 2. 对局：BEGIN 先手、TURN 应对（成五、堵四）、BOARD 摆子（按子数判定本方颜色）、TAKEBACK、RESTART；
+ * 3. INFO：时间参数推算每步预算，rule=4（连珠）下不走黑方禁手点，对局中途改规则重放已有着法；
+ * 4. END 结束 run() 循环，后续输入不再处理。
+ */
+#include <sstream>
+#include <string>
+#include <vector>
+#include "TestCommon.h"
+#include "protocol/PiskvorkProtocol.h"
+
+namespace {
+
+/**
+ * @brief 收集应答行（跳过 MESSAGE/DEBUG 信息行）
+ */
+std::vector<std::string> replies(const std::ostringstream& out) {
+    std::vector<std::string> lines;
+    std::istringstream in(out.str());
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("MESSAGE", 0) != 0 && line.rfind("DEBUG", 0) != 0) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+/**
+ * @brief 依次发送命令，返回最后一条应答
+ */
+std::string send(PiskvorkProtocol& protocol, std::ostringstream& out, const std::vector<std::string>& commands) {
+    out.str("");
+    for (const std::string& command : commands) {
+        protocol.handleLine(command);
+    }
+    const std::vector<std::string> lines = replies(out);
+    return lines.empty() ? std::string() : lines.back();
+}
+
+void testHandshake() {
+    std::ostringstream out;
+    PiskvorkProtocol protocol(out);
+    CHECK(send(protocol, out, { "TURN 7,7" }).rfind("ERROR", 0) == 0);
+    CHECK(send(protocol, out, { "START 20" }).rfind("ERROR", 0) == 0);
+    CHECK(send(protocol, out, { "RECTSTART 15,19" }).rfind("ERROR", 0) == 0);
+    CHECK(send(protocol, out, { "START 15\r" }) == "OK");
+    CHECK(send(protocol, out, { "RECTSTART 19,19" }) == "OK");
+    CHECK(send(protocol, out, { "about" }).find("name=") == 0);
+    CHECK(send(protocol, out, { "SUGGEST" }) == "UNKNOWN SUGGEST");
+    CHECK(protocol.handleLine("INFO max_memory 83886080"));
+    CHECK(!protocol.handleLine("END"));
+}
+
+void testGame() {
+    std::ostringstream out;
+    PiskvorkProtocol protocol(out);
+    send(protocol, out, { "INFO timeout_turn 200", "START 15" });
+    CHECK(send(protocol, out, { "BEGIN" }) == "7,7");
+
+    // 对方先手：堵住对方的冲四（x=3..6, y=7，另一端已被本方占住）
+    CHECK(send(protocol, out, { "RESTART" }) == "OK");
+    CHECK(send(protocol, out, { "BOARD", "2,7,1", "3,7,2", "4,7,2", "5,7,2", "6,7,2", "0,0,1", "DONE" }) == "7,7");
+
+    // 本方成五优先于堵对方
+    const std::string five = send(protocol, out, { "BOARD", "3,3,1", "3,4,1", "3,5,1", "3,6,1", "9,9,2", "9,10,2", "9,11,2",
+                                                   "9,12,2", "1,1,2", "DONE" });
+    CHECK(five == "3,2" || five == "3,7");
+
+    // TURN：对方落子后应答一个空点；逐手撤销回到空盘，空盘再撤销报错
+    CHECK(send(protocol, out, { "RESTART" }) == "OK");
+    const std::string first = send(protocol, out, { "TURN 7,7" });
+    CHECK(!first.empty() && first != "7,7" && first.rfind("ERROR", 0) != 0);
+    CHECK(send(protocol, out, { "TURN 7,7" }).rfind("ERROR", 0) == 0); // 已有棋子
+    CHECK(send(protocol, out, { "TAKEBACK " + first }) == "OK");
+    CHECK(send(protocol, out, { "TAKEBACK 7,7" }) == "OK");
+    CHECK(send(protocol, out, { "TAKEBACK 7,7" }).rfind("ERROR", 0) == 0);
+}
+
+void testInfo() {
+    std::ostringstream out;
+    PiskvorkProtocol protocol(out);
+    send(protocol, out, { "INFO timeout_turn 5000", "INFO timeout_match 0", "INFO time_left 2147483647" });
+    CHECK(protocol.moveBudgetMs() > 4000 && protocol.moveBudgetMs() < 5000);
+    send(protocol, out, { "INFO timeout_match 180000", "INFO time_left 30000" });
+    CHECK(protocol.moveBudgetMs() < 2000);
+    send(protocol, out, { "INFO timeout_turn 0", "INFO timeout_match 0" });
+    CHECK(protocol.moveBudgetMs() > 0 && protocol.moveBudgetMs() <= 100);
+
+    // 连珠：本方执黑（子数相同），(7,7) 是四四禁手，冲四点 (8,7)/(7,8) 合法
+    send(protocol, out, { "INFO timeout_turn 300", "INFO rule 4", "START 15" });
+    const std::vector<std::string> board = { "BOARD", "4,7,1", "5,7,1", "6,7,1", "7,4,1", "7,5,1", "7,6,1",
+                                             "3,7,2", "7,3,2", "12,12,2", "13,12,2", "12,13,2", "0,14,2", "DONE" };
+    const std::string renjuMove = send(protocol, out, board);
+    CHECK(!renjuMove.empty() && renjuMove != "7,7");
+
+    // 同一局面在无禁手规则下 (7,7) 双四取胜
+    send(protocol, out, { "INFO rule 0" });
+    CHECK(send(protocol, out, board) == "7,7");
+
+    // 对局中途改规则：以新规则重建会话并重放已有着法，撤销与占用检查照常
+    send(protocol, out, { "INFO rule 4" });
+    CHECK(send(protocol, out, { "TAKEBACK 7,7" }) == "OK");
+    CHECK(send(protocol, out, { "TURN 3,7" }).rfind("ERROR", 0) == 0);
+}
+
+void testRunStopsAtEnd() {
+    std::ostringstream out;
+    PiskvorkProtocol protocol(out);
+    std::istringstream in("START 15\nINFO timeout_turn 100\nEND\nBEGIN\n");
+    CHECK(protocol.run(in) == 0);
+    const std::vector<std::string> lines = replies(out);
+    CHECK(lines.size() == 1 && lines[0] == "OK");
+}
+
+} // namespace
+
+int main() {
+    testHandshake();
+    testGame();
+    testInfo();
+    testRunStopsAtEnd();
+    return testResult("PiskvorkProtocolTest");
+}
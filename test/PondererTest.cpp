@@ -0,0 +1,95 @@
+﻿/**
+ * @brief Ponderer 单元测试
+ * 测试内容：
+ * 1. 立即取消：后台思考开始后（包括刚启动、线程尚未进入搜索时）stop() 都能在极短时间内返回；
+ * 2. 反复启动/停止不会死锁或泄漏线程；
+ * 3. 复用：后台思考写入的置换表条目能被人类落子后的正式搜索命中，达到相同深度所需节点更少。
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "TestCommon.h"
+#include "ai/Ponderer.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+void testCancel() {
+    Board board;
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+    SearchEngine engine(8);
+    Ponderer ponderer(engine);
+
+    // 等到至少完成一轮迭代再停止（负载较高时固定的等待时间可能还不够完成第一轮）
+    std::atomic<int> iterations{0};
+    SearchLimits limits;
+    limits.timeMs = 60000;
+    limits.onIteration = [&](const SearchResult&) { ++iterations; };
+    ponderer.start(board, B, limits);
+    CHECK(waitFor([&]() { return iterations.load() > 0; }));
+    CHECK(ponderer.isRunning());
+    auto start = std::chrono::steady_clock::now();
+    const SearchResult r = ponderer.stop();
+    CHECK(elapsedMs(start) < 50);
+    CHECK(!ponderer.isRunning());
+    CHECK(r.depth >= 1 && r.row >= 0);
+
+    // 刚启动立即停止（覆盖线程尚未进入search()的竞态）
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        ponderer.start(board, i % 2 ? W : B, 60000);
+        ponderer.stop();
+    }
+    CHECK(elapsedMs(start) < 2000);
+
+    // 未在思考时stop()返回空结果
+    CHECK(ponderer.stop().row == -1);
+}
+
+void testReuse() {
+    // 白方刚落子，轮到黑方（人类）；后台思考黑方局面后，黑方落子，再由白方（AI）正式搜索
+    Board board;
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 8;
+
+    SearchEngine cold(16);
+    Board afterHuman = board;
+    SearchEngine probe(16);
+    SearchLimits quick;
+    quick.timeMs = 0;
+    quick.maxDepth = 6;    // 固定深度，预测着法不受机器负载影响
+    const SearchResult predicted = probe.search(board, B, quick);
+    afterHuman.placePiece(predicted.row, predicted.col, B);
+    const SearchResult coldResult = cold.search(afterHuman, W, limits);
+
+    // 后台思考到固定深度后自然结束（不按时间截断），置换表内容与机器负载无关，节点数可复现
+    SearchEngine warm(16);
+    Ponderer ponderer(warm);
+    SearchLimits ponderLimits;
+    ponderLimits.timeMs = 0;
+    ponderLimits.maxDepth = limits.maxDepth + 1;
+    ponderer.start(board, B, ponderLimits);
+    CHECK(waitFor([&]() { return !ponderer.isRunning(); }, 60000));
+    CHECK(ponderer.stop().depth == ponderLimits.maxDepth);
+    const SearchResult warmResult = warm.search(afterHuman, W, limits);
+
+    std::printf("nodes to depth %d: cold=%llu warm=%llu\n", limits.maxDepth,
+                static_cast<unsigned long long>(coldResult.nodes), static_cast<unsigned long long>(warmResult.nodes));
+    CHECK(warmResult.depth == coldResult.depth);
+    CHECK(warmResult.nodes < coldResult.nodes);
+}
+
+} // namespace
+
+int main() {
+    testCancel();
+    testReuse();
+    return testResult("PondererTest");
+}
@@ -0,0 +1,328 @@
+﻿/**
+ * @brief 规则变体单元测试（编译期规则策略：Freestyle / Standard / Renju / Caro）
+ * 测试内容：
+ * 1. Caro：两端都被对方棋子堵住的五连（含长连）不算胜，一端被堵或抵住棋盘边缘算胜；
+ * 2. Renju禁手：三三、四四、同线四四、长连为禁手，成五优先于禁手；白方任何情况都不是禁手；
+ *    增量禁手位排除假活三（含远处落子改变成活四点是否为禁手的情形），与完整判定逐格一致；
+ * 3. 禁手位增量维护：随机走子/退子后，与按当前棋子重新摆出的新棋盘逐格一致；
+ * 4. 引擎：Renju下SearchEngine/MctsEngine/ThreatSolver不会给黑方返回禁手点，
+ *    守方唯一的防点是禁手时VCF成立（同一局面在Freestyle下不成立）；
+ * 5. GameSession 按（尺寸, 规则）分派，isForbidden做范围与空点检查。
+ */
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "TestCommon.h"
+#include "ai/MctsEngine.h"
+#include "ai/SearchEngine.h"
+#include "ai/ThreatSolver.h"
+#include "game/GameSession.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+using RenjuBoard = BasicBoard<N, Rule::Renju>;
+using CaroBoard = BasicBoard<N, Rule::Caro>;
+
+template <typename BoardT>
+void place(BoardT& board, std::initializer_list<std::pair<int, int>> cells, Config::PieceType type) {
+    for (const auto& cell : cells) {
+        board.placePiece(cell.first, cell.second, type);
+    }
+}
+
+void testCaroWin() {
+    // 两端被堵：o x x x x x o
+    CaroBoard blocked;
+    place(blocked, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {7, 7} }, B);
+    place(blocked, { {7, 2}, {7, 8} }, W);
+    CHECK(!blocked.checkWin(7, 7, B));
+    BasicBoard<N, Rule::Freestyle> freestyle;
+    place(freestyle, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {7, 7} }, B);
+    place(freestyle, { {7, 2}, {7, 8} }, W);
+    CHECK(freestyle.checkWin(7, 7, B));
+
+    // 一端被堵
+    CaroBoard halfOpen;
+    place(halfOpen, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {7, 7} }, B);
+    place(halfOpen, { {7, 2} }, W);
+    CHECK(halfOpen.checkWin(7, 5, B));
+
+    // 棋盘边缘不算对方棋子
+    CaroBoard edge;
+    place(edge, { {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0} }, W);
+    place(edge, { {5, 0} }, B);
+    CHECK(edge.checkWin(4, 0, W));
+
+    // 长连：两端被堵不算，两端开放算
+    CaroBoard overline;
+    place(overline, { {3, 3}, {4, 4}, {5, 5}, {6, 6}, {7, 7}, {8, 8} }, B);
+    CHECK(overline.checkWin(5, 5, B));
+    place(overline, { {2, 2}, {9, 9} }, W);
+    CHECK(!overline.checkWin(5, 5, B));
+}
+
+void testRenjuForbidden() {
+    // 三三：横向与纵向各一个活三交汇于(7,7)
+    RenjuBoard doubleThree;
+    place(doubleThree, { {7, 5}, {7, 6}, {5, 7}, {6, 7} }, B);
+    CHECK(doubleThree.isForbidden(7, 7));
+    CHECK(!doubleThree.isForbidden(7, 7, W));
+    CHECK(!doubleThree.isForbidden(7, 4));
+
+    // 四四：横向与纵向各一个冲四
+    RenjuBoard doubleFour;
+    place(doubleFour, { {7, 4}, {7, 5}, {7, 6}, {4, 7}, {5, 7}, {6, 7} }, B);
+    place(doubleFour, { {7, 3}, {3, 7} }, W);
+    CHECK(doubleFour.isForbidden(7, 7));
+
+    // 同线四四：x . x * x . x
+    RenjuBoard lineFour;
+    place(lineFour, { {7, 4}, {7, 6}, {7, 8}, {7, 10} }, B);
+    CHECK(lineFour.isForbidden(7, 7));
+
+    // 长连
+    RenjuBoard overline;
+    place(overline, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {7, 8} }, B);
+    CHECK(overline.isForbidden(7, 7));
+    overline.placePiece(7, 7, B);
+    CHECK(!overline.checkWin(7, 7, B));
+
+    // 成五优先：横向成五，纵向同时长连
+    RenjuBoard five;
+    place(five, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {3, 7}, {4, 7}, {5, 7}, {6, 7}, {8, 7} }, B);
+    CHECK(!five.isForbidden(7, 7));
+    five.placePiece(7, 7, B);
+    CHECK(five.checkWin(7, 7, B));
+
+    // 同样的三三、四四、长连形状换成白方：白方没有禁手，长连算胜
+    RenjuBoard white;
+    place(white, { {7, 5}, {7, 6}, {5, 7}, {6, 7} }, W);
+    place(white, { {10, 3}, {10, 4}, {10, 5}, {10, 6}, {10, 8} }, W);
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            CHECK(!white.isForbidden(r, c, B) && !white.isForbidden(r, c, W));
+        }
+    }
+    white.placePiece(10, 7, W);
+    CHECK(white.checkWin(10, 7, W));
+
+    // 其他规则不维护禁手
+    BasicBoard<N, Rule::Standard> standard;
+    place(standard, { {7, 5}, {7, 6}, {5, 7}, {6, 7} }, B);
+    CHECK(!standard.isForbidden(7, 7));
+    CHECK(standard.playableRow(B, 7) == standard.candidateRow(7));
+}
+
+/**
+ * @brief 完整禁手判定与增量禁手位：假活三构成的三三不算禁手，两者逐格一致
+ */
+void testRenjuExact() {
+    RenjuBoard doubleThree;
+    place(doubleThree, { {7, 5}, {7, 6}, {5, 7}, {6, 7} }, B);
+    CHECK(doubleThree.isForbiddenExact(7, 7));
+    CHECK(!doubleThree.isForbiddenExact(7, 4));
+    CHECK(!doubleThree.isForbiddenExact(7, 6));     // 有子
+    CHECK(!doubleThree.isForbiddenExact(-1, 7));
+
+    RenjuBoard lineFour;
+    place(lineFour, { {7, 4}, {7, 6}, {7, 8}, {7, 10} }, B);
+    CHECK(lineFour.isForbiddenExact(7, 7));
+    RenjuBoard overline;
+    place(overline, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {7, 8} }, B);
+    CHECK(overline.isForbiddenExact(7, 7));
+    RenjuBoard five;
+    place(five, { {7, 3}, {7, 4}, {7, 5}, {7, 6}, {3, 7}, {4, 7}, {5, 7}, {6, 7}, {8, 7} }, B);
+    CHECK(!five.isForbiddenExact(7, 7));
+
+    // 假活三：横向三 (7,5)(7,6)(7,7) 被白(7,9)挡住一侧，唯一的成活四点(7,4)对黑方是四四禁手
+    // （横向活四 + 纵向 (8,4)(9,4)(10,4) 的冲四），因此(7,7)只有纵向一个真活三，不是禁手
+    RenjuBoard falseThree;
+    place(falseThree, { {7, 5}, {7, 6}, {5, 7}, {6, 7}, {8, 4}, {9, 4}, {10, 4} }, B);
+    place(falseThree, { {7, 9}, {11, 4} }, W);
+    CHECK(!falseThree.isForbiddenExact(7, 7));
+    CHECK(!falseThree.isForbidden(7, 7));           // 增量禁手位同样排除假活三
+    // 去掉使(7,4)成为禁手的冲四后，横向三恢复为真活三
+    RenjuBoard realThree;
+    place(realThree, { {7, 5}, {7, 6}, {5, 7}, {6, 7}, {8, 4}, {9, 4} }, B);
+    place(realThree, { {7, 9}, {11, 4} }, W);
+    CHECK(realThree.isForbiddenExact(7, 7));
+    CHECK(realThree.isForbidden(7, 7));
+    // 成活四点(7,4)是否为禁手随纵线上的落子改变：补上(10,4)后(7,7)重新变为假活三，撤回后恢复
+    realThree.makeMove(10, 4, B);
+    CHECK(!realThree.isForbidden(7, 7));
+    realThree.unmakeMove();
+    CHECK(realThree.isForbidden(7, 7));
+
+    // 窗口外第5格：横向补(7,3)实为长连而非成五，(7,7)只有纵向一个四，不是禁手；提走(7,2)后恢复为四四
+    RenjuBoard farStone;
+    place(farStone, { {7, 2}, {7, 4}, {7, 5}, {7, 6}, {4, 7}, {5, 7}, {6, 7} }, B);
+    place(farStone, { {7, 8}, {3, 7} }, W);
+    CHECK(!farStone.isForbiddenExact(7, 7));
+    CHECK(!farStone.isForbidden(7, 7));
+    farStone.removePiece(7, 2);
+    CHECK(farStone.isForbiddenExact(7, 7));
+    CHECK(farStone.isForbidden(7, 7));
+
+    // 白方与其他规则没有禁手
+    BasicBoard<N, Rule::Standard> standard;
+    place(standard, { {7, 5}, {7, 6}, {5, 7}, {6, 7} }, B);
+    CHECK(!standard.isForbiddenExact(7, 7));
+
+    // 随机局面（不含已成五的棋形）：增量禁手位与完整判定逐格一致
+    std::mt19937 rng(181);
+    int exactSeen = 0;
+    int mismatches = 0;
+    for (int game = 0; game < 40; ++game) {
+        RenjuBoard board;
+        for (int move = 0; move < 60; ++move) {
+            const int cell = static_cast<int>(rng() % (N * N));
+            const Config::PieceType side = move % 2 ? W : B;
+            if (board.makeMove(cell / N, cell % N, side) && board.checkWin(cell / N, cell % N, side)) {
+                board.unmakeMove();
+            }
+        }
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                const bool exact = board.isForbiddenExact(r, c);
+                exactSeen += exact;
+                mismatches += exact != board.isForbidden(r, c);
+            }
+        }
+    }
+    CHECK(exactSeen > 0);
+    CHECK(mismatches == 0);
+}
+
+/**
+ * @brief 增量禁手位与重新摆出的棋盘（rebuild路径）逐格比对
+ */
+void testIncrementalMask() {
+    std::mt19937 rng(18);
+    RenjuBoard board;
+    int mismatches = 0;
+    int forbiddenSeen = 0;
+    for (int step = 0; step < 6000; ++step) {
+        const int cell = static_cast<int>(rng() % (N * N));
+        if (board.moveCount() > 60 || (board.moveCount() > 0 && rng() % 3 == 0)) {
+            board.unmakeMove();
+        } else {
+            board.makeMove(cell / N, cell % N, rng() % 2 ? B : W);
+        }
+        if (step % 25 != 0) {
+            continue;
+        }
+        RenjuBoard fresh;
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                fresh.placePiece(r, c, board.getPiece(r, c));
+            }
+        }
+        for (int r = 0; r < N; ++r) {
+            mismatches += board.playableRow(B, r) != fresh.playableRow(B, r);
+            for (int c = 0; c < N; ++c) {
+                mismatches += board.isForbidden(r, c) != fresh.isForbidden(r, c);
+                forbiddenSeen += board.isForbidden(r, c);
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(forbiddenSeen > 0);
+    while (board.unmakeMove() >= 0) {
+    }
+    for (int r = 0; r < N; ++r) {
+        CHECK(board.playableRow(B, r) == 0);
+    }
+}
+
+void testEnginesAvoidForbidden() {
+    // (7,7)是黑方四四禁手，也是最“显眼”的着法；(7,8)等其他冲四点合法
+    RenjuBoard board;
+    place(board, { {7, 4}, {7, 5}, {7, 6}, {4, 7}, {5, 7}, {6, 7} }, B);
+    place(board, { {7, 3}, {3, 7}, {10, 10}, {11, 10} }, W);
+    CHECK(board.isForbidden(7, 7));
+
+    BasicSearchEngine<N, Rule::Renju> engine(4);
+    engine.setThreadCount(1);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 4;
+    const SearchResult result = engine.search(board, B, limits);
+    CHECK(result.row >= 0 && !board.isForbidden(result.row, result.col));
+
+    BasicMctsEngine<N, Rule::Renju> mcts(4);
+    MctsLimits mctsLimits;
+    mctsLimits.timeMs = 0;
+    mctsLimits.maxPlayouts = 2000;
+    const MctsResult mctsResult = mcts.search(board, B, mctsLimits);
+    CHECK(mctsResult.row >= 0 && !board.isForbidden(mctsResult.row, mctsResult.col));
+
+    BasicThreatSolver<N, Rule::Renju> solver(10);
+    const ThreatResult win = solver.findForcedWin(board, B);
+    CHECK(!win.found || !board.isForbidden(win.row, win.col));
+
+    // 白方活三被黑子挡住一端：白(7,8)冲四后唯一防点(7,7)是黑方四四禁手，VCF成立
+    RenjuBoard renju;
+    place(renju, { {4, 7}, {5, 7}, {6, 7}, {4, 4}, {5, 5}, {6, 6}, {7, 12} }, B);
+    place(renju, { {7, 9}, {7, 10}, {7, 11}, {0, 0}, {0, 14}, {14, 0}, {14, 14} }, W);
+    CHECK(renju.isForbidden(7, 7));
+    const ThreatResult vcf = solver.solveVCF(renju, W);
+    CHECK(vcf.found && vcf.row == 7 && vcf.col == 8);
+
+    BasicBoard<N, Rule::Freestyle> freestyle;
+    place(freestyle, { {4, 7}, {5, 7}, {6, 7}, {4, 4}, {5, 5}, {6, 6}, {7, 12} }, B);
+    place(freestyle, { {7, 9}, {7, 10}, {7, 11}, {0, 0}, {0, 14}, {14, 0}, {14, 14} }, W);
+    BasicThreatSolver<N> freeSolver(10);
+    CHECK(!freeSolver.solveVCF(freestyle, W).found);
+}
+
+void testSessionDispatch() {
+    const Rule rules[] = { Rule::Freestyle, Rule::Standard, Rule::Renju, Rule::Caro };
+    for (const int size : { Config::BOARD_SIZE, Config::LARGE_BOARD_SIZE }) {
+        for (const Rule rule : rules) {
+            const std::unique_ptr<GameSession> session = GameSession::create(size, rule);
+            CHECK(session && session->boardSize() == size && session->rule() == rule);
+        }
+    }
+
+    const std::unique_ptr<GameSession> renju = GameSession::create(Config::BOARD_SIZE, Rule::Renju);
+    const std::unique_ptr<GameSession> freestyle = GameSession::create(Config::BOARD_SIZE);
+    for (GameSession* session : { renju.get(), freestyle.get() }) {
+        session->placePiece(7, 5, B);
+        session->placePiece(7, 6, B);
+        session->placePiece(5, 7, B);
+        session->placePiece(6, 7, B);
+    }
+    CHECK(renju->isForbidden(7, 7, B));
+    CHECK(!renju->isForbidden(7, 7, W));
+    CHECK(!freestyle->isForbidden(7, 7, B));
+    CHECK(!renju->isForbidden(7, 6, B));
+    CHECK(!renju->isForbidden(-1, 7, B));
+    CHECK(!renju->isForbidden(7, N, B));
+
+    int blackMoves[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+    int whiteMoves[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+    const int blackCount = renju->candidateMoves(blackMoves, B);
+    const int whiteCount = renju->candidateMoves(whiteMoves, W);
+    CHECK(blackCount == whiteCount - 1);
+    for (int i = 0; i < blackCount; ++i) {
+        CHECK(blackMoves[i] != 7 * N + 7);
+    }
+}
+
+} // namespace
+
+int main() {
+    testCaroWin();
+    testRenjuForbidden();
+    testRenjuExact();
+    testIncrementalMask();
+    testEnginesAvoidForbidden();
+    testSessionDispatch();
+    return testResult("RuleTest");
+}
@@ -0,0 +1,75 @@
+﻿/**
+ * @brief SearchEngine 性能基准
+ * 对一组固定的中盘局面（16子、无冲四/活三的平稳局面）各搜索 1 秒，
+ * 输出每个局面的完成深度、节点数、耗时与 NPS，以及总 NPS 和各排序启发的截断占比，用于跨版本跟踪引擎性能。
+ * 完成深度是迭代加深的名义深度：搜索是选择性的（内部节点按层数截取着法、靠后的着法按LMR少搜），
+ * 不同版本的深度只有在剪枝参数相同时才可直接比较。
+ * 用法：SearchBench [每局面毫秒数，默认1000]
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "TestCommon.h"
+#include "ai/SearchEngine.h"
+
+namespace {
+
+/**
+ * @brief 基准局面：坐标串为“列字母+行号”交替落子（黑先），16子后轮到黑方
+ */
+const char* const POSITIONS[] = {
+    "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11",
+    "j5j11h7g9i10g8k9h11f9f6h9f8g11i5f5j9",
+    "g7e9i6h11e11j7k6k7i10h9g11j5f5g5f8k9",
+    "e9g9j5i6j10k6g8h8f9e8j8i8k5e5f7i11",
+    "j5g10e11i5i10g6g5f8f5k10g11k5i6i11e8k11",
+    "h11g10j10i11j9f10h10g11k9f7e9h7i5h8h5i10",
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int timeMs = argc > 1 ? std::atoi(argv[1]) : 1000;
+    SearchEngine engine(64);
+    uint64_t totalNodes = 0;
+    int64_t totalMs = 0;
+    MoveOrderingStats ordering;
+
+    std::printf("depth is the nominal iterative-deepening depth; the search is selective (ply-dependent width, late-move reductions)\n");
+    for (const char* moves : POSITIONS) {
+        Board board;
+        playMoves(board, moves);
+        engine.clear();
+
+        SearchLimits limits;
+        limits.timeMs = timeMs;
+        const SearchResult r = engine.search(board, Config::PieceType::Black, limits);
+        totalNodes += r.nodes;
+        totalMs += r.timeMs;
+        const MoveOrderingStats& st = engine.orderingStats();
+        ordering.cutoffs += st.cutoffs;
+        ordering.firstMoveCutoffs += st.firstMoveCutoffs;
+        ordering.ttMoveCutoffs += st.ttMoveCutoffs;
+        ordering.threatCutoffs += st.threatCutoffs;
+        ordering.killerCutoffs += st.killerCutoffs;
+        ordering.counterMoveCutoffs += st.counterMoveCutoffs;
+        ordering.historyCutoffs += st.historyCutoffs;
+        ordering.otherCutoffs += st.otherCutoffs;
+        std::printf("%-44s depth %2d  score %7d  nodes %9llu  time %5lld ms  nps %9llu\n",
+                    moves, r.depth, r.score, static_cast<unsigned long long>(r.nodes),
+                    static_cast<long long>(r.timeMs), static_cast<unsigned long long>(r.nps));
+    }
+
+    std::printf("total nodes %llu  time %lld ms  nps %llu\n",
+                static_cast<unsigned long long>(totalNodes), static_cast<long long>(totalMs),
+                static_cast<unsigned long long>(totalMs > 0 ? totalNodes * 1000 / static_cast<uint64_t>(totalMs) : 0));
+
+    const double cutoffs = ordering.cutoffs > 0 ? static_cast<double>(ordering.cutoffs) : 1.0;
+    std::printf("cutoffs %llu  first-move %.1f%%  tt %.1f%%  threat %.1f%%  killer %.1f%%  counter %.1f%%  history %.1f%%  other %.1f%%\n",
+                static_cast<unsigned long long>(ordering.cutoffs),
+                100.0 * ordering.firstMoveCutoffs / cutoffs, 100.0 * ordering.ttMoveCutoffs / cutoffs,
+                100.0 * ordering.threatCutoffs / cutoffs, 100.0 * ordering.killerCutoffs / cutoffs,
+                100.0 * ordering.counterMoveCutoffs / cutoffs, 100.0 * ordering.historyCutoffs / cutoffs,
+                100.0 * ordering.otherCutoffs / cutoffs);
+    return 0;
+}
@@ -0,0 +1,227 @@
+﻿/**
+ * @brief SearchEngine 单元测试
+ * 测试内容：
+ * 1. 战术正确性：能成五必成五、对方冲四必堵、活三转活四的必胜识别；
+ * 2. 预算控制：节点预算与时间预算内必定返回一步合法着法；
+ * 3. 空棋盘开局走天元；
+ * 4. 着法排序启发：杀手/反击着法/历史表的加分与更新，搜索后截断来源统计自洽；
+ * 5. Lazy SMP：多线程搜索的战术结果与单线程一致，固定深度搜索能完成目标深度，线程数可调整；
+ * 6. 搜索统计：启用时每轮迭代一条记录且节点数合计不超过总数，选择性深度、命中率、截断率与分支因子自洽，
+ *    进度回调带有截至该轮的统计，多线程时仍为主线程统计；编译期关闭时统计为空。
+ */
+#include <chrono>
+#include <string>
+#include "TestCommon.h"
+#include "ai/SearchEngine.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+void testTactics() {
+    SearchEngine engine(4);
+    SearchLimits limits;
+    limits.timeMs = 500;
+
+    // 黑方横向四连（h8~k8），白方随意，黑走应成五
+    Board board;
+    for (int c = 7; c <= 10; ++c) board.placePiece(7, c, B);
+    for (int c = 7; c <= 9; ++c) board.placePiece(9, c, W);
+    board.placePiece(0, 0, W);
+    SearchResult r = engine.search(board, B, limits);
+    CHECK(r.row == 7 && (r.col == 6 || r.col == 11));
+    CHECK(r.score > 0 && SearchEngine::isWinScore(r.score));
+
+    // 白方冲四（一端被堵），黑方无威胁，必须堵住唯一成五点
+    board.reset();
+    board.placePiece(3, 3, W);
+    board.placePiece(3, 4, W);
+    board.placePiece(3, 5, W);
+    board.placePiece(3, 6, W);
+    board.placePiece(3, 2, B);
+    board.placePiece(10, 10, B);
+    board.placePiece(12, 12, B);
+    r = engine.search(board, B, limits);
+    CHECK(r.row == 3 && r.col == 7);
+
+    // 黑方活三，白方无威胁：黑方必胜（活三→活四）
+    board.reset();
+    board.placePiece(7, 6, B);
+    board.placePiece(7, 7, B);
+    board.placePiece(7, 8, B);
+    board.placePiece(9, 9, W);
+    board.placePiece(10, 4, W);
+    r = engine.search(board, B, limits);
+    CHECK(r.score > 0 && SearchEngine::isWinScore(r.score));
+    CHECK(r.row == 7 && (r.col == 5 || r.col == 9));
+}
+
+void testBudgets() {
+    Board board;
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+
+    SearchEngine engine(8);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxNodes = 20000;
+    SearchResult r = engine.search(board, B, limits);
+    CHECK(r.nodes <= limits.maxNodes + 1024);
+    CHECK(r.row >= 0 && board.getPiece(r.row, r.col) == Config::PieceType::None);
+
+    limits.maxNodes = 0;
+    limits.timeMs = 100;
+    const auto start = std::chrono::steady_clock::now();
+    r = engine.search(board, B, limits);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    CHECK(elapsed < 200);
+    CHECK(r.depth >= 1);
+    CHECK(r.row >= 0 && board.getPiece(r.row, r.col) == Config::PieceType::None);
+    CHECK(!r.pv.empty() && r.pv.front() == r.row * Config::BOARD_SIZE + r.col);
+}
+
+void testEmptyBoard() {
+    Board board;
+    SearchEngine engine(1);
+    const SearchResult r = engine.search(board, B, SearchLimits());
+    CHECK(r.row == Config::BOARD_SIZE / 2 && r.col == Config::BOARD_SIZE / 2);
+}
+
+void testMoveOrdering() {
+    MoveOrdering ordering;
+    const int cell = 7 * Config::BOARD_SIZE + 7;
+    const int prev = 6 * Config::BOARD_SIZE + 6;
+    const int failed[] = { 8 * Config::BOARD_SIZE + 8 };
+    CHECK(ordering.bonus(B, 3, cell, prev) == 0);
+
+    ordering.updateQuietCutoff(B, 3, 4, cell, prev, failed, 1);
+    const int b = ordering.bonus(B, 3, cell, prev);
+    CHECK(b > MoveOrdering::KILLER_BONUS + MoveOrdering::COUNTER_MOVE_BONUS);
+    CHECK(ordering.bonus(B, 4, cell, -1) > 0 && ordering.bonus(B, 4, cell, -1) < MoveOrdering::COUNTER_MOVE_BONUS);
+    CHECK(ordering.bonus(B, 3, failed[0], prev) < 0);
+    CHECK(ordering.bonus(W, 4, cell, prev) == 0);
+
+    // 第二个杀手把原杀手挤到第二槽位
+    ordering.updateQuietCutoff(B, 3, 4, cell + 1, prev, nullptr, 0);
+    CHECK(ordering.bonus(B, 3, cell + 1, -1) >= MoveOrdering::KILLER_BONUS);
+    CHECK(ordering.bonus(B, 3, cell, -1) >= MoveOrdering::SECOND_KILLER_BONUS);
+    CHECK(ordering.bonus(B, 3, cell, -1) < MoveOrdering::KILLER_BONUS);
+
+    // 历史分有界
+    for (int i = 0; i < 1000; ++i) {
+        ordering.updateQuietCutoff(W, 10, 40, cell, -1, nullptr, 0);
+    }
+    CHECK(ordering.bonus(W, 11, cell, -1) <= MoveOrdering::HISTORY_MAX);
+
+    ordering.newSearch();
+    CHECK(ordering.bonus(B, 3, cell + 1, -1) < MoveOrdering::COUNTER_MOVE_BONUS);
+
+    // 搜索后各来源截断数之和等于截断总数
+    Board board;
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+    SearchEngine engine(8);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 8;
+    engine.search(board, B, limits);
+    const MoveOrderingStats& st = engine.orderingStats();
+    CHECK(st.cutoffs > 0);
+    CHECK(st.firstMoveCutoffs <= st.cutoffs);
+    CHECK(st.ttMoveCutoffs + st.threatCutoffs + st.killerCutoffs + st.counterMoveCutoffs
+          + st.historyCutoffs + st.otherCutoffs == st.cutoffs);
+    CHECK(st.killerCutoffs > 0);
+}
+
+void testLazySmp() {
+    SearchEngine engine(8);
+    engine.setThreadCount(4);
+    CHECK(engine.threadCount() == 4);
+
+    Board board;
+    board.placePiece(7, 6, B);
+    board.placePiece(7, 7, B);
+    board.placePiece(7, 8, B);
+    board.placePiece(9, 9, W);
+    board.placePiece(10, 4, W);
+    SearchLimits limits;
+    limits.timeMs = 500;
+    SearchResult r = engine.search(board, B, limits);
+    CHECK(r.score > 0 && SearchEngine::isWinScore(r.score));
+    CHECK(r.row == 7 && (r.col == 5 || r.col == 9));
+
+    board.reset();
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+    limits.timeMs = 0;
+    limits.maxDepth = 6;
+    r = engine.search(board, B, limits);
+    CHECK(r.depth == 6);
+    CHECK(r.row >= 0 && board.getPiece(r.row, r.col) == Config::PieceType::None);
+    CHECK(!r.pv.empty() && r.pv.front() == r.row * Config::BOARD_SIZE + r.col);
+
+    engine.setThreadCount(1);
+    CHECK(engine.threadCount() == 1);
+    engine.setThreadCount(0);
+    CHECK(engine.threadCount() >= 1);
+}
+
+void testSearchStats() {
+    Board board;
+    playMoves(board, "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11");
+    SearchEngine engine(8);
+    engine.setThreadCount(1);
+    SearchLimits limits;
+    limits.timeMs = 0;
+    limits.maxDepth = 6;
+    size_t reported = 0;
+    limits.onIteration = [&](const SearchResult& progress) {
+        if constexpr (SearchStats::ENABLED) {
+            CHECK(progress.stats.iterations.size() == ++reported);
+            CHECK(progress.stats.iterations.back().depth == progress.depth);
+        }
+    };
+    const SearchResult r = engine.search(board, B, limits);
+    const SearchStats& stats = r.stats;
+    if constexpr (!SearchStats::ENABLED) {
+        CHECK(stats.iterations.empty() && stats.ttProbes == 0 && stats.selDepth == 0);
+        return;
+    }
+
+    CHECK(r.depth == 6 && stats.iterations.size() == 6 && reported == 6);
+    uint64_t iterationNodes = 0;
+    for (size_t i = 0; i < stats.iterations.size(); ++i) {
+        const IterationStats& iteration = stats.iterations[i];
+        CHECK(iteration.depth == static_cast<int>(i) + 1);
+        CHECK(iteration.selDepth >= iteration.depth - 1 && iteration.timeMs >= 0 && iteration.nodes > 0);
+        iterationNodes += iteration.nodes;
+    }
+    CHECK(iterationNodes <= r.nodes);
+    CHECK(stats.iterations.back().score == r.score);
+    CHECK(stats.selDepth >= 5 && stats.selDepth == stats.iterations.back().selDepth);
+    CHECK(stats.ttProbes > 0 && stats.ttHits > 0 && stats.ttHits <= stats.ttProbes);
+    CHECK(stats.ttHitRate() > 0.0 && stats.ttHitRate() <= 1.0);
+    CHECK(stats.ttCollisions <= stats.ttProbes);
+    CHECK(stats.ttFillRate == engine.transpositionTable().fillRate());
+    CHECK(stats.cutoffs == engine.orderingStats().cutoffs && stats.firstMoveCutoffs <= stats.cutoffs);
+    CHECK(stats.firstMoveCutoffRate() > 0.0 && stats.firstMoveCutoffRate() <= 1.0);
+    CHECK(stats.branchingFactor() > 0.0);
+
+    // 多线程：辅助线程的结果可能替换最终结果，统计仍来自主线程
+    engine.setThreadCount(3);
+    limits.onIteration = nullptr;
+    const SearchResult smp = engine.search(board, B, limits);
+    CHECK(!smp.stats.iterations.empty() && smp.stats.ttProbes > 0);
+    CHECK(smp.stats.iterations.size() <= static_cast<size_t>(smp.depth));
+}
+
+} // namespace
+
+int main() {
+    testTactics();
+    testBudgets();
+    testEmptyBoard();
+    testMoveOrdering();
+    testLazySmp();
+    testSearchStats();
+    return testResult("SearchEngineTest");
+}
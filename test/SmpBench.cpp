@@ -0,0 +1,59 @@
+﻿/**
+ * @brief Lazy SMP 多线程加速比基准（time-to-depth）
+ * 对一组固定的平稳中盘局面，分别以 1/2/4/8/16 个线程搜索到固定深度（不限时），
+ * 每次搜索前清空置换表，输出各线程数下的总耗时、总节点数，以及相对单线程的加速比。
+ * 用法：SmpBench [目标深度，默认10] [最大线程数，默认16]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "TestCommon.h"
+#include "ai/SearchEngine.h"
+
+namespace {
+
+/**
+ * @brief 基准局面：坐标串为“列字母+行号”交替落子（黑先），16子后轮到黑方（均无VCF/VCT，必须完整搜索）
+ */
+const char* const POSITIONS[] = {
+    "h5h9k8j5k9j10h11f9g8j7g10k7i9f8i6g11",
+    "j5j11h7g9i10g8k9h11f9f6h9f8g11i5f5j9",
+    "e9g9j5i6j10k6g8h8f9e8j8i8k5e5f7i11",
+    "h11g10j10i11j9f10h10g11k9f7e9h7i5h8h5i10",
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int depth = argc > 1 ? std::atoi(argv[1]) : 10;
+    const int maxThreads = argc > 2 ? std::atoi(argv[2]) : 16;
+    SearchEngine engine(64);
+    double baseMs = 0.0;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        engine.setThreadCount(threads);
+        uint64_t totalNodes = 0;
+        double totalMs = 0.0;
+        for (const char* moves : POSITIONS) {
+            Board board;
+            playMoves(board, moves);
+            engine.clear();
+
+            SearchLimits limits;
+            limits.timeMs = 0;
+            limits.maxDepth = depth;
+            const auto start = std::chrono::steady_clock::now();
+            const SearchResult r = engine.search(board, Config::PieceType::Black, limits);
+            totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            totalNodes += r.nodes;
+        }
+        if (threads == 1) {
+            baseMs = totalMs;
+        }
+        std::printf("threads %2d  depth %2d  time %9.1f ms  nodes %11llu  nps %9.0f  speedup %.2fx\n",
+                    threads, depth, totalMs, static_cast<unsigned long long>(totalNodes),
+                    totalMs > 0 ? totalNodes * 1000.0 / totalMs : 0.0, totalMs > 0 ? baseMs / totalMs : 0.0);
+    }
+    return 0;
+}
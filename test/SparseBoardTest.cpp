@@ -0,0 +1,169 @@
+﻿/**
+ * @brief SparseBoard 单元测试（无界棋盘稀疏后端）
+ * 测试内容：
+ * 1. 差分测试：在平移到任意坐标（含负坐标）的15×15窗口内随机落子/提子，
+ *    getPiece / checkWin / 候选着法与稠密Board逐一比对（四种规则）；
+ * 2. 无界：相距极远的棋子、跨分块边界与负坐标上的五连、坐标上限拒绝；
+ * 3. 内存：分块与候选计数只随棋子数增长，全部提走后归零。
+ */
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "TestCommon.h"
+#include "game/Board.h"
+#include "game/SparseBoard.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+std::vector<std::pair<int, int>> sparseCandidates(const SparseBoard& board, int rowOffset, int colOffset) {
+    std::vector<SparseBoard::Cell> cells;
+    board.candidateMoves(cells);
+    std::vector<std::pair<int, int>> result;
+    for (const SparseBoard::Cell& cell : cells) {
+        result.emplace_back(cell.row - rowOffset, cell.col - colOffset);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * @brief 稠密棋盘候选点中落在窗口内的部分（稀疏棋盘没有边缘，窗口外的候选点另行过滤）
+ */
+template <typename BoardT>
+std::vector<std::pair<int, int>> denseCandidates(const BoardT& board) {
+    int cells[N * N];
+    const int count = board.candidateMoves(cells);
+    std::vector<std::pair<int, int>> result;
+    for (int i = 0; i < count; ++i) {
+        result.emplace_back(cells[i] / N, cells[i] % N);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * @brief 单一规则下的差分测试（稠密棋盘的规则是编译期参数，稀疏棋盘是运行期参数）
+ */
+template <Rule R>
+void testAgainstDenseBoardFor(std::mt19937& rng) {
+    const int offsets[][2] = { {0, 0}, {-7, -7}, {-1000003, 999983}, {SparseBoard::COORD_LIMIT - N, -SparseBoard::COORD_LIMIT} };
+    for (const auto& offset : offsets) {
+        BasicBoard<N, R> dense;
+        SparseBoard sparse(R);
+        int mismatches = 0;
+        for (int step = 0; step < 4000; ++step) {
+            const int r = static_cast<int>(rng() % N);
+            const int c = static_cast<int>(rng() % N);
+            const int sr = r + offset[0];
+            const int sc = c + offset[1];
+            if (dense.getPiece(r, c) != Config::PieceType::None && rng() % 3 == 0) {
+                mismatches += dense.removePiece(r, c) != sparse.removePiece(sr, sc);
+            } else {
+                const Config::PieceType type = rng() % 2 ? B : W;
+                const bool placed = dense.placePiece(r, c, type);
+                mismatches += placed != sparse.placePiece(sr, sc, type);
+                if (placed) {
+                    mismatches += dense.checkWin(r, c, type) != sparse.checkWin(sr, sc, type);
+                }
+            }
+            mismatches += dense.stoneCount() != sparse.stoneCount();
+            if (step % 50 == 0) {
+                for (int rr = 0; rr < N; ++rr) {
+                    for (int cc = 0; cc < N; ++cc) {
+                        mismatches += dense.getPiece(rr, cc) != sparse.getPiece(rr + offset[0], cc + offset[1]);
+                    }
+                }
+                std::vector<std::pair<int, int>> expected = denseCandidates(dense);
+                std::vector<std::pair<int, int>> actual = sparseCandidates(sparse, offset[0], offset[1]);
+                if (dense.stoneCount() > 0) {
+                    actual.erase(std::remove_if(actual.begin(), actual.end(), [](const std::pair<int, int>& cell) {
+                        return cell.first < 0 || cell.first >= N || cell.second < 0 || cell.second >= N;
+                    }), actual.end());
+                    mismatches += expected != actual;
+                }
+            }
+            if (dense.stoneCount() > N * N / 2) {
+                dense.reset();
+                sparse.reset();
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+void testAgainstDenseBoard() {
+    std::mt19937 rng(16);
+    testAgainstDenseBoardFor<Rule::Freestyle>(rng);
+    testAgainstDenseBoardFor<Rule::Standard>(rng);
+    testAgainstDenseBoardFor<Rule::Renju>(rng);
+    testAgainstDenseBoardFor<Rule::Caro>(rng);
+}
+
+void testUnbounded() {
+    SparseBoard board;
+    CHECK(!board.isFull());
+    std::vector<SparseBoard::Cell> cells;
+    CHECK(board.candidateMoves(cells) == 1 && cells[0].row == 0 && cells[0].col == 0);
+
+    // 跨分块边界（-2..2）与负坐标上的斜线五连
+    for (int i = -2; i <= 2; ++i) {
+        CHECK(board.placePiece(i - 100, i + 7, B));
+    }
+    CHECK(board.checkWin(-100, 7, B));
+    CHECK(!board.checkWin(-100, 7, W));
+
+    // 相距极远的棋子各自只占一个分块
+    CHECK(board.placePiece(500000000, -500000000, W));
+    CHECK(board.placePiece(-SparseBoard::COORD_LIMIT, SparseBoard::COORD_LIMIT, W));
+    CHECK(!board.placePiece(SparseBoard::COORD_LIMIT + 1, 0, W));
+    CHECK(!board.placePiece(500000000, -500000000, B));
+    CHECK(board.getPiece(500000000, -500000000) == W);
+    CHECK(board.tileCount() <= 4);
+    CHECK(board.candidateMoves(cells) == 56 + 24 + 8); // 斜线五子5×5邻域并集的空点 + 孤子 + 坐标角上的孤子
+    CHECK(board.stoneCount() == 7);
+
+    // 长连：Standard下不算胜，Freestyle下算胜
+    SparseBoard standard(Rule::Standard);
+    SparseBoard freestyle(Rule::Freestyle);
+    for (int c = -3; c <= 2; ++c) {
+        standard.placePiece(-1, c, B);
+        freestyle.placePiece(-1, c, B);
+    }
+    CHECK(!standard.checkWin(-1, 0, B));
+    CHECK(freestyle.checkWin(-1, 0, B));
+}
+
+void testMemoryFollowsStones() {
+    SparseBoard board;
+    std::mt19937 rng(3);
+    std::vector<SparseBoard::Cell> placed;
+    while (placed.size() < 300) {
+        const SparseBoard::Cell cell{ static_cast<int>(rng() % 2000001) - 1000000, static_cast<int>(rng() % 2000001) - 1000000 };
+        if (board.placePiece(cell.row, cell.col, placed.size() % 2 ? W : B)) {
+            placed.push_back(cell);
+        }
+    }
+    CHECK(board.tileCount() <= placed.size());
+    std::vector<SparseBoard::Cell> cells;
+    CHECK(board.candidateMoves(cells) <= 24 * static_cast<int>(placed.size()));
+    for (const SparseBoard::Cell& cell : placed) {
+        CHECK(board.removePiece(cell.row, cell.col));
+    }
+    CHECK(board.stoneCount() == 0);
+    CHECK(board.tileCount() == 0);
+    CHECK(board.candidateMoves(cells) == 1);
+}
+
+} // namespace
+
+int main() {
+    testAgainstDenseBoard();
+    testUnbounded();
+    testMemoryFollowsStones();
+    return testResult("SparseBoardTest");
+}
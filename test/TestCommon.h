@@ -0,0 +1,87 @@
+﻿#pragma once
+#ifndef TESTCOMMON_H
+#define TESTCOMMON_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "story/Constants.h"
+
+/**
+ * @brief 单元测试公共工具（不依赖测试框架）
+ * CHECK(cond) 失败时打印文件/行号并累计失败数，testResult() 汇总后作为 main 的返回值，
+ * 与 ctest 的“返回0即通过”约定一致；另含各测试与基准共用的落子、计时与等待辅助函数。
+ */
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            ++testFailures();                                              \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);  \
+        }                                                                  \
+    } while (0)
+
+/**
+ * @brief 汇总测试结果
+ * @param name 测试程序名称
+ * @return int EXIT_SUCCESS=全部通过，EXIT_FAILURE=存在失败
+ */
+inline int testResult(const char* name) {
+    if (testFailures() != 0) {
+        std::printf("%s: %d check(s) failed\n", name, testFailures());
+        return EXIT_FAILURE;
+    }
+    std::printf("%s: all checks passed\n", name);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief 按“列字母+行号”的坐标串交替落子（黑先），如 "h8i9h9"
+ * @tparam BoardT 任意尺寸与规则的 BasicBoard
+ */
+template <typename BoardT>
+void playMoves(BoardT& board, const std::string& moves) {
+    Config::PieceType side = Config::PieceType::Black;
+    size_t i = 0;
+    while (i < moves.size()) {
+        const int col = moves[i++] - 'a';
+        int row = 0;
+        while (i < moves.size() && moves[i] >= '0' && moves[i] <= '9') {
+            row = row * 10 + (moves[i++] - '0');
+        }
+        board.placePiece(row - 1, col, side);
+        side = Config::opponent(side);
+    }
+}
+
+/**
+ * @brief 自start起经过的毫秒数
+ */
+inline int64_t elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief 等待条件成立（最多timeoutMs毫秒，每毫秒检查一次），用于等待后台线程的进度而不是固定休眠
+ * @return bool 条件是否在超时前成立
+ */
+template <typename Pred>
+bool waitFor(Pred pred, int timeoutMs = 5000) {
+    const auto start = std::chrono::steady_clock::now();
+    while (!pred()) {
+        if (elapsedMs(start) > timeoutMs) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+#endif // TESTCOMMON_H
@@ -0,0 +1,201 @@
+﻿/**
+ * @brief Texel 式估值调参单元测试（样本提取、损失与梯度、K 拟合与分值拟合）
+ * 测试内容：
+ * 1. 棋谱行解析：Tournament 紧凑棋谱行、BookBuilder 带空格的棋谱、省略结果、非法坐标；
+ * 2. 样本提取：特征与 PATTERN_SCORE 的内积等于 Board::evaluate(Black)，跳过开局手数、有成五点的局面不收录，
+ *    结果按注明值或重放判定，含非法着法的对局整局作废；
+ * 3. 损失与梯度：解析梯度与数值差分一致，多线程与单线程结果一致；
+ * 4. 拟合：由已知 K 与分值按 logistic 模型生成的合成样本上，fitScale 找回 K，tuneWeights 降低损失并向真实分值靠拢，
+ *    结果满足约束（None为0、单调不减、不超过上限）；生成的头文件含新的 PATTERN_SCORE 定义。
+ */
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "TestCommon.h"
+#include "tuning/TexelTuner.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+double currentWeights(int type) {
+    return PATTERN_SCORE[type];
+}
+
+/**
+ * @brief 合成样本：特征随机，结果按 σ(K × 真实估值) 的概率随机取胜负
+ */
+std::vector<TuningPosition> syntheticPositions(const double* weights, double scale, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> feature(-6, 6);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<TuningPosition> positions(count);
+    for (TuningPosition& position : positions) {
+        for (int type = 1; type < PATTERN_TYPE_COUNT - 2; ++type) {
+            position.features[type] = static_cast<int16_t>(feature(rng));
+        }
+        const double p = 1.0 / (1.0 + std::exp(-scale * positionEval(position, weights)));
+        position.result = uniform(rng) < p ? 1.0f : 0.0f;
+    }
+    return positions;
+}
+
+void testParseRecord() {
+    const int N = Config::BOARD_SIZE;
+    TuningGame game;
+    CHECK(parseGameRecord("h8i8h10 1-0 A 3", N, game));
+    CHECK(game.hasResult && game.result == 1);
+    CHECK(game.moves == std::vector<int>({ 7 * N + 7, 7 * N + 8, 9 * N + 7 }));
+
+    CHECK(parseGameRecord("h8 i9 h9\t0-1\r", N, game));
+    CHECK(game.hasResult && game.result == -1 && game.moves.size() == 3);
+    CHECK(parseGameRecord("h8i9 1/2", N, game));
+    CHECK(game.hasResult && game.result == 0 && game.moves.size() == 2);
+    CHECK(parseGameRecord("h8i9h9", N, game));
+    CHECK(!game.hasResult && game.moves.size() == 3);
+
+    CHECK(!parseGameRecord("h8z9 1-0", N, game));
+    CHECK(!parseGameRecord("1-0", N, game));
+    CHECK(!parseGameRecord("# A=ab B=ab", N, game));
+}
+
+void testExtractPositions() {
+    const int N = Config::BOARD_SIZE;
+    std::unique_ptr<GameSession> session = GameSession::create(N);
+    TuningGame game;
+    // 黑方第8行 h~l 连成五（第9手成五），第10手为成五之后的多余着法
+    CHECK(parseGameRecord("h8h9i8i9j8j9k8k9l8a15", N, game));
+
+    std::vector<TuningPosition> positions;
+    CHECK(extractPositions(*session, game, 0, positions) > 0);
+    CHECK(session->stoneCount() == 9);
+
+    // 逐手重放：平静局面的特征内积等于增量估值
+    Board board;
+    Config::PieceType side = B;
+    size_t index = 0;
+    for (int ply = 0; ply < 9; ++ply) {
+        const bool quiet = board.threatCount(B, PatternType::Five) == 0 && board.threatCount(W, PatternType::Five) == 0;
+        if (quiet) {
+            CHECK(index < positions.size());
+            if (index < positions.size()) {
+                double weights[PATTERN_TYPE_COUNT];
+                for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+                    weights[type] = currentWeights(type);
+                }
+                CHECK(static_cast<int>(positionEval(positions[index], weights)) == board.evaluate(B));
+                CHECK(positions[index].features[static_cast<int>(PatternType::Five)] == 0);
+                CHECK(positions[index].result == 1.0f);  // 未注明结果：按重放判定黑胜
+            }
+            ++index;
+        }
+        board.makeMove(game.moves[ply] / N, game.moves[ply] % N, side);
+        side = Config::opponent(side);
+    }
+    CHECK(index == positions.size());
+    CHECK(index < 9);   // 黑方活四、冲四之后的局面有成五点，不收录
+
+    // 注明结果优先；跳过开局手数
+    game.hasResult = true;
+    game.result = 0;
+    std::vector<TuningPosition> skipped;
+    CHECK(extractPositions(*session, game, 4, skipped) == static_cast<int>(positions.size()) - 4);
+    CHECK(!skipped.empty() && skipped[0].result == 0.5f);
+
+    // 含被占着法的对局整局作废，不留下样本
+    CHECK(parseGameRecord("h8i9h10h8 0-1", N, game));
+    CHECK(extractPositions(*session, game, 0, skipped) == -1);
+    CHECK(skipped.size() == positions.size() - 4);
+
+    // Renju：黑方禁手着法使整局作废
+    std::unique_ptr<GameSession> renju = GameSession::create(N, Rule::Renju);
+    CHECK(parseGameRecord("h8a1j8a2i9a3i10a4i8", N, game));   // 黑 i8 形成三三
+    CHECK(extractPositions(*renju, game, 0, skipped) == -1);
+}
+
+void testLossAndGradient() {
+    double truth[PATTERN_TYPE_COUNT];
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        truth[type] = currentWeights(type);
+    }
+    const std::vector<TuningPosition> positions = syntheticPositions(truth, 0.01, 30000, 7);
+    double weights[PATTERN_TYPE_COUNT] = { 0, 5, 12, 20, 40, 70, 300, 5000 };
+    const double scale = 0.01;
+
+    double gradient[PATTERN_TYPE_COUNT];
+    const double loss = tuningLoss(positions, weights, scale, 1, gradient);
+    CHECK(loss > 0.0 && loss < std::log(2.0));
+    for (int type = 1; type < PATTERN_TYPE_COUNT - 2; ++type) {
+        const double h = 1e-3;
+        double plus[PATTERN_TYPE_COUNT];
+        double minus[PATTERN_TYPE_COUNT];
+        for (int t = 0; t < PATTERN_TYPE_COUNT; ++t) {
+            plus[t] = minus[t] = weights[t];
+        }
+        plus[type] += h;
+        minus[type] -= h;
+        const double numeric = (tuningLoss(positions, plus, scale, 1) - tuningLoss(positions, minus, scale, 1)) / (2 * h);
+        CHECK(std::fabs(numeric - gradient[type]) < 1e-6 + 1e-4 * std::fabs(gradient[type]));
+    }
+    CHECK(gradient[static_cast<int>(PatternType::Five)] == 0.0);    // 样本中不出现的棋型梯度为0
+
+    double threaded[PATTERN_TYPE_COUNT];
+    const double threadedLoss = tuningLoss(positions, weights, scale, 4, threaded);
+    CHECK(std::fabs(threadedLoss - loss) < 1e-12);
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        CHECK(std::fabs(threaded[type] - gradient[type]) < 1e-12);
+    }
+    CHECK(tuningLoss(std::vector<TuningPosition>(), weights, scale, 4, threaded) == 0.0 && threaded[1] == 0.0);
+}
+
+void testTuning() {
+    const double truth[PATTERN_TYPE_COUNT] = { 0, 6, 15, 25, 90, 110, 500, 5000 };
+    const double trueScale = 0.008;
+    const std::vector<TuningPosition> positions = syntheticPositions(truth, trueScale, 60000, 11);
+
+    const double fitted = fitScale(positions, truth, 2);
+    CHECK(std::fabs(fitted / trueScale - 1.0) < 0.1);
+
+    TunerOptions options;
+    options.threads = 2;
+    options.epochs = 600;
+    options.learningRate = 1.0;
+    options.scale = trueScale;
+    int epochs = 0;
+    const TunerResult result = tuneWeights(positions, PATTERN_SCORE, options, [&](int epoch, double, const double*) {
+        CHECK(epoch == ++epochs);
+    });
+    CHECK(epochs == options.epochs && result.scale == trueScale);
+    CHECK(result.finalLoss < result.initialLoss);
+    CHECK(result.weights[0] == 0);
+    for (int type = 1; type < PATTERN_TYPE_COUNT; ++type) {
+        CHECK(result.weights[type] >= result.weights[type - 1] && result.weights[type] <= PATTERN_SCORE_LIMIT);
+    }
+    // 样本中出现的棋型向真实分值靠拢，不出现的棋型保持初始分值
+    for (int type = 1; type < PATTERN_TYPE_COUNT - 2; ++type) {
+        CHECK(std::fabs(result.weights[type] - truth[type]) < std::fabs(PATTERN_SCORE[type] - truth[type]) / 2 + 2);
+    }
+    CHECK(result.weights[static_cast<int>(PatternType::Five)] == PATTERN_SCORE[static_cast<int>(PatternType::Five)]);
+
+    const std::string header = formatWeightsHeader(result.weights, "测试");
+    CHECK(header.compare(0, 3, "\xEF\xBB\xBF") == 0);
+    std::string expected = "constexpr int PATTERN_SCORE[] = { 0";
+    for (int type = 1; type < PATTERN_TYPE_COUNT; ++type) {
+        expected += ", " + std::to_string(result.weights[type]);
+    }
+    CHECK(header.find(expected + " };\n") != std::string::npos);
+    CHECK(header.find("// 来源：测试\n") != std::string::npos);
+}
+
+} // namespace
+
+int main() {
+    testParseRecord();
+    testExtractPositions();
+    testLossAndGradient();
+    testTuning();
+    return testResult("TexelTunerTest");
+}
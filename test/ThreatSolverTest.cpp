@@ -0,0 +1,142 @@
+﻿/**
+ * @brief ThreatSolver 单元测试
+ * 测试内容：
+ * 1. VCF：长连续冲四（15手以上）能在毫秒级找到，返回的变例逐手合法（攻方每手冲四、守方堵成五点、最后成五）；
+ * 2. VCT：VCF不成立、必须借助活三的局面能找到必胜序列；
+ * 3. 无威胁局面与对方先成五的局面返回无解；
+ * 4. SearchEngine 在根节点直接采用必胜序列的第一手。
+ */
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include "TestCommon.h"
+#include "ai/SearchEngine.h"
+#include "ai/ThreatSolver.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+const int N = Config::BOARD_SIZE;
+
+/**
+ * @brief 逐手复盘必胜变例：攻方每手至少形成minPattern级威胁，守方着法必须落在空点，最后一手攻方成五
+ */
+bool replayLine(Board board, Config::PieceType attacker, const std::vector<int>& line, PatternType minPattern) {
+    if (line.empty() || line.size() % 2 == 0) {
+        return false;
+    }
+    Config::PieceType side = attacker;
+    for (size_t i = 0; i < line.size(); ++i) {
+        const int r = line[i] / N;
+        const int c = line[i] % N;
+        if (board.getPiece(r, c) != Config::PieceType::None) {
+            return false;
+        }
+        if (side == attacker && i + 1 < line.size()) {
+            PatternType best = PatternType::None;
+            for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+                best = std::max(best, board.pattern(r, c, dir, attacker));
+            }
+            if (best < minPattern) {
+                return false;
+            }
+        }
+        board.placePiece(r, c, side);
+        if (i + 1 == line.size()) {
+            return board.checkWin(r, c, attacker);
+        }
+        side = Config::opponent(side);
+    }
+    return false;
+}
+
+void testVcf() {
+    ThreatSolver solver;
+    Board board;
+    playMoves(board, "h8f8e6j8e10d5f7j6l7e12i10d9f5g7f11l4k12h4h5h12");
+
+    const auto start = std::chrono::steady_clock::now();
+    const ThreatResult r = solver.solveVCF(board, B);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    CHECK(r.found);
+    CHECK(r.line.size() >= 15);
+    CHECK(r.row * N + r.col == r.line.front());
+    CHECK(replayLine(board, B, r.line, PatternType::Four));
+    CHECK(elapsed < 50);
+
+    // 同一局面白方无VCF
+    CHECK(!solver.solveVCF(board, W).found);
+
+    // 轮到白方行棋的长VCF局面
+    board.reset();
+    playMoves(board, "h8h6g4h7g10f8e4d10j10g5d6h9g11d12j5e8d11g8d9i4k5");
+    const ThreatResult w = solver.solveVCF(board, W);
+    CHECK(w.found);
+    CHECK(w.line.size() >= 15);
+    CHECK(replayLine(board, W, w.line, PatternType::Four));
+}
+
+void testVct() {
+    ThreatSolver solver;
+    Board board;
+    playMoves(board, "h8g8f9d9f11d7e11e5e12d10d8e10j9k8h7d6j7h5e4f5f6i10");
+    CHECK(!solver.solveVCF(board, B).found);
+
+    const auto start = std::chrono::steady_clock::now();
+    const ThreatResult r = solver.solveVCT(board, B);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    CHECK(r.found);
+    CHECK(replayLine(board, B, r.line, PatternType::OpenThree));
+    CHECK(elapsed < 100);
+
+    // 空棋盘与单子局面没有必胜序列
+    board.reset();
+    CHECK(!solver.findForcedWin(board, B).found);
+    board.placePiece(7, 7, B);
+    CHECK(!solver.findForcedWin(board, W).found);
+}
+
+void testOpponentFive() {
+    // 黑方有活三可成VCT，但白方已冲四：黑方若不能以冲四堵住，则无必胜
+    ThreatSolver solver;
+    Board board;
+    board.placePiece(7, 6, B);
+    board.placePiece(7, 7, B);
+    board.placePiece(7, 8, B);
+    for (int c = 3; c <= 6; ++c) board.placePiece(2, c, W);
+    board.placePiece(2, 2, B);
+    CHECK(!solver.findForcedWin(board, B).found);
+
+    // 白方冲四被堵之后，黑方活三转活四
+    board.placePiece(2, 7, B);
+    board.placePiece(12, 12, W);
+    const ThreatResult r = solver.findForcedWin(board, B);
+    CHECK(r.found);
+    CHECK(r.row == 7 && (r.col == 5 || r.col == 9));
+}
+
+void testSearchIntegration() {
+    Board board;
+    playMoves(board, "h8f8e6j8e10d5f7j6l7e12i10d9f5g7f11l4k12h4h5h12");
+    ThreatSolver solver;
+    const ThreatResult expected = solver.solveVCF(board, B);
+
+    SearchEngine engine(4);
+    const SearchResult r = engine.search(board, B, SearchLimits());
+    CHECK(SearchEngine::isWinScore(r.score) && r.score > 0);
+    CHECK(r.row == expected.row && r.col == expected.col);
+    CHECK(r.timeMs < 100);
+}
+
+} // namespace
+
+int main() {
+    testVcf();
+    testVct();
+    testOpponentFive();
+    testSearchIntegration();
+    return testResult("ThreatSolverTest");
+}
@@ -0,0 +1,246 @@
+﻿/**
+ * @brief 自对弈锦标赛单元测试（统计、开局集、对局裁决与并行调度）
+ * 测试内容：
+ * 1. 配置串解析：合法/非法配置、未设限制的配置被拒绝、describe() 可再解析回同一配置；
+ * 2. 统计：得分率与 Elo 换算、置信区间随局数收窄、SPRT 在明显占优/势均力敌/样本不足时的判定；
+ * 3. 开局集：26 种标准开局互不相同且在全部 8 种棋盘对称下两两不等价；随机扩展按种子可复现、不成五；
+ * 4. 对局：重放棋谱验证裁决（只有最后一手成五，和棋时满盘或无着法），连珠下黑方不走禁手；
+ * 5. 锦标赛：局数、成对开局交换执色、棋谱行格式、SPRT 得出判定后提前结束。
+ */
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "TestCommon.h"
+#include "tournament/Tournament.h"
+
+namespace {
+
+const Config::PieceType B = Config::PieceType::Black;
+const Config::PieceType W = Config::PieceType::White;
+
+MatchScore makeScore(int wins, int draws, int losses) {
+    MatchScore score;
+    score.wins = wins;
+    score.draws = draws;
+    score.losses = losses;
+    return score;
+}
+
+/**
+ * @brief 测试用的快速配置（小节点预算，单局在数十毫秒内下完）
+ */
+EngineConfig fastConfig(uint64_t nodes) {
+    EngineConfig config;
+    config.maxNodes = nodes;
+    return config;
+}
+
+/**
+ * @brief 重放对局并检查裁决：开局之后每手都是空点且不是禁手，只有最后一手可能成五，结果与最后一手一致
+ */
+bool replayMatches(const GameRecord& record, int boardSize, Rule rule) {
+    std::unique_ptr<GameSession> session = GameSession::create(boardSize, rule);
+    Config::PieceType side = B;
+    for (size_t i = 0; i < record.moves.size(); ++i) {
+        const int row = record.moves[i] / boardSize;
+        const int col = record.moves[i] % boardSize;
+        if (static_cast<int>(i) >= record.openingPlies && session->isForbidden(row, col, side)) {
+            return false;
+        }
+        if (!session->makeMove(row, col, side)) {
+            return false;
+        }
+        const bool wins = session->checkWin(row, col, side);
+        if (wins != (i + 1 == record.moves.size() && record.result != 0)) {
+            return false;
+        }
+        if (wins && record.result != (side == B ? 1 : -1)) {
+            return false;
+        }
+        side = Config::opponent(side);
+    }
+    int candidates[Config::MAX_BOARD_SIZE * Config::MAX_BOARD_SIZE];
+    return record.result != 0 || session->isFull() || session->candidateMoves(candidates, side) == 0;
+}
+
+void testEngineConfig() {
+    EngineConfig config;
+    CHECK(EngineConfig::parse("ab", config));
+    CHECK(config.kind == EngineConfig::Kind::AlphaBeta && config.maxNodes == 20000);
+    CHECK(EngineConfig::parse("ab:nodes=5000,depth=6", config));
+    CHECK(config.maxNodes == 5000 && config.maxDepth == 6 && config.timeMs == 0);
+    CHECK(EngineConfig::parse("mcts:playouts=300,time=50", config));
+    CHECK(config.kind == EngineConfig::Kind::Mcts && config.maxPlayouts == 300 && config.timeMs == 50);
+
+    EngineConfig unchanged = config;
+    CHECK(!EngineConfig::parse("alphabeta", config));
+    CHECK(!EngineConfig::parse("ab:nodes=", config));
+    CHECK(!EngineConfig::parse("ab:nodes=-5", config));
+    CHECK(!EngineConfig::parse("ab:depth=0", config));
+    CHECK(!EngineConfig::parse("ab:speed=3", config));
+    CHECK(!EngineConfig::parse("ab:nodes=0", config));          // 不限时、不限节点、不限深度
+    CHECK(!EngineConfig::parse("mcts:playouts=0", config));
+    CHECK(config.describe() == unchanged.describe());
+
+    EngineConfig reparsed;
+    CHECK(EngineConfig::parse("ab:nodes=0,depth=5", config));
+    CHECK(EngineConfig::parse(config.describe(), reparsed) && reparsed.describe() == config.describe());
+}
+
+void testStatistics() {
+    CHECK(makeScore(0, 0, 0).score() == 0.5);
+    CHECK(makeScore(3, 2, 1).score() == 4.0 / 6.0);
+    CHECK(std::fabs(eloFromScore(0.5)) < 1e-9);
+    CHECK(std::fabs(eloFromScore(0.75) - 190.85) < 0.01);
+    CHECK(std::fabs(eloFromScore(0.25) + 190.85) < 0.01);
+    CHECK(std::isinf(eloFromScore(1.0)) && eloFromScore(1.0) > 0);
+
+    const EloEstimate even = estimateElo(makeScore(40, 20, 40));
+    CHECK(std::fabs(even.elo) < 1e-9 && std::fabs(even.lower + even.upper) < 1e-6 && even.lower < 0);
+    const EloEstimate small = estimateElo(makeScore(30, 10, 20));
+    const EloEstimate large = estimateElo(makeScore(300, 100, 200));
+    CHECK(std::fabs(small.elo - large.elo) < 1e-9 && small.elo > 0);
+    CHECK(small.lower < large.lower && large.lower < large.elo && large.elo < large.upper && large.upper < small.upper);
+
+    SprtParams params;
+    params.elo0 = 0.0;
+    params.elo1 = 10.0;
+    CHECK(sprtLlr(makeScore(0, 0, 0), params) == 0.0);
+    CHECK(sprtVerdict(makeScore(6, 2, 4), params) == SprtVerdict::Continue);
+    CHECK(sprtVerdict(makeScore(600, 200, 400), params) == SprtVerdict::AcceptH1);
+    CHECK(sprtVerdict(makeScore(5000, 0, 5000), params) == SprtVerdict::AcceptH0);
+    CHECK(sprtLlr(makeScore(60, 20, 40), params) > sprtLlr(makeScore(50, 20, 50), params));
+    CHECK(sprtVerdict(makeScore(2, 0, 0), params) == SprtVerdict::Continue);      // 开头一边倒不立即判定
+    CHECK(sprtVerdict(makeScore(30, 0, 0), params) == SprtVerdict::AcceptH1);     // 全胜：方差为0也能判定
+    CHECK(sprtVerdict(makeScore(0, 500, 0), params) == SprtVerdict::AcceptH0);     // 全和：与H0一致
+}
+
+void testOpenings() {
+    const int N = Config::BOARD_SIZE;
+    const int c = N / 2;
+    const std::vector<std::vector<int>> openings = standardOpenings(N);
+    CHECK(openings.size() == 26);
+
+    // 8 种对称变换下的规范形式两两不同
+    std::set<std::vector<int>> canonical;
+    for (const std::vector<int>& opening : openings) {
+        CHECK(opening.size() == 3 && opening[0] == c * N + c);
+        std::vector<int> best;
+        for (int t = 0; t < 8; ++t) {
+            std::vector<int> mapped;
+            for (int cell : opening) {
+                int dr = cell / N - c;
+                int dc = cell % N - c;
+                if (t & 1) std::swap(dr, dc);
+                if (t & 2) dr = -dr;
+                if (t & 4) dc = -dc;
+                mapped.push_back((c + dr) * N + c + dc);
+            }
+            if (best.empty() || mapped < best) {
+                best = mapped;
+            }
+        }
+        canonical.insert(best);
+    }
+    CHECK(canonical.size() == 26);
+
+    std::unique_ptr<GameSession> session = GameSession::create(N, Rule::Renju);
+    const std::vector<int> first = extendOpening(*session, openings[5], 4, 123);
+    const std::vector<int> again = extendOpening(*session, openings[5], 4, 123);
+    const std::vector<int> other = extendOpening(*session, openings[5], 4, 124);
+    CHECK(first.size() == 7 && first == again && first != other);
+    CHECK(std::equal(openings[5].begin(), openings[5].end(), first.begin()));
+    CHECK(session->stoneCount() == 7);
+
+    std::vector<int> cells;
+    CHECK(parseOpening("h8 i9\th10", N, cells));
+    CHECK(cells == std::vector<int>({ 7 * N + 7, 8 * N + 8, 9 * N + 7 }));
+    CHECK(!parseOpening("h8z9", N, cells));
+    CHECK(!parseOpening("h16", N, cells));
+    CHECK(!parseOpening("hh8", N, cells));
+    CHECK(!parseOpening("", N, cells));
+}
+
+void testPlayGame() {
+    const int N = Config::BOARD_SIZE;
+    const std::vector<std::vector<int>> openings = standardOpenings(N);
+    for (Rule rule : { Rule::Freestyle, Rule::Renju }) {
+        std::unique_ptr<GameSession> black = GameSession::create(N, rule);
+        std::unique_ptr<GameSession> white = GameSession::create(N, rule);
+        for (int i = 0; i < 3; ++i) {
+            const GameRecord record = playGame(*black, fastConfig(3000), *white, fastConfig(1500), openings[i * 7]);
+            CHECK(record.openingPlies == 3 && static_cast<int>(record.moves.size()) > record.openingPlies);
+            CHECK(replayMatches(record, N, rule));
+        }
+    }
+
+    // 开局已成五：不再搜索，直接按开局裁决
+    std::unique_ptr<GameSession> a = GameSession::create(N);
+    std::unique_ptr<GameSession> b = GameSession::create(N);
+    const std::vector<int> five = { 0, N, 1, N + 1, 2, N + 2, 3, N + 3, 4, N + 4 };
+    const GameRecord record = playGame(*a, fastConfig(1000), *b, fastConfig(1000), five);
+    CHECK(record.result == 1 && record.moves.size() == 9 && record.openingPlies == 9);
+}
+
+void testTournament() {
+    TournamentOptions options;
+    options.engineA = fastConfig(2000);
+    options.engineB = fastConfig(1000);
+    options.games = 7;
+    options.threads = 2;
+    // 自对弈默认用小置换表，1MB 的表同样能下完整局
+    CHECK(options.ttSizeMB < static_cast<size_t>(Config::AI_TT_SIZE_MB));
+    options.ttSizeMB = 1;
+
+    std::vector<TournamentGame> games;
+    const MatchScore score = runTournament(options, [&](const TournamentGame& game, const MatchScore& current) {
+        games.push_back(game);
+        CHECK(current.games() == static_cast<int>(games.size()));
+    });
+    CHECK(score.games() == 8 && games.size() == 8);
+
+    std::sort(games.begin(), games.end(), [](const TournamentGame& x, const TournamentGame& y) { return x.index < y.index; });
+    for (size_t i = 0; i < games.size(); ++i) {
+        CHECK(games[i].index == static_cast<int>(i));
+        CHECK(games[i].opening == static_cast<int>(i / 2));
+        CHECK(games[i].engineABlack == (i % 2 == 0));
+        CHECK(replayMatches(games[i].record, options.boardSize, options.rule));
+        if (i % 2 == 1) {
+            const std::vector<int>& prev = games[i - 1].record.moves;
+            const std::vector<int>& cur = games[i].record.moves;
+            CHECK(games[i].record.openingPlies == 3 + options.randomPlies);
+            CHECK(std::equal(cur.begin(), cur.begin() + games[i].record.openingPlies, prev.begin()));
+        }
+
+        // 棋谱行：着法串可按开局格式解析回原着法，后接结果、黑方引擎与开局编号
+        const std::string line = formatRecord(games[i], options.boardSize);
+        const size_t space = line.find(' ');
+        std::vector<int> cells;
+        CHECK(parseOpening(line.substr(0, space), options.boardSize, cells) && cells == games[i].record.moves);
+        const std::string result = games[i].record.result > 0 ? "1-0" : games[i].record.result < 0 ? "0-1" : "1/2";
+        CHECK(line.substr(space + 1) == result + (i % 2 == 0 ? " A " : " B ") + std::to_string(i / 2));
+    }
+
+    // 极宽松的错误率下第一局就能得出判定，单线程时只下一局
+    options.threads = 1;
+    options.games = 20;
+    options.useSprt = true;
+    options.sprt.elo1 = 400.0;
+    options.sprt.alpha = 0.49;
+    options.sprt.beta = 0.49;
+    CHECK(runTournament(options, nullptr).games() == 1);
+}
+
+} // namespace
+
+int main() {
+    testEngineConfig();
+    testStatistics();
+    testOpenings();
+    testPlayGame();
+    testTournament();
+    return testResult("TournamentTest");
+}
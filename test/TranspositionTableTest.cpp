@@ -0,0 +1,145 @@
+﻿/**
+ * @brief TranspositionTable 单元测试
+ * 测试内容：
+ * 1. 写入/查询/覆盖与字段打包（负分、无着法、深度截断）；
+ * 2. 替换策略：同桶满时优先替换浅层、旧世代条目，store() 返回是否发生冲突；
+ * 3. 多线程并发读写：XOR校验保证读到的条目字段始终与键自洽；
+ * 4. 大页内存选项：Linux内核支持透明大页时必须启用，否则（含非Linux）回退普通内存；搜索引擎透传该选项；填充率。
+ */
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "TestCommon.h"
+#include "ai/SearchEngine.h"
+#include "ai/TranspositionTable.h"
+
+namespace {
+
+void testStoreProbe() {
+    TranspositionTable tt(1);
+    TTEntry e;
+    CHECK(!tt.probe(0x1234, e));
+
+    tt.store(0x1234, -777, 9, TTBound::Lower, 112);
+    CHECK(tt.probe(0x1234, e));
+    CHECK(e.score == -777);
+    CHECK(e.depth == 9);
+    CHECK(e.bound == TTBound::Lower);
+    CHECK(e.move == 112);
+
+    // 同局面更浅的非精确结果不覆盖本世代的深层条目
+    tt.store(0x1234, 5, 2, TTBound::Upper, -1);
+    CHECK(tt.probe(0x1234, e));
+    CHECK(e.depth == 9);
+
+    // 精确值总是覆盖，未给出着法时保留旧着法
+    tt.store(0x1234, 42, 3, TTBound::Exact, -1);
+    CHECK(tt.probe(0x1234, e));
+    CHECK(e.score == 42 && e.depth == 3 && e.move == 112);
+
+    tt.store(0x5678, 1000000, 300, TTBound::Exact, -1);
+    CHECK(tt.probe(0x5678, e));
+    CHECK(e.depth == 255 && e.move == -1 && e.score == 1000000);
+
+    tt.clear();
+    CHECK(!tt.probe(0x1234, e));
+}
+
+void testReplacement() {
+    // 0MB → 仅1个桶，所有键落入同一个桶
+    TranspositionTable tt(0);
+    for (uint64_t k = 1; k <= 4; ++k) {
+        tt.store(k, 0, static_cast<int>(10 + k), TTBound::Exact, 0);
+    }
+    CHECK(tt.store(5, 0, 1, TTBound::Exact, 0));   // 挤掉了其他局面：冲突
+    TTEntry e;
+    CHECK(!tt.probe(1, e));     // 最浅的条目被替换
+    CHECK(tt.probe(5, e));
+    CHECK(!tt.store(5, 0, 2, TTBound::Exact, 0));  // 覆盖同一局面不算冲突
+
+    // 两个世代之后，旧条目的优先级按世代差降低：先挤掉旧的浅层条目，再挤掉旧的深层条目，
+    // 而不会挤掉本世代刚写入的浅层条目
+    tt.newSearch();
+    tt.newSearch();
+    tt.store(6, 0, 1, TTBound::Exact, 0);
+    tt.store(7, 0, 1, TTBound::Exact, 0);
+    CHECK(tt.probe(6, e) && tt.probe(7, e));
+    CHECK(!tt.probe(5, e));
+    CHECK(!tt.probe(2, e));
+    CHECK(tt.probe(3, e) && tt.probe(4, e));
+}
+
+void testConcurrent() {
+    TranspositionTable tt(1);
+    const int threads = 4;
+    std::vector<std::thread> workers;
+    std::vector<int> corrupt(threads, 0);
+    std::vector<int> hits(threads, 0);
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&tt, &corrupt, &hits, t]() {
+            std::mt19937_64 rng(static_cast<uint64_t>(t) + 1);
+            for (int i = 0; i < 200000; ++i) {
+                // 分值、深度、着法都由键派生，读到的条目必须与键一致
+                const uint64_t key = rng() % 50000 + 1;
+                const int score = static_cast<int>(key % 100000);
+                const int depth = static_cast<int>(key % 200);
+                const int move = static_cast<int>(key % 225);
+                if (rng() % 2) {
+                    tt.store(key, score, depth, TTBound::Exact, move);
+                } else {
+                    TTEntry e;
+                    if (tt.probe(key, e)) {
+                        ++hits[t];
+                        if (e.score != score || e.move != move || e.depth < depth) {
+                            ++corrupt[t];
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    for (int c : corrupt) {
+        CHECK(c == 0);
+    }
+    for (int h : hits) {
+        CHECK(h > 0);
+    }
+    CHECK(tt.fillRate() > 0.0 && tt.fillRate() <= 1.0);
+}
+
+void testHugePages() {
+    // madvise(MADV_HUGEPAGE)只在内核编入透明大页（存在该sysfs目录）时成功，与enabled的取值无关
+#if defined(__linux__)
+    const bool supported = std::ifstream("/sys/kernel/mm/transparent_hugepage/enabled").good();
+#else
+    const bool supported = false;
+#endif
+    TranspositionTable tt(4, true);
+    CHECK(tt.usingHugePages() == supported);
+    CHECK(tt.sizeBytes() == 4u * 1024u * 1024u);
+    tt.store(99, 1, 1, TTBound::Exact, 1);
+    TTEntry e;
+    CHECK(tt.probe(99, e));
+    tt.resize(2, false);
+    CHECK(!tt.usingHugePages());
+    CHECK(!tt.probe(99, e));
+
+    SearchEngine engine(4, true);
+    CHECK(engine.transpositionTable().usingHugePages() == supported);
+    SearchEngine plain(4);
+    CHECK(!plain.transpositionTable().usingHugePages());
+}
+
+} // namespace
+
+int main() {
+    testStoreProbe();
+    testReplacement();
+    testConcurrent();
+    testHugePages();
+    return testResult("TranspositionTableTest");
+}
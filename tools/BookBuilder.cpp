@@ -0,0 +1,239 @@
+﻿/**
+ * @brief 开局库建库工具
+ * 数据来源（可同时使用）：
+ * 1. 导入棋谱：文本文件每行一局，着法为“列字母+行号”坐标串（黑先，如 "h8i9h9i10"，着法间可有空格），
+ *    行尾可附对局结果 "1-0"（黑胜）/"0-1"（白胜）/"1/2"（和棋）；未附结果时按重放中是否成五判定，未分胜负记为和棋；
+ *    空行与 '#' 开头的行忽略；
+ * 2. 自对弈：困难AI（SearchEngine）双方对弈，前若干手在天元附近随机落子以保证开局多样性，
+ *    超过步数上限未分胜负记为和棋。
+ * 用法：BookBuilder <输出文件> [--games 棋谱文件]... [--selfplay 局数] [--time 每步毫秒]
+ *                  [--max-ply 收录手数] [--min-games 最少对局数] [--seed 随机种子]
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "ai/OpeningBook.h"
+#include "ai/SearchEngine.h"
+
+namespace {
+
+constexpr int N = Config::BOARD_SIZE;
+
+/**
+ * @brief 自对弈开局随机落子的手数与范围（天元周围 ±RANDOM_RADIUS）
+ */
+constexpr int RANDOM_OPENING_PLIES = 3;
+constexpr int RANDOM_RADIUS = 2;
+
+/**
+ * @brief 自对弈单局步数上限
+ */
+constexpr int MAX_GAME_PLIES = 120;
+
+/**
+ * @brief 解析一行棋谱
+ * 着法之间只允许空白；每个着法必须是“列字母+行号”且在棋盘范围内（与 Tournament 的开局解析一致），
+ * 其余字符（包括缺少行号的列字母）使整行无效，而不是被跳过或解析成棋盘外的格子。
+ * @param line 输入行
+ * @param cells 输出着法序列
+ * @param result 输出对局结果（1黑胜，-1白胜，0和棋；未注明时由调用方判定）
+ * @param hasResult 输出是否注明了结果
+ * @return bool 该行格式是否正确
+ */
+bool parseRecord(const std::string& line, std::vector<int>& cells, int& result, bool& hasResult) {
+    hasResult = false;
+    size_t i = 0;
+    while (i < line.size()) {
+        if (line.compare(i, 3, "1-0") == 0) { result = 1; hasResult = true; break; }
+        if (line.compare(i, 3, "0-1") == 0) { result = -1; hasResult = true; break; }
+        if (line.compare(i, 3, "1/2") == 0) { result = 0; hasResult = true; break; }
+        const char c = line[i];
+        if (c == ' ' || c == '\t' || c == '\r') {
+            ++i;
+            continue;
+        }
+        if (c < 'a' || c >= 'a' + N) {
+            return false;
+        }
+        const int col = c - 'a';
+        int row = 0;
+        ++i;
+        const size_t digits = i;
+        while (i < line.size() && line[i] >= '0' && line[i] <= '9') {
+            row = row * 10 + (line[i++] - '0');
+        }
+        if (i == digits || row < 1 || row > N) {
+            return false;
+        }
+        cells.push_back((row - 1) * N + col);
+    }
+    return true;
+}
+
+/**
+ * @brief 重放着法序列判定胜负（成五者胜，否则和棋），并截断成五之后的多余着法
+ */
+int replayResult(std::vector<int>& cells) {
+    Board board;
+    Config::PieceType side = Config::PieceType::Black;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        const int row = cells[i] / N;
+        const int col = cells[i] % N;
+        if (!board.placePiece(row, col, side)) {
+            cells.resize(i);
+            return 0;
+        }
+        if (board.checkWin(row, col, side)) {
+            cells.resize(i + 1);
+            return side == Config::PieceType::Black ? 1 : -1;
+        }
+        side = Config::opponent(side);
+    }
+    return 0;
+}
+
+/**
+ * @brief 导入棋谱文件（格式错误的行报告行号后跳过）
+ * @return int 成功收录的对局数（-1表示文件无法打开）
+ */
+int importRecords(const char* path, OpeningBookBuilder& builder) {
+    std::ifstream in(path);
+    if (!in) {
+        return -1;
+    }
+    int games = 0;
+    int lineNumber = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<int> cells;
+        int result = 0;
+        bool hasResult = false;
+        if (!parseRecord(line, cells, result, hasResult)) {
+            std::fprintf(stderr, "%s 第 %d 行格式错误，已跳过：%s\n", path, lineNumber, line.c_str());
+            continue;
+        }
+        const int replayed = replayResult(cells);
+        if (cells.empty()) {
+            continue;
+        }
+        if (builder.addGame(cells.data(), static_cast<int>(cells.size()), hasResult ? result : replayed)) {
+            ++games;
+        }
+    }
+    return games;
+}
+
+/**
+ * @brief 自对弈一局
+ * @return int 对局结果（1黑胜，-1白胜，0和棋）
+ */
+int selfPlayGame(SearchEngine& engine, int timeMs, std::mt19937& rng, std::vector<int>& cells) {
+    Board board;
+    Config::PieceType side = Config::PieceType::Black;
+    SearchLimits limits;
+    limits.timeMs = timeMs;
+    engine.clear();
+
+    for (int ply = 0; ply < MAX_GAME_PLIES && !board.isFull(); ++ply) {
+        int row;
+        int col;
+        if (ply < RANDOM_OPENING_PLIES) {
+            do {
+                row = N / 2 + static_cast<int>(rng() % (2 * RANDOM_RADIUS + 1)) - RANDOM_RADIUS;
+                col = N / 2 + static_cast<int>(rng() % (2 * RANDOM_RADIUS + 1)) - RANDOM_RADIUS;
+            } while (board.getPiece(row, col) != Config::PieceType::None);
+        } else {
+            const SearchResult r = engine.search(board, side, limits);
+            row = r.row;
+            col = r.col;
+        }
+        board.placePiece(row, col, side);
+        cells.push_back(row * N + col);
+        if (board.checkWin(row, col, side)) {
+            return side == Config::PieceType::Black ? 1 : -1;
+        }
+        side = Config::opponent(side);
+    }
+    return 0;
+}
+
+void printUsage() {
+    std::printf("用法：BookBuilder <输出文件> [--games 棋谱文件]... [--selfplay 局数] [--time 每步毫秒]\n"
+                "                 [--max-ply 收录手数] [--min-games 最少对局数] [--seed 随机种子]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    const char* output = argv[1];
+    std::vector<const char*> recordFiles;
+    int selfPlayGames = 0;
+    int timeMs = 50;
+    int maxPly = 12;
+    uint32_t minGames = 1;
+    unsigned seed = 20260216;
+    for (int i = 2; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--games") == 0 && hasValue) {
+            recordFiles.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--selfplay") == 0 && hasValue) {
+            selfPlayGames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--time") == 0 && hasValue) {
+            timeMs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-ply") == 0 && hasValue) {
+            maxPly = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--min-games") == 0 && hasValue) {
+            minGames = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    OpeningBookBuilder builder(maxPly);
+    for (const char* path : recordFiles) {
+        const int games = importRecords(path, builder);
+        if (games < 0) {
+            std::fprintf(stderr, "无法打开棋谱文件：%s\n", path);
+            return 1;
+        }
+        std::printf("导入 %s：%d 局\n", path, games);
+    }
+
+    if (selfPlayGames > 0) {
+        SearchEngine engine(64);
+        std::mt19937 rng(seed);
+        int results[3] = { 0, 0, 0 };   // 白胜/和/黑胜
+        for (int g = 0; g < selfPlayGames; ++g) {
+            std::vector<int> cells;
+            const int result = selfPlayGame(engine, timeMs, rng, cells);
+            builder.addGame(cells.data(), static_cast<int>(cells.size()), result);
+            ++results[result + 1];
+            std::printf("\r自对弈 %d/%d（黑胜 %d，白胜 %d，和 %d）", g + 1, selfPlayGames,
+                        results[2], results[0], results[1]);
+            std::fflush(stdout);
+        }
+        std::printf("\n");
+    }
+
+    if (!builder.write(output, minGames)) {
+        std::fprintf(stderr, "写出开局库失败：%s\n", output);
+        return 1;
+    }
+    std::printf("开局库已写出：%s（收录 %zu 个局面着法）\n", output, builder.entryCount());
+    return 0;
+}
@@ -0,0 +1,177 @@
+﻿/**
+ * @brief 神经网络估值训练工具（离线、纯CPU）
+ * 读取自对弈棋谱（与 TexelTuner 相同的格式，每行一局），重放每局并把开局之后的平静局面（行棋方视角）与对局结果作为样本，
+ * 以小批 Adam 训练浮点网络，再量化写成权重文件（放到可执行文件同目录、命名为 eval<棋盘边长>.nnue 即被困难 AI 加载）。
+ * 输出缩放取 1/K（K 为当前棋型分值在同一批样本上拟合的缩放系数），使网络估值与棋型估值同一量级。
+ * 训练后应再用 Tournament 对比网络估值与棋型估值的实际棋力。
+ * 用法：NnueTrainer --games 棋谱文件 [--games 棋谱文件]... [--size 15|19] [--rule freestyle|standard|renju|caro]
+ *                  [--skip 跳过的开局手数] [--threads 线程数] [--epochs 轮数] [--batch 小批大小] [--lr 步长]
+ *                  [--seed 随机种子] [--scale K] [--out 权重文件]
+ * 示例：Tournament --games 20000 --out games.txt
+ *       NnueTrainer --games games.txt --out eval15.nnue
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tuning/NnueTrainer.h"
+
+namespace {
+
+/**
+ * @brief 默认跳过的开局手数（与 TexelTuner 相同：开局集与随机着法不反映棋力）
+ */
+constexpr int DEFAULT_SKIP_PLIES = 6;
+
+bool parseRule(const std::string& name, Rule& rule) {
+    if (name == "freestyle") {
+        rule = Rule::Freestyle;
+    } else if (name == "standard") {
+        rule = Rule::Standard;
+    } else if (name == "renju") {
+        rule = Rule::Renju;
+    } else if (name == "caro") {
+        rule = Rule::Caro;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取一个棋谱文件，同时提取网络样本与棋型特征样本（后者只用于拟合输出缩放）
+ * @return bool 文件能否打开
+ */
+bool loadGames(const char* path, GameSession& session, int skipPlies, std::vector<NnueSample>& samples,
+               std::vector<TuningPosition>& positions, int& games, int& rejected) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    TuningGame game;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line == "\r") {
+            continue;
+        }
+        if (!parseGameRecord(line, session.boardSize(), game)
+            || extractNnueSamples(session, game, skipPlies, samples) < 0) {
+            ++rejected;
+            continue;
+        }
+        extractPositions(session, game, skipPlies, positions);
+        ++games;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::printf("用法：NnueTrainer --games 棋谱文件 [--games 棋谱文件]... [--size 15|19] [--rule freestyle|standard|renju|caro]\n"
+                "                  [--skip 跳过的开局手数] [--threads 线程数] [--epochs 轮数] [--batch 小批大小] [--lr 步长]\n"
+                "                  [--seed 随机种子] [--scale K] [--out 权重文件]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<const char*> gamePaths;
+    int boardSize = Config::BOARD_SIZE;
+    Rule rule = Rule::Freestyle;
+    int skipPlies = DEFAULT_SKIP_PLIES;
+    double scale = 0.0;
+    NnueTrainerOptions options;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (!hasValue) {
+            // 所有选项都带参数
+        } else if (std::strcmp(argv[i], "--games") == 0) {
+            gamePaths.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--size") == 0) {
+            boardSize = std::atoi(argv[++i]);
+            ok = GameSession::isSupportedSize(boardSize);
+        } else if (std::strcmp(argv[i], "--rule") == 0) {
+            ok = parseRule(argv[++i], rule);
+        } else if (std::strcmp(argv[i], "--skip") == 0) {
+            skipPlies = std::atoi(argv[++i]);
+            ok = skipPlies >= 0;
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--epochs") == 0) {
+            options.epochs = std::atoi(argv[++i]);
+            ok = options.epochs >= 0;
+        } else if (std::strcmp(argv[i], "--batch") == 0) {
+            options.batchSize = std::atoi(argv[++i]);
+            ok = options.batchSize > 0;
+        } else if (std::strcmp(argv[i], "--lr") == 0) {
+            options.learningRate = std::atof(argv[++i]);
+            ok = options.learningRate > 0.0;
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--scale") == 0) {
+            scale = std::atof(argv[++i]);
+            ok = scale > 0.0;
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            outputPath = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 1;
+        }
+    }
+    if (gamePaths.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (outputPath.empty()) {
+        outputPath = "eval" + std::to_string(boardSize) + ".nnue";
+    }
+
+    std::unique_ptr<GameSession> session = GameSession::create(boardSize, rule);
+    std::vector<NnueSample> samples;
+    std::vector<TuningPosition> positions;
+    int games = 0;
+    int rejected = 0;
+    for (const char* path : gamePaths) {
+        if (!loadGames(path, *session, skipPlies, samples, positions, games, rejected)) {
+            std::fprintf(stderr, "无法读取棋谱文件：%s\n", path);
+            return 1;
+        }
+    }
+    std::printf("%d 局（跳过 %d 行格式错误或含非法着法的对局），%zu 个样本\n", games, rejected, samples.size());
+    if (samples.empty()) {
+        std::fprintf(stderr, "没有可用的样本\n");
+        return 1;
+    }
+
+    if (scale <= 0.0) {
+        double weights[PATTERN_TYPE_COUNT];
+        for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+            weights[type] = PATTERN_SCORE[type];
+        }
+        scale = fitScale(positions, weights, options.threads);
+    }
+    const int32_t outputScale = static_cast<int32_t>(std::max(1L, std::lround(1.0 / scale)));
+    std::printf("K = %.6g，输出缩放 %d\n", scale, outputScale);
+
+    const NnueFloatNetwork network = trainNnue(samples, boardSize, options, [](int epoch, double loss) {
+        std::printf("第 %d 轮：损失 %.6f\n", epoch, loss);
+        std::fflush(stdout);
+    });
+    std::printf("训练完成：全量损失 %.6f\n", nnueLoss(network, samples, options.threads));
+
+    if (!network.quantize(outputScale).write(QString::fromStdString(outputPath))) {
+        std::fprintf(stderr, "无法写出：%s\n", outputPath.c_str());
+        return 1;
+    }
+    std::printf("已写出 %s（%lld 字节），放到可执行文件同目录后困难 AI 自动加载\n", outputPath.c_str(),
+                static_cast<long long>(NnueNetwork::fileSize(boardSize)));
+    return 0;
+}
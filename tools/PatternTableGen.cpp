@@ -0,0 +1,41 @@
+﻿/**
+ * @brief 棋型查找表生成器（构建期自动运行，无需手动调用）
+ * 按 PatternGen.h 的算法计算每种规则（Rule）的65536个表项，写出 PatternTables.inc，
+ * 由 Pattern.cpp 以constexpr数组的形式包含。
+ * 用法：PatternTableGen <输出文件>
+ */
+#include <cstdio>
+#include <vector>
+#include "game/PatternGen.h"
+
+namespace {
+
+const char* const RULE_NAMES[RULE_COUNT] = { "Freestyle", "Standard", "Renju", "Caro" };
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "用法：PatternTableGen <输出文件>\n");
+        return 1;
+    }
+    std::FILE* out = std::fopen(argv[1], "w");
+    if (!out) {
+        std::fprintf(stderr, "无法写入：%s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<uint32_t> entries(PatternCode::TABLE_SIZE);
+    std::vector<PatternType> black(PatternCode::TABLE_SIZE);
+    std::vector<PatternType> white(PatternCode::TABLE_SIZE);
+    std::fprintf(out, "// 由 tools/PatternTableGen 在构建时生成，请勿手工修改\n");
+    for (int rule = 0; rule < RULE_COUNT; ++rule) {
+        PatternGen::buildEntries(static_cast<Rule>(rule), entries.data(), black.data(), white.data());
+        std::fprintf(out, "// Rule::%s\n{ {\n", RULE_NAMES[rule]);
+        for (int code = 0; code < PatternCode::TABLE_SIZE; ++code) {
+            std::fprintf(out, "0x%08Xu,%c", entries[code], code % 8 == 7 ? '\n' : ' ');
+        }
+        std::fprintf(out, "} },\n");
+    }
+    return std::fclose(out) == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+﻿/**
+ * @brief Piskvork/Gomocup 协议引擎（无界面，只依赖棋盘与AI代码）
+ * 通过标准输入输出与 Piskvork 管理器、Gomocup 对弈平台或其他兼容程序通信，
+ * 用于与其他引擎本地对局、在无显示环境的服务器上运行，以及脱离界面测量启动与每步耗时。
+ * 协议细节见 src/protocol/PiskvorkProtocol.h。
+ * 用法：pbrain-lqhj（命令从标准输入逐行读取，应答写到标准输出）
+ */
+#include <iostream>
+#include "protocol/PiskvorkProtocol.h"
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    PiskvorkProtocol protocol(std::cout);
+    return protocol.run(std::cin);
+}
@@ -0,0 +1,183 @@
+﻿/**
+ * @brief 估值分值调参工具（Texel 式，离线、纯CPU）
+ * 读取自对弈棋谱（Tournament --out 的紧凑棋谱行或 BookBuilder 的棋谱格式，每行一局），
+ * 重放每局并把开局之后的平静局面（双方都没有成五点）与对局结果作为样本，
+ * 先拟合估值到胜率的缩放系数 K，再固定 K 以多线程全量梯度下降（Adam）使对数损失最小，
+ * 最后把取整后的棋型分值写成 src/game/EvalWeights.h，重新构建即可让引擎使用新分值。
+ * 调参前后应再用 Tournament 对比新旧分值的实际棋力（损失下降不等于棋力提升）。
+ * 用法：TexelTuner --games 棋谱文件 [--games 棋谱文件]... [--size 15|19] [--rule freestyle|standard|renju|caro]
+ *                 [--skip 跳过的开局手数] [--threads 线程数] [--epochs 轮数] [--lr 步长] [--scale K] [--out 头文件]
+ * 示例：Tournament --games 20000 --out games.txt
+ *       TexelTuner --games games.txt --out src/game/EvalWeights.h
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tuning/TexelTuner.h"
+
+namespace {
+
+/**
+ * @brief 默认跳过的开局手数（Tournament 的开局集 3 手加随机着法 2 手，与棋型分值无关）
+ */
+constexpr int DEFAULT_SKIP_PLIES = 6;
+
+/**
+ * @brief 进度输出间隔（轮）
+ */
+constexpr int REPORT_INTERVAL = 50;
+
+bool parseRule(const std::string& name, Rule& rule) {
+    if (name == "freestyle") {
+        rule = Rule::Freestyle;
+    } else if (name == "standard") {
+        rule = Rule::Standard;
+    } else if (name == "renju") {
+        rule = Rule::Renju;
+    } else if (name == "caro") {
+        rule = Rule::Caro;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取一个棋谱文件并提取样本（空行与 '#' 开头的行忽略，格式错误或含非法着法的对局跳过）
+ * @return bool 文件能否打开
+ */
+bool loadGames(const char* path, GameSession& session, int skipPlies, std::vector<TuningPosition>& positions,
+               int& games, int& rejected) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    TuningGame game;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line == "\r") {
+            continue;
+        }
+        if (!parseGameRecord(line, session.boardSize(), game)
+            || extractPositions(session, game, skipPlies, positions) < 0) {
+            ++rejected;
+            continue;
+        }
+        ++games;
+    }
+    return true;
+}
+
+void printWeights(const char* label, const int* weights) {
+    std::printf("%s {", label);
+    for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+        std::printf(" %d", weights[type]);
+    }
+    std::printf(" }\n");
+}
+
+void printUsage() {
+    std::printf("用法：TexelTuner --games 棋谱文件 [--games 棋谱文件]... [--size 15|19] [--rule freestyle|standard|renju|caro]\n"
+                "                 [--skip 跳过的开局手数] [--threads 线程数] [--epochs 轮数] [--lr 步长] [--scale K] [--out 头文件]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<const char*> gamePaths;
+    int boardSize = Config::BOARD_SIZE;
+    Rule rule = Rule::Freestyle;
+    int skipPlies = DEFAULT_SKIP_PLIES;
+    TunerOptions options;
+    const char* outputPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (!hasValue) {
+            // 所有选项都带参数
+        } else if (std::strcmp(argv[i], "--games") == 0) {
+            gamePaths.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--size") == 0) {
+            boardSize = std::atoi(argv[++i]);
+            ok = GameSession::isSupportedSize(boardSize);
+        } else if (std::strcmp(argv[i], "--rule") == 0) {
+            ok = parseRule(argv[++i], rule);
+        } else if (std::strcmp(argv[i], "--skip") == 0) {
+            skipPlies = std::atoi(argv[++i]);
+            ok = skipPlies >= 0;
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--epochs") == 0) {
+            options.epochs = std::atoi(argv[++i]);
+            ok = options.epochs >= 0;
+        } else if (std::strcmp(argv[i], "--lr") == 0) {
+            options.learningRate = std::atof(argv[++i]);
+            ok = options.learningRate > 0.0;
+        } else if (std::strcmp(argv[i], "--scale") == 0) {
+            options.scale = std::atof(argv[++i]);
+            ok = options.scale > 0.0;
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            outputPath = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 1;
+        }
+    }
+    if (gamePaths.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::unique_ptr<GameSession> session = GameSession::create(boardSize, rule);
+    std::vector<TuningPosition> positions;
+    int games = 0;
+    int rejected = 0;
+    for (const char* path : gamePaths) {
+        if (!loadGames(path, *session, skipPlies, positions, games, rejected)) {
+            std::fprintf(stderr, "无法读取棋谱文件：%s\n", path);
+            return 1;
+        }
+    }
+    std::printf("%d 局（跳过 %d 行格式错误或含非法着法的对局），%zu 个样本\n", games, rejected, positions.size());
+    if (positions.empty()) {
+        std::fprintf(stderr, "没有可用的样本\n");
+        return 1;
+    }
+
+    printWeights("初始分值", PATTERN_SCORE);
+    const TunerResult result = tuneWeights(positions, PATTERN_SCORE, options, [&](int epoch, double loss, const double* weights) {
+        if (epoch % REPORT_INTERVAL == 0 || epoch == options.epochs) {
+            std::printf("第 %d 轮：损失 %.6f，分值 {", epoch, loss);
+            for (int type = 0; type < PATTERN_TYPE_COUNT; ++type) {
+                std::printf(" %.1f", weights[type]);
+            }
+            std::printf(" }\n");
+            std::fflush(stdout);
+        }
+    });
+    std::printf("K = %.6g，损失 %.6f -> %.6f\n", result.scale, result.initialLoss, result.finalLoss);
+    printWeights("调参分值", result.weights);
+
+    if (!outputPath) {
+        std::printf("未指定 --out，不写出头文件\n");
+        return 0;
+    }
+    char source[256];
+    std::snprintf(source, sizeof(source), "%d 局 %zu 个样本（%dx%d，跳过开局 %d 手），K=%.6g，对数损失 %.6f -> %.6f",
+                  games, positions.size(), boardSize, boardSize, skipPlies, result.scale, result.initialLoss,
+                  result.finalLoss);
+    std::ofstream out(outputPath, std::ios::binary);
+    if (!out || !(out << formatWeightsHeader(result.weights, source))) {
+        std::fprintf(stderr, "无法写出：%s\n", outputPath);
+        return 1;
+    }
+    std::printf("已写出 %s，重新构建后生效\n", outputPath);
+    return 0;
+}
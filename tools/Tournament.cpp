@@ -0,0 +1,177 @@
+﻿/**
+ * @brief 自对弈锦标赛工具（无界面，多线程并行对局，用数据判断引擎改动的强弱）
+ * 两个引擎配置（见 EngineConfig 的配置串格式）以固定开局集成对对局（同一开局交换执色），
+ * 默认开局集为 26 种标准三手开局，也可从文件读入（每行一个“列字母+行号”坐标串）。
+ * 满盘判和；结束时报告胜/和/负、Elo 差与 95% 置信区间；启用 --sprt 时按 SPRT 判定接受/拒绝并提前结束。
+ * 每局写一行紧凑棋谱（格式见 formatRecord()，可直接交给 BookBuilder --games 导入）。
+ * 用法：Tournament [--a 配置串] [--b 配置串] [--games 局数] [--threads 线程数] [--size 15|19]
+ *                 [--rule freestyle|standard|renju|caro] [--openings 开局文件] [--random-plies 手数]
+ *                 [--seed 随机种子] [--tt 置换表MB] [--sprt elo0,elo1] [--alpha α] [--beta β] [--out 棋谱文件]
+ * 示例：Tournament --a ab:nodes=40000 --b ab:nodes=20000 --games 2000 --sprt 0,10 --out games.txt
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "tournament/Tournament.h"
+
+namespace {
+
+/**
+ * @brief 进度输出间隔（局）
+ */
+constexpr int REPORT_INTERVAL = 20;
+
+bool parseRule(const std::string& name, Rule& rule) {
+    if (name == "freestyle") {
+        rule = Rule::Freestyle;
+    } else if (name == "standard") {
+        rule = Rule::Standard;
+    } else if (name == "renju") {
+        rule = Rule::Renju;
+    } else if (name == "caro") {
+        rule = Rule::Caro;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取开局文件（空行与 '#' 开头的行忽略）
+ * @return bool 文件能否打开且每行都是合法坐标串
+ */
+bool loadOpenings(const char* path, int boardSize, std::vector<std::vector<int>>& openings) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line == "\r") {
+            continue;
+        }
+        std::vector<int> cells;
+        if (!parseOpening(line, boardSize, cells)) {
+            std::fprintf(stderr, "开局格式错误：%s\n", line.c_str());
+            return false;
+        }
+        openings.push_back(cells);
+    }
+    return true;
+}
+
+void printScore(const MatchScore& score, const SprtParams* sprt) {
+    const EloEstimate elo = estimateElo(score);
+    std::printf("%d 局：A 胜 %d，和 %d，负 %d，得分率 %.1f%%，Elo %+.1f [%+.1f, %+.1f]",
+                score.games(), score.wins, score.draws, score.losses, score.score() * 100.0, elo.elo, elo.lower, elo.upper);
+    if (sprt) {
+        std::printf("，LLR %.2f", sprtLlr(score, *sprt));
+    }
+    std::printf("\n");
+}
+
+void printUsage() {
+    std::printf("用法：Tournament [--a 配置串] [--b 配置串] [--games 局数] [--threads 线程数] [--size 15|19]\n"
+                "                 [--rule freestyle|standard|renju|caro] [--openings 开局文件] [--random-plies 手数]\n"
+                "                 [--seed 随机种子] [--tt 置换表MB] [--sprt elo0,elo1] [--alpha α] [--beta β] [--out 棋谱文件]\n"
+                "配置串：ab[:nodes=N,depth=D,time=MS] 或 mcts[:playouts=N,time=MS]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // 默认 A 的节点预算是 B 的两倍：不带参数运行即可确认工具能分辨出强弱
+    TournamentOptions options;
+    options.engineA.maxNodes = 40000;
+    const char* openingsPath = nullptr;
+    const char* outputPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (!hasValue) {
+            // 所有选项都带参数
+        } else if (std::strcmp(argv[i], "--a") == 0) {
+            ok = EngineConfig::parse(argv[++i], options.engineA);
+        } else if (std::strcmp(argv[i], "--b") == 0) {
+            ok = EngineConfig::parse(argv[++i], options.engineB);
+        } else if (std::strcmp(argv[i], "--games") == 0) {
+            options.games = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--size") == 0) {
+            options.boardSize = std::atoi(argv[++i]);
+            ok = GameSession::isSupportedSize(options.boardSize);
+        } else if (std::strcmp(argv[i], "--rule") == 0) {
+            ok = parseRule(argv[++i], options.rule);
+        } else if (std::strcmp(argv[i], "--openings") == 0) {
+            openingsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--random-plies") == 0) {
+            options.randomPlies = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--tt") == 0) {
+            options.ttSizeMB = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+            ok = options.ttSizeMB > 0;
+        } else if (std::strcmp(argv[i], "--sprt") == 0) {
+            options.useSprt = std::sscanf(argv[++i], "%lf,%lf", &options.sprt.elo0, &options.sprt.elo1) == 2
+                && options.sprt.elo0 < options.sprt.elo1;
+            ok = options.useSprt;
+        } else if (std::strcmp(argv[i], "--alpha") == 0) {
+            options.sprt.alpha = std::atof(argv[++i]);
+            ok = options.sprt.alpha > 0.0 && options.sprt.alpha < 0.5;
+        } else if (std::strcmp(argv[i], "--beta") == 0) {
+            options.sprt.beta = std::atof(argv[++i]);
+            ok = options.sprt.beta > 0.0 && options.sprt.beta < 0.5;
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            outputPath = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // 开局文件的坐标依赖棋盘尺寸，在全部参数解析完后再读
+    if (openingsPath && !loadOpenings(openingsPath, options.boardSize, options.openings)) {
+        std::fprintf(stderr, "无法读取开局文件：%s\n", openingsPath);
+        return 1;
+    }
+    std::ofstream output;
+    if (outputPath) {
+        output.open(outputPath);
+        if (!output) {
+            std::fprintf(stderr, "无法写出棋谱文件：%s\n", outputPath);
+            return 1;
+        }
+        output << "# A=" << options.engineA.describe() << " B=" << options.engineB.describe()
+               << " size=" << options.boardSize << " rule=" << static_cast<int>(options.rule)
+               << " seed=" << options.seed << "\n";
+    }
+
+    std::printf("A = %s\nB = %s\n", options.engineA.describe().c_str(), options.engineB.describe().c_str());
+    const SprtParams* sprt = options.useSprt ? &options.sprt : nullptr;
+    const MatchScore score = runTournament(options, [&](const TournamentGame& game, const MatchScore& current) {
+        if (output.is_open()) {
+            output << formatRecord(game, options.boardSize) << "\n";
+        }
+        if (current.games() % REPORT_INTERVAL == 0) {
+            printScore(current, sprt);
+            std::fflush(stdout);
+        }
+    });
+
+    std::printf("最终结果：");
+    printScore(score, sprt);
+    if (sprt) {
+        const SprtVerdict verdict = sprtVerdict(score, *sprt);
+        std::printf("SPRT [%.1f, %.1f] α=%.2f β=%.2f：%s\n", sprt->elo0, sprt->elo1, sprt->alpha, sprt->beta,
+                    verdict == SprtVerdict::AcceptH1 ? "接受 H1（A 更强）"
+                    : verdict == SprtVerdict::AcceptH0 ? "接受 H0（拒绝 A 更强）" : "未得出结论（局数用尽）");
+    }
+    return 0;
+}